@@ -65,6 +65,47 @@ ODE_API dSpaceID dQuadTreeSpaceCreate (dSpaceID space, const dVector3 Center, co
 
 ODE_API dSpaceID dSweepAndPruneSpaceCreate( dSpaceID space, int axisorder );
 
+/**
+ * @brief Create a space that keeps its geoms in a dynamic AABB tree.
+ *
+ * The leaves of the tree hold the AABBs of the geoms enlarged by a margin.
+ * A geom that moves within its enlarged AABB does not change the tree, the
+ * others are taken out and inserted again, so geoms that never move cost
+ * nothing after their insertion. dSpaceCollide2 queries the tree instead
+ * of testing every geom, which makes this space a good container for
+ * static geometry that is only ever collided against other spaces.
+ *
+ * @param space the space to add the new space to, or 0
+ * @returns the new space
+ * @ingroup collide
+ * @see dTreeSpaceSetMargin
+ */
+ODE_API dSpaceID dTreeSpaceCreate (dSpaceID space);
+
+/**
+ * @brief Set the margin added to the AABBs of the leaves of a tree space.
+ *
+ * A larger margin lets moving geoms stay longer in their leaf, at the cost
+ * of looser boxes during the queries. The new margin applies to the geoms
+ * that are inserted afterwards. The default is 0.05.
+ *
+ * @param space the tree space to modify
+ * @param margin the margin, in each direction of each axis
+ * @ingroup collide
+ * @see dTreeSpaceGetMargin
+ */
+ODE_API void dTreeSpaceSetMargin (dSpaceID space, dReal margin);
+
+/**
+ * @brief Get the margin added to the AABBs of the leaves of a tree space.
+ *
+ * @param space the tree space to query
+ * @returns the margin
+ * @ingroup collide
+ * @see dTreeSpaceSetMargin
+ */
+ODE_API dReal dTreeSpaceGetMargin (dSpaceID space);
+
 
 
 ODE_API void dSpaceDestroy (dSpaceID);
@@ -161,6 +202,7 @@ ODE_API dGeomID dSpaceGetGeom (dSpaceID, int i);
  *  @li dHashSpaceClass
  *  @li dSweepAndPruneSpaceClass
  *  @li dQuadTreeSpaceClass
+ *  @li dTreeSpaceClass
  *  @li dFirstUserClass
  *  @li dLastUserClass
  *
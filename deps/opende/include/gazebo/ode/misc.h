@@ -41,7 +41,8 @@ ODE_API int dTestRand(void);
  */
 ODE_API unsigned long dRand(void);
 
-/* get and set the current random number seed. */
+/* get and set the current random number seed. The seed is local to the
+ * calling thread. */
 ODE_API unsigned long  dRandGetSeed(void);
 ODE_API void dRandSetSeed (unsigned long s);
 
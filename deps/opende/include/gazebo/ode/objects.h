@@ -155,6 +155,25 @@ ODE_API void dWorldSetCFM (dWorldID, dReal cfm);
  */
 ODE_API dReal dWorldGetCFM (dWorldID);
 
+/**
+ * @brief Set the seed of the random numbers drawn while stepping the world.
+ *
+ * Each island of a step seeds the random generator of the thread that
+ * solves it from this seed, the step and the island index, so the
+ * sequence doesn't depend on which thread solves the island, nor on other
+ * worlds stepped in the same process.
+ * @ingroup world
+ * @param s the seed
+ */
+ODE_API void dWorldSetRandSeed (dWorldID, unsigned long s);
+
+/**
+ * @brief Get the seed of the random numbers drawn by the next step.
+ * @ingroup world
+ * @return the seed
+ */
+ODE_API unsigned long dWorldGetRandSeed (dWorldID);
+
 
 /**
  * @brief Set the world to use shared working memory along with another world.
@@ -606,6 +625,21 @@ ODE_API dReal dWorldGetQuickStepWarmStartFactor (dWorldID);
  */
 ODE_API int dWorldGetQuickStepExtraFrictionIterations (dWorldID);
 
+/**
+ * @brief Get option to solve constraint rows with the packed vector kernel.
+ * see dWorldSetQuickStepSIMDRows for details.
+ * @ingroup world
+ */
+ODE_API bool dWorldGetQuickStepSIMDRows (dWorldID);
+
+/**
+ * @brief Get the number of threads of the colored PGS solve, 0 if the
+ * rows are solved in order.
+ * see dWorldSetQuickStepColoredRows for details.
+ * @ingroup world
+ */
+ODE_API int dWorldGetQuickStepColoredRows (dWorldID);
+
 /**
  * @brief Get the friction model.
  * @ingroup world
@@ -669,6 +703,17 @@ ODE_API void dWorldSetQuickStepExperimentalRowReordering (dWorldID, bool order);
  */
 ODE_API void dWorldSetQuickStepWarmStartFactor (dWorldID, dReal warm);
 
+/**
+ * @brief Clear the lambda values cached on each joint for warm starting.
+ *
+ * Joints keep the constraint impulses of the previous step so that the
+ * next solve can be warm started. After teleporting bodies (e.g. when
+ * restoring a saved state) these impulses no longer match the
+ * configuration and should be discarded.
+ * @ingroup world
+ */
+ODE_API void dWorldResetQuickStepWarmStart (dWorldID);
+
 /**
  * @brief Set extra friction constraint iterations within each time step,
  * to be done after initial sweeps.
@@ -678,6 +723,32 @@ ODE_API void dWorldSetQuickStepWarmStartFactor (dWorldID, dReal warm);
  */
 ODE_API void dWorldSetQuickStepExtraFrictionIterations (dWorldID, int iters);
 
+/**
+ * @brief Solve the PGS constraint rows with the packed vector kernel.
+ * The rows of J and inv(M)*J' are copied in the order they are solved,
+ * so that each sweep reads them sequentially, with the halves of the two
+ * bodies of a constraint interleaved, so that both bodies are handled by
+ * the same vector operations (256 bit wide on processors with AVX).
+ * Results are bit for bit the same as with the default kernel.
+ * @ingroup world
+ * @param simd set to true to use the packed vector kernel
+ */
+ODE_API void dWorldSetQuickStepSIMDRows (dWorldID, bool simd);
+
+/**
+ * @brief Solve the PGS constraint rows of each island by colors, in
+ * parallel. The rows are colored so that two rows of a color never act on
+ * the same body, the colors are solved one after the other, and the rows
+ * of a color are shared among the threads. This changes the order the
+ * rows are solved in, so results differ from the default solve, but they
+ * do not depend on the number of threads. The cone friction model always
+ * solves the rows in order.
+ * @ingroup world
+ * @param threads number of threads, 1 to color the rows without threads,
+ * 0 to solve the rows in order (default)
+ */
+ODE_API void dWorldSetQuickStepColoredRows (dWorldID, int threads);
+
 /**
  * @brief Set the friction model from: cone friction, pyramid friction
  * and box friction.
@@ -2131,6 +2202,30 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Get the impulses of the joint rows from the last step of the
+ * quickstep solver, which warm starts the next step from them.
+ * They are only saved when the quickstep warm start factor is positive.
+ * @ingroup joints
+ * @param lambda receives the impulses of the 6 rows, may be NULL
+ * @param lambda_erp receives the impulses of the 6 rows of the position
+ * correction, may be NULL
+ */
+ODE_API void dJointGetLambda (dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the impulses the quickstep solver warm starts the joint
+ * from on the next step. This is meant for joints that are created again
+ * every step, such as contact joints, to carry over the impulses of the
+ * joint they replace.
+ * @ingroup joints
+ * @param lambda impulses of the 6 rows, may be NULL
+ * @param lambda_erp impulses of the 6 rows of the position correction,
+ * may be NULL
+ */
+ODE_API void dJointSetLambda (dJointID, const dReal *lambda,
+  const dReal *lambda_erp);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
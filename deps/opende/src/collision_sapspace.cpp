@@ -444,7 +444,8 @@ void dxSAPSpace::collide( void *_data, dNearCallback *callback )
 		if( !GEOM_ENABLED(g) ) // skip disabled ones
 			continue;
 		const dReal& amax = g->aabb[axis0max];
-		if(_dequal(amax, dInfinity)) // HACK? probably not...
+		// no _dequal here, inf - inf is nan and never compares equal
+		if(amax >= dInfinity || g->aabb[ax0idx] <= -dInfinity)
 			TmpInfGeomList.push( g );
 		else
 			TmpGeomList.push( g );
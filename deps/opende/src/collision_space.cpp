@@ -775,6 +775,14 @@ static void swap_callback(void *data, dxGeom *g1, dxGeom *g2)
 }
 
 
+// Whether the geoms of a space can be walked with first/next
+static inline bool spaceIsIterable(const dxSpace *space)
+{
+	return space->type != dSweepAndPruneSpaceClass &&
+		space->type != dQuadTreeSpaceClass;
+}
+
+
 void dSpaceCollide2 (dxGeom *g1, dxGeom *g2, void *data,
 					 dNearCallback *callback)
 {
@@ -807,8 +815,11 @@ void dSpaceCollide2 (dxGeom *g1, dxGeom *g2, void *data,
 			}
 			else {
 				// iterate through the space that has the fewest geoms, calling
-				// collide2 in the other space for each one.
-				if (s1->count < s2->count) {
+				// collide2 in the other space for each one. the sweep and prune
+				// and quadtree spaces do not keep their geoms in the linked
+				// list, they can only be collided with collide2.
+				if (spaceIsIterable(s1) &&
+				    (s1->count < s2->count || !spaceIsIterable(s2))) {
 					DataCallback dc = {data, callback};
 					for (dxGeom *g = s1->first; g; g=g->next) {
 						s2->collide2 (&dc,g,swap_callback);
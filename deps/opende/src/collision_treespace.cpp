@@ -0,0 +1,594 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001-2003 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+/*
+
+dynamic AABB tree space.
+
+every geom with a finite AABB is a leaf of a binary tree of bounding
+boxes. leaves store the AABB of their geom enlarged by a margin, so a geom
+that moves a little stays inside its leaf box and the tree is left alone.
+only geoms that leave their box are taken out and inserted again, and the
+tree is rebalanced with rotations on the way up. geoms that never move
+(static geometry) are never touched after their first insertion.
+
+collide() queries the tree once per geom, collide2() once for the given
+geom, so both are O(log n) per geom instead of O(n). geoms with infinite
+AABBs (planes) are kept in a separate list and tested against everything.
+
+*/
+
+#include <unordered_map>
+#include <vector>
+
+#include <gazebo/ode/common.h>
+#include <gazebo/ode/matrix.h>
+#include <gazebo/ode/collision_space.h>
+#include <gazebo/ode/collision.h>
+#include "config.h"
+#include "collision_kernel.h"
+
+#include "collision_space_internal.h"
+
+#define GEOM_ENABLED(g) (((g)->gflags & GEOM_ENABLE_TEST_MASK) == GEOM_ENABLE_TEST_VALUE)
+
+// margin added to the leaf boxes by default
+#define TREE_SPACE_DEFAULT_MARGIN REAL(0.05)
+
+// marks the absence of a node
+#define TREE_NULL_NODE (-1)
+
+// leaf index of the geoms kept in the list of infinite geoms
+#define TREE_INFINITE_LEAF (-2)
+
+
+static inline bool aabbIsFinite (const dReal *aabb)
+{
+  for (int i=0; i<6; i++) {
+    if (!(aabb[i] > -dInfinity && aabb[i] < dInfinity)) return false;
+  }
+  return true;
+}
+
+
+static inline bool aabbOverlap (const dReal *a, const dReal *b)
+{
+  return !(a[0] > b[1] || a[1] < b[0] ||
+	   a[2] > b[3] || a[3] < b[2] ||
+	   a[4] > b[5] || a[5] < b[4]);
+}
+
+
+static inline bool aabbContains (const dReal *outer, const dReal *inner)
+{
+  return outer[0] <= inner[0] && outer[1] >= inner[1] &&
+    outer[2] <= inner[2] && outer[3] >= inner[3] &&
+    outer[4] <= inner[4] && outer[5] >= inner[5];
+}
+
+
+static inline void aabbUnion (dReal *out, const dReal *a, const dReal *b)
+{
+  for (int i=0; i<6; i += 2) {
+    out[i] = a[i] < b[i] ? a[i] : b[i];
+    out[i+1] = a[i+1] > b[i+1] ? a[i+1] : b[i+1];
+  }
+}
+
+
+// half the surface area of a box, the cost of a node in the tree
+static inline dReal aabbCost (const dReal *a)
+{
+  dReal x = a[1] - a[0];
+  dReal y = a[3] - a[2];
+  dReal z = a[5] - a[4];
+  return x*y + y*z + z*x;
+}
+
+
+static inline dReal aabbUnionCost (const dReal *a, const dReal *b)
+{
+  dReal u[6];
+  aabbUnion (u,a,b);
+  return aabbCost (u);
+}
+
+//****************************************************************************
+// tree space
+
+struct dxTreeSpace : public dxSpace {
+  struct Node {
+    dReal aabb[6];	// box of the leaf geom, or of both children
+    dxGeom *geom;	// geom of a leaf, 0 for inner nodes
+    int parent;		// parent node, or next free node
+    int child1,child2;	// children, TREE_NULL_NODE for leaves
+    int height;		// 0 for leaves
+  };
+
+  std::vector<Node> nodes;
+  int root;		// root node of the tree
+  int freeList;		// first free node
+  dReal margin;		// enlargement of the leaf boxes
+
+  // leaf of each geom, or TREE_NULL_NODE if the geom is not in the tree yet
+  std::unordered_map<dxGeom*,int> leaves;
+
+  // geoms with infinite AABBs, they are not in the tree
+  std::vector<dxGeom*> infinite;
+
+  // traversal stack of the queries
+  std::vector<int> stack;
+
+  dxTreeSpace (dSpaceID _space);
+  ~dxTreeSpace();
+
+  void add (dxGeom *);
+  void remove (dxGeom *);
+  void computeAABB();
+  void cleanGeoms();
+  void collide (void *data, dNearCallback *callback);
+  void collide2 (void *data, dxGeom *geom, dNearCallback *callback);
+
+  void setMargin (dReal value) { margin = value; }
+  dReal getMargin() const { return margin; }
+
+private:
+  int allocateNode();
+  void freeNode (int node);
+  void insertLeaf (int leaf);
+  void removeLeaf (int leaf);
+  int balance (int node);
+  void refit (int node);
+  void updateGeom (dxGeom *geom);
+  void unlinkGeom (dxGeom *geom);
+
+  // call collideAABBs for all the enabled geoms of the tree whose leaf box
+  // overlaps aabb. with a valid skip leaf, only the leaves with a larger
+  // index are reported, so each pair of the tree is visited once.
+  void query (dxGeom *geom, int skip, void *data, dNearCallback *callback);
+};
+
+
+dxTreeSpace::dxTreeSpace (dSpaceID _space) : dxSpace (_space)
+{
+  type = dTreeSpaceClass;
+  root = TREE_NULL_NODE;
+  freeList = TREE_NULL_NODE;
+  margin = TREE_SPACE_DEFAULT_MARGIN;
+}
+
+
+dxTreeSpace::~dxTreeSpace()
+{
+  // the base class destructor would call its own remove(), take the geoms
+  // out here so that the tree is kept consistent
+  CHECK_NOT_LOCKED (this);
+  while (first) {
+    if (cleanup) dGeomDestroy (first);
+    else remove (first);
+  }
+}
+
+
+int dxTreeSpace::allocateNode()
+{
+  int node;
+  if (freeList != TREE_NULL_NODE) {
+    node = freeList;
+    freeList = nodes[node].parent;
+  }
+  else {
+    node = (int) nodes.size();
+    nodes.push_back (Node());
+  }
+  Node &n = nodes[node];
+  n.geom = 0;
+  n.parent = TREE_NULL_NODE;
+  n.child1 = TREE_NULL_NODE;
+  n.child2 = TREE_NULL_NODE;
+  n.height = 0;
+  return node;
+}
+
+
+void dxTreeSpace::freeNode (int node)
+{
+  nodes[node].parent = freeList;
+  nodes[node].height = -1;
+  freeList = node;
+}
+
+
+void dxTreeSpace::insertLeaf (int leaf)
+{
+  if (root == TREE_NULL_NODE) {
+    root = leaf;
+    nodes[root].parent = TREE_NULL_NODE;
+    return;
+  }
+
+  // walk down to the sibling that makes the tree grow the least
+  const dReal *box = nodes[leaf].aabb;
+  int index = root;
+  while (nodes[index].child1 != TREE_NULL_NODE) {
+    const Node &n = nodes[index];
+    dReal cost = aabbCost (n.aabb);
+    dReal combined = aabbUnionCost (n.aabb,box);
+
+    // cost of a new parent for this node and the leaf, and the minimum
+    // cost of pushing the leaf further down
+    dReal newCost = 2 * combined;
+    dReal inherited = 2 * (combined - cost);
+
+    dReal cost1, cost2;
+    const Node &c1 = nodes[n.child1];
+    const Node &c2 = nodes[n.child2];
+    if (c1.child1 == TREE_NULL_NODE) cost1 = aabbUnionCost (c1.aabb,box);
+    else cost1 = aabbUnionCost (c1.aabb,box) - aabbCost (c1.aabb);
+    cost1 += inherited;
+    if (c2.child1 == TREE_NULL_NODE) cost2 = aabbUnionCost (c2.aabb,box);
+    else cost2 = aabbUnionCost (c2.aabb,box) - aabbCost (c2.aabb);
+    cost2 += inherited;
+
+    if (newCost < cost1 && newCost < cost2) break;
+    index = cost1 < cost2 ? n.child1 : n.child2;
+  }
+
+  // make a new parent for the sibling and the leaf. allocateNode() may
+  // move the nodes, so no references are kept across it.
+  int sibling = index;
+  int oldParent = nodes[sibling].parent;
+  int newParent = allocateNode();
+  Node &p = nodes[newParent];
+  p.parent = oldParent;
+  aabbUnion (p.aabb,nodes[sibling].aabb,nodes[leaf].aabb);
+  p.height = nodes[sibling].height + 1;
+  p.child1 = sibling;
+  p.child2 = leaf;
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+
+  if (oldParent != TREE_NULL_NODE) {
+    if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+    else nodes[oldParent].child2 = newParent;
+  }
+  else {
+    root = newParent;
+  }
+
+  refit (nodes[leaf].parent);
+}
+
+
+void dxTreeSpace::removeLeaf (int leaf)
+{
+  if (leaf == root) {
+    root = TREE_NULL_NODE;
+    return;
+  }
+
+  int parent = nodes[leaf].parent;
+  int grandParent = nodes[parent].parent;
+  int sibling = nodes[parent].child1 == leaf ?
+    nodes[parent].child2 : nodes[parent].child1;
+
+  if (grandParent != TREE_NULL_NODE) {
+    // replace the parent by the sibling
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode (parent);
+    refit (grandParent);
+  }
+  else {
+    root = sibling;
+    nodes[sibling].parent = TREE_NULL_NODE;
+    freeNode (parent);
+  }
+}
+
+
+void dxTreeSpace::refit (int index)
+{
+  // recompute the boxes and heights up to the root, rebalancing on the way
+  while (index != TREE_NULL_NODE) {
+    index = balance (index);
+    Node &n = nodes[index];
+    const Node &c1 = nodes[n.child1];
+    const Node &c2 = nodes[n.child2];
+    n.height = 1 + (c1.height > c2.height ? c1.height : c2.height);
+    aabbUnion (n.aabb,c1.aabb,c2.aabb);
+    index = n.parent;
+  }
+}
+
+
+// rotate node a up if one of its subtrees is two levels taller than the
+// other. returns the node that is now at the position of a.
+int dxTreeSpace::balance (int a)
+{
+  Node &A = nodes[a];
+  if (A.child1 == TREE_NULL_NODE || A.height < 2) return a;
+
+  int b = A.child1;
+  int c = A.child2;
+  int diff = nodes[c].height - nodes[b].height;
+
+  if (diff > 1 || diff < -1) {
+    // promote the taller child, its taller grandchild stays below it
+    int up = diff > 1 ? c : b;
+    int down = diff > 1 ? b : c;
+    Node &U = nodes[up];
+    int f = U.child1;
+    int g = U.child2;
+
+    U.child1 = a;
+    U.parent = A.parent;
+    A.parent = up;
+    if (U.parent != TREE_NULL_NODE) {
+      if (nodes[U.parent].child1 == a) nodes[U.parent].child1 = up;
+      else nodes[U.parent].child2 = up;
+    }
+    else {
+      root = up;
+    }
+
+    int keep = nodes[f].height > nodes[g].height ? f : g;
+    int give = keep == f ? g : f;
+    U.child2 = keep;
+    if (diff > 1) A.child2 = give;
+    else A.child1 = give;
+    nodes[give].parent = a;
+
+    const Node &D = nodes[down];
+    const Node &G = nodes[give];
+    aabbUnion (A.aabb,D.aabb,G.aabb);
+    A.height = 1 + (D.height > G.height ? D.height : G.height);
+    const Node &K = nodes[keep];
+    aabbUnion (U.aabb,A.aabb,K.aabb);
+    U.height = 1 + (A.height > K.height ? A.height : K.height);
+    return up;
+  }
+
+  return a;
+}
+
+
+void dxTreeSpace::updateGeom (dxGeom *geom)
+{
+  int &leaf = leaves[geom];
+
+  if (!aabbIsFinite (geom->aabb)) {
+    if (leaf == TREE_INFINITE_LEAF) return;
+    if (leaf != TREE_NULL_NODE) {
+      removeLeaf (leaf);
+      freeNode (leaf);
+    }
+    leaf = TREE_INFINITE_LEAF;
+    infinite.push_back (geom);
+    return;
+  }
+
+  if (leaf == TREE_INFINITE_LEAF) {
+    for (size_t i=0; i<infinite.size(); i++) {
+      if (infinite[i] == geom) {
+	infinite.erase (infinite.begin() + i);
+	break;
+      }
+    }
+    leaf = TREE_NULL_NODE;
+  }
+  else if (leaf != TREE_NULL_NODE) {
+    // still inside its enlarged box, nothing to do
+    if (aabbContains (nodes[leaf].aabb,geom->aabb)) return;
+    removeLeaf (leaf);
+    freeNode (leaf);
+  }
+
+  int node = allocateNode();
+  Node &n = nodes[node];
+  n.geom = geom;
+  for (int i=0; i<6; i += 2) {
+    n.aabb[i] = geom->aabb[i] - margin;
+    n.aabb[i+1] = geom->aabb[i+1] + margin;
+  }
+  insertLeaf (node);
+  leaf = node;
+}
+
+
+void dxTreeSpace::unlinkGeom (dxGeom *geom)
+{
+  std::unordered_map<dxGeom*,int>::iterator it = leaves.find (geom);
+  if (it == leaves.end()) return;
+
+  if (it->second == TREE_INFINITE_LEAF) {
+    for (size_t i=0; i<infinite.size(); i++) {
+      if (infinite[i] == geom) {
+	infinite.erase (infinite.begin() + i);
+	break;
+      }
+    }
+  }
+  else if (it->second != TREE_NULL_NODE) {
+    removeLeaf (it->second);
+    freeNode (it->second);
+  }
+  leaves.erase (it);
+}
+
+
+void dxTreeSpace::add (dxGeom *geom)
+{
+  // the geom is inserted in the tree by the next cleanGeoms(), when its
+  // AABB is known
+  leaves[geom] = TREE_NULL_NODE;
+  dxSpace::add (geom);
+}
+
+
+void dxTreeSpace::remove (dxGeom *geom)
+{
+  CHECK_NOT_LOCKED (this);
+  unlinkGeom (geom);
+  dxSpace::remove (geom);
+}
+
+
+void dxTreeSpace::computeAABB()
+{
+  // the tree holds the union of all the leaves, only slightly larger than
+  // the exact box because of the margin
+  cleanGeoms();
+  if (root == TREE_NULL_NODE && infinite.empty()) {
+    dSetZero (aabb,6);
+    return;
+  }
+
+  dReal a[6] = { dInfinity, -dInfinity, dInfinity, -dInfinity,
+		 dInfinity, -dInfinity };
+  if (root != TREE_NULL_NODE) memcpy (a,nodes[root].aabb,6*sizeof(dReal));
+  for (size_t i=0; i<infinite.size(); i++) aabbUnion (a,a,infinite[i]->aabb);
+  memcpy (aabb,a,6*sizeof(dReal));
+}
+
+
+void dxTreeSpace::cleanGeoms()
+{
+  // compute the AABBs of all dirty geoms, clear the dirty flags, and move
+  // the geoms that left their leaf box
+  lock_count++;
+  for (dxGeom *g=first; g && (g->gflags & GEOM_DIRTY); g=g->next) {
+    if (IS_SPACE(g)) {
+      ((dxSpace*)g)->cleanGeoms();
+    }
+    g->recomputeAABB();
+    g->gflags &= (~(GEOM_DIRTY|GEOM_AABB_BAD));
+    updateGeom (g);
+  }
+  lock_count--;
+}
+
+
+void dxTreeSpace::query (dxGeom *geom, int skip, void *data,
+			 dNearCallback *callback)
+{
+  if (root == TREE_NULL_NODE) return;
+
+  stack.clear();
+  stack.push_back (root);
+  while (!stack.empty()) {
+    int index = stack.back();
+    stack.pop_back();
+    const Node &n = nodes[index];
+    if (!aabbOverlap (n.aabb,geom->aabb)) continue;
+
+    if (n.child1 == TREE_NULL_NODE) {
+      if (index > skip && n.geom != geom && GEOM_ENABLED(n.geom)) {
+	if (skip == TREE_NULL_NODE) collideAABBs (n.geom,geom,data,callback);
+	else collideAABBs (geom,n.geom,data,callback);
+      }
+    }
+    else {
+      stack.push_back (n.child2);
+      stack.push_back (n.child1);
+    }
+  }
+}
+
+
+void dxTreeSpace::collide (void *data, dNearCallback *callback)
+{
+  dAASSERT (callback);
+
+  lock_count++;
+  cleanGeoms();
+
+  // each geom of the tree against the leaves after its own
+  for (dxGeom *g=first; g; g=g->next) {
+    if (!GEOM_ENABLED(g)) continue;
+    int leaf = leaves[g];
+    if (leaf >= 0) query (g,leaf,data,callback);
+  }
+
+  // infinite geoms against everything else
+  for (size_t i=0; i<infinite.size(); i++) {
+    dxGeom *g1 = infinite[i];
+    if (!GEOM_ENABLED(g1)) continue;
+    for (size_t j=i+1; j<infinite.size(); j++) {
+      if (GEOM_ENABLED(infinite[j])) {
+	collideAABBs (g1,infinite[j],data,callback);
+      }
+    }
+    for (dxGeom *g2=first; g2; g2=g2->next) {
+      if (GEOM_ENABLED(g2) && leaves[g2] >= 0) {
+	collideAABBs (g1,g2,data,callback);
+      }
+    }
+  }
+
+  lock_count--;
+}
+
+
+void dxTreeSpace::collide2 (void *data, dxGeom *geom,
+			    dNearCallback *callback)
+{
+  dAASSERT (geom && callback);
+
+  lock_count++;
+  cleanGeoms();
+  geom->recomputeAABB();
+
+  query (geom,TREE_NULL_NODE,data,callback);
+  for (size_t i=0; i<infinite.size(); i++) {
+    dxGeom *g = infinite[i];
+    if (g != geom && GEOM_ENABLED(g)) collideAABBs (g,geom,data,callback);
+  }
+
+  lock_count--;
+}
+
+//****************************************************************************
+// space functions
+
+dxSpace *dTreeSpaceCreate (dxSpace *space)
+{
+  return new dxTreeSpace (space);
+}
+
+
+void dTreeSpaceSetMargin (dxSpace *space, dReal margin)
+{
+  dAASSERT (space);
+  dUASSERT (margin >= 0,"the margin must not be negative");
+  dUASSERT (space->type == dTreeSpaceClass,"argument must be a tree space");
+  ((dxTreeSpace*)space)->setMargin (margin);
+}
+
+
+dReal dTreeSpaceGetMargin (dxSpace *space)
+{
+  dAASSERT (space);
+  dUASSERT (space->type == dTreeSpaceClass,"argument must be a tree space");
+  return ((dxTreeSpace*)space)->getMargin();
+}
@@ -28,7 +28,10 @@
 //****************************************************************************
 // random numbers
 
-static unsigned long seed = 0;
+// The generator state is per thread so that several worlds stepped in
+// parallel threads of one process don't share it. Stepping a world seeds
+// it for each island from the seed of the world, see dWorldSetRandSeed.
+static thread_local unsigned long seed = 0;
 
 unsigned long dRand()
 {
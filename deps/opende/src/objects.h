@@ -123,6 +123,8 @@ struct dxQuickStepParameters {
   bool row_reorder1;  // control quickstep row reordering
   dReal warm_start;  // warm start factor, 0: no warm start, 1: full warm start
   int friction_iterations;  // extra quickstep iterations friction.
+  bool simd_rows;  // solve rows packed in solve order with vector kernels
+  int colored_rows;  // threads of the colored solve, 0: solve rows in order
   Friction_Model friction_model;  // friction model, enum type Friction_Model
   World_Solver_Type world_solver_type;  // world step solver, enum type World_Solver_Type.
 };
@@ -202,6 +204,7 @@ struct dxWorld : public dBase {
   dxContactParameters contactp;
   dxDampingParameters dampingp; // damping parameters
   dReal max_angular_speed;      // limit the angular velocity to this magnitude
+  unsigned long rand_seed;      // seed of the random numbers of the next step
   boost::threadpool::pool *threadpool;
   boost::threadpool::pool *row_threadpool;
 };
@@ -1542,6 +1542,25 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
   return joint->feedback;
 }
 
+void dJointGetLambda (dxJoint *joint, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (joint);
+  for (int i=0; i<6; i++) {
+    if (lambda) lambda[i] = joint->lambda[i];
+    if (lambda_erp) lambda_erp[i] = joint->lambda_erp[i];
+  }
+}
+
+void dJointSetLambda (dxJoint *joint, const dReal *lambda,
+  const dReal *lambda_erp)
+{
+  dAASSERT (joint);
+  for (int i=0; i<6; i++) {
+    if (lambda) joint->lambda[i] = lambda[i];
+    if (lambda_erp) joint->lambda_erp[i] = lambda_erp[i];
+  }
+}
+
 
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
@@ -1669,6 +1688,8 @@ dxWorld * dWorldCreate()
   w->qs.row_reorder1 = true;
   w->qs.warm_start = 0.5;
   w->qs.friction_iterations = 10;
+  w->qs.simd_rows = false;
+  w->qs.colored_rows = 0;
   w->qs.friction_model = pyramid_friction;
   w->qs.world_solver_type = ODE_DEFAULT;
 
@@ -1680,6 +1701,7 @@ dxWorld * dWorldCreate()
   w->dampingp.linear_threshold = REAL(0.01) * REAL(0.01);
   w->dampingp.angular_threshold = REAL(0.01) * REAL(0.01);
   w->max_angular_speed = dInfinity;
+  w->rand_seed = 0;
 
   w->threadpool = NULL; // new boost::threadpool::pool(0);
   w->row_threadpool = NULL; // new boost::threadpool::pool(0);
@@ -1843,6 +1865,20 @@ dReal dWorldGetCFM (dWorldID w)
 }
 
 
+void dWorldSetRandSeed (dWorldID w, unsigned long s)
+{
+  dAASSERT (w);
+  w->rand_seed = s & 0xffffffff;
+}
+
+
+unsigned long dWorldGetRandSeed (dWorldID w)
+{
+  dAASSERT (w);
+  return w->rand_seed;
+}
+
+
 int dWorldUseSharedWorkingMemory(dWorldID w, dWorldID from_world)
 {
   dUASSERT (w,"bad world argument");
@@ -2325,6 +2361,18 @@ int  dWorldGetQuickStepExtraFrictionIterations (dWorldID w)
   return w->qs.friction_iterations;
 }
 
+bool dWorldGetQuickStepSIMDRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.simd_rows;
+}
+
+int dWorldGetQuickStepColoredRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.colored_rows;
+}
+
 Friction_Model dWorldGetQuickStepFrictionModel (dWorldID w)
 {
   dAASSERT(w);
@@ -2373,12 +2421,33 @@ void dWorldSetQuickStepWarmStartFactor (dWorldID w, dReal warm)
   w->qs.warm_start = warm;
 }
 
+void dWorldResetQuickStepWarmStart (dWorldID w)
+{
+  dAASSERT(w);
+  for (dxJoint *j = w->firstjoint; j; j = (dxJoint*)j->next)
+  {
+    dSetZero (j->lambda, 6);
+    dSetZero (j->lambda_erp, 6);
+  }
+}
+
 void dWorldSetQuickStepExtraFrictionIterations (dWorldID w, int iters)
 {
   dAASSERT(w);
   w->qs.friction_iterations = iters;
 }
 
+void dWorldSetQuickStepSIMDRows (dWorldID w, bool simd)
+{
+  dAASSERT(w);
+  w->qs.simd_rows = simd;
+}
+
+void dWorldSetQuickStepColoredRows (dWorldID w, int threads)
+{
+  dAASSERT(w);
+  w->qs.colored_rows = threads > 0 ? threads : 0;
+}
 
 void dWorldSetQuickStepFrictionModel (dWorldID w, Friction_Model fricmodel)
 {
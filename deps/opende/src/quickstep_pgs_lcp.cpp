@@ -19,7 +19,12 @@
 * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
 *                                                                       *
 *************************************************************************/
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <gazebo/ode/common.h>
 #include <gazebo/ode/odemath.h>
@@ -49,6 +54,55 @@ std::vector<dReal> errors;
 
 using namespace ode;
 
+// update the rms of dlambda and of the residual in qs from the sums over
+// the rows of one iteration, and return the rms of the residual of all rows
+static dReal UpdateRMS(dxQuickStepParameters *qs, const dReal *rms_dlambda,
+  const dReal *rms_error, const int *m_rms_dlambda)
+{
+  dReal dlambda_bilateral_mean = 0.0;
+  dReal dlambda_contact_normal_mean = 0.0;
+  dReal dlambda_contact_friction_mean = 0.0;
+  dReal dlambda_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
+  if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
+    dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
+  qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
+  qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
+  qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
+
+  dReal residual_bilateral_mean = 0.0;
+  dReal residual_contact_normal_mean = 0.0;
+  dReal residual_contact_friction_mean = 0.0;
+  dReal residual_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
+  if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
+    residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
+  qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
+  qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
+  qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
+  qs->num_contacts = m_rms_dlambda[1];
+  return qs->rms_constraint_residual[3];
+}
+
+ODE_ROWS_TARGETS
 static void* ComputeRows(void *p)
 {
   dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
@@ -109,8 +163,13 @@ static void* ComputeRows(void *p)
 
 #ifdef REORDER_CONSTRAINTS
   dRealMutablePtr last_lambda  = params->last_lambda;
+  IndexError* order_tmp        = params->order_tmp;
 #endif
 
+  dRealPtr        J_rows       = params->J_rows;
+  dRealPtr        iMJ_rows     = params->iMJ_rows;
+  dxPGSLCPBatchStats *batch_stats = params->batch_stats;
+
   //printf("iiiiiiiii %d %d %d\n",thread_id,jb[0],jb[1]);
   //for (int i=startRow; i<startRow+nRows; i++) // swap within boundary of our own segment
   //  printf("wwwwwwwwwwwww>id %d start %d n %d  order[%d].index=%d\n",thread_id,startRow,nRows,i,order[i].index);
@@ -205,7 +264,14 @@ static void* ComputeRows(void *p)
   dRealMutablePtr cforce_ptr2;
   int total_iterations = precon_iterations + num_iterations +
     friction_iterations;
-  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  int first_iteration = 0;
+  if (batch_stats)
+  {
+    first_iteration = params->batch_iteration;
+    total_iterations = first_iteration + 1;
+  }
+  for (int iteration = first_iteration; iteration < total_iterations;
+       ++iteration)
   {
     // reset rms_dlambda at beginning of iteration
     rms_dlambda[2] = 0;
@@ -257,7 +323,7 @@ static void* ComputeRows(void *p)
 
     //if (thread_id == 0) for (int i=startRow;i<startRow+nRows;i++) printf("=====> %d %d %d %f %d\n",thread_id,iteration,i,order[i].error,order[i].index);
 
-    qsort (order+startRow,nRows,sizeof(IndexError),&compare_index_error);
+    quickstep::sort_index_error (order+startRow,order_tmp+startRow,nRows);
 
     //@@@ potential optimization: swap lambda and last_lambda pointers rather
     //    than copying the data. we must make sure lambda is properly
@@ -304,10 +370,8 @@ static void* ComputeRows(void *p)
     for (int i=startRow; i<startRow+nRows; i++) {
       //boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
 
-      // @@@ potential optimization: we could pre-sort J and iMJ, thereby
-      //     linearizing access to those arrays. hmmm, this does not seem
-      //     like a win, but we should think carefully about our memory
-      //     access pattern.
+      // with qs->simd_rows or the colored solve, J and iMJ are pre-sorted
+      // in J_rows and iMJ_rows, thereby linearizing access to those arrays.
 
       int index = order[i].index;
       int constraint_index = findex[index];  // cache for efficiency
@@ -528,17 +592,38 @@ static void* ComputeRows(void *p)
                  Jvnew_final +
 #endif
                 rhs[index] - old_lambda*Adcfm[index];
-          dRealPtr J_ptr = J + index*12;
-          delta -= quickstep::dot6(caccel_ptr1, J_ptr);
-          if (caccel_ptr2)
-            delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
+          dRealPtr J_ptr = J_rows ? J_rows + i*12 : J + index*12;
+          if (J_rows && caccel_ptr2)
+          {
+            dReal d1, d2;
+            quickstep::dot6x2(caccel_ptr1, caccel_ptr2, J_ptr, d1, d2);
+            delta -= d1;
+            delta -= d2;
+          }
+          else
+          {
+            delta -= quickstep::dot6(caccel_ptr1, J_ptr);
+            if (caccel_ptr2)
+              delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
+          }
 
           if (inline_position_correction)
           {
             delta_erp = rhs_erp[index] - old_lambda_erp*Adcfm[index];
-            delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
-            if (caccel_ptr2)
-              delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
+            if (J_rows && caccel_ptr2)
+            {
+              dReal d1, d2;
+              quickstep::dot6x2(caccel_erp_ptr1, caccel_erp_ptr2, J_ptr,
+                d1, d2);
+              delta_erp -= d1;
+              delta_erp -= d2;
+            }
+            else
+            {
+              delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
+              if (caccel_ptr2)
+                delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
+            }
           }
 
         // set the limits for this constraint.
@@ -700,18 +785,29 @@ static void* ComputeRows(void *p)
           // update caccel
           {
             // FOR erp throttled by info.c_v_max or info.c
-            dRealPtr iMJ_ptr = iMJ + index*12;
+            dRealPtr iMJ_ptr = iMJ_rows ? iMJ_rows + i*12 : iMJ + index*12;
 
             // update caccel.
-            quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
-            if (caccel_ptr2)
-              quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
+            if (iMJ_rows && caccel_ptr2)
+              quickstep::sum6x2(caccel_ptr1, caccel_ptr2, delta, iMJ_ptr);
+            else
+            {
+              quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
+              if (caccel_ptr2)
+                quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
+            }
 
             if (inline_position_correction)
             {
-              quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
-              if (caccel_erp_ptr2)
-                quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
+              if (iMJ_rows && caccel_erp_ptr2)
+                quickstep::sum6x2(caccel_erp_ptr1, caccel_erp_ptr2, delta_erp,
+                  iMJ_ptr);
+              else
+              {
+                quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
+                if (caccel_erp_ptr2)
+                  quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
+              }
             }
           }
         }  // end of skip friction check
@@ -813,49 +909,22 @@ static void* ComputeRows(void *p)
 
     // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
     // since local convergence might produce errors in other nodes?
-    dReal dlambda_bilateral_mean = 0.0;
-    dReal dlambda_contact_normal_mean = 0.0;
-    dReal dlambda_contact_friction_mean = 0.0;
-    dReal dlambda_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
-    if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
-      dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
-    qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
-    qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
-    qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
-
-    dReal residual_bilateral_mean = 0.0;
-    dReal residual_contact_normal_mean = 0.0;
-    dReal residual_contact_friction_mean = 0.0;
-    dReal residual_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
-    if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
-      residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
-    qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
-    qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
-    qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
-    qs->num_contacts = m_rms_dlambda[1];
+    if (batch_stats)
+    {
+      // colored solve: PGS_LCP adds up the batches in a fixed order
+      for (int k = 0; k < 3; ++k)
+      {
+        batch_stats->rms_dlambda[k] = rms_dlambda[k];
+        batch_stats->rms_error[k] = rms_error[k];
+        batch_stats->m_rms_dlambda[k] = m_rms_dlambda[k];
+      }
+      break;
+    }
+    UpdateRMS(qs, rms_dlambda, rms_error, m_rms_dlambda);
 
 #ifdef HDF5_INSTRUMENT
-    errors[iteration] = residual_total_mean;
+    errors[iteration] = qs->rms_constraint_residual[3] *
+      qs->rms_constraint_residual[3];
 #endif
     // debugging mutex locking
     //{
@@ -953,6 +1022,251 @@ static void* ComputeRows(void *p)
   return NULL;
 }
 
+//***************************************************************************
+// colored solve, see dWorldSetQuickStepColoredRows.
+// the rows are colored so that two rows of a color never act on the same
+// body. a row only reads and writes caccel of its bodies, its own lambda
+// and the lambda of its normal row, which shares its bodies, so the rows
+// of a color give the same result in any order, and in parallel. colors
+// are solved one after the other, split in batches of COLORED_ROWS_BATCH
+// rows. the rms sums of each batch are added up in batch order, so that
+// the convergence test, and the whole solve, do not depend on the number
+// of threads.
+
+// barrier between the colors. a color is short work, so the threads spin
+// for a while before giving up the core.
+struct ColoredRowsBarrier
+{
+  std::atomic<int> arrived;
+  std::atomic<int> generation;
+  int threads;
+
+  void wait()
+  {
+    const int current = generation.load(std::memory_order_acquire);
+    if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == threads)
+    {
+      arrived.store(0, std::memory_order_relaxed);
+      generation.fetch_add(1, std::memory_order_release);
+      return;
+    }
+    for (int spin = 0;
+         generation.load(std::memory_order_acquire) == current; ++spin)
+    {
+      if (spin > 1000)
+        std::this_thread::yield();
+    }
+  }
+};
+
+// shared state of the threads of one colored solve
+struct ColoredRowsSolve
+{
+  const dxPGSLCPParameters *params;
+  int num_colors;
+  // color c has batches color_batch[c] to color_batch[c+1]-1
+  const int *color_batch;
+  // batch b has rows batch_start[b] to batch_start[b+1]-1 of order
+  const int *batch_start;
+  dxPGSLCPBatchStats *stats;
+  int threads;
+  ColoredRowsBarrier barrier;
+  bool converged;
+};
+
+// add up the sums of all batches in batch order and update qs.
+// returns true if the tolerance is met.
+static bool ReduceColoredRows(ColoredRowsSolve *solve, int iteration,
+  dReal *rms_dlambda, dReal *rms_error, int *m_rms_dlambda)
+{
+  dxQuickStepParameters *qs = solve->params->qs;
+  // as in ComputeRows, the sums of bilateral and normal rows are kept
+  // during the extra friction iterations, which skip those rows
+  rms_dlambda[2] = 0;
+  rms_error[2] = 0;
+  m_rms_dlambda[2] = 0;
+  if (iteration < qs->num_iterations + qs->precon_iterations)
+  {
+    dSetZero(rms_dlambda, 2);
+    dSetZero(rms_error, 2);
+    m_rms_dlambda[0] = 0;
+    m_rms_dlambda[1] = 0;
+  }
+  const int num_batches = solve->color_batch[solve->num_colors];
+  for (int b = 0; b < num_batches; ++b)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      rms_dlambda[k] += solve->stats[b].rms_dlambda[k];
+      rms_error[k] += solve->stats[b].rms_error[k];
+      m_rms_dlambda[k] += solve->stats[b].m_rms_dlambda[k];
+    }
+  }
+  // with thread_position_correction, the other solve writes qs too
+  const dReal residual =
+    UpdateRMS(qs, rms_dlambda, rms_error, m_rms_dlambda);
+  return iteration >= qs->precon_iterations &&
+    residual < qs->pgs_lcp_tolerance;
+}
+
+// iterations of a colored solve, run by each of its threads
+static void SolveColoredRows(void *data, int thread)
+{
+  ColoredRowsSolve *solve = (ColoredRowsSolve*)data;
+  dxPGSLCPParameters params = *solve->params;
+  params.thread_id = thread;
+  const dxQuickStepParameters *qs = params.qs;
+  const int total_iterations = qs->precon_iterations + qs->num_iterations +
+    qs->friction_iterations;
+  dReal rms_dlambda[3];
+  dReal rms_error[3];
+  int m_rms_dlambda[3];
+  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  {
+    params.batch_iteration = iteration;
+    for (int c = 0; c < solve->num_colors; ++c)
+    {
+      for (int b = solve->color_batch[c] + thread;
+           b < solve->color_batch[c+1]; b += solve->threads)
+      {
+        params.nStart = solve->batch_start[b];
+        params.nChunkSize = solve->batch_start[b+1] - params.nStart;
+        params.batch_stats = solve->stats + b;
+        ComputeRows((void*)(&params));
+      }
+      solve->barrier.wait();
+    }
+    if (thread == 0)
+    {
+      solve->converged = ReduceColoredRows(solve, iteration,
+        rms_dlambda, rms_error, m_rms_dlambda);
+    }
+    solve->barrier.wait();
+    if (solve->converged)
+      break;
+  }
+}
+
+// work handed to the pool. pending is decremented when it is done.
+struct ColoredRowsTask
+{
+  void (*run)(void *data, int thread);
+  void *data;
+  int thread;
+  std::atomic<int> *pending;
+};
+
+// threads kept from one step to the next for the colored solves, which
+// would otherwise create and join their threads on every call. idle
+// workers park on a condition variable. a task never waits for a busy
+// worker, since the threads of a colored solve spin on the barrier until
+// all of them have started: a worker is added when none is idle, so the
+// pool grows to the largest number of tasks run at once, by one world or
+// by several worlds stepping at the same time.
+class ColoredRowsPool
+{
+public:
+  static ColoredRowsPool &Instance()
+  {
+    static ColoredRowsPool pool;
+    return pool;
+  }
+
+  ~ColoredRowsPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    condition.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i)
+      workers[i].join();
+  }
+
+  void Run(void (*run)(void *, int), void *data, int thread,
+    std::atomic<int> *pending)
+  {
+    ColoredRowsTask task = {run, data, thread, pending};
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(task);
+    if (tasks.size() > idle)
+      workers.push_back(std::thread(&ColoredRowsPool::Work, this));
+    else
+      condition.notify_one();
+  }
+
+private:
+  ColoredRowsPool() : idle(0), stop(false) {}
+
+  void Work()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+      ++idle;
+      condition.wait(lock, [this] { return stop || !tasks.empty(); });
+      --idle;
+      if (tasks.empty())
+        return;
+      ColoredRowsTask task = tasks.front();
+      tasks.pop_front();
+      lock.unlock();
+      task.run(task.data, task.thread);
+      task.pending->fetch_sub(1, std::memory_order_release);
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<ColoredRowsTask> tasks;
+  std::vector<std::thread> workers;
+  size_t idle;
+  bool stop;
+};
+
+// wait for the pool tasks counted by pending. like the barrier, spin
+// for a while before giving up the core.
+static void WaitColoredRows(const std::atomic<int> *pending)
+{
+  for (int spin = 0; pending->load(std::memory_order_acquire) > 0; ++spin)
+  {
+    if (spin > 1000)
+      std::this_thread::yield();
+  }
+}
+
+// set up a colored solve with the given number of threads
+static void InitColoredRows(ColoredRowsSolve *solve,
+  const dxPGSLCPParameters *params, int num_colors,
+  const int *color_batch, const int *batch_start,
+  dxPGSLCPBatchStats *stats, int threads)
+{
+  solve->params = params;
+  solve->num_colors = num_colors;
+  solve->color_batch = color_batch;
+  solve->batch_start = batch_start;
+  solve->stats = stats;
+  solve->threads = threads;
+  solve->barrier.arrived.store(0);
+  solve->barrier.generation.store(0);
+  solve->barrier.threads = threads;
+  solve->converged = false;
+}
+
+// run a colored solve on the calling thread and threads-1 pool workers
+static void ColoredRows(void *data, int)
+{
+  ColoredRowsSolve *solve = (ColoredRowsSolve*)data;
+  std::atomic<int> pending(solve->threads - 1);
+  ColoredRowsPool &pool = ColoredRowsPool::Instance();
+  for (int t = 1; t < solve->threads; ++t)
+    pool.Run(SolveColoredRows, solve, t, &pending);
+  SolveColoredRows(solve, 0);
+  // the workers read the solve after the last barrier
+  WaitColoredRows(&pending);
+}
+
 //***************************************************************************
 // PGS_LCP method was previously SOR_LCP
 //
@@ -1195,6 +1509,82 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   // this is used to measure error for when we are reordering the indexes.
   dReal *last_lambda = context->AllocateArray<dReal> (m);
   dReal *last_lambda_erp = context->AllocateArray<dReal> (m);
+  // scratch space to sort order, one for each of the erp and non erp rows
+  IndexError *order_tmp = context->AllocateArray<IndexError> (m);
+  IndexError *order_tmp_erp = context->AllocateArray<IndexError> (m);
+#endif
+
+  // color the rows for the colored solve. this changes the order the rows
+  // are solved in, so it comes before the rows are packed.
+  int num_colors = 0;
+  int *color_batch = NULL;
+  int *batch_start = NULL;
+  dxPGSLCPBatchStats *batch_stats = NULL;
+  dxPGSLCPBatchStats *batch_stats_erp = NULL;
+  int colored_threads = 0;
+#if !defined(REORDER_CONSTRAINTS) && !defined(RANDOMLY_REORDER_CONSTRAINTS) && \
+    !defined(PENETRATION_JVERROR_CORRECTION)
+  // the cone friction model reads the rows next to each row in order
+  if (qs->colored_rows > 0 && qs->friction_model != cone_friction && m > 0)
+  {
+    IndexError *order_colored = context->AllocateArray<IndexError> (m);
+    int *row_color = context->AllocateArray<int> (m);
+    uint64_t *body_colors = context->AllocateArray<uint64_t> (nb);
+    int *color_start =
+      context->AllocateArray<int> (COLORED_ROWS_MAX_GROUPS+1);
+    bool *color_serial =
+      context->AllocateArray<bool> (COLORED_ROWS_MAX_GROUPS);
+    num_colors = quickstep::color_rows (order, order_colored, row_color, m,
+      nb, jb, findex, body_colors, color_start, color_serial);
+
+    // split the colors in batches, a serial color is a single batch
+    color_batch = context->AllocateArray<int> (num_colors+1);
+    batch_start =
+      context->AllocateArray<int> (m/COLORED_ROWS_BATCH + num_colors + 1);
+    int num_batches = 0;
+    int max_batches = 0;
+    for (int c=0; c<num_colors; c++) {
+      color_batch[c] = num_batches;
+      const int step = color_serial[c] ? m : COLORED_ROWS_BATCH;
+      for (int i=color_start[c]; i<color_start[c+1]; i+=step)
+        batch_start[num_batches++] = i;
+      if (num_batches - color_batch[c] > max_batches)
+        max_batches = num_batches - color_batch[c];
+    }
+    color_batch[num_colors] = num_batches;
+    batch_start[num_batches] = m;
+    batch_stats = context->AllocateArray<dxPGSLCPBatchStats> (num_batches);
+    if (qs->thread_position_correction)
+      batch_stats_erp =
+        context->AllocateArray<dxPGSLCPBatchStats> (num_batches);
+
+    // more threads than batches in a color, or than the processor runs at
+    // once, would only wait. this does not change the results.
+    colored_threads = qs->colored_rows < max_batches ?
+      qs->colored_rows : max_batches;
+    const int hardware_threads = std::thread::hardware_concurrency();
+    if (hardware_threads > 0 && colored_threads > hardware_threads)
+      colored_threads = hardware_threads;
+  }
+#endif
+
+  // copy the rows of J and iMJ in the order they are solved, so that the
+  // sweeps read them sequentially. this needs a fixed order. the colored
+  // solve always does it, as its order jumps all over J otherwise.
+  dReal *J_rows = NULL;
+  dReal *iMJ_rows = NULL;
+#if !defined(REORDER_CONSTRAINTS) && !defined(RANDOMLY_REORDER_CONSTRAINTS)
+  if (qs->simd_rows || colored_threads > 0)
+  {
+    J_rows = context->AllocateArray<dReal> (m*12);
+    iMJ_rows = context->AllocateArray<dReal> (m*12);
+    for (int i=0; i<m; i++) {
+      const int index = order[i].index;
+      const bool two_bodies = jb[index*2+1] >= 0;
+      quickstep::pack_row (J_rows + i*12, J + index*12, two_bodies);
+      quickstep::pack_row (iMJ_rows + i*12, iMJ + index*12, two_bodies);
+    }
+  }
 #endif
 
   boost::recursive_mutex* mutex =
@@ -1203,6 +1593,9 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   // number of chunks must be at least 1
   // (single iteration, through all the constraints)
   int num_chunks = qs->num_chunks > 0 ? qs->num_chunks : 1; // min is 1
+  // the colored solve splits the rows itself
+  if (colored_threads > 0)
+    num_chunks = 1;
 
   // divide into chunks sequentially
   int chunk = m / num_chunks+1;
@@ -1247,6 +1640,9 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     if (nEnd > m) nEnd = m;
 
     std::thread params_erp_thread;
+    // the colored erp solve runs on a pool worker
+    ColoredRowsSolve solve_erp;
+    std::atomic<int> solve_erp_pending(0);
 
     if (qs->thread_position_correction && params_erp != NULL)
     {
@@ -1297,13 +1693,27 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
 
 #ifdef REORDER_CONSTRAINTS
       params_erp[thread_id].last_lambda  = last_lambda_erp;
+      params_erp[thread_id].order_tmp  = order_tmp_erp;
 #endif
+      params_erp[thread_id].J_rows = J_rows;
+      params_erp[thread_id].iMJ_rows = iMJ_rows;
+      params_erp[thread_id].batch_iteration = 0;
+      params_erp[thread_id].batch_stats = NULL;
 
 #ifdef DEBUG_CONVERGENCE_TOLERANCE
       printf("thread summary: id %d i %d m %d chunk %d start %d end %d \n",
         thread_id,i,m,chunk,nStart,nEnd);
 #endif
 
+      if (colored_threads > 0)
+      {
+        InitColoredRows(&solve_erp, &params_erp[thread_id], num_colors,
+          color_batch, batch_start, batch_stats_erp, colored_threads);
+        solve_erp_pending.store(1);
+        ColoredRowsPool::Instance().Run(ColoredRows, &solve_erp, 0,
+          &solve_erp_pending);
+      }
+      else
 #ifdef USE_TPROW
       if (row_threadpool && row_threadpool->size() > 1)
       {
@@ -1374,12 +1784,25 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
 
 #ifdef REORDER_CONSTRAINTS
     params[thread_id].last_lambda  = last_lambda;
+    params[thread_id].order_tmp  = order_tmp;
 #endif
+    params[thread_id].J_rows = J_rows;
+    params[thread_id].iMJ_rows = iMJ_rows;
+    params[thread_id].batch_iteration = 0;
+    params[thread_id].batch_stats = NULL;
 
 #ifdef DEBUG_CONVERGENCE_TOLERANCE
     printf("thread summary: id %d i %d m %d chunk %d start %d end %d \n",
       thread_id,i,m,chunk,nStart,nEnd);
 #endif
+    if (colored_threads > 0)
+    {
+      ColoredRowsSolve solve;
+      InitColoredRows(&solve, &params[thread_id], num_colors, color_batch,
+        batch_start, batch_stats, colored_threads);
+      ColoredRows(&solve, 0);
+    }
+    else
 #ifdef USE_TPROW
     if (row_threadpool && row_threadpool->size() > 0)
     {
@@ -1399,6 +1822,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
       params_erp_thread.join();
       IFTIMING (dTimerNow ("params_erp threads done"));
     }
+    WaitColoredRows(&solve_erp_pending);
   }
 
 
@@ -1569,7 +1993,7 @@ void quickstep::dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_
   } // if-else (abs(v)< eps)
 }
 
-size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
+size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int nb)
 {
   size_t res = dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Ad
@@ -1581,6 +2005,24 @@ size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
 #ifdef REORDER_CONSTRAINTS
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for last_lambda
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for last_lambda_erp
+  res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for order_tmp
+  res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for order_tmp_erp
+#else
+  res += dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for J_rows
+  res += dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ_rows
+  {
+    const int max_batches =
+      m/COLORED_ROWS_BATCH + COLORED_ROWS_MAX_GROUPS + 1;
+    res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for order_colored
+    res += dEFFICIENT_SIZE(sizeof(int) * m); // for row_color
+    res += dEFFICIENT_SIZE(sizeof(uint64_t) * nb); // for body_colors
+    res += dEFFICIENT_SIZE(sizeof(int) * (COLORED_ROWS_MAX_GROUPS+1)); // for color_start
+    res += dEFFICIENT_SIZE(sizeof(bool) * COLORED_ROWS_MAX_GROUPS); // for color_serial
+    res += dEFFICIENT_SIZE(sizeof(int) * (COLORED_ROWS_MAX_GROUPS+1)); // for color_batch
+    res += dEFFICIENT_SIZE(sizeof(int) * max_batches); // for batch_start
+    res += dEFFICIENT_SIZE(sizeof(dxPGSLCPBatchStats) * max_batches); // for batch_stats
+    res += dEFFICIENT_SIZE(sizeof(dxPGSLCPBatchStats) * max_batches); // for batch_stats_erp
+  }
 #endif
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params_erp
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params
@@ -153,18 +153,93 @@ void quickstep::multiply_J_invM_JT (int m, int nb, dRealMutablePtr J, dRealMutab
 #endif
 
 #ifdef REORDER_CONSTRAINTS
-int quickstep::compare_index_error (const void *a, const void *b)
+// bucket of a row: rows with findex < 0 use the lower half of the buckets,
+// then the binary exponent of the error (clamped), infinity last.
+static const int REORDER_EXPONENTS = 128;
+static const int REORDER_BUCKETS = 2 * (REORDER_EXPONENTS + 1);
+
+static inline int index_error_bucket (const IndexError &row)
+{
+  int bucket = 0;
+  if (!(row.error < dInfinity)) {
+    bucket = REORDER_EXPONENTS;
+  }
+  else if (row.error > 0) {
+    int exponent;
+    frexp (row.error, &exponent);
+    bucket = exponent + REORDER_EXPONENTS/2;
+    if (bucket < 0) bucket = 0;
+    if (bucket > REORDER_EXPONENTS-1) bucket = REORDER_EXPONENTS-1;
+  }
+  return row.findex < 0 ? bucket : bucket + REORDER_EXPONENTS + 1;
+}
+
+void quickstep::sort_index_error (IndexError *order, IndexError *tmp, int n)
 {
-  const IndexError *i1 = (IndexError*) a;
-  const IndexError *i2 = (IndexError*) b;
-  if (i1->findex < 0 && i2->findex >= 0) return -1;
-  if (i1->findex >= 0 && i2->findex < 0) return 1;
-  if (i1->error < i2->error) return -1;
-  if (i1->error > i2->error) return 1;
-  return 0;
+  // counting sort, stable, so rows with close errors keep their order
+  int start[REORDER_BUCKETS+1];
+  memset (start, 0, sizeof(start));
+  for (int i=0; i<n; i++) start[index_error_bucket(order[i])+1]++;
+  for (int b=0; b<REORDER_BUCKETS; b++) start[b+1] += start[b];
+  for (int i=0; i<n; i++) tmp[start[index_error_bucket(order[i])]++] = order[i];
+  memcpy (order, tmp, n*sizeof(IndexError));
 }
 #endif
 
+int quickstep::color_rows (IndexError *order, IndexError *tmp, int *row_color,
+  int m, int nb, const int *jb, const int *findex, uint64_t *body_colors,
+  int *color_start, bool *color_serial)
+{
+  int num_colors = 0;
+  int begin = 0;
+  while (begin < m) {
+    // the rows with findex < 0 and the friction rows are colored apart,
+    // so that friction rows are still solved after the normal rows.
+    const bool friction = findex[order[begin].index] >= 0;
+    int end = begin;
+    while (end < m && (findex[order[end].index] >= 0) == friction) end++;
+
+    // first fit: the lowest color that no row of the same bodies has yet.
+    // body_colors[b] has bit c set if a row of color c acts on body b.
+    memset (body_colors, 0, nb*sizeof(uint64_t));
+    int count[COLORED_ROWS_MAX_COLORS+1];
+    memset (count, 0, sizeof(count));
+    for (int i=begin; i<end; i++) {
+      const int index = order[i].index;
+      const int b1 = jb[index*2];
+      const int b2 = jb[index*2+1];
+      uint64_t used = body_colors[b1];
+      if (b2 >= 0) used |= body_colors[b2];
+      int color = 0;
+      while (color < COLORED_ROWS_MAX_COLORS && (used >> color) & 1) color++;
+      if (color < COLORED_ROWS_MAX_COLORS) {
+        body_colors[b1] |= (uint64_t)1 << color;
+        if (b2 >= 0) body_colors[b2] |= (uint64_t)1 << color;
+      }
+      row_color[i] = color;
+      count[color]++;
+    }
+
+    // stable counting sort by color, empty colors are dropped
+    int start[COLORED_ROWS_MAX_COLORS+1];
+    int offset = begin;
+    for (int c=0; c<=COLORED_ROWS_MAX_COLORS; c++) {
+      start[c] = offset;
+      if (count[c] > 0) {
+        color_start[num_colors] = offset;
+        color_serial[num_colors] = c == COLORED_ROWS_MAX_COLORS;
+        num_colors++;
+      }
+      offset += count[c];
+    }
+    for (int i=begin; i<end; i++) tmp[start[row_color[i]]++] = order[i];
+    begin = end;
+  }
+  color_start[num_colors] = m;
+  memcpy (order, tmp, m*sizeof(IndexError));
+  return num_colors;
+}
+
 //***************************************************************************
 // Modifying inertia along constrained axes without modifying dynamics.
 void quickstep::DYNAMIC_INERTIA(const int infom, const dxJoint::Info2 &Jinfo, const int b1, const int b2,
@@ -23,6 +23,7 @@
 #ifndef _ODE_QUICK_STEP_UTIL_H_
 #define _ODE_QUICK_STEP_UTIL_H_
 
+#include <stdint.h>
 #include <gazebo/ode/common.h>
 #include "gazebo/gazebo_config.h"
 
@@ -31,6 +32,20 @@
 #define Kf(x) _mm_set_pd((x),(x))
 #endif
 
+// on x86 linux, ComputeRows is built for both AVX and the baseline
+// instruction set, and the loader picks the version that matches the
+// processor, so that the vector row kernels below use 256 bit registers
+// when they can. no FMA is enabled, so both versions give the same results.
+#if defined(ODE_SSE) && defined(__linux__) && defined(__has_attribute) && \
+    (defined(__x86_64__) || defined(__i386__))
+#if __has_attribute(target_clones)
+#define ODE_ROWS_TARGETS __attribute__((target_clones("avx","default")))
+#endif
+#endif
+#ifndef ODE_ROWS_TARGETS
+#define ODE_ROWS_TARGETS
+#endif
+
 
 #undef REPORT_THREAD_TIMING
 #undef USE_TPROW
@@ -120,6 +135,23 @@ struct IndexError {
   int index;    // row index
 };
 
+// sums of the rms of one batch of rows over one iteration of the colored
+// solve, see qs->colored_rows
+struct dxPGSLCPBatchStats {
+  dReal rms_dlambda[3];
+  dReal rms_error[3];
+  int m_rms_dlambda[3];
+};
+
+// the colored solve gives at most this many colors to the rows with
+// findex < 0, and as many to the friction rows. rows that find no free
+// color are solved serially after the others of their group.
+#define COLORED_ROWS_MAX_COLORS 64
+#define COLORED_ROWS_MAX_GROUPS (2*(COLORED_ROWS_MAX_COLORS+1))
+// rows per batch of the colored solve. batches do not depend on the
+// number of threads, which only decides who solves which batch.
+#define COLORED_ROWS_BATCH 64
+
 // structure for passing variable pointers in PGS_LCP
 struct dxPGSLCPParameters {
     int thread_id;
@@ -168,7 +200,21 @@ struct dxPGSLCPParameters {
 #ifdef REORDER_CONSTRAINTS
     dRealMutablePtr last_lambda ;
     dRealMutablePtr last_lambda_erp;
+    IndexError* order_tmp;
 #endif
+
+    /// Only used if qs->simd_rows is set or by the colored solve,
+    /// NULL otherwise.
+    /// Rows of J and iMJ copied in solve order, row i of J_rows
+    /// is row order[i].index of J.
+    dRealPtr J_rows;
+    dRealPtr iMJ_rows;
+
+    /// Only used by the colored solve, NULL otherwise.
+    /// ComputeRows then runs iteration batch_iteration only, and stores
+    /// the rms sums of its rows in batch_stats instead of updating qs.
+    int batch_iteration;
+    dxPGSLCPBatchStats *batch_stats;
 };
 // ****************************************************************
 // ******************* Util Functions *****************************
@@ -254,8 +300,96 @@ inline void sum6(dRealMutablePtr a, dReal delta, dRealPtr b)
 #endif
 }
 
-// compare the index error when REORDER_CONSTRAINTS is defined
-int compare_index_error (const void *a, const void *b);
+// copy a row of J or iMJ (12 values) to the packed rows used with the
+// simd_rows option. for constraints between two bodies, the halves of the
+// two bodies are interleaved two values at a time, so that dot6x2 and
+// sum6x2 can load them directly in vector registers.
+inline void pack_row(dRealMutablePtr to, dRealPtr from, bool two_bodies)
+{
+#ifdef ODE_SSE
+  if (two_bodies) {
+    for (int j = 0; j < 6; j += 2) {
+      to[2*j+0] = from[j];
+      to[2*j+1] = from[j+1];
+      to[2*j+2] = from[j+6];
+      to[2*j+3] = from[j+7];
+    }
+    return;
+  }
+#else
+  (void)two_bodies;
+#endif
+  memcpy(to, from, 12*sizeof(dReal));
+}
+
+#ifdef ODE_SSE
+typedef double dVector4 __attribute__((vector_size(32)));
+#endif
+
+// dot products of a packed row b of J between two bodies with the
+// accelerations of the bodies: d1 = dot6(a1, b1), d2 = dot6(a2, b2) where
+// b1 and b2 are the halves of the row before packing
+inline void dot6x2(dRealPtr a1, dRealPtr a2, dRealPtr b,
+  dReal &d1, dReal &d2)
+{
+#ifdef ODE_SSE
+  // the lanes hold (a1[0], a1[1], a2[0], a2[1]) and so on, and are summed
+  // in the same order as the two SSE dot6, so the results are identical.
+  dVector4 b0, b1, b2;
+  memcpy(&b0, b, sizeof(b0));
+  memcpy(&b1, b + 4, sizeof(b1));
+  memcpy(&b2, b + 8, sizeof(b2));
+  dVector4 d = dVector4{a1[0], a1[1], a2[0], a2[1]} * b0 +
+               dVector4{a1[2], a1[3], a2[2], a2[3]} * b1 +
+               dVector4{a1[4], a1[5], a2[4], a2[5]} * b2;
+  d1 = d[0] + d[1];
+  d2 = d[2] + d[3];
+#else
+  d1 = dot6(a1, b);
+  d2 = dot6(a2, b + 6);
+#endif
+}
+
+// a1 = a1 + delta * b1, a2 = a2 + delta * b2, for a packed row b of iMJ
+// between two bodies
+inline void sum6x2(dRealMutablePtr a1, dRealMutablePtr a2, dReal delta,
+  dRealPtr b)
+{
+#ifdef ODE_SSE
+  const dVector4 k = {delta, delta, delta, delta};
+  for (int j = 0; j < 6; j += 2) {
+    dVector4 c;
+    memcpy(&c, b + 2*j, sizeof(c));
+    dVector4 a = dVector4{a1[j], a1[j+1], a2[j], a2[j+1]} + k * c;
+    a1[j] = a[0];
+    a1[j+1] = a[1];
+    a2[j] = a[2];
+    a2[j+1] = a[3];
+  }
+#else
+  sum6(a1, delta, b);
+  sum6(a2, delta, b + 6);
+#endif
+}
+
+#ifdef REORDER_CONSTRAINTS
+// sort the rows of order by error, rows with findex < 0 first. rows are
+// bucketed by the binary exponent of their error, which is all the
+// reordering needs, in linear time. tmp holds n entries.
+void sort_index_error (IndexError *order, IndexError *tmp, int n);
+#endif
+
+// reorder the rows of order by color, so that two rows of the same color
+// never act on the same body, and can be solved in parallel. the rows with
+// findex < 0 are colored first, then the friction rows, each by first fit
+// in their current order. color c holds rows color_start[c] to
+// color_start[c+1]-1, color_serial[c] is set if its rows share bodies and
+// must be solved in order. returns the number of colors, at most
+// COLORED_ROWS_MAX_GROUPS. tmp and row_color hold m entries,
+// body_colors nb.
+int color_rows (IndexError *order, IndexError *tmp, int *row_color, int m,
+  int nb, const int *jb, const int *findex, uint64_t *body_colors,
+  int *color_start, bool *color_serial);
 
 // Modifying inertia along constrained axes without modifying dynamics.
 void DYNAMIC_INERTIA(const int infom, const dxJoint::Info2 &Jinfo, const int b1, const int b2,
@@ -572,8 +572,13 @@ void dxProcessOneIsland(dxWorldProcessContext *island_context, dxWorld *world, d
                         dxBody *const* bodystart,
                         int bcount,
                         dxJoint *const *jointstart,
-                        int jcount)
+                        int jcount,
+                        unsigned long rand_seed)
 {
+    // the random generator state is per thread, seed it for this island
+    // whichever thread of the pool solves it
+    dRandSetSeed (rand_seed);
+
 #ifdef REPORT_THREAD_TIMING
     struct timeval tv;
     double cur_time;
@@ -633,16 +638,20 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
     dIASSERT(island_wmem != NULL);
     dxWorldProcessContext *island_context = island_wmem->GetWorldProcessingContext();
 
+    // seed of the island, from the seed of the world for this step
+    const unsigned long island_seed =
+      (world->rand_seed + 2654435761UL * island_index) & 0xffffffff;
+
 #define USE_TPISLAND
 #ifdef USE_TPISLAND
     IFTIMING(dTimerNow("scheduling island"));
     //printf("debug opende tp %d\n",world->threadpool->size());
     if (world->threadpool && world->threadpool->size() > 0)
-      world->threadpool->schedule(boost::bind(dxProcessOneIsland,island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount));
+      world->threadpool->schedule(boost::bind(dxProcessOneIsland,island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount, island_seed));
     else //automatically skip threadpool if only 1 thread allocated
-      dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount);
+      dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount, island_seed);
 #else
-    dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount);
+    dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount, island_seed);
 #endif
 
     bodystart += bcount;
@@ -653,6 +662,9 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   if (world->threadpool && world->threadpool->size() > 0)
     world->threadpool->wait();
 #endif
+
+  // the next step draws a different sequence
+  world->rand_seed = (1664525UL*world->rand_seed + 1013904223UL) & 0xffffffff;
   IFTIMING(dTimerEnd());
   IFTIMING(dTimerReport (stdout,1));
 
@@ -254,6 +254,21 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     sub.ParseFromString(packet.serialized_data());
     this->RemoveSubscriber(sub);
   }
+  else if (packet.type() == "subscriber_stats")
+  {
+    msgs::Subscribe stats;
+    stats.ParseFromString(packet.serialized_data());
+
+    for (auto &sub : this->dataPtr->subscribers)
+    {
+      if (sub.first.topic() == stats.topic() &&
+          sub.first.host() == stats.host() &&
+          sub.first.port() == stats.port())
+      {
+        sub.first.set_dropped(stats.dropped());
+      }
+    }
+  }
   else if (packet.type() == "subscribe")
   {
     msgs::Subscribe sub;
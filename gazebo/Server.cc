@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <atomic>
 #include <mutex>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -53,12 +54,14 @@
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/common/Events.hh"
 
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/sensors/SensorsIface.hh"
 
+#include "gazebo/physics/EpisodeRunner.hh"
 #include "gazebo/physics/PhysicsFactory.hh"
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/PresetManager.hh"
@@ -117,6 +120,20 @@ namespace gazebo
 
 bool ServerPrivate::stop = true;
 
+/////////////////////////////////////////////////
+/// \brief Get whether every world has loaded its plugins, which happens
+/// in its first update.
+/// \return True if the worlds are started.
+static bool WorldsStarted()
+{
+  for (auto const &world : physics::get_worlds())
+  {
+    if (!world->PluginsLoaded())
+      return false;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 Server::Server()
   : dataPtr(new ServerPrivate())
@@ -177,9 +194,14 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_resources", "Recording with model meshes and materials.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
+    ("episodes", po::value<unsigned int>(),
+     "Run a batch of seeded episodes of --iters iterations each in every "
+     "loaded world, restoring the world between episodes, then exit.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
+    ("startup_trace", po::value<std::string>(),
+     "Write a Chrome trace of the server startup to the given file.")
     ("profile,o", po::value<std::string>(),
      "Physics preset profile name from the options in the world file.");
 
@@ -243,6 +265,18 @@ bool Server::ParseArgs(int _argc, char **_argv)
   else
     gazebo::transport::setMinimalComms(false);
 
+  // Trace the startup, the trace is written once the worlds are running.
+  if (this->dataPtr->vm.count("startup_trace"))
+  {
+    common::StartupProfiler::Instance()->Enable(
+        this->dataPtr->vm["startup_trace"].as<std::string>());
+  }
+  else if (common::getEnv("GAZEBO_STARTUP_TRACE"))
+  {
+    common::StartupProfiler::Instance()->Enable(
+        common::getEnv("GAZEBO_STARTUP_TRACE"));
+  }
+
   // Set the random number seed if present on the command line.
   if (this->dataPtr->vm.count("seed"))
   {
@@ -295,6 +329,12 @@ bool Server::ParseArgs(int _argc, char **_argv)
     }
   }
 
+  if (this->dataPtr->vm.count("episodes"))
+  {
+    this->dataPtr->params["episodes"] = boost::lexical_cast<std::string>(
+        this->dataPtr->vm["episodes"].as<unsigned int>());
+  }
+
   if (this->dataPtr->vm.count("lockstep"))
   {
     this->dataPtr->lockstep = true;
@@ -423,6 +463,7 @@ bool Server::LoadFile(const std::string &_filename,
         if (fileExtension == "sdf" || fileExtension == "world")
         {
           filename = current.c_str();
+          common::StartupScope startupScope(filename, "sdf");
           if (!sdf::readFile(filename, sdf))
           {
             gzerr << "Unable to read SDF from URL[" << filename << "]\n";
@@ -446,6 +487,7 @@ bool Server::LoadFile(const std::string &_filename,
     }
     fclose(test);
 
+    common::StartupScope startupScope(foundFile, "sdf");
     if (!sdf::readFile(foundFile, sdf))
     {
       gzerr << "Unable to read sdf file[" << filename << "]\n";
@@ -469,10 +511,13 @@ bool Server::LoadString(const std::string &_sdfString)
     return false;
   }
 
-  if (!sdf::readString(_sdfString, sdf))
   {
-    gzerr << "Unable to read SDF string[" << _sdfString << "]\n";
-    return false;
+    common::StartupScope startupScope("SDF string", "sdf");
+    if (!sdf::readString(_sdfString, sdf))
+    {
+      gzerr << "Unable to read SDF string[" << _sdfString << "]\n";
+      return false;
+    }
   }
 
   return this->LoadImpl(sdf->Root());
@@ -481,6 +526,8 @@ bool Server::LoadString(const std::string &_sdfString)
 /////////////////////////////////////////////////
 bool Server::PreLoad()
 {
+  common::StartupScope startupScope("Server::PreLoad", "server");
+
   // setup gazebo
   return gazebo::setupServer(this->dataPtr->systemPluginsArgc,
                              this->dataPtr->systemPluginsArgv);
@@ -501,11 +548,21 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
             << "], the default will be used instead.\n";
     }
     // Try inserting physics engine name if one is given
-    else if (_elem->HasElement("world") &&
-             _elem->GetElement("world")->HasElement("physics"))
+    else if (_elem->HasElement("world"))
     {
-      _elem->GetElement("world")->GetElement("physics")
-           ->GetAttribute("type")->Set(_physics);
+      for (sdf::ElementPtr elem = _elem->GetElement("world"); elem;
+           elem = elem->GetNextElement("world"))
+      {
+        if (elem->HasElement("physics"))
+        {
+          elem->GetElement("physics")->GetAttribute("type")->Set(_physics);
+        }
+        else
+        {
+          gzerr << "Cannot set physics engine: <world> does not have "
+                << "<physics>\n";
+        }
+      }
     }
     else
     {
@@ -513,20 +570,35 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
     }
   }
 
+  // Each <world> element is loaded as an independent world with its own
+  // update thread. Meshes and the model database are process wide and
+  // shared between the worlds.
   sdf::ElementPtr worldElem = _elem->GetElement("world");
-  if (worldElem)
+  while (worldElem)
   {
-    physics::WorldPtr world = physics::create_world();
-
-    // Create the world
-    try
+    std::string worldName = worldElem->Get<std::string>("name");
+    if (physics::has_world(worldName))
     {
-      physics::load_world(world, worldElem);
+      gzerr << "A world named [" << worldName << "] already exists, "
+            << "world names must be unique. Skipping." << std::endl;
     }
-    catch(common::Exception &e)
+    else
     {
-      gzthrow("Failed to load the World\n"  << e);
+      physics::WorldPtr world = physics::create_world();
+      common::StartupScope startupScope("Load world " + worldName, "server");
+
+      // Create the world
+      try
+      {
+        physics::load_world(world, worldElem);
+      }
+      catch(common::Exception &e)
+      {
+        gzthrow("Failed to load the World\n"  << e);
+      }
     }
+
+    worldElem = worldElem->GetNextElement("world");
   }
 
   this->dataPtr->node = transport::NodePtr(new transport::Node());
@@ -555,10 +627,13 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
       << " seconds for namespaces. Giving up.\n";
   }
 
-  if (this->dataPtr->lockstep)
-    physics::init_worlds(rendering::update_scene_poses);
-  else
-    physics::init_worlds(nullptr);
+  {
+    common::StartupScope startupScope("Init worlds", "server");
+    if (this->dataPtr->lockstep)
+      physics::init_worlds(rendering::update_scene_poses);
+    else
+      physics::init_worlds(nullptr);
+  }
 
   this->dataPtr->stop = false;
 
@@ -616,12 +691,15 @@ void Server::Run()
   if (this->dataPtr->stop)
     return;
 
-  // Make sure the sensors are updated once before running the world.
-  // This makes sure plugins get loaded properly.
-  sensors::run_once(true);
+  {
+    // Make sure the sensors are updated once before running the world.
+    // This makes sure plugins get loaded properly.
+    common::StartupScope startupScope("Init sensors", "server");
+    sensors::run_once(true);
 
-  // Run the sensor threads
-  sensors::run_threads();
+    // Run the sensor threads
+    sensors::run_threads();
+  }
 
   unsigned int iterations = 0;
   common::StrStr_M::iterator piter = this->dataPtr->params.find("iterations");
@@ -639,6 +717,18 @@ void Server::Run()
     }
   }
 
+  piter = this->dataPtr->params.find("episodes");
+  if (piter != this->dataPtr->params.end())
+  {
+    common::StartupProfiler::Instance()->Finish();
+    this->RunEpisodes(boost::lexical_cast<unsigned int>(piter->second),
+        iterations);
+
+    // Shutdown gazebo
+    gazebo::shutdown();
+    return;
+  }
+
   // Run each world. Each world starts a new thread
   physics::run_worlds(iterations);
 
@@ -673,14 +763,70 @@ void Server::Run()
       IGN_PROFILE_END();
     }
 
+    // The startup ends once the worlds have loaded their plugins
+    if (common::StartupProfiler::Instance()->Enabled() && WorldsStarted())
+      common::StartupProfiler::Instance()->Finish();
+
     if (!this->dataPtr->lockstep)
       common::Time::MSleep(1);
   }
 
+  // Write what was traced if the server stopped during the startup
+  common::StartupProfiler::Instance()->Finish();
+
   // Shutdown gazebo
   gazebo::shutdown();
 }
 
+/////////////////////////////////////////////////
+void Server::RunEpisodes(const unsigned int _count,
+                         const unsigned int _iterations)
+{
+  if (_iterations == 0)
+  {
+    gzerr << "Batch episode mode requires --iters to be set" << std::endl;
+    return;
+  }
+
+  // The worlds are stepped one after the other on this thread, since each
+  // episode reseeds the global random number generator. Rendering sensors
+  // are not updated while an episode runs.
+  const uint32_t baseSeed = ignition::math::Rand::Seed();
+  std::atomic<bool> stopped(false);
+
+  this->dataPtr->initialized = true;
+
+  for (auto const &world : physics::get_worlds())
+  {
+    const std::string worldName = world->Name();
+    physics::EpisodeRunner runner(world);
+
+    auto endConn = runner.ConnectEpisodeEnd(
+        [&worldName](const physics::EpisodeResult &_result)
+        {
+          gzmsg << "World [" << worldName << "] episode [" << _result.index
+                << "] seed [" << _result.seed << "] sim time ["
+                << _result.simTime << "] wall time [" << _result.wallTime
+                << "]" << std::endl;
+        });
+    auto sigIntConn = event::Events::ConnectSigInt(
+        [&runner, &stopped]()
+        {
+          stopped = true;
+          runner.Stop();
+        });
+
+    runner.Snapshot();
+    unsigned int count = runner.RunEpisodes(_count, _iterations, baseSeed);
+
+    gzmsg << "Completed [" << count << "] of [" << _count << "] episodes "
+          << "of world [" << worldName << "]" << std::endl;
+
+    if (stopped)
+      break;
+  }
+}
+
 /////////////////////////////////////////////////
 void Server::ProcessParams()
 {
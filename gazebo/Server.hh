@@ -98,6 +98,13 @@ namespace gazebo
     /// \param[in] _v Unused.
     private: static void SigInt(int _v);
 
+    /// \brief Run a batch of episodes on each loaded world, one world
+    /// after the other, instead of running the worlds continuously.
+    /// \param[in] _count Number of episodes to run.
+    /// \param[in] _iterations Number of iterations per episode.
+    private: void RunEpisodes(const unsigned int _count,
+                              const unsigned int _iterations);
+
     /// \brief Process all command line parameters.
     private: void ProcessParams();
 
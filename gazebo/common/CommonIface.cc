@@ -45,6 +45,7 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/FuelModelDatabase.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/common/SystemPaths.hh"
 
 #ifdef _WIN32
@@ -164,6 +165,7 @@ void common::add_search_path_suffix(const std::string &_suffix)
 /////////////////////////////////////////////////
 std::string common::find_file(const std::string &_file)
 {
+  common::StartupScope startupScope(_file, "uri");
   std::string path = common::FuelModelDatabase::Instance()->ModelPath(_file);
   if (path.empty())
   {
@@ -175,6 +177,7 @@ std::string common::find_file(const std::string &_file)
 /////////////////////////////////////////////////
 std::string common::find_file(const std::string &_file, bool _searchLocalPath)
 {
+  common::StartupScope startupScope(_file, "uri");
   std::string path = common::FuelModelDatabase::Instance()->ModelPath(_file);
   if (path.empty())
   {
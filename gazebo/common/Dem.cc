@@ -290,6 +290,18 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     const ignition::math::Vector3d &_size,
     const ignition::math::Vector3d &_scale,
     bool _flipY, std::vector<float> &_heights)
+{
+  this->FillHeightMapRegion(_subSampling, _vertSize, _size, _scale, _flipY,
+      0, 0, _vertSize, _vertSize, _heights);
+}
+
+//////////////////////////////////////////////////
+void Dem::FillHeightMapRegion(int _subSampling, unsigned int _vertSize,
+    const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, bool _flipY,
+    unsigned int _x, unsigned int _y,
+    unsigned int _width, unsigned int _height,
+    std::vector<float> &_heights)
 {
   if (_subSampling <= 0)
   {
@@ -297,34 +309,49 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     return;
   }
 
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the [" << _vertSize << " x "
+          << _vertSize << "] height lookup table\n";
+    return;
+  }
+
+  // Resize the vector to match the size of the region.
+  _heights.resize(static_cast<size_t>(_width) * _height);
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  const unsigned int side = this->dataPtr->side;
+  const float *demData = this->dataPtr->demData.data();
+
+  // Iterate over the vertices of the region
+  for (unsigned int row = 0; row < _height; ++row)
   {
+    // Vertex row in the DEM, taking the flip into account
+    unsigned int y = _flipY ? _vertSize - (_y + row) - 1 : _y + row;
+
     double yf = y / static_cast<double>(_subSampling);
     unsigned int y1 = floor(yf);
     unsigned int y2 = ceil(yf);
-    if (y2 >= this->dataPtr->side)
-      y2 = this->dataPtr->side - 1;
+    if (y2 >= side)
+      y2 = side - 1;
     double dy = yf - y1;
 
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int col = 0; col < _width; ++col)
     {
+      unsigned int x = _x + col;
       double xf = x / static_cast<double>(_subSampling);
       unsigned int x1 = floor(xf);
       unsigned int x2 = ceil(xf);
-      if (x2 >= this->dataPtr->side)
-        x2 = this->dataPtr->side - 1;
+      if (x2 >= side)
+        x2 = side - 1;
       double dx = xf - x1;
 
-      double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
-      double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
+      double px1 = demData[static_cast<size_t>(y1) * side + x1];
+      double px2 = demData[static_cast<size_t>(y1) * side + x2];
       float h1 = (px1 - ((px1 - px2) * dx));
 
-      double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
-      double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
+      double px3 = demData[static_cast<size_t>(y2) * side + x1];
+      double px4 = demData[static_cast<size_t>(y2) * side + x2];
       float h2 = (px3 - ((px3 - px4) * dx));
 
       float h = this->dataPtr->minElevation +
@@ -341,10 +368,7 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
         h = this->dataPtr->minElevation;
 
       // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      _heights[static_cast<size_t>(row) * _width + col] = h;
     }
   }
 }
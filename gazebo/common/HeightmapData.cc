@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+
 #include <gazebo/gazebo_config.h>
 
 #ifdef HAVE_GDAL
@@ -34,6 +36,37 @@
 using namespace gazebo;
 using namespace common;
 
+//////////////////////////////////////////////////
+void HeightmapData::FillHeightMapRegion(int _subSampling,
+    unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, bool _flipY,
+    unsigned int _x, unsigned int _y,
+    unsigned int _width, unsigned int _height,
+    std::vector<float> &_heights)
+{
+  _heights.clear();
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the [" << _vertSize << " x "
+          << _vertSize << "] height lookup table\n";
+    return;
+  }
+
+  std::vector<float> all;
+  this->FillHeightMap(_subSampling, _vertSize, _size, _scale, _flipY, all);
+  if (all.size() != static_cast<size_t>(_vertSize) * _vertSize)
+    return;
+
+  _heights.resize(static_cast<size_t>(_width) * _height);
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    auto row = all.begin() + static_cast<size_t>(_y + y) * _vertSize + _x;
+    std::copy(row, row + _width,
+        _heights.begin() + static_cast<size_t>(y) * _width);
+  }
+}
+
 //////////////////////////////////////////////////
 HeightmapData *HeightmapDataLoader::LoadImageAsTerrain(
     const std::string &_filename)
@@ -56,6 +56,30 @@ namespace gazebo
           const ignition::math::Vector3d &_scale, bool _flipY,
           std::vector<float> &_heights) = 0;
 
+      /// \brief Fill a rectangular region of the height lookup table
+      /// described by FillHeightMap. Only the requested vertices are
+      /// computed, which allows large terrains to be built in tiles instead
+      /// of allocating the whole table at once. The default implementation
+      /// builds the whole table and copies the region out of it.
+      /// \param[in] _subsampling Multiplier used to increase the resolution.
+      /// \param[in] _vertSize Number of points per row of the whole table.
+      /// \param[in] _size Real dimmensions of the terrain.
+      /// \param[in] _scale Vector3 used to scale the height.
+      /// \param[in] _flipY If true, it inverts the order in which the table
+      /// is filled.
+      /// \param[in] _x Column of the first vertex of the region.
+      /// \param[in] _y Row of the first vertex of the region.
+      /// \param[in] _width Number of columns of the region.
+      /// \param[in] _height Number of rows of the region.
+      /// \param[out] _heights Region heights, _width * _height values stored
+      /// row by row.
+      public: virtual void FillHeightMapRegion(int _subSampling,
+          unsigned int _vertSize, const ignition::math::Vector3d &_size,
+          const ignition::math::Vector3d &_scale, bool _flipY,
+          unsigned int _x, unsigned int _y,
+          unsigned int _width, unsigned int _height,
+          std::vector<float> &_heights);
+
       /// \brief Get the terrain's height.
       /// \return The terrain's height.
       public: virtual unsigned int GetHeight() const = 0;
@@ -30,6 +30,8 @@ ImageHeightmap::ImageHeightmap()
 //////////////////////////////////////////////////
 int ImageHeightmap::Load(const std::string &_filename)
 {
+  this->samples.clear();
+
   if (this->img.Load(_filename) != 0)
   {
     gzerr << "Unable to load image file as a terrain [" << _filename << "]\n";
@@ -45,27 +47,68 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
     const ignition::math::Vector3d &_scale, bool _flipY,
     std::vector<float> &_heights)
 {
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
+  this->FillHeightMapRegion(_subSampling, _vertSize, _size, _scale, _flipY,
+      0, 0, _vertSize, _vertSize, _heights);
+}
+
+//////////////////////////////////////////////////
+void ImageHeightmap::FillHeightMapRegion(int _subSampling,
+    unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, bool _flipY,
+    unsigned int _x, unsigned int _y,
+    unsigned int _width, unsigned int _height,
+    std::vector<float> &_heights)
+{
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the [" << _vertSize << " x "
+          << _vertSize << "] height lookup table\n";
+    return;
+  }
+
+  // Resize the vector to match the size of the region.
+  _heights.resize(static_cast<size_t>(_width) * _height);
 
   int imgHeight = this->GetHeight();
   int imgWidth = this->GetWidth();
 
   GZ_ASSERT(imgWidth == imgHeight, "Heightmap image must be square");
 
-  // Bytes per row
-  unsigned int pitch = this->img.GetPitch();
+  // Keep only the first channel of each pixel, which is the only one used
+  if (this->samples.empty())
+  {
+    // Bytes per row
+    unsigned int pitch = this->img.GetPitch();
+
+    // Bytes per pixel
+    unsigned int bpp = pitch / imgWidth;
+
+    unsigned char *data = nullptr;
+    unsigned int count;
+    this->img.GetData(&data, count);
+
+    this->samples.resize(static_cast<size_t>(imgWidth) * imgHeight);
+    for (int y = 0; y < imgHeight; ++y)
+    {
+      for (int x = 0; x < imgWidth; ++x)
+      {
+        this->samples[static_cast<size_t>(y) * imgWidth + x] =
+            data[static_cast<size_t>(y) * pitch + x * bpp];
+      }
+    }
 
-  // Bytes per pixel
-  unsigned int bpp = pitch / imgWidth;
+    delete [] data;
+  }
 
-  unsigned char *data = nullptr;
-  unsigned int count;
-  this->img.GetData(&data, count);
+  const unsigned char *data = this->samples.data();
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  // Iterate over the vertices of the region
+  for (unsigned int row = 0; row < _height; ++row)
   {
+    // Vertex row in the image, taking the flip into account
+    unsigned int y = _flipY ? _vertSize - (_y + row) - 1 : _y + row;
+
     // yf ranges between 0 and 4
     double yf = y / static_cast<double>(_subSampling);
     int y1 = floor(yf);
@@ -74,8 +117,9 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
       y2 = imgHeight-1;
     double dy = yf - y1;
 
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int col = 0; col < _width; ++col)
     {
+      unsigned int x = _x + col;
       double xf = x / static_cast<double>(_subSampling);
       int x1 = floor(xf);
       int x2 = ceil(xf);
@@ -83,12 +127,20 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
         x2 = imgWidth-1;
       double dx = xf - x1;
 
-      double px1 = static_cast<int>(data[y1 * pitch + x1 * bpp]) / 255.0;
-      double px2 = static_cast<int>(data[y1 * pitch + x2 * bpp]) / 255.0;
+      double px1 =
+          static_cast<int>(data[static_cast<size_t>(y1) * imgWidth + x1]) /
+          255.0;
+      double px2 =
+          static_cast<int>(data[static_cast<size_t>(y1) * imgWidth + x2]) /
+          255.0;
       float h1 = (px1 - ((px1 - px2) * dx));
 
-      double px3 = static_cast<int>(data[y2 * pitch + x1 * bpp]) / 255.0;
-      double px4 = static_cast<int>(data[y2 * pitch + x2 * bpp]) / 255.0;
+      double px3 =
+          static_cast<int>(data[static_cast<size_t>(y2) * imgWidth + x1]) /
+          255.0;
+      double px4 =
+          static_cast<int>(data[static_cast<size_t>(y2) * imgWidth + x2]) /
+          255.0;
       float h2 = (px3 - ((px3 - px4) * dx));
 
       float h = (h1 - ((h1 - h2) * dy)) * _scale.Z();
@@ -100,14 +152,9 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
         h = 1.0 - h;
 
       // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      _heights[static_cast<size_t>(row) * _width + col] = h;
     }
   }
-
-  delete [] data;
 }
 
 //////////////////////////////////////////////////
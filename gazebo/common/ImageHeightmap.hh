@@ -53,6 +53,14 @@ namespace gazebo
           const ignition::math::Vector3d &_scale, bool _flipY,
           std::vector<float> &_heights);
 
+      // Documentation inherited.
+      public: void FillHeightMapRegion(int _subSampling,
+          unsigned int _vertSize, const ignition::math::Vector3d &_size,
+          const ignition::math::Vector3d &_scale, bool _flipY,
+          unsigned int _x, unsigned int _y,
+          unsigned int _width, unsigned int _height,
+          std::vector<float> &_heights);
+
       /// \brief Get the full filename of the image
       /// \return The filename used to load the image
       public: std::string GetFilename() const;
@@ -68,6 +76,11 @@ namespace gazebo
 
       /// \brief Image containing the heightmap data.
       private: gazebo::common::Image img;
+
+      /// \brief First channel of every pixel of the image, row by row.
+      /// Filled on the first call to FillHeightMapRegion so that building
+      /// a heightmap in tiles does not copy the image for every tile.
+      private: std::vector<unsigned char> samples;
     };
     /// \}
   }
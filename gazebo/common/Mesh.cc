@@ -481,6 +481,42 @@ void SubMesh::CopyNormals(const std::vector<ignition::math::Vector3d> &_norms)
   }
 }
 
+//////////////////////////////////////////////////
+void SubMesh::SetVertices(const double *_coords, unsigned int _count)
+{
+  this->vertices.resize(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    this->vertices[i].Set(_coords[i * 3], _coords[i * 3 + 1],
+        _coords[i * 3 + 2]);
+  }
+}
+
+//////////////////////////////////////////////////
+void SubMesh::SetNormals(const double *_coords, unsigned int _count)
+{
+  this->normals.resize(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    this->normals[i].Set(_coords[i * 3], _coords[i * 3 + 1],
+        _coords[i * 3 + 2]);
+  }
+}
+
+//////////////////////////////////////////////////
+void SubMesh::SetTexCoords(const double *_coords, unsigned int _count)
+{
+  this->texCoords.resize(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+    this->texCoords[i].Set(_coords[i * 2], _coords[i * 2 + 1]);
+}
+
+//////////////////////////////////////////////////
+void SubMesh::SetIndices(const unsigned int *_indices, unsigned int _count)
+{
+  this->indices.assign(_indices, _indices + _count);
+}
+
 //////////////////////////////////////////////////
 void SubMesh::SetVertexCount(unsigned int _count)
 {
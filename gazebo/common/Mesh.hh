@@ -253,6 +253,28 @@ namespace gazebo
       public: void CopyNormals(
                   const std::vector<ignition::math::Vector3d> &_norms);
 
+      /// \brief Replace the vertices with packed coordinates
+      /// \param[in] _coords Coordinates, three per vertex
+      /// \param[in] _count Number of vertices
+      public: void SetVertices(const double *_coords, unsigned int _count);
+
+      /// \brief Replace the normals with packed coordinates. Unlike
+      /// CopyNormals, the normals are not normalized.
+      /// \param[in] _coords Coordinates, three per normal
+      /// \param[in] _count Number of normals
+      public: void SetNormals(const double *_coords, unsigned int _count);
+
+      /// \brief Replace the texture coordinates with packed coordinates
+      /// \param[in] _coords Coordinates, two per texture coordinate
+      /// \param[in] _count Number of texture coordinates
+      public: void SetTexCoords(const double *_coords, unsigned int _count);
+
+      /// \brief Replace the indices
+      /// \param[in] _indices The indices
+      /// \param[in] _count Number of indices
+      public: void SetIndices(const unsigned int *_indices,
+                  unsigned int _count);
+
       /// \brief Resize the vertex array
       /// \param[in] _count the new size of the array
       public: void SetVertexCount(unsigned int _count);
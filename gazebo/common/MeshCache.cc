@@ -0,0 +1,569 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sys/stat.h>
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Magic number at the start of every entry.
+static const char kMeshCacheMagic[4] = {'G', 'Z', 'M', 'C'};
+
+/// \brief Version of the entry format. Increase it whenever the format
+/// changes so that old entries are ignored.
+static const uint32_t kMeshCacheVersion = 1;
+
+/// \internal
+/// \brief Private data class for MeshCache
+class gazebo::common::MeshCachePrivate
+{
+  /// \brief Cache directory.
+  public: std::string path;
+};
+
+/// \internal
+/// \brief Appends plain values to a byte buffer.
+class MeshCacheWriter
+{
+  /// \brief Append a value.
+  /// \param[in] _value Value to append.
+  public: template<typename T> void Write(const T &_value)
+  {
+    this->data.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+  }
+
+  /// \brief Append a string, prefixed by its length.
+  /// \param[in] _str String to append.
+  public: void WriteString(const std::string &_str)
+  {
+    this->Write(static_cast<uint32_t>(_str.size()));
+    this->data.append(_str);
+  }
+
+  /// \brief Append a color.
+  /// \param[in] _clr Color to append.
+  public: void WriteColor(const ignition::math::Color &_clr)
+  {
+    this->Write(_clr.R());
+    this->Write(_clr.G());
+    this->Write(_clr.B());
+    this->Write(_clr.A());
+  }
+
+  /// \brief Buffer.
+  public: std::string data;
+};
+
+/// \internal
+/// \brief Reads plain values from a byte buffer, failing instead of
+/// reading past its end.
+class MeshCacheReader
+{
+  /// \brief Constructor.
+  /// \param[in] _data Start of the buffer.
+  /// \param[in] _size Size of the buffer.
+  public: MeshCacheReader(const char *_data, const size_t _size)
+    : ptr(_data), end(_data + _size)
+  {
+  }
+
+  /// \brief Read a value.
+  /// \param[out] _value Value read.
+  /// \return False if the buffer is too short.
+  public: template<typename T> bool Read(T &_value)
+  {
+    if (static_cast<size_t>(this->end - this->ptr) < sizeof(T))
+      return false;
+    std::memcpy(&_value, this->ptr, sizeof(T));
+    this->ptr += sizeof(T);
+    return true;
+  }
+
+  /// \brief Read an array of values with a single copy.
+  /// \param[out] _values Values read, resized to _count.
+  /// \param[in] _count Number of values.
+  /// \return False if the buffer is too short.
+  public: template<typename T> bool ReadArray(std::vector<T> &_values,
+      const uint64_t _count)
+  {
+    if (!this->Has(_count * sizeof(T)))
+      return false;
+    _values.resize(_count);
+    if (_count > 0)
+      std::memcpy(_values.data(), this->ptr, _count * sizeof(T));
+    this->ptr += _count * sizeof(T);
+    return true;
+  }
+
+  /// \brief Read a string prefixed by its length.
+  /// \param[out] _str String read.
+  /// \return False if the buffer is too short.
+  public: bool ReadString(std::string &_str)
+  {
+    uint32_t size = 0;
+    if (!this->Read(size) || !this->Has(size))
+      return false;
+    _str.assign(this->ptr, size);
+    this->ptr += size;
+    return true;
+  }
+
+  /// \brief Read a color.
+  /// \param[out] _clr Color read.
+  /// \return False if the buffer is too short.
+  public: bool ReadColor(ignition::math::Color &_clr)
+  {
+    float r, g, b, a;
+    if (!this->Read(r) || !this->Read(g) || !this->Read(b) || !this->Read(a))
+      return false;
+    _clr.Set(r, g, b, a);
+    return true;
+  }
+
+  /// \brief Check that a number of bytes is left in the buffer.
+  /// \param[in] _size Number of bytes.
+  /// \return True if at least _size bytes are left.
+  public: bool Has(const uint64_t _size) const
+  {
+    return static_cast<uint64_t>(this->end - this->ptr) >= _size;
+  }
+
+  /// \brief Current position.
+  private: const char *ptr;
+
+  /// \brief End of the buffer.
+  private: const char *end;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the size and modification time of a file.
+/// \param[in] _filename Path to the file.
+/// \param[out] _size Size of the file in bytes.
+/// \param[out] _mtime Modification time of the file.
+/// \return False if the file can not be accessed.
+static bool meshFileStamp(const std::string &_filename, uint64_t &_size,
+    int64_t &_mtime)
+{
+  struct stat st;
+  if (stat(_filename.c_str(), &st) != 0)
+    return false;
+
+  _size = static_cast<uint64_t>(st.st_size);
+  _mtime = static_cast<int64_t>(st.st_mtime);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse the payload of an entry.
+/// \param[in] _reader Reader positioned after the entry header.
+/// \return New mesh, or nullptr if the payload is corrupt.
+static Mesh *readMesh(MeshCacheReader &_reader)
+{
+  std::unique_ptr<Mesh> mesh(new Mesh());
+
+  std::string str;
+  if (!_reader.ReadString(str))
+    return nullptr;
+  mesh->SetName(str);
+  if (!_reader.ReadString(str))
+    return nullptr;
+  mesh->SetPath(str);
+
+  uint32_t materialCount = 0;
+  if (!_reader.Read(materialCount))
+    return nullptr;
+  for (uint32_t i = 0; i < materialCount; ++i)
+  {
+    std::unique_ptr<Material> mat(new Material());
+    ignition::math::Color clr;
+    double value, dst;
+    int32_t mode;
+    uint8_t flag;
+
+    if (!_reader.ReadString(str))
+      return nullptr;
+    mat->SetTextureImage(str);
+
+    if (!_reader.ReadColor(clr))
+      return nullptr;
+    mat->SetAmbient(clr);
+    if (!_reader.ReadColor(clr))
+      return nullptr;
+    mat->SetDiffuse(clr);
+    if (!_reader.ReadColor(clr))
+      return nullptr;
+    mat->SetSpecular(clr);
+    if (!_reader.ReadColor(clr))
+      return nullptr;
+    mat->SetEmissive(clr);
+
+    if (!_reader.Read(value))
+      return nullptr;
+    mat->SetTransparency(value);
+    if (!_reader.Read(value))
+      return nullptr;
+    mat->SetShininess(value);
+    if (!_reader.Read(value) || !_reader.Read(dst))
+      return nullptr;
+    mat->SetBlendFactors(value, dst);
+    if (!_reader.Read(mode) || mode < 0 || mode >= Material::BLEND_COUNT)
+      return nullptr;
+    mat->SetBlendMode(static_cast<Material::BlendMode>(mode));
+    if (!_reader.Read(mode) || mode < 0 || mode >= Material::SHADE_COUNT)
+      return nullptr;
+    mat->SetShadeMode(static_cast<Material::ShadeMode>(mode));
+    if (!_reader.Read(value))
+      return nullptr;
+    mat->SetPointSize(value);
+    if (!_reader.Read(flag))
+      return nullptr;
+    mat->SetDepthWrite(flag != 0);
+    if (!_reader.Read(flag))
+      return nullptr;
+    mat->SetLighting(flag != 0);
+
+    mesh->AddMaterial(mat.release());
+  }
+
+  uint32_t subMeshCount = 0;
+  if (!_reader.Read(subMeshCount))
+    return nullptr;
+  std::vector<double> coords;
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < subMeshCount; ++i)
+  {
+    std::unique_ptr<SubMesh> subMesh(new SubMesh());
+    int32_t value;
+    uint32_t count;
+
+    if (!_reader.ReadString(str))
+      return nullptr;
+    subMesh->SetName(str);
+    if (!_reader.Read(value) || value < SubMesh::POINTS ||
+        value > SubMesh::TRISTRIPS)
+    {
+      return nullptr;
+    }
+    subMesh->SetPrimitiveType(static_cast<SubMesh::PrimitiveType>(value));
+    if (!_reader.Read(value))
+      return nullptr;
+    subMesh->SetMaterialIndex(value);
+
+    // The arrays are copied out of the entry at once, the entry may not be
+    // aligned for doubles
+    if (!_reader.Read(count) || !_reader.ReadArray(coords, count * 3ull))
+      return nullptr;
+    subMesh->SetVertices(coords.data(), count);
+
+    // Normals are kept as they were saved
+    if (!_reader.Read(count) || !_reader.ReadArray(coords, count * 3ull))
+      return nullptr;
+    subMesh->SetNormals(coords.data(), count);
+
+    if (!_reader.Read(count) || !_reader.ReadArray(coords, count * 2ull))
+      return nullptr;
+    subMesh->SetTexCoords(coords.data(), count);
+
+    if (!_reader.Read(count) || !_reader.ReadArray(indices, count))
+      return nullptr;
+    subMesh->SetIndices(indices.data(), count);
+
+    // Node assignments
+    const uint64_t assignmentSize = 2 * sizeof(uint32_t) + sizeof(float);
+    if (!_reader.Read(count) || !_reader.Has(count * assignmentSize))
+      return nullptr;
+    for (uint32_t j = 0; j < count; ++j)
+    {
+      uint32_t vertex, node;
+      float weight;
+      _reader.Read(vertex);
+      _reader.Read(node);
+      _reader.Read(weight);
+      subMesh->AddNodeAssignment(vertex, node, weight);
+    }
+
+    mesh->AddSubMesh(subMesh.release());
+  }
+
+  return mesh.release();
+}
+
+//////////////////////////////////////////////////
+MeshCache::MeshCache(const std::string &_path)
+  : dataPtr(new MeshCachePrivate)
+{
+  this->dataPtr->path = _path;
+}
+
+//////////////////////////////////////////////////
+MeshCache::~MeshCache()
+{
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::Path() const
+{
+  return this->dataPtr->path;
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::EntryPath(const std::string &_filename) const
+{
+  if (this->dataPtr->path.empty())
+    return std::string();
+
+  // 64 bit FNV-1a hash of the path, stable across runs and platforms
+  uint64_t hash = 14695981039346656037ull;
+  for (auto const c : _filename)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << hash
+         << ".gzmesh";
+
+  return (boost::filesystem::path(this->dataPtr->path) / stream.str())
+      .string();
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshCache::Load(const std::string &_filename) const
+{
+  std::string entry = this->EntryPath(_filename);
+  if (entry.empty())
+    return nullptr;
+
+  uint64_t size;
+  int64_t mtime;
+  if (!meshFileStamp(_filename, size, mtime))
+    return nullptr;
+
+#ifndef _WIN32
+  int fd = open(entry.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+  size_t length = static_cast<size_t>(st.st_size);
+
+  void *addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    return nullptr;
+  const char *data = static_cast<const char *>(addr);
+#else
+  std::ifstream file(entry, std::ios::binary);
+  if (!file)
+    return nullptr;
+  std::vector<char> buffer((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  size_t length = buffer.size();
+  const char *data = buffer.data();
+#endif
+
+  Mesh *mesh = nullptr;
+  MeshCacheReader reader(data, length);
+
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t entrySize = 0;
+  int64_t entryMtime = 0;
+  std::string entryFilename;
+  if (reader.Read(magic) &&
+      std::memcmp(magic, kMeshCacheMagic, sizeof(magic)) == 0 &&
+      reader.Read(version) && version == kMeshCacheVersion &&
+      reader.Read(entrySize) && entrySize == size &&
+      reader.Read(entryMtime) && entryMtime == mtime &&
+      reader.ReadString(entryFilename) && entryFilename == _filename)
+  {
+    mesh = readMesh(reader);
+    if (!mesh)
+      gzwarn << "Ignoring corrupt mesh cache entry[" << entry << "]\n";
+  }
+
+#ifndef _WIN32
+  munmap(addr, length);
+#endif
+
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+bool MeshCache::Save(const std::string &_filename, const Mesh &_mesh) const
+{
+  std::string entry = this->EntryPath(_filename);
+  if (entry.empty() || _mesh.HasSkeleton())
+    return false;
+
+  uint64_t size;
+  int64_t mtime;
+  if (!meshFileStamp(_filename, size, mtime))
+    return false;
+
+  MeshCacheWriter writer;
+  writer.data.append(kMeshCacheMagic, sizeof(kMeshCacheMagic));
+  writer.Write(kMeshCacheVersion);
+  writer.Write(size);
+  writer.Write(mtime);
+  writer.WriteString(_filename);
+
+  writer.WriteString(_mesh.GetName());
+  writer.WriteString(_mesh.GetPath());
+
+  writer.Write(static_cast<uint32_t>(_mesh.GetMaterialCount()));
+  for (unsigned int i = 0; i < _mesh.GetMaterialCount(); ++i)
+  {
+    const Material *mat = _mesh.GetMaterial(i);
+    double src, dst;
+    mat->GetBlendFactors(src, dst);
+
+    writer.WriteString(mat->GetTextureImage());
+    writer.WriteColor(mat->Ambient());
+    writer.WriteColor(mat->Diffuse());
+    writer.WriteColor(mat->Specular());
+    writer.WriteColor(mat->Emissive());
+    writer.Write(mat->GetTransparency());
+    writer.Write(mat->GetShininess());
+    writer.Write(src);
+    writer.Write(dst);
+    writer.Write(static_cast<int32_t>(mat->GetBlendMode()));
+    writer.Write(static_cast<int32_t>(mat->GetShadeMode()));
+    writer.Write(mat->GetPointSize());
+    writer.Write(static_cast<uint8_t>(mat->GetDepthWrite()));
+    writer.Write(static_cast<uint8_t>(mat->GetLighting()));
+  }
+
+  writer.Write(static_cast<uint32_t>(_mesh.GetSubMeshCount()));
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+
+    writer.WriteString(subMesh->GetName());
+    writer.Write(static_cast<int32_t>(subMesh->GetPrimitiveType()));
+    writer.Write(static_cast<int32_t>(subMesh->GetMaterialIndex()));
+
+    writer.Write(static_cast<uint32_t>(subMesh->GetVertexCount()));
+    for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+    {
+      ignition::math::Vector3d v = subMesh->Vertex(j);
+      writer.Write(v.X());
+      writer.Write(v.Y());
+      writer.Write(v.Z());
+    }
+
+    writer.Write(static_cast<uint32_t>(subMesh->GetNormalCount()));
+    for (unsigned int j = 0; j < subMesh->GetNormalCount(); ++j)
+    {
+      ignition::math::Vector3d n = subMesh->Normal(j);
+      writer.Write(n.X());
+      writer.Write(n.Y());
+      writer.Write(n.Z());
+    }
+
+    writer.Write(static_cast<uint32_t>(subMesh->GetTexCoordCount()));
+    for (unsigned int j = 0; j < subMesh->GetTexCoordCount(); ++j)
+    {
+      ignition::math::Vector2d t = subMesh->TexCoord(j);
+      writer.Write(t.X());
+      writer.Write(t.Y());
+    }
+
+    writer.Write(static_cast<uint32_t>(subMesh->GetIndexCount()));
+    for (unsigned int j = 0; j < subMesh->GetIndexCount(); ++j)
+      writer.Write(static_cast<uint32_t>(subMesh->GetIndex(j)));
+
+    writer.Write(static_cast<uint32_t>(subMesh->GetNodeAssignmentsCount()));
+    for (unsigned int j = 0; j < subMesh->GetNodeAssignmentsCount(); ++j)
+    {
+      NodeAssignment na = subMesh->GetNodeAssignment(j);
+      writer.Write(static_cast<uint32_t>(na.vertexIndex));
+      writer.Write(static_cast<uint32_t>(na.nodeIndex));
+      writer.Write(na.weight);
+    }
+  }
+
+  // Write to a temporary file and rename it, so that concurrent gazebo
+  // processes never read a partial entry.
+  try
+  {
+    boost::filesystem::create_directories(this->dataPtr->path);
+    boost::filesystem::path tmp = boost::filesystem::unique_path(
+        entry + ".%%%%%%.tmp");
+
+    {
+      std::ofstream out(tmp.string(), std::ios::binary | std::ios::trunc);
+      out.write(writer.data.data(), writer.data.size());
+      if (!out)
+      {
+        gzwarn << "Unable to write mesh cache entry[" << entry << "]\n";
+        boost::filesystem::remove(tmp);
+        return false;
+      }
+    }
+
+    boost::filesystem::rename(tmp, entry);
+  }
+  catch(const boost::filesystem::filesystem_error &_e)
+  {
+    gzwarn << "Unable to write mesh cache entry[" << entry << "]: "
+           << _e.what() << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::DefaultPath()
+{
+  const char *env = std::getenv("GAZEBO_MESH_CACHE_PATH");
+  if (env)
+    return env;
+
+  return std::string();
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHCACHE_HH_
+#define GAZEBO_COMMON_MESHCACHE_HH_
+
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class MeshCachePrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshCache MeshCache.hh common/common.hh
+    /// \brief On-disk cache of loaded meshes in a compact binary format.
+    ///
+    /// Parsing COLLADA, OBJ and STL files dominates the startup time of
+    /// worlds with large meshes. The cache stores the result of a mesh
+    /// loader (submeshes and materials) in one file per mesh, keyed by the
+    /// absolute path of the mesh file. An entry is only used if the size and
+    /// modification time of the mesh file still match the ones recorded
+    /// when the entry was written. Entries are memory mapped on load.
+    ///
+    /// Meshes with a skeleton are not cached.
+    class GZ_COMMON_VISIBLE MeshCache
+    {
+      /// \brief Constructor.
+      /// \param[in] _path Directory the entries are stored in. It is created
+      /// on the first save. An empty path disables the cache.
+      public: explicit MeshCache(const std::string &_path);
+
+      /// \brief Destructor.
+      public: virtual ~MeshCache();
+
+      /// \brief Get the directory the entries are stored in.
+      /// \return Cache directory, empty if the cache is disabled.
+      public: std::string Path() const;
+
+      /// \brief Get the path of the entry of a mesh file.
+      /// \param[in] _filename Absolute path of the mesh file.
+      /// \return Path of the cache entry, empty if the cache is disabled.
+      public: std::string EntryPath(const std::string &_filename) const;
+
+      /// \brief Load a mesh from the cache.
+      /// \param[in] _filename Absolute path of the mesh file.
+      /// \return A new mesh owned by the caller, or nullptr if there is no
+      /// valid entry for the mesh file.
+      public: Mesh *Load(const std::string &_filename) const;
+
+      /// \brief Store a mesh in the cache, replacing any previous entry.
+      /// \param[in] _filename Absolute path of the file the mesh was loaded
+      /// from.
+      /// \param[in] _mesh Mesh to store.
+      /// \return True if the entry was written.
+      public: bool Save(const std::string &_filename, const Mesh &_mesh) const;
+
+      /// \brief Get the default cache directory. The cache is opt-in: this
+      /// is the value of the GAZEBO_MESH_CACHE_PATH environment variable,
+      /// and the cache is disabled when it is not set or empty.
+      /// \return Default cache directory, empty if the cache is disabled.
+      public: static std::string DefaultPath();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MeshCachePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
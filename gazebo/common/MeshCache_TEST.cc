@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include "test_config.h"
+#include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+#include "gazebo/common/STLLoader.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshCacheTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Create a temporary cache directory.
+  protected: void SetUp() override
+  {
+    gazebo::testing::AutoLogFixture::SetUp();
+    this->dir = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("gazebo_mesh_cache_%%%%%%");
+  }
+
+  /// \brief Remove the temporary cache directory.
+  protected: void TearDown() override
+  {
+    boost::filesystem::remove_all(this->dir);
+    gazebo::testing::AutoLogFixture::TearDown();
+  }
+
+  /// \brief Copy a test mesh to the temporary directory.
+  /// \param[in] _name Name of the file in test/data.
+  /// \return Path to the copy.
+  protected: std::string CopyTestMesh(const std::string &_name)
+  {
+    boost::filesystem::create_directories(this->dir / "meshes");
+    boost::filesystem::path dst = this->dir / "meshes" / _name;
+    boost::filesystem::copy_file(
+        boost::filesystem::path(PROJECT_SOURCE_PATH) / "test/data" / _name,
+        dst);
+    return dst.string();
+  }
+
+  /// \brief Temporary directory.
+  protected: boost::filesystem::path dir;
+};
+
+/////////////////////////////////////////////////
+/// \brief Expect two meshes to hold the same data.
+void ExpectEqualMeshes(const common::Mesh &_a, const common::Mesh &_b)
+{
+  EXPECT_EQ(_a.GetName(), _b.GetName());
+  EXPECT_EQ(_a.GetPath(), _b.GetPath());
+  EXPECT_EQ(_a.Min(), _b.Min());
+  EXPECT_EQ(_a.Max(), _b.Max());
+
+  ASSERT_EQ(_a.GetMaterialCount(), _b.GetMaterialCount());
+  for (unsigned int i = 0; i < _a.GetMaterialCount(); ++i)
+  {
+    const common::Material *ma = _a.GetMaterial(i);
+    const common::Material *mb = _b.GetMaterial(i);
+    EXPECT_EQ(ma->GetTextureImage(), mb->GetTextureImage());
+    EXPECT_EQ(ma->Ambient(), mb->Ambient());
+    EXPECT_EQ(ma->Diffuse(), mb->Diffuse());
+    EXPECT_EQ(ma->Specular(), mb->Specular());
+    EXPECT_EQ(ma->Emissive(), mb->Emissive());
+    EXPECT_DOUBLE_EQ(ma->GetTransparency(), mb->GetTransparency());
+    EXPECT_DOUBLE_EQ(ma->GetShininess(), mb->GetShininess());
+    EXPECT_EQ(ma->GetBlendMode(), mb->GetBlendMode());
+    EXPECT_EQ(ma->GetShadeMode(), mb->GetShadeMode());
+    EXPECT_EQ(ma->GetLighting(), mb->GetLighting());
+  }
+
+  ASSERT_EQ(_a.GetSubMeshCount(), _b.GetSubMeshCount());
+  for (unsigned int i = 0; i < _a.GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *sa = _a.GetSubMesh(i);
+    const common::SubMesh *sb = _b.GetSubMesh(i);
+    EXPECT_EQ(sa->GetName(), sb->GetName());
+    EXPECT_EQ(sa->GetPrimitiveType(), sb->GetPrimitiveType());
+    EXPECT_EQ(sa->GetMaterialIndex(), sb->GetMaterialIndex());
+
+    ASSERT_EQ(sa->GetVertexCount(), sb->GetVertexCount());
+    for (unsigned int j = 0; j < sa->GetVertexCount(); ++j)
+      EXPECT_EQ(sa->Vertex(j), sb->Vertex(j));
+
+    ASSERT_EQ(sa->GetNormalCount(), sb->GetNormalCount());
+    for (unsigned int j = 0; j < sa->GetNormalCount(); ++j)
+      EXPECT_EQ(sa->Normal(j), sb->Normal(j));
+
+    ASSERT_EQ(sa->GetTexCoordCount(), sb->GetTexCoordCount());
+    for (unsigned int j = 0; j < sa->GetTexCoordCount(); ++j)
+      EXPECT_EQ(sa->TexCoord(j), sb->TexCoord(j));
+
+    ASSERT_EQ(sa->GetIndexCount(), sb->GetIndexCount());
+    for (unsigned int j = 0; j < sa->GetIndexCount(); ++j)
+      EXPECT_EQ(sa->GetIndex(j), sb->GetIndex(j));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Collada)
+{
+  std::string filename = this->CopyTestMesh("box.dae");
+  common::MeshCache cache((this->dir / "cache").string());
+
+  // Nothing cached yet
+  EXPECT_EQ(nullptr, cache.Load(filename));
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+
+  EXPECT_TRUE(cache.Save(filename, *mesh));
+  EXPECT_TRUE(boost::filesystem::exists(cache.EntryPath(filename)));
+
+  std::unique_ptr<common::Mesh> cached(cache.Load(filename));
+  ASSERT_NE(nullptr, cached);
+  ExpectEqualMeshes(*mesh, *cached);
+
+  // A different file must not hit the entry
+  EXPECT_NE(cache.EntryPath(filename), cache.EntryPath(filename + "x"));
+  EXPECT_EQ(nullptr, cache.Load(filename + "x"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, STL)
+{
+  std::string filename = this->CopyTestMesh("twoFaces.stl");
+  common::MeshCache cache((this->dir / "cache").string());
+
+  common::STLLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_TRUE(cache.Save(filename, *mesh));
+
+  std::unique_ptr<common::Mesh> cached(cache.Load(filename));
+  ASSERT_NE(nullptr, cached);
+  ExpectEqualMeshes(*mesh, *cached);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Stale)
+{
+  std::string filename = this->CopyTestMesh("box.dae");
+  common::MeshCache cache((this->dir / "cache").string());
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_TRUE(cache.Save(filename, *mesh));
+
+  // Changing the mesh file invalidates the entry
+  {
+    std::ofstream out(filename, std::ios::app);
+    out << "\n";
+  }
+  EXPECT_EQ(nullptr, cache.Load(filename));
+
+  // A corrupt entry is ignored
+  EXPECT_TRUE(cache.Save(filename, *mesh));
+  boost::filesystem::resize_file(cache.EntryPath(filename), 64);
+  EXPECT_EQ(nullptr, cache.Load(filename));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Disabled)
+{
+  std::string filename = this->CopyTestMesh("box.dae");
+  common::MeshCache cache("");
+  EXPECT_TRUE(cache.Path().empty());
+  EXPECT_TRUE(cache.EntryPath(filename).empty());
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_FALSE(cache.Save(filename, *mesh));
+  EXPECT_EQ(nullptr, cache.Load(filename));
+}
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(MeshCacheTest, DefaultPath)
+{
+  const char *env = std::getenv("GAZEBO_MESH_CACHE_PATH");
+  std::string original = env ? env : "";
+
+  // The cache is only used when a path is set
+  unsetenv("GAZEBO_MESH_CACHE_PATH");
+  EXPECT_TRUE(common::MeshCache::DefaultPath().empty());
+
+  setenv("GAZEBO_MESH_CACHE_PATH", this->dir.string().c_str(), 1);
+  EXPECT_EQ(this->dir.string(), common::MeshCache::DefaultPath());
+
+  if (env)
+    setenv("GAZEBO_MESH_CACHE_PATH", original.c_str(), 1);
+  else
+    unsetenv("GAZEBO_MESH_CACHE_PATH");
+}
+#endif
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Skeleton)
+{
+  std::string filename = this->CopyTestMesh("box_nested_animation.dae");
+  common::MeshCache cache((this->dir / "cache").string());
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(filename));
+  ASSERT_NE(nullptr, mesh);
+  ASSERT_TRUE(mesh->HasSkeleton());
+
+  // Skinned meshes are not cached
+  EXPECT_FALSE(cache.Save(filename, *mesh));
+  EXPECT_EQ(nullptr, cache.Load(filename));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,17 +16,23 @@
  */
 
 #include <sys/stat.h>
+#include <memory>
+#include <set>
 #include <string>
 #include <map>
 
+#include <boost/thread/condition_variable.hpp>
+
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/ColladaLoader.hh"
 #include "gazebo/common/ColladaExporter.hh"
 #include "gazebo/common/STLLoader.hh"
 #include "gazebo/common/OBJLoader.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/gazebo_config.h"
 
 #ifdef HAVE_GTS
@@ -43,19 +49,16 @@ namespace common
 //////////////////////////////////////////////////
 class MeshManagerPrivate
 {
-  /// \brief 3D mesh loader for COLLADA files
-  public: ColladaLoader *colladaLoader = nullptr;
-
   /// \brief 3D mesh exporter for COLLADA files
   public: ColladaExporter *colladaExporter = nullptr;
 
-  /// \brief 3D mesh loader for STL files
-  public: STLLoader *stlLoader = nullptr;
-
   // \brief 3D mesh loader for FBX files
   // \todo The FBX loader needs to be implemented.
   // public: FBXLoader *fbxLoader = nullptr;
 
+  /// \brief On-disk cache of meshes loaded from files
+  public: MeshCache cache{MeshCache::DefaultPath()};
+
   /// \brief Dictionary of meshes, indexed by name
   public: std::map<std::string, Mesh*> meshes;
 
@@ -65,19 +68,19 @@ class MeshManagerPrivate
   /// \brief Mutex to protect from loading the same mesh in different threads
   /// at the same time.
   public: boost::mutex mutex;
-};
 
-// added here for ABI compatibility
-// TODO move to header / private class when merging forward.
-static OBJLoader objLoader;
+  /// \brief Names of the meshes being loaded by a thread.
+  public: std::set<std::string> loading;
+
+  /// \brief Signaled when a thread finished loading a mesh.
+  public: boost::condition_variable loadingCond;
+};
 
 //////////////////////////////////////////////////
 MeshManager::MeshManager()
   : dataPtr(new MeshManagerPrivate)
 {
-  this->dataPtr->colladaLoader = new ColladaLoader();
   this->dataPtr->colladaExporter = new ColladaExporter();
-  this->dataPtr->stlLoader = new STLLoader();
 
   // Create some basic shapes
   this->CreatePlane("unit_plane",
@@ -116,9 +119,7 @@ MeshManager::MeshManager()
 //////////////////////////////////////////////////
 MeshManager::~MeshManager()
 {
-  delete this->dataPtr->colladaLoader;
   delete this->dataPtr->colladaExporter;
-  delete this->dataPtr->stlLoader;
   for (auto &pairNameMesh : this->dataPtr->meshes)
   {
     delete pairNameMesh.second;
@@ -142,9 +143,11 @@ const Mesh *MeshManager::Load(const std::string &_filename)
 
   std::string extension;
 
-  if (this->HasMesh(_filename))
   {
-    return this->dataPtr->meshes[_filename];
+    boost::mutex::scoped_lock lock(this->dataPtr->mutex);
+    auto iter = this->dataPtr->meshes.find(_filename);
+    if (iter != this->dataPtr->meshes.end())
+      return iter->second;
 
     // This breaks trimesh geom. Each new trimesh should have a unique name.
     /*
@@ -166,39 +169,57 @@ const Mesh *MeshManager::Load(const std::string &_filename)
     extension = fullname.substr(fullname.rfind(".")+1, fullname.size());
     std::transform(extension.begin(), extension.end(),
         extension.begin(), ::tolower);
-    MeshLoader *loader = nullptr;
 
+    // Loaders keep parsing state, use one per call so that different meshes
+    // can be loaded in parallel.
+    std::unique_ptr<MeshLoader> loader;
     if (extension == "stl" || extension == "stlb" || extension == "stla")
-      loader = this->dataPtr->stlLoader;
+      loader.reset(new STLLoader());
     else if (extension == "dae")
-      loader = this->dataPtr->colladaLoader;
+      loader.reset(new ColladaLoader());
     else if (extension == "obj")
-      loader = &objLoader;
+      loader.reset(new OBJLoader());
     else
     {
       gzerr << "Unsupported mesh format for file[" << _filename << "]\n";
       return nullptr;
     }
 
-    try
+    // Prevent two threads from loading the same mesh at the same time. The
+    // second thread waits for the first one and uses its mesh.
+    boost::mutex::scoped_lock lock(this->dataPtr->mutex);
+    while (this->dataPtr->loading.count(_filename) > 0)
+      this->dataPtr->loadingCond.wait(lock);
+
+    auto iter = this->dataPtr->meshes.find(_filename);
+    if (iter != this->dataPtr->meshes.end())
+      return iter->second;
+
+    this->dataPtr->loading.insert(_filename);
+    lock.unlock();
+
+    // Whatever happens below, wake up the threads waiting for this mesh,
+    // otherwise an unexpected exception would make them wait forever.
+    struct LoadingGuard
     {
-      // This mutex prevents two threads from loading the same mesh at the
-      // same time.
-      boost::mutex::scoped_lock lock(this->dataPtr->mutex);
-      if (!this->HasMesh(_filename))
-      {
-        if ((mesh = loader->Load(fullname)) != nullptr)
-        {
-          mesh->SetName(_filename);
-          this->dataPtr->meshes.insert(std::make_pair(_filename, mesh));
-        }
-        else
-          gzerr << "Unable to load mesh[" << fullname << "]\n";
-      }
-      else
+      ~LoadingGuard()
       {
-        mesh = this->dataPtr->meshes[_filename];
+        boost::mutex::scoped_lock guardLock(this->data->mutex);
+        this->data->loading.erase(this->filename);
+        this->data->loadingCond.notify_all();
       }
+      MeshManagerPrivate *data;
+      const std::string &filename;
+    } loadingGuard{this->dataPtr, _filename};
+
+    try
+    {
+      StartupScope startupScope(fullname, "mesh");
+
+      // Try the on-disk cache first, which avoids parsing the file
+      mesh = this->dataPtr->cache.Load(fullname);
+      if (!mesh && (mesh = loader->Load(fullname)) != nullptr)
+        this->dataPtr->cache.Save(fullname, *mesh);
     }
     catch(gazebo::common::Exception &e)
     {
@@ -206,6 +227,18 @@ const Mesh *MeshManager::Load(const std::string &_filename)
       gzerr << e << "\n";
       gzthrow(e);
     }
+
+    lock.lock();
+    if (mesh != nullptr)
+    {
+      mesh->SetName(_filename);
+      this->dataPtr->meshes.insert(std::make_pair(_filename, mesh));
+    }
+    else
+      gzerr << "Unable to load mesh[" << fullname << "]\n";
+
+    // The guard takes the lock again
+    lock.unlock();
   }
   else
     gzerr << "Unable to find file[" << _filename << "]\n";
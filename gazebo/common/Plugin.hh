@@ -37,6 +37,7 @@
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/StartupProfiler.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/sensors/SensorTypes.hh"
@@ -106,19 +107,15 @@ namespace gazebo
               return this->handleName;
             }
 
-    /// \brief a class method that creates a plugin from a file name.
-    /// It locates the shared library and loads it dynamically.
-    /// \param[in] _filename the path to the shared library.
-    /// \param[in] _name short name of the plugin
-    /// \return Shared Pointer to this class type
-    public: static TPtr Create(const std::string &_filename,
-                const std::string &_name)
+    /// \brief Adjust the name of a plugin library to the platform and
+    /// locate it in the plugin paths.
+    /// \param[in,out] _filename Name of the shared library. On return it
+    /// holds the name adjusted for the platform library suffix.
+    /// \return Full path to the shared library, or the adjusted name if the
+    /// library is not in the plugin paths.
+    public: static std::string FindLibrary(std::string &_filename)
             {
-              TPtr result;
-              // PluginPtr result;
               struct stat st;
-              bool found = false;
-              std::string fullname, filename(_filename);
               std::list<std::string>::iterator iter;
               std::list<std::string> pluginPaths =
                 common::SystemPaths::Instance()->GetPluginPaths();
@@ -127,28 +124,28 @@ namespace gazebo
               // This is a hack to work around issue #800,
               // error loading plugin libraries with different extensions
               {
-                size_t soSuffix = filename.rfind(".so");
+                size_t soSuffix = _filename.rfind(".so");
                 if (soSuffix != std::string::npos)
                 {
                   const std::string macSuffix(".dylib");
-                  filename.replace(soSuffix, macSuffix.length(), macSuffix);
+                  _filename.replace(soSuffix, macSuffix.length(), macSuffix);
                 }
               }
 #elif _WIN32
               // Corresponding windows hack
               {
                 // replace .so with .dll
-                size_t soSuffix = filename.rfind(".so");
+                size_t soSuffix = _filename.rfind(".so");
                 if (soSuffix != std::string::npos)
                 {
                   const std::string winSuffix(".dll");
-                  filename.replace(soSuffix, winSuffix.length(), winSuffix);
+                  _filename.replace(soSuffix, winSuffix.length(), winSuffix);
                 }
-                size_t libPrefix = filename.find("lib");
+                size_t libPrefix = _filename.find("lib");
                 if (libPrefix == 0)
                 {
                   // remove the lib prefix
-                  filename.erase(0, 3);
+                  _filename.erase(0, 3);
                 }
               }
 #endif  // ifdef __APPLE__
@@ -156,18 +153,29 @@ namespace gazebo
               for (iter = pluginPaths.begin();
                    iter!= pluginPaths.end(); ++iter)
               {
-                fullname = (*iter)+std::string("/")+filename;
+                std::string fullname = (*iter)+std::string("/")+_filename;
                 fullname = boost::filesystem::path(fullname)
                     .make_preferred().string();
                 if (stat(fullname.c_str(), &st) == 0)
-                {
-                  found = true;
-                  break;
-                }
+                  return fullname;
               }
 
-              if (!found)
-                fullname = filename;
+              return _filename;
+            }
+
+    /// \brief a class method that creates a plugin from a file name.
+    /// It locates the shared library and loads it dynamically.
+    /// \param[in] _filename the path to the shared library.
+    /// \param[in] _name short name of the plugin
+    /// \return Shared Pointer to this class type
+    public: static TPtr Create(const std::string &_filename,
+                const std::string &_name)
+            {
+              TPtr result;
+              // PluginPtr result;
+              std::string filename(_filename);
+              common::StartupScope startupScope(filename, "plugin");
+              std::string fullname = FindLibrary(filename);
 
               fptr_union_t registerFunc;
               std::string registerName = "RegisterPlugin";
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _WIN32
+  #include <unistd.h>
+#else
+  #include <process.h>
+  #define getpid _getpid
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/StartupProfiler.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Categories of the scopes open on the calling thread, innermost
+/// last.
+static thread_local std::vector<std::string> g_openCategories;
+
+/// \internal
+/// \brief Private data class for StartupProfiler
+class gazebo::common::StartupProfilerPrivate
+{
+  /// \brief True while recording.
+  public: std::atomic<bool> enabled{false};
+
+  /// \brief Time Enable was called.
+  public: std::chrono::steady_clock::time_point origin;
+
+  /// \brief File written by Finish.
+  public: std::string filename;
+
+  /// \brief Protects spans and threads.
+  public: mutable std::mutex mutex;
+
+  /// \brief Spans recorded.
+  public: std::vector<StartupSpan> spans;
+
+  /// \brief Index of each thread seen.
+  public: std::map<std::thread::id, unsigned int> threads;
+};
+
+/// \internal
+/// \brief Private data class for StartupScope
+class gazebo::common::StartupScopePrivate
+{
+  /// \brief The span being recorded.
+  public: StartupSpan span;
+};
+
+/////////////////////////////////////////////////
+/// \brief Write a string as a JSON string literal.
+/// \param[in] _out Stream to write to.
+/// \param[in] _str String to write.
+static void WriteJsonString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (auto const c : _str)
+  {
+    switch (c)
+    {
+      case '"':
+        _out << "\\\"";
+        break;
+      case '\\':
+        _out << "\\\\";
+        break;
+      case '\n':
+        _out << "\\n";
+        break;
+      case '\t':
+        _out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          _out << buffer;
+        }
+        else
+          _out << c;
+        break;
+    }
+  }
+  _out << '"';
+}
+
+/////////////////////////////////////////////////
+StartupProfiler::StartupProfiler()
+  : dataPtr(new StartupProfilerPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+StartupProfiler::~StartupProfiler()
+{
+}
+
+/////////////////////////////////////////////////
+void StartupProfiler::Enable(const std::string &_filename)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->spans.clear();
+  this->dataPtr->threads.clear();
+  this->dataPtr->filename = _filename;
+  this->dataPtr->origin = std::chrono::steady_clock::now();
+  this->dataPtr->enabled = true;
+}
+
+/////////////////////////////////////////////////
+bool StartupProfiler::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+/////////////////////////////////////////////////
+bool StartupProfiler::Finish()
+{
+  std::string filename;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->enabled)
+      return true;
+    this->dataPtr->enabled = false;
+    filename = this->dataPtr->filename;
+  }
+
+  if (filename.empty())
+    return true;
+
+  if (!this->Write(filename))
+    return false;
+
+  gzmsg << "Startup trace written to [" << filename << "]" << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::vector<StartupSpan> StartupProfiler::Spans() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->spans;
+}
+
+/////////////////////////////////////////////////
+double StartupProfiler::CategoryTime(const std::string &_category) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  double total = 0;
+  for (auto const &span : this->dataPtr->spans)
+  {
+    if (!span.nested && span.category == _category)
+      total += span.duration;
+  }
+  return total;
+}
+
+/////////////////////////////////////////////////
+bool StartupProfiler::Write(const std::string &_filename) const
+{
+  std::ofstream out(_filename);
+  if (!out)
+  {
+    gzerr << "Unable to write startup trace [" << _filename << "]"
+          << std::endl;
+    return false;
+  }
+
+  std::vector<StartupSpan> spans = this->Spans();
+
+  // Enclosing spans first, which makes the file easier to read
+  std::stable_sort(spans.begin(), spans.end(),
+      [](const StartupSpan &_a, const StartupSpan &_b)
+      {
+        return _a.start < _b.start;
+      });
+
+  const int pid = getpid();
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < spans.size(); ++i)
+  {
+    // Chrome traces use microseconds
+    out << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+    WriteJsonString(out, spans[i].name);
+    out << ",\"cat\":";
+    WriteJsonString(out, spans[i].category);
+    out << ",\"ph\":\"X\""
+        << ",\"ts\":" << static_cast<int64_t>(spans[i].start * 1e6)
+        << ",\"dur\":" << static_cast<int64_t>(spans[i].duration * 1e6)
+        << ",\"pid\":" << pid
+        << ",\"tid\":" << spans[i].thread << "}";
+  }
+  out << "\n]}\n";
+
+  return out.good();
+}
+
+/////////////////////////////////////////////////
+void StartupProfiler::AddSpan(StartupSpan &_span)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // A span that outlived the recording is dropped
+  if (!this->dataPtr->enabled)
+    return;
+
+  auto thread = this->dataPtr->threads.emplace(std::this_thread::get_id(),
+      static_cast<unsigned int>(this->dataPtr->threads.size())).first;
+  _span.thread = thread->second;
+  this->dataPtr->spans.push_back(_span);
+}
+
+/////////////////////////////////////////////////
+double StartupProfiler::Now() const
+{
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - this->dataPtr->origin).count();
+}
+
+/////////////////////////////////////////////////
+StartupScope::StartupScope(const std::string &_name, const char *_category)
+{
+  if (this->Begin(_category))
+    this->dataPtr->span.name = _name;
+}
+
+/////////////////////////////////////////////////
+StartupScope::StartupScope(const char *_name, const char *_category)
+{
+  if (this->Begin(_category))
+    this->dataPtr->span.name = _name;
+}
+
+/////////////////////////////////////////////////
+bool StartupScope::Begin(const char *_category)
+{
+  StartupProfiler *profiler = StartupProfiler::Instance();
+  if (!profiler->Enabled())
+    return false;
+
+  this->dataPtr.reset(new StartupScopePrivate);
+  this->dataPtr->span.category = _category;
+  this->dataPtr->span.nested = std::find(g_openCategories.begin(),
+      g_openCategories.end(), this->dataPtr->span.category) !=
+      g_openCategories.end();
+  g_openCategories.push_back(this->dataPtr->span.category);
+  this->dataPtr->span.start = profiler->Now();
+  return true;
+}
+
+/////////////////////////////////////////////////
+StartupScope::~StartupScope()
+{
+  if (!this->dataPtr)
+    return;
+
+  StartupProfiler *profiler = StartupProfiler::Instance();
+  this->dataPtr->span.duration =
+      profiler->Now() - this->dataPtr->span.start;
+  g_openCategories.pop_back();
+  profiler->AddSpan(this->dataPtr->span);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_STARTUPPROFILER_HH_
+#define GAZEBO_COMMON_STARTUPPROFILER_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, StartupProfiler)
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data classes
+    class StartupProfilerPrivate;
+    class StartupScopePrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \brief Time spent in one phase of the server startup.
+    class GZ_COMMON_VISIBLE StartupSpan
+    {
+      /// \brief Name of the span, usually the file or entity being worked
+      /// on.
+      public: std::string name;
+
+      /// \brief Phase of the startup, such as "sdf", "uri", "mesh",
+      /// "physics", "plugin" or "sensors".
+      public: std::string category;
+
+      /// \brief Start time in seconds since the profiler was enabled.
+      public: double start = 0;
+
+      /// \brief Duration in seconds.
+      public: double duration = 0;
+
+      /// \brief Index of the thread that recorded the span, in the order
+      /// the threads were first seen.
+      public: unsigned int thread = 0;
+
+      /// \brief True if the span is inside another span of the same
+      /// category on the same thread.
+      public: bool nested = false;
+    };
+
+    /// \class StartupProfiler StartupProfiler.hh common/common.hh
+    /// \brief Records where the server startup time goes, as spans of
+    /// time tagged with a phase, and writes them as a Chrome trace file
+    /// that chrome://tracing and Perfetto can open.
+    ///
+    /// Spans are recorded with StartupScope and only while the profiler is
+    /// enabled. Otherwise a scope costs a check of Enabled: its name and
+    /// category are not copied. Code that builds a span name, for example
+    /// by concatenation, should check Enabled first so that the name is
+    /// only built while recording.
+    class GZ_COMMON_VISIBLE StartupProfiler
+      : public SingletonT<StartupProfiler>
+    {
+      /// \brief Constructor.
+      private: StartupProfiler();
+
+      /// \brief Destructor.
+      private: virtual ~StartupProfiler();
+
+      /// \brief Start recording, dropping the spans of any previous
+      /// recording.
+      /// \param[in] _filename File that Finish writes the trace to, empty
+      /// to keep the trace in memory only.
+      public: void Enable(const std::string &_filename = "");
+
+      /// \brief Get whether spans are being recorded.
+      /// \return True between Enable and Finish.
+      public: bool Enabled() const;
+
+      /// \brief Stop recording, and write the trace to the file given to
+      /// Enable. The spans are kept until the next call to Enable.
+      /// \return False if the trace file could not be written.
+      public: bool Finish();
+
+      /// \brief Get the spans recorded.
+      /// \return Spans in the order they ended.
+      public: std::vector<StartupSpan> Spans() const;
+
+      /// \brief Get the total time spent in a phase. Spans nested in a
+      /// span of the same phase are only counted once, and the time of
+      /// other phases nested in the phase's spans is included.
+      /// \param[in] _category Phase of the startup.
+      /// \return Time in seconds.
+      public: double CategoryTime(const std::string &_category) const;
+
+      /// \brief Write the spans recorded as a Chrome trace file.
+      /// \param[in] _filename Path of the file to write.
+      /// \return False if the file could not be written.
+      public: bool Write(const std::string &_filename) const;
+
+      /// \brief Add a span, used by StartupScope.
+      /// \param[in] _span The span. The thread index is filled in here.
+      private: void AddSpan(StartupSpan &_span);
+
+      /// \brief Get the time since the profiler was enabled.
+      /// \return Time in seconds.
+      private: double Now() const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StartupProfilerPrivate> dataPtr;
+
+      /// \brief StartupScope records the spans.
+      private: friend class StartupScope;
+
+      /// \brief Singleton implementation
+      private: friend class SingletonT<StartupProfiler>;
+    };
+
+    /// \class StartupScope StartupProfiler.hh common/common.hh
+    /// \brief Records a span of the StartupProfiler that lasts as long as
+    /// the object, if the profiler is enabled when the object is created.
+    class GZ_COMMON_VISIBLE StartupScope
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Name of the span, copied only if the profiler is
+      /// enabled.
+      /// \param[in] _category Phase of the startup.
+      public: StartupScope(const std::string &_name, const char *_category);
+
+      /// \brief Constructor.
+      /// \param[in] _name Name of the span, copied only if the profiler is
+      /// enabled.
+      /// \param[in] _category Phase of the startup.
+      public: StartupScope(const char *_name, const char *_category);
+
+      /// \brief Destructor, records the span.
+      public: ~StartupScope();
+
+      /// \brief Copying a scope would record its span twice.
+      public: StartupScope(const StartupScope &) = delete;
+
+      /// \brief Copying a scope would record its span twice.
+      public: StartupScope &operator=(const StartupScope &) = delete;
+
+      /// \brief Start recording the span, if the profiler is enabled.
+      /// \param[in] _category Phase of the startup.
+      /// \return False if the profiler is disabled, in which case nothing
+      /// is recorded.
+      private: bool Begin(const char *_category);
+
+      /// \brief Private data pointer, null if the profiler was disabled.
+      private: std::unique_ptr<StartupScopePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/StartupProfiler.hh"
+#include "gazebo/common/Time.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class StartupProfilerTest : public gazebo::testing::AutoLogFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(StartupProfilerTest, Disabled)
+{
+  common::StartupProfiler *profiler = common::StartupProfiler::Instance();
+  profiler->Enable();
+  EXPECT_TRUE(profiler->Finish());
+  EXPECT_FALSE(profiler->Enabled());
+
+  {
+    common::StartupScope scope("model", "physics");
+  }
+  EXPECT_TRUE(profiler->Spans().empty());
+  EXPECT_DOUBLE_EQ(profiler->CategoryTime("physics"), 0.0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(StartupProfilerTest, Spans)
+{
+  common::StartupProfiler *profiler = common::StartupProfiler::Instance();
+  profiler->Enable();
+  EXPECT_TRUE(profiler->Enabled());
+
+  {
+    common::StartupScope world("world", "physics");
+    {
+      common::StartupScope model("model", "physics");
+      common::StartupScope mesh("box.dae", "mesh");
+      common::Time::MSleep(20);
+    }
+
+    std::thread thread([]()
+        {
+          common::StartupScope mesh("sphere.dae", "mesh");
+          common::Time::MSleep(20);
+        });
+    thread.join();
+  }
+  EXPECT_TRUE(profiler->Finish());
+
+  // Spans that end after the recording are dropped
+  {
+    common::StartupScope late("late", "physics");
+  }
+
+  std::vector<common::StartupSpan> spans = profiler->Spans();
+  ASSERT_EQ(4u, spans.size());
+
+  // In the order they ended
+  EXPECT_EQ("box.dae", spans[0].name);
+  EXPECT_EQ("mesh", spans[0].category);
+  EXPECT_FALSE(spans[0].nested);
+  EXPECT_EQ("model", spans[1].name);
+  EXPECT_TRUE(spans[1].nested);
+  EXPECT_EQ("sphere.dae", spans[2].name);
+  EXPECT_FALSE(spans[2].nested);
+  EXPECT_EQ("world", spans[3].name);
+  EXPECT_FALSE(spans[3].nested);
+
+  EXPECT_EQ(spans[0].thread, spans[3].thread);
+  EXPECT_NE(spans[2].thread, spans[3].thread);
+
+  EXPECT_GE(spans[1].start, spans[3].start);
+  EXPECT_GE(spans[1].duration, 0.02);
+  EXPECT_GE(spans[3].duration, 0.04);
+
+  // The nested physics span is part of the enclosing one
+  EXPECT_DOUBLE_EQ(spans[3].duration, profiler->CategoryTime("physics"));
+  EXPECT_DOUBLE_EQ(spans[0].duration + spans[2].duration,
+      profiler->CategoryTime("mesh"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(StartupProfilerTest, Write)
+{
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_startup_trace-%%%%%%.json");
+
+  common::StartupProfiler *profiler = common::StartupProfiler::Instance();
+  profiler->Enable(path.string());
+  {
+    common::StartupScope plugin("lib\"quoted\".so", "plugin");
+  }
+  EXPECT_TRUE(profiler->Finish());
+  ASSERT_TRUE(boost::filesystem::exists(path));
+
+  std::ifstream in(path.string());
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  std::string trace = buffer.str();
+
+  EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"lib\\\"quoted\\\".so\""));
+  EXPECT_NE(std::string::npos, trace.find("\"cat\":\"plugin\""));
+  EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+  EXPECT_EQ(trace.size() - 4, trace.rfind("\n]}\n"));
+
+  // Enabling again starts a new recording
+  profiler->Enable();
+  EXPECT_TRUE(profiler->Spans().empty());
+  EXPECT_TRUE(profiler->Finish());
+
+  boost::filesystem::remove(path);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_TRIPLEBUFFER_HH_
+#define GAZEBO_COMMON_TRIPLEBUFFER_HH_
+
+#include <atomic>
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class TripleBuffer TripleBuffer.hh common/common.hh
+    /// \brief Lock-free exchange of data between one writer thread and one
+    /// reader thread.
+    ///
+    /// The writer fills the back buffer and publishes it, the reader
+    /// consumes the most recently published buffer. Neither side ever
+    /// waits for the other: the published buffer is handed over with a
+    /// single atomic exchange. A buffer that is published again before the
+    /// reader consumed it is returned to the writer, which can tell from
+    /// the return value of Publish() whether its content was seen.
+    ///
+    /// All writer functions must be called from the same thread (or be
+    /// serialized by the caller), and the same holds for the reader
+    /// functions.
+    template<typename T>
+    class TripleBuffer
+    {
+      /// \brief Constructor.
+      public: TripleBuffer() = default;
+
+      /// \brief Get the buffer the writer fills. Writer only.
+      /// \return The back buffer.
+      public: T &Back()
+      {
+        return this->buffers[this->back];
+      }
+
+      /// \brief Publish the back buffer and take a new one. Writer only.
+      /// \return True if the new back buffer was published earlier and
+      /// never consumed by the reader, in which case it still holds that
+      /// content. False if the reader is done with it.
+      public: bool Publish()
+      {
+        const int previous = this->middle.exchange(this->back | Fresh,
+            std::memory_order_acq_rel);
+        this->back = previous & Index;
+        return (previous & Fresh) != 0;
+      }
+
+      /// \brief Take the most recently published buffer. Reader only.
+      /// \return True if a buffer was published since the last call, in
+      /// which case Front() returns it. False if there is nothing new.
+      public: bool Consume()
+      {
+        if ((this->middle.load(std::memory_order_relaxed) & Fresh) == 0)
+          return false;
+
+        this->front = this->middle.exchange(this->front,
+            std::memory_order_acq_rel) & Index;
+        return true;
+      }
+
+      /// \brief Get the buffer consumed last. Reader only.
+      /// \return The front buffer.
+      public: const T &Front() const
+      {
+        return this->buffers[this->front];
+      }
+
+      /// \brief Bit set in middle when it holds a buffer that was not
+      /// consumed yet.
+      private: static const int Fresh = 4;
+
+      /// \brief Mask of the buffer index in middle.
+      private: static const int Index = 3;
+
+      /// \brief The three buffers.
+      private: T buffers[3];
+
+      /// \brief Index of the buffer owned by the writer.
+      private: int back = 0;
+
+      /// \brief Index of the buffer in transit, and the Fresh bit.
+      private: std::atomic<int> middle{1};
+
+      /// \brief Index of the buffer owned by the reader.
+      private: int front = 2;
+    };
+    /// \}
+  }
+}
+#endif
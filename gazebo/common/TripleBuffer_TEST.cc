@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "gazebo/common/TripleBuffer.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TripleBufferTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TripleBufferTest, PublishConsume)
+{
+  common::TripleBuffer<int> buffer;
+
+  // Nothing published yet
+  EXPECT_FALSE(buffer.Consume());
+
+  buffer.Back() = 1;
+  EXPECT_FALSE(buffer.Publish());
+  EXPECT_TRUE(buffer.Consume());
+  EXPECT_EQ(1, buffer.Front());
+
+  // A buffer is consumed only once
+  EXPECT_FALSE(buffer.Consume());
+  EXPECT_EQ(1, buffer.Front());
+
+  // The reader only sees the latest buffer, and the writer gets back the
+  // one that was never consumed
+  buffer.Back() = 2;
+  EXPECT_FALSE(buffer.Publish());
+  buffer.Back() = 3;
+  EXPECT_TRUE(buffer.Publish());
+  EXPECT_EQ(2, buffer.Back());
+  EXPECT_TRUE(buffer.Consume());
+  EXPECT_EQ(3, buffer.Front());
+  EXPECT_FALSE(buffer.Consume());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TripleBufferTest, Threads)
+{
+  // The writer publishes increasing sequences, the reader must always see
+  // a complete sequence that is newer than the previous one.
+  const int count = 20000;
+  const size_t size = 64;
+  common::TripleBuffer<std::vector<int>> buffer;
+
+  std::thread writer([&]()
+  {
+    for (int i = 1; i <= count; ++i)
+    {
+      buffer.Back().assign(size, i);
+      buffer.Publish();
+    }
+  });
+
+  int last = 0;
+  int consumed = 0;
+  while (last < count)
+  {
+    if (!buffer.Consume())
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const std::vector<int> &front = buffer.Front();
+    ASSERT_EQ(size, front.size());
+    EXPECT_GT(front[0], last);
+    for (auto const value : front)
+      ASSERT_EQ(front[0], value);
+    last = front[0];
+    ++consumed;
+  }
+  writer.join();
+
+  EXPECT_GT(consumed, 0);
+  EXPECT_FALSE(buffer.Consume());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,7 @@
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/ModelDatabase.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo_shared.hh"
 
@@ -69,6 +70,8 @@ bool gazebo_shared::setup(const std::string &_prefix, int _argc, char **_argv,
   for (std::vector<gazebo::SystemPluginPtr>::iterator iter =
        _plugins.begin(); iter != _plugins.end(); ++iter)
   {
+    gazebo::common::StartupScope startupScope((*iter)->GetFilename(),
+        "plugin");
     (*iter)->Load(_argc, _argv);
   }
 
@@ -75,6 +75,11 @@ using namespace gui;
 
 #define MINIMUM_TAB_WIDTH 250
 
+/// \brief Milliseconds to wait for the answer to a chunked scene request
+/// before requesting the whole scene. Servers older than
+/// "scene_info_chunked" don't answer it.
+static const int SceneRequestTimeout = 3000;
+
 extern bool g_fullscreen;
 /////////////////////////////////////////////////
 MainWindow::MainWindow()
@@ -361,8 +366,7 @@ void MainWindow::Init()
                                             "/gazebo/world/modify",
                                             &MainWindow::OnWorldModify, this);
 
-  this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
-  this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+  this->RequestScene();
 
   gui::Events::mainWindowReady();
 }
@@ -2138,13 +2142,45 @@ void MainWindow::OnLight(ConstLightPtr &_msg)
   gui::Events::lightUpdate(*_msg);
 }
 
+/////////////////////////////////////////////////
+void MainWindow::RequestScene()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->requestMutex);
+
+  // The models follow the rest of the scene in chunks, see OnResponse
+  delete this->dataPtr->requestMsg;
+  this->dataPtr->requestMsg = msgs::CreateRequest("scene_info_chunked");
+  this->dataPtr->requestAnswered = false;
+  this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+
+  const int id = this->dataPtr->requestMsg->id();
+  QTimer::singleShot(SceneRequestTimeout, this, [this, id]()
+  {
+    std::lock_guard<std::mutex> timeoutLock(this->dataPtr->requestMutex);
+    if (!this->dataPtr->requestMsg || this->dataPtr->requestMsg->id() != id ||
+        this->dataPtr->requestAnswered || !this->dataPtr->requestPub)
+    {
+      return;
+    }
+
+    gzlog << "No answer to the chunked scene request, requesting the whole "
+          << "scene" << std::endl;
+    delete this->dataPtr->requestMsg;
+    this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
+    this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+  });
+}
+
 /////////////////////////////////////////////////
 void MainWindow::OnResponse(ConstResponsePtr &_msg)
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->requestMutex);
   if (!this->dataPtr->requestMsg || _msg->id() !=
     this->dataPtr->requestMsg->id())
     return;
 
+  this->dataPtr->requestAnswered = true;
+
   msgs::Scene sceneMsg;
 
   if (_msg->has_type() && _msg->type() == sceneMsg.GetTypeName())
@@ -2175,6 +2211,10 @@ void MainWindow::OnResponse(ConstResponsePtr &_msg)
     {
       gui::Events::lightUpdate(sceneMsg.light(i));
     }
+
+    // More chunks of models are on their way
+    if (_msg->response() == "partial")
+      return;
   }
 
   delete this->dataPtr->requestMsg;
@@ -2220,8 +2260,7 @@ void MainWindow::OnWorldModify(ConstWorldModifyPtr &_msg)
   if (_msg->has_create() && _msg->create())
   {
     this->dataPtr->renderWidget->CreateScene(_msg->world_name());
-    this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
-    this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+    this->RequestScene();
   }
   else if (_msg->has_remove() && _msg->remove())
     this->dataPtr->renderWidget->RemoveScene(_msg->world_name());
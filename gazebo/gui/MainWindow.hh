@@ -286,6 +286,11 @@ namespace gazebo
       private: void OnLight(ConstLightPtr &_msg);
 
       private: void OnResponse(ConstResponsePtr &_msg);
+
+      /// \brief Request the scene in chunks, and the whole scene if the
+      /// server doesn't answer.
+      private: void RequestScene();
+
       private: void OnWorldModify(ConstWorldModifyPtr &_msg);
       private: void OnManipMode(const std::string &_mode);
       private: void OnSetSelectedEntity(const std::string &_name,
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -101,6 +102,12 @@ namespace gazebo
       /// \brief Message used to field requests.
       public: msgs::Request *requestMsg = nullptr;
 
+      /// \brief True once requestMsg got a response.
+      public: bool requestAnswered = false;
+
+      /// \brief Protects requestMsg and requestAnswered.
+      public: std::mutex requestMutex;
+
       /// \brief The left-hand tab widget
       public: QTabWidget *tabWidget = nullptr;
 
@@ -60,6 +60,11 @@ using namespace gui;
 
 extern ModelRightMenu *g_modelRightMenu;
 
+/// \brief Milliseconds to wait for the answer to a chunked scene request
+/// before requesting the whole scene. Servers older than
+/// "scene_info_chunked" don't answer it.
+static const int SceneRequestTimeout = 3000;
+
 /////////////////////////////////////////////////
 ModelListWidget::ModelListWidget(QWidget *_parent)
   : QWidget(_parent), dataPtr(new ModelListWidgetPrivate)
@@ -186,9 +191,28 @@ void ModelListWidget::OnModelSelection(QTreeWidgetItem *_item, int /*_column*/)
     this->dataPtr->propTreeBrowser->clear();
     if (name == "Scene")
     {
-      this->dataPtr->requestMsg = msgs::CreateRequest("scene_info",
-                         this->dataPtr->selectedEntityName);
+      // Only the scene properties are shown, which are all in the first
+      // response. The chunks of models that follow don't match the request
+      // anymore, see OnResponse.
+      std::lock_guard<std::mutex> lock(this->dataPtr->requestMutex);
+      this->dataPtr->requestMsg = msgs::CreateRequest("scene_info_chunked");
       this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+
+      const int id = this->dataPtr->requestMsg->id();
+      QTimer::singleShot(SceneRequestTimeout, this, [this, id]()
+      {
+        std::lock_guard<std::mutex> timeoutLock(this->dataPtr->requestMutex);
+        if (!this->dataPtr->requestMsg ||
+            this->dataPtr->requestMsg->id() != id ||
+            !this->dataPtr->requestPub)
+        {
+          return;
+        }
+
+        delete this->dataPtr->requestMsg;
+        this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
+        this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+      });
     }
     else if (name == "Models")
     {
@@ -505,6 +529,7 @@ void ModelListWidget::ProcessModelMsgs()
 /////////////////////////////////////////////////
 void ModelListWidget::OnResponse(ConstResponsePtr &_msg)
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->requestMutex);
   if (!this->dataPtr->requestMsg || _msg->id() !=
       this->dataPtr->requestMsg->id())
     return;
@@ -21,6 +21,7 @@
 #include <list>
 #include <vector>
 #include <deque>
+#include <mutex>
 #include <sdf/sdf.hh>
 #include <ignition/msgs/plugin.pb.h>
 #include <ignition/transport/Node.hh>
@@ -91,6 +92,10 @@ namespace gazebo
 
       public: msgs::Request *requestMsg;
 
+      /// \brief Protects requestMsg against the responses and the fallback
+      /// of the scene request.
+      public: std::mutex requestMutex;
+
       public: std::vector<event::ConnectionPtr> connections;
 
       typedef std::list<msgs::Model> ModelMsgs_L;
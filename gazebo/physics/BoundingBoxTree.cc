@@ -0,0 +1,625 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/BoundingBoxTree.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Index of a missing node.
+static const int kNullNode = -1;
+
+/// \internal
+/// \brief Minimum and maximum corners of a box.
+struct TreeBox
+{
+  /// \brief Minimum corner.
+  ignition::math::Vector3d min;
+
+  /// \brief Maximum corner.
+  ignition::math::Vector3d max;
+
+  /// \brief Get the smallest box that contains two boxes.
+  /// \param[in] _a First box.
+  /// \param[in] _b Second box.
+  /// \return The union of the boxes.
+  static TreeBox Merge(const TreeBox &_a, const TreeBox &_b)
+  {
+    TreeBox result;
+    result.min.Set(std::min(_a.min.X(), _b.min.X()),
+        std::min(_a.min.Y(), _b.min.Y()), std::min(_a.min.Z(), _b.min.Z()));
+    result.max.Set(std::max(_a.max.X(), _b.max.X()),
+        std::max(_a.max.Y(), _b.max.Y()), std::max(_a.max.Z(), _b.max.Z()));
+    return result;
+  }
+
+  /// \brief Get the surface area of the box, used as the cost of a node.
+  /// \return Surface area.
+  double Area() const
+  {
+    ignition::math::Vector3d d = this->max - this->min;
+    return 2.0 * (d.X() * d.Y() + d.Y() * d.Z() + d.Z() * d.X());
+  }
+
+  /// \brief Check if the box contains another one.
+  /// \param[in] _other The other box.
+  /// \return True if _other is inside this box.
+  bool Contains(const TreeBox &_other) const
+  {
+    return this->min.X() <= _other.min.X() &&
+           this->min.Y() <= _other.min.Y() &&
+           this->min.Z() <= _other.min.Z() &&
+           this->max.X() >= _other.max.X() &&
+           this->max.Y() >= _other.max.Y() &&
+           this->max.Z() >= _other.max.Z();
+  }
+
+  /// \brief Check if the box intersects another one.
+  /// \param[in] _other The other box.
+  /// \return True if the boxes overlap or touch.
+  bool Intersects(const TreeBox &_other) const
+  {
+    return this->min.X() <= _other.max.X() &&
+           this->min.Y() <= _other.max.Y() &&
+           this->min.Z() <= _other.max.Z() &&
+           this->max.X() >= _other.min.X() &&
+           this->max.Y() >= _other.min.Y() &&
+           this->max.Z() >= _other.min.Z();
+  }
+
+  /// \brief Check if the box intersects a sphere.
+  /// \param[in] _center Center of the sphere.
+  /// \param[in] _radius Radius of the sphere.
+  /// \return True if they overlap or touch.
+  bool Intersects(const ignition::math::Vector3d &_center,
+      const double _radius) const
+  {
+    double dist2 = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      double d = 0;
+      if (_center[i] < this->min[i])
+        d = this->min[i] - _center[i];
+      else if (_center[i] > this->max[i])
+        d = _center[i] - this->max[i];
+      dist2 += d * d;
+    }
+    return dist2 <= _radius * _radius;
+  }
+
+  /// \brief Check if the box intersects a line segment, using the slab
+  /// method.
+  /// \param[in] _start Start of the segment.
+  /// \param[in] _dir End of the segment minus its start.
+  /// \return True if they intersect.
+  bool Intersects(const ignition::math::Vector3d &_start,
+      const ignition::math::Vector3d &_dir) const
+  {
+    double tmin = 0;
+    double tmax = 1;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (std::abs(_dir[i]) < 1e-12)
+      {
+        if (_start[i] < this->min[i] || _start[i] > this->max[i])
+          return false;
+        continue;
+      }
+
+      double t1 = (this->min[i] - _start[i]) / _dir[i];
+      double t2 = (this->max[i] - _start[i]) / _dir[i];
+      if (t1 > t2)
+        std::swap(t1, t2);
+      tmin = std::max(tmin, t1);
+      tmax = std::min(tmax, t2);
+      if (tmin > tmax)
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Convert to an ignition box.
+  /// \return The box.
+  ignition::math::AxisAlignedBox Ign() const
+  {
+    return ignition::math::AxisAlignedBox(this->min, this->max);
+  }
+};
+
+/// \internal
+/// \brief A node of the tree.
+struct TreeNode
+{
+  /// \brief Enlarged box for leaves, union of the children for internal
+  /// nodes.
+  TreeBox fat;
+
+  /// \brief Exact box of a leaf.
+  TreeBox box;
+
+  /// \brief Parent node, or next free node if the node is free.
+  int parent = kNullNode;
+
+  /// \brief First child, kNullNode for leaves.
+  int child1 = kNullNode;
+
+  /// \brief Second child, kNullNode for leaves.
+  int child2 = kNullNode;
+
+  /// \brief Height of the subtree, 0 for leaves, -1 for free nodes.
+  int height = -1;
+
+  /// \brief User value of a leaf.
+  uint32_t data = 0;
+
+  /// \brief Check if the node is a leaf.
+  /// \return True if the node has no children.
+  bool IsLeaf() const
+  {
+    return this->child1 == kNullNode;
+  }
+};
+
+/// \internal
+/// \brief Private data class for BoundingBoxTree
+class gazebo::physics::BoundingBoxTreePrivate
+{
+  /// \brief Take a node from the free list, growing the pool if needed.
+  /// \return Index of the node.
+  public: int Allocate()
+  {
+    if (this->freeList == kNullNode)
+    {
+      this->nodes.emplace_back();
+      this->nodes.back().height = 0;
+      return static_cast<int>(this->nodes.size()) - 1;
+    }
+
+    int index = this->freeList;
+    this->freeList = this->nodes[index].parent;
+    this->nodes[index] = TreeNode();
+    this->nodes[index].height = 0;
+    return index;
+  }
+
+  /// \brief Return a node to the free list.
+  /// \param[in] _index Index of the node.
+  public: void Free(const int _index)
+  {
+    this->nodes[_index].parent = this->freeList;
+    this->nodes[_index].height = -1;
+    this->freeList = _index;
+  }
+
+  /// \brief Insert a leaf, choosing its sibling with the surface area
+  /// heuristic.
+  /// \param[in] _leaf Index of the leaf.
+  public: void InsertLeaf(const int _leaf)
+  {
+    if (this->root == kNullNode)
+    {
+      this->root = _leaf;
+      this->nodes[_leaf].parent = kNullNode;
+      return;
+    }
+
+    const TreeBox leafBox = this->nodes[_leaf].fat;
+    int index = this->root;
+    while (!this->nodes[index].IsLeaf())
+    {
+      const TreeNode &node = this->nodes[index];
+      double area = node.fat.Area();
+      double combinedArea = TreeBox::Merge(node.fat, leafBox).Area();
+
+      // Cost of creating a new parent for this node and the new leaf
+      double cost = 2.0 * combinedArea;
+
+      // Minimum cost of pushing the leaf further down the tree
+      double inheritanceCost = 2.0 * (combinedArea - area);
+
+      double cost1 = this->DescendCost(node.child1, leafBox) +
+        inheritanceCost;
+      double cost2 = this->DescendCost(node.child2, leafBox) +
+        inheritanceCost;
+
+      if (cost < cost1 && cost < cost2)
+        break;
+
+      index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int sibling = index;
+    int oldParent = this->nodes[sibling].parent;
+    int newParent = this->Allocate();
+    this->nodes[newParent].parent = oldParent;
+    this->nodes[newParent].fat =
+      TreeBox::Merge(leafBox, this->nodes[sibling].fat);
+    this->nodes[newParent].height = this->nodes[sibling].height + 1;
+    this->nodes[newParent].child1 = sibling;
+    this->nodes[newParent].child2 = _leaf;
+    this->nodes[sibling].parent = newParent;
+    this->nodes[_leaf].parent = newParent;
+
+    if (oldParent == kNullNode)
+    {
+      this->root = newParent;
+    }
+    else if (this->nodes[oldParent].child1 == sibling)
+    {
+      this->nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+      this->nodes[oldParent].child2 = newParent;
+    }
+
+    this->Refit(this->nodes[_leaf].parent);
+  }
+
+  /// \brief Remove a leaf from the hierarchy, without freeing it.
+  /// \param[in] _leaf Index of the leaf.
+  public: void RemoveLeaf(const int _leaf)
+  {
+    if (_leaf == this->root)
+    {
+      this->root = kNullNode;
+      return;
+    }
+
+    int parent = this->nodes[_leaf].parent;
+    int grandParent = this->nodes[parent].parent;
+    int sibling = this->nodes[parent].child1 == _leaf ?
+      this->nodes[parent].child2 : this->nodes[parent].child1;
+
+    if (grandParent == kNullNode)
+    {
+      this->root = sibling;
+      this->nodes[sibling].parent = kNullNode;
+      this->Free(parent);
+      return;
+    }
+
+    if (this->nodes[grandParent].child1 == parent)
+      this->nodes[grandParent].child1 = sibling;
+    else
+      this->nodes[grandParent].child2 = sibling;
+    this->nodes[sibling].parent = grandParent;
+    this->Free(parent);
+
+    this->Refit(grandParent);
+  }
+
+  /// \brief Cost of descending into a child to insert a box.
+  /// \param[in] _child Index of the child.
+  /// \param[in] _box Box to insert.
+  /// \return Cost of the child.
+  public: double DescendCost(const int _child, const TreeBox &_box) const
+  {
+    const TreeNode &child = this->nodes[_child];
+    double combinedArea = TreeBox::Merge(child.fat, _box).Area();
+    if (child.IsLeaf())
+      return combinedArea;
+    return combinedArea - child.fat.Area();
+  }
+
+  /// \brief Walk up from a node, rebalancing and updating the boxes and
+  /// heights of its ancestors.
+  /// \param[in] _index Index of the first node to update.
+  public: void Refit(int _index)
+  {
+    while (_index != kNullNode)
+    {
+      _index = this->Balance(_index);
+
+      TreeNode &node = this->nodes[_index];
+      const TreeNode &child1 = this->nodes[node.child1];
+      const TreeNode &child2 = this->nodes[node.child2];
+      node.height = 1 + std::max(child1.height, child2.height);
+      node.fat = TreeBox::Merge(child1.fat, child2.fat);
+
+      _index = node.parent;
+    }
+  }
+
+  /// \brief Perform a left or right rotation if a node is imbalanced.
+  /// \param[in] _a Index of the node.
+  /// \return Index of the node that took the place of _a.
+  public: int Balance(const int _a)
+  {
+    TreeNode &a = this->nodes[_a];
+    if (a.IsLeaf() || a.height < 2)
+      return _a;
+
+    int ib = a.child1;
+    int ic = a.child2;
+    int balance = this->nodes[ic].height - this->nodes[ib].height;
+
+    if (balance > 1)
+      return this->Rotate(_a, ic, ib);
+    if (balance < -1)
+      return this->Rotate(_a, ib, ic);
+    return _a;
+  }
+
+  /// \brief Promote the higher child of a node.
+  /// \param[in] _a Index of the node.
+  /// \param[in] _high Index of the higher child, promoted in place of _a.
+  /// \param[in] _low Index of the other child.
+  /// \return Index of the promoted child.
+  public: int Rotate(const int _a, const int _high, const int _low)
+  {
+    TreeNode &a = this->nodes[_a];
+    TreeNode &h = this->nodes[_high];
+    int i1 = h.child1;
+    int i2 = h.child2;
+
+    // Swap a and high
+    h.child1 = _a;
+    h.parent = a.parent;
+    a.parent = _high;
+
+    if (h.parent == kNullNode)
+      this->root = _high;
+    else if (this->nodes[h.parent].child1 == _a)
+      this->nodes[h.parent].child1 = _high;
+    else
+      this->nodes[h.parent].child2 = _high;
+
+    // Keep the higher grandchild under high, move the other one to a
+    int keep = i1;
+    int move = i2;
+    if (this->nodes[i1].height < this->nodes[i2].height)
+      std::swap(keep, move);
+
+    h.child2 = keep;
+    if (a.child1 == _high)
+      a.child1 = move;
+    else
+      a.child2 = move;
+    this->nodes[move].parent = _a;
+
+    a.fat = TreeBox::Merge(this->nodes[_low].fat, this->nodes[move].fat);
+    h.fat = TreeBox::Merge(a.fat, this->nodes[keep].fat);
+    a.height = 1 + std::max(this->nodes[_low].height,
+        this->nodes[move].height);
+    h.height = 1 + std::max(a.height, this->nodes[keep].height);
+
+    return _high;
+  }
+
+  /// \brief Collect the user values of the leaves that pass a test.
+  /// \param[in] _test Test applied to the boxes of the nodes.
+  /// \param[out] _result User values of the leaves found.
+  public: template<typename Test>
+  void Query(const Test &_test, std::vector<uint32_t> &_result) const
+  {
+    if (this->root == kNullNode)
+      return;
+
+    std::vector<int> stack;
+    stack.push_back(this->root);
+    while (!stack.empty())
+    {
+      const TreeNode &node = this->nodes[stack.back()];
+      stack.pop_back();
+
+      if (!_test(node.fat))
+        continue;
+
+      if (node.IsLeaf())
+      {
+        if (_test(node.box))
+          _result.push_back(node.data);
+      }
+      else
+      {
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+      }
+    }
+  }
+
+  /// \brief Check that a proxy id refers to a leaf.
+  /// \param[in] _proxy Proxy id.
+  /// \return True if the proxy is valid.
+  public: bool Valid(const int _proxy) const
+  {
+    return _proxy >= 0 && _proxy < static_cast<int>(this->nodes.size()) &&
+      this->nodes[_proxy].height == 0;
+  }
+
+  /// \brief Node pool.
+  public: std::vector<TreeNode> nodes;
+
+  /// \brief Root of the tree.
+  public: int root = kNullNode;
+
+  /// \brief First free node of the pool.
+  public: int freeList = kNullNode;
+
+  /// \brief Number of leaves.
+  public: unsigned int count = 0;
+
+  /// \brief Margin of the leaves.
+  public: double margin = 0.1;
+};
+
+//////////////////////////////////////////////////
+BoundingBoxTree::BoundingBoxTree(const double _margin)
+  : dataPtr(new BoundingBoxTreePrivate)
+{
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
+
+//////////////////////////////////////////////////
+BoundingBoxTree::BoundingBoxTree(const BoundingBoxTree &_other)
+  : dataPtr(new BoundingBoxTreePrivate(*_other.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+BoundingBoxTree::~BoundingBoxTree()
+{
+}
+
+//////////////////////////////////////////////////
+BoundingBoxTree &BoundingBoxTree::operator=(const BoundingBoxTree &_other)
+{
+  if (this != &_other)
+    *this->dataPtr = *_other.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+int BoundingBoxTree::Insert(const ignition::math::AxisAlignedBox &_box,
+    const uint32_t _data)
+{
+  int leaf = this->dataPtr->Allocate();
+  TreeNode &node = this->dataPtr->nodes[leaf];
+  ignition::math::Vector3d margin(this->dataPtr->margin,
+      this->dataPtr->margin, this->dataPtr->margin);
+  node.box.min = _box.Min();
+  node.box.max = _box.Max();
+  node.fat.min = _box.Min() - margin;
+  node.fat.max = _box.Max() + margin;
+  node.data = _data;
+
+  this->dataPtr->InsertLeaf(leaf);
+  ++this->dataPtr->count;
+  return leaf;
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::Remove(const int _proxy)
+{
+  if (!this->dataPtr->Valid(_proxy))
+    return;
+
+  this->dataPtr->RemoveLeaf(_proxy);
+  this->dataPtr->Free(_proxy);
+  --this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+bool BoundingBoxTree::Update(const int _proxy,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  if (!this->dataPtr->Valid(_proxy))
+    return false;
+
+  TreeNode &node = this->dataPtr->nodes[_proxy];
+  node.box.min = _box.Min();
+  node.box.max = _box.Max();
+  if (node.fat.Contains(node.box))
+    return false;
+
+  ignition::math::Vector3d margin(this->dataPtr->margin,
+      this->dataPtr->margin, this->dataPtr->margin);
+  node.fat.min = _box.Min() - margin;
+  node.fat.max = _box.Max() + margin;
+  this->dataPtr->RemoveLeaf(_proxy);
+  this->dataPtr->InsertLeaf(_proxy);
+  return true;
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox BoundingBoxTree::Box(const int _proxy) const
+{
+  GZ_ASSERT(this->dataPtr->Valid(_proxy), "Invalid bounding box proxy");
+  return this->dataPtr->nodes[_proxy].box.Ign();
+}
+
+//////////////////////////////////////////////////
+uint32_t BoundingBoxTree::Data(const int _proxy) const
+{
+  GZ_ASSERT(this->dataPtr->Valid(_proxy), "Invalid bounding box proxy");
+  return this->dataPtr->nodes[_proxy].data;
+}
+
+//////////////////////////////////////////////////
+unsigned int BoundingBoxTree::Count() const
+{
+  return this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+unsigned int BoundingBoxTree::Height() const
+{
+  if (this->dataPtr->root == kNullNode)
+    return 0;
+  return this->dataPtr->nodes[this->dataPtr->root].height;
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->root = kNullNode;
+  this->dataPtr->freeList = kNullNode;
+  this->dataPtr->count = 0;
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::QueryBox(const ignition::math::AxisAlignedBox &_box,
+    std::vector<uint32_t> &_result) const
+{
+  TreeBox box;
+  box.min = _box.Min();
+  box.max = _box.Max();
+  this->dataPtr->Query([&box](const TreeBox &_b)
+      {
+        return _b.Intersects(box);
+      }, _result);
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::QuerySphere(const ignition::math::Vector3d &_center,
+    const double _radius, std::vector<uint32_t> &_result) const
+{
+  this->dataPtr->Query([&_center, _radius](const TreeBox &_b)
+      {
+        return _b.Intersects(_center, _radius);
+      }, _result);
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::QueryFrustum(const ignition::math::Frustum &_frustum,
+    std::vector<uint32_t> &_result) const
+{
+  this->dataPtr->Query([&_frustum](const TreeBox &_b)
+      {
+        return _frustum.Contains(_b.Ign());
+      }, _result);
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxTree::QueryRay(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end,
+    std::vector<uint32_t> &_result) const
+{
+  const ignition::math::Vector3d dir = _end - _start;
+  this->dataPtr->Query([&_start, &dir](const TreeBox &_b)
+      {
+        return _b.Intersects(_start, dir);
+      }, _result);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BOUNDINGBOXTREE_HH_
+#define GAZEBO_PHYSICS_BOUNDINGBOXTREE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BoundingBoxTreePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class BoundingBoxTree BoundingBoxTree.hh physics/physics.hh
+    /// \brief Dynamic bounding volume hierarchy of axis aligned boxes.
+    ///
+    /// Each box is stored in a leaf together with a user value, and
+    /// identified by a proxy id returned by Insert. The tree is kept
+    /// balanced on insertion. Leaves are enlarged by a margin, so that a
+    /// box that moves a little stays in its leaf and Update is cheap.
+    /// Queries test the exact boxes, the margin never causes false
+    /// positives.
+    ///
+    /// The tree is not thread safe.
+    class GZ_PHYSICS_VISIBLE BoundingBoxTree
+    {
+      /// \brief Constructor.
+      /// \param[in] _margin Distance by which the leaves are enlarged on
+      /// each side of the boxes.
+      public: explicit BoundingBoxTree(const double _margin = 0.1);
+
+      /// \brief Copy constructor. The proxy ids of the copy are the ones
+      /// of the original.
+      /// \param[in] _other Tree to copy.
+      public: BoundingBoxTree(const BoundingBoxTree &_other);
+
+      /// \brief Destructor.
+      public: virtual ~BoundingBoxTree();
+
+      /// \brief Assignment operator.
+      /// \param[in] _other Tree to copy.
+      /// \return Reference to this tree.
+      public: BoundingBoxTree &operator=(const BoundingBoxTree &_other);
+
+      /// \brief Insert a box.
+      /// \param[in] _box Box to insert.
+      /// \param[in] _data User value returned by the queries.
+      /// \return Proxy id of the box.
+      public: int Insert(const ignition::math::AxisAlignedBox &_box,
+                  const uint32_t _data);
+
+      /// \brief Remove a box.
+      /// \param[in] _proxy Proxy id returned by Insert.
+      public: void Remove(const int _proxy);
+
+      /// \brief Change a box.
+      /// \param[in] _proxy Proxy id returned by Insert.
+      /// \param[in] _box New box.
+      /// \return True if the box left its leaf and was reinserted.
+      public: bool Update(const int _proxy,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Get a box.
+      /// \param[in] _proxy Proxy id returned by Insert.
+      /// \return The box, as last inserted or updated.
+      public: ignition::math::AxisAlignedBox Box(const int _proxy) const;
+
+      /// \brief Get the user value of a box.
+      /// \param[in] _proxy Proxy id returned by Insert.
+      /// \return The user value.
+      public: uint32_t Data(const int _proxy) const;
+
+      /// \brief Get the number of boxes.
+      /// \return Number of boxes.
+      public: unsigned int Count() const;
+
+      /// \brief Get the height of the tree. A tree with a single box has a
+      /// height of 0.
+      /// \return Height of the tree, 0 if it is empty.
+      public: unsigned int Height() const;
+
+      /// \brief Remove all the boxes.
+      public: void Clear();
+
+      /// \brief Find the boxes that intersect a box.
+      /// \param[in] _box Box to test.
+      /// \param[out] _result User values of the boxes found are appended.
+      public: void QueryBox(const ignition::math::AxisAlignedBox &_box,
+                  std::vector<uint32_t> &_result) const;
+
+      /// \brief Find the boxes that intersect a sphere.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[out] _result User values of the boxes found are appended.
+      public: void QuerySphere(const ignition::math::Vector3d &_center,
+                  const double _radius, std::vector<uint32_t> &_result) const;
+
+      /// \brief Find the boxes that intersect a frustum, using the same test
+      /// as ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Frustum to test.
+      /// \param[out] _result User values of the boxes found are appended.
+      public: void QueryFrustum(const ignition::math::Frustum &_frustum,
+                  std::vector<uint32_t> &_result) const;
+
+      /// \brief Find the boxes that intersect a line segment.
+      /// \param[in] _start Start of the segment.
+      /// \param[in] _end End of the segment.
+      /// \param[out] _result User values of the boxes found are appended.
+      public: void QueryRay(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end,
+                  std::vector<uint32_t> &_result) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BoundingBoxTreePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/BoundingBoxTree.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class BoundingBoxTreeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Sort the result of a query.
+std::vector<uint32_t> Sorted(std::vector<uint32_t> _values)
+{
+  std::sort(_values.begin(), _values.end());
+  return _values;
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, InsertRemove)
+{
+  physics::BoundingBoxTree tree;
+  EXPECT_EQ(0u, tree.Count());
+  EXPECT_EQ(0u, tree.Height());
+
+  ignition::math::AxisAlignedBox a(
+      ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(1, 1, 1));
+  ignition::math::AxisAlignedBox b(
+      ignition::math::Vector3d(5, 0, 0), ignition::math::Vector3d(6, 1, 1));
+
+  int pa = tree.Insert(a, 10);
+  int pb = tree.Insert(b, 20);
+  EXPECT_NE(pa, pb);
+  EXPECT_EQ(2u, tree.Count());
+  EXPECT_EQ(1u, tree.Height());
+  EXPECT_EQ(a, tree.Box(pa));
+  EXPECT_EQ(20u, tree.Data(pb));
+
+  std::vector<uint32_t> result;
+  tree.QueryBox(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(-1, -1, -1),
+      ignition::math::Vector3d(10, 10, 10)), result);
+  EXPECT_EQ(std::vector<uint32_t>({10, 20}), Sorted(result));
+
+  // The margin of the leaves does not cause false positives
+  result.clear();
+  tree.QueryBox(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(1.05, 0, 0),
+      ignition::math::Vector3d(1.08, 1, 1)), result);
+  EXPECT_TRUE(result.empty());
+
+  tree.Remove(pa);
+  EXPECT_EQ(1u, tree.Count());
+  result.clear();
+  tree.QuerySphere(ignition::math::Vector3d(0, 0, 0), 100, result);
+  EXPECT_EQ(std::vector<uint32_t>({20}), result);
+
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Count());
+  result.clear();
+  tree.QuerySphere(ignition::math::Vector3d(0, 0, 0), 100, result);
+  EXPECT_TRUE(result.empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Update)
+{
+  physics::BoundingBoxTree tree(0.5);
+  ignition::math::AxisAlignedBox box(
+      ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(1, 1, 1));
+  int proxy = tree.Insert(box, 1);
+  tree.Insert(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(10, 0, 0),
+      ignition::math::Vector3d(11, 1, 1)), 2);
+
+  // A small move stays inside the enlarged leaf
+  ignition::math::Vector3d step(0.2, 0, 0);
+  EXPECT_FALSE(tree.Update(proxy, box + step));
+  EXPECT_EQ(box + step, tree.Box(proxy));
+
+  // A large move reinserts the leaf
+  ignition::math::Vector3d jump(0, 20, 0);
+  EXPECT_TRUE(tree.Update(proxy, box + jump));
+
+  std::vector<uint32_t> result;
+  tree.QueryBox(box, result);
+  EXPECT_TRUE(result.empty());
+  tree.QueryBox(box + jump, result);
+  EXPECT_EQ(std::vector<uint32_t>({1}), result);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Copy)
+{
+  physics::BoundingBoxTree tree(0.0);
+  ignition::math::AxisAlignedBox box(
+      ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(1, 1, 1));
+  int proxy = tree.Insert(box, 1);
+
+  // The copy keeps the proxy ids and changes independently
+  physics::BoundingBoxTree copy(tree);
+  ignition::math::Vector3d jump(0, 20, 0);
+  copy.Update(proxy, box + jump);
+  EXPECT_EQ(1u, copy.Count());
+  EXPECT_EQ(box, tree.Box(proxy));
+  EXPECT_EQ(box + jump, copy.Box(proxy));
+
+  std::vector<uint32_t> result;
+  copy.QueryBox(box, result);
+  EXPECT_TRUE(result.empty());
+  tree.QueryBox(box, result);
+  EXPECT_EQ(std::vector<uint32_t>({1}), result);
+
+  tree = copy;
+  EXPECT_EQ(box + jump, tree.Box(proxy));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Ray)
+{
+  physics::BoundingBoxTree tree;
+  for (int i = 0; i < 10; ++i)
+  {
+    ignition::math::Vector3d min(i * 2.0, 0, 0);
+    tree.Insert(ignition::math::AxisAlignedBox(min,
+        min + ignition::math::Vector3d(1, 1, 1)), i);
+  }
+
+  // Along the row of boxes, stopping inside the fourth box
+  std::vector<uint32_t> result;
+  tree.QueryRay(ignition::math::Vector3d(-1, 0.5, 0.5),
+      ignition::math::Vector3d(6.5, 0.5, 0.5), result);
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3}), Sorted(result));
+
+  // Through the gaps
+  result.clear();
+  tree.QueryRay(ignition::math::Vector3d(1.5, -1, 0.5),
+      ignition::math::Vector3d(1.5, 2, 0.5), result);
+  EXPECT_TRUE(result.empty());
+
+  // Degenerate segment
+  result.clear();
+  tree.QueryRay(ignition::math::Vector3d(4.5, 0.5, 0.5),
+      ignition::math::Vector3d(4.5, 0.5, 0.5), result);
+  EXPECT_EQ(std::vector<uint32_t>({2}), result);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Frustum)
+{
+  physics::BoundingBoxTree tree;
+  tree.Insert(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(4, -0.5, -0.5),
+      ignition::math::Vector3d(5, 0.5, 0.5)), 1);
+  tree.Insert(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(-5, -0.5, -0.5),
+      ignition::math::Vector3d(-4, 0.5, 0.5)), 2);
+  tree.Insert(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(4, 10, -0.5),
+      ignition::math::Vector3d(5, 11, 0.5)), 3);
+
+  // Looking down the x axis
+  ignition::math::Frustum frustum(0.1, 10, IGN_DTOR(60), 1.0,
+      ignition::math::Pose3d::Zero);
+
+  std::vector<uint32_t> result;
+  tree.QueryFrustum(frustum, result);
+  EXPECT_EQ(std::vector<uint32_t>({1}), result);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Random)
+{
+  ignition::math::Rand::Seed(7);
+  physics::BoundingBoxTree tree;
+
+  // Proxies and boxes in the tree, by user value
+  std::map<uint32_t, std::pair<int, ignition::math::AxisAlignedBox>> boxes;
+
+  auto randomBox = []()
+  {
+    ignition::math::Vector3d center(
+        ignition::math::Rand::DblUniform(-50, 50),
+        ignition::math::Rand::DblUniform(-50, 50),
+        ignition::math::Rand::DblUniform(-50, 50));
+    ignition::math::Vector3d half(
+        ignition::math::Rand::DblUniform(0.1, 2),
+        ignition::math::Rand::DblUniform(0.1, 2),
+        ignition::math::Rand::DblUniform(0.1, 2));
+    return ignition::math::AxisAlignedBox(center - half, center + half);
+  };
+
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    ignition::math::AxisAlignedBox box = randomBox();
+    boxes[i] = std::make_pair(tree.Insert(box, i), box);
+  }
+
+  // Move and remove boxes
+  for (int i = 0; i < 2000; ++i)
+  {
+    auto iter = boxes.begin();
+    std::advance(iter, ignition::math::Rand::IntUniform(0, boxes.size() - 1));
+    if (i % 4 == 0)
+    {
+      tree.Remove(iter->second.first);
+      boxes.erase(iter);
+    }
+    else
+    {
+      ignition::math::Vector3d offset(
+          ignition::math::Rand::DblUniform(-1, 1),
+          ignition::math::Rand::DblUniform(-1, 1),
+          ignition::math::Rand::DblUniform(-1, 1));
+      iter->second.second = iter->second.second + offset;
+      tree.Update(iter->second.first, iter->second.second);
+    }
+  }
+  ASSERT_EQ(boxes.size(), tree.Count());
+
+  // A balanced tree is far from the height of a list
+  EXPECT_LT(tree.Height(), 30u);
+
+  // Queries match a brute force search
+  for (int i = 0; i < 50; ++i)
+  {
+    ignition::math::AxisAlignedBox query = randomBox();
+    query = ignition::math::AxisAlignedBox(
+        query.Min() - ignition::math::Vector3d(5, 5, 5),
+        query.Max() + ignition::math::Vector3d(5, 5, 5));
+
+    std::vector<uint32_t> expected;
+    for (auto const &b : boxes)
+    {
+      if (b.second.second.Intersects(query))
+        expected.push_back(b.first);
+    }
+
+    std::vector<uint32_t> result;
+    tree.QueryBox(query, result);
+    EXPECT_EQ(expected, Sorted(result));
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
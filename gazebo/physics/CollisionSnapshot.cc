@@ -0,0 +1,1120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Matrix3.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/physics/BoundingBoxTree.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/SurfaceParams.hh"
+#include "gazebo/physics/CollisionSnapshot.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Vertices of the triangles of a mesh, shared between snapshots.
+using SnapshotTriangles =
+    std::shared_ptr<const std::vector<ignition::math::Vector3d>>;
+
+/// \brief Maximum number of steps of a sphere tracing sweep.
+static const int kSweepIterations = 100;
+
+/// \brief Distance under which a sweep touches a collision.
+static const double kSweepTolerance = 1e-6;
+
+/// \brief Version of the next snapshot created.
+static std::atomic<uint64_t> g_nextVersion{1};
+
+/// \brief Number of entries in a block of a snapshot.
+static const uint32_t kEntryBlockSize = 64;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A collision of a snapshot.
+    class CollisionSnapshotEntry
+    {
+      /// \brief Geometry of a collision.
+      public: enum Kind {BOX, SPHERE, CYLINDER, PLANE, MESH, BOUNDS};
+
+      /// \brief Geometry of the collision.
+      public: Kind kind = BOUNDS;
+
+      /// \brief Id of the collision.
+      public: uint32_t id = 0;
+
+      /// \brief Scoped name of the collision.
+      public: std::string name;
+
+      /// \brief World pose of the collision.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief World bounding box of the collision.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Half size of a box. Radius and half length of a cylinder
+      /// in X and Z. Radius of a sphere in X. Unit normal of a plane in the
+      /// world frame. Scale of a mesh.
+      public: ignition::math::Vector3d size;
+
+      /// \brief Center and half size of the scaled box of a mesh, in the
+      /// frame of the mesh.
+      public: ignition::math::Vector3d meshCenter;
+
+      /// \brief See meshCenter.
+      public: ignition::math::Vector3d meshHalf;
+
+      /// \brief Triangles of a mesh.
+      public: SnapshotTriangles triangles;
+
+      /// \brief Proxy of the box in the tree, -1 if the entry is not
+      /// bounded.
+      public: int proxy = -1;
+    };
+
+    /// \internal
+    /// \brief Part of a snapshot that is shared with the snapshots copied
+    /// from it. A snapshot copies it the first time it changes it, so that
+    /// a copy only costs a pointer per part.
+    template<typename T>
+    class SnapshotShared
+    {
+      /// \brief Get the value.
+      /// \return The value.
+      public: const T &Get() const
+      {
+        static const T empty;
+        return this->value ? *this->value : empty;
+      }
+
+      /// \brief Get the value to change it, after copying it if it is
+      /// not owned by the snapshot.
+      /// \param[in] _version Version of the snapshot.
+      /// \return The value.
+      public: T &Mutable(const uint64_t _version)
+      {
+        if (!this->value)
+          this->value = std::make_shared<T>();
+        else if (this->owner != _version)
+          this->value = std::make_shared<T>(*this->value);
+        this->owner = _version;
+        return *this->value;
+      }
+
+      /// \brief The value, null until it is first changed.
+      private: std::shared_ptr<T> value;
+
+      /// \brief Version of the snapshot that may change the value.
+      private: uint64_t owner = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for CollisionSnapshot.
+    class CollisionSnapshotPrivate
+    {
+      /// \brief Get an entry.
+      /// \param[in] _index Index of the entry.
+      /// \return The entry.
+      public: const CollisionSnapshotEntry &Entry(const uint32_t _index) const
+      {
+        return this->blocks[_index / kEntryBlockSize].Get()[
+          _index % kEntryBlockSize];
+      }
+
+      /// \brief Get an entry to change it.
+      /// \param[in] _index Index of the entry.
+      /// \return The entry.
+      public: CollisionSnapshotEntry &MutableEntry(const uint32_t _index)
+      {
+        return this->blocks[_index / kEntryBlockSize].Mutable(
+          this->version)[_index % kEntryBlockSize];
+      }
+
+      /// \brief Simulation time of the snapshot.
+      public: common::Time simTime;
+
+      /// \brief World iterations of the snapshot.
+      public: uint64_t iterations = 0;
+
+      /// \brief Version of the snapshot.
+      public: uint64_t version = 0;
+
+      /// \brief The collisions, in blocks of kEntryBlockSize entries. A
+      /// snapshot copied from another one shares the blocks it does not
+      /// change.
+      public: std::vector<SnapshotShared<
+                std::vector<CollisionSnapshotEntry>>> blocks;
+
+      /// \brief Number of entries.
+      public: uint32_t count = 0;
+
+      /// \brief Index of the entries, by collision id.
+      public: SnapshotShared<std::unordered_map<uint32_t, uint32_t>> index;
+
+      /// \brief Boxes of the bounded entries. The user value of each box is
+      /// the index of its entry.
+      public: BoundingBoxTree tree{0.0};
+
+      /// \brief Indices of the entries that are not bounded, such as
+      /// planes. They are tested by every query.
+      public: SnapshotShared<std::vector<uint32_t>> unbounded;
+
+      /// \brief Triangles of the meshes, by URI.
+      public: SnapshotShared<std::map<std::string, SnapshotTriangles>>
+                meshes;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Signed distance from a point to a box centered at the origin.
+/// \param[in] _p The point.
+/// \param[in] _half Half size of the box.
+/// \return Distance, negative inside the box.
+static double BoxDistance(const ignition::math::Vector3d &_p,
+    const ignition::math::Vector3d &_half)
+{
+  ignition::math::Vector3d q(std::abs(_p.X()) - _half.X(),
+      std::abs(_p.Y()) - _half.Y(), std::abs(_p.Z()) - _half.Z());
+  ignition::math::Vector3d outside(std::max(q.X(), 0.0),
+      std::max(q.Y(), 0.0), std::max(q.Z(), 0.0));
+  return outside.Length() + std::min(q.Max(), 0.0);
+}
+
+//////////////////////////////////////////////////
+/// \brief Signed distance from a point to a collision. Meshes and bounds
+/// use their box.
+/// \param[in] _entry The collision.
+/// \param[in] _p Point in the world frame.
+/// \return Distance, negative inside the collision.
+static double Distance(const CollisionSnapshotEntry &_entry,
+    const ignition::math::Vector3d &_p)
+{
+  ignition::math::Vector3d local =
+    _entry.pose.Rot().RotateVectorReverse(_p - _entry.pose.Pos());
+
+  switch (_entry.kind)
+  {
+    case CollisionSnapshotEntry::BOX:
+      return BoxDistance(local, _entry.size);
+    case CollisionSnapshotEntry::SPHERE:
+      return local.Length() - _entry.size.X();
+    case CollisionSnapshotEntry::CYLINDER:
+    {
+      double dr = std::hypot(local.X(), local.Y()) - _entry.size.X();
+      double dz = std::abs(local.Z()) - _entry.size.Z();
+      return std::min(std::max(dr, dz), 0.0) +
+        std::hypot(std::max(dr, 0.0), std::max(dz, 0.0));
+    }
+    case CollisionSnapshotEntry::PLANE:
+      return _entry.size.Dot(_p - _entry.pose.Pos());
+    case CollisionSnapshotEntry::MESH:
+      return BoxDistance(local - _entry.meshCenter, _entry.meshHalf);
+    case CollisionSnapshotEntry::BOUNDS:
+    default:
+      return BoxDistance(_p - _entry.box.Center(), _entry.box.Size() * 0.5);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a segment with a box.
+/// \param[in] _o Start of the segment.
+/// \param[in] _d Vector from the start to the end of the segment.
+/// \param[in] _min Minimum corner of the box.
+/// \param[in] _max Maximum corner of the box.
+/// \param[out] _t Fraction of the segment at the hit.
+/// \param[out] _n Normal at the hit, zero if the segment starts inside.
+/// \return True if the segment hits the box.
+static bool RayBox(const ignition::math::Vector3d &_o,
+    const ignition::math::Vector3d &_d, const ignition::math::Vector3d &_min,
+    const ignition::math::Vector3d &_max, double &_t,
+    ignition::math::Vector3d &_n)
+{
+  double tmin = 0;
+  double tmax = 1;
+  int axis = -1;
+  double sign = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::abs(_d[i]) < 1e-12)
+    {
+      if (_o[i] < _min[i] || _o[i] > _max[i])
+        return false;
+      continue;
+    }
+
+    double t1 = (_min[i] - _o[i]) / _d[i];
+    double t2 = (_max[i] - _o[i]) / _d[i];
+    double s = -1;
+    if (t1 > t2)
+    {
+      std::swap(t1, t2);
+      s = 1;
+    }
+    if (t1 > tmin)
+    {
+      tmin = t1;
+      axis = i;
+      sign = s;
+    }
+    tmax = std::min(tmax, t2);
+    if (tmin > tmax)
+      return false;
+  }
+
+  _t = tmin;
+  _n = ignition::math::Vector3d::Zero;
+  if (axis >= 0)
+    _n[axis] = sign;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a segment with a sphere centered at the origin.
+/// \param[in] _o Start of the segment.
+/// \param[in] _d Vector from the start to the end of the segment.
+/// \param[in] _radius Radius of the sphere.
+/// \param[out] _t Fraction of the segment at the hit.
+/// \param[out] _n Normal at the hit, zero if the segment starts inside.
+/// \return True if the segment hits the sphere.
+static bool RaySphere(const ignition::math::Vector3d &_o,
+    const ignition::math::Vector3d &_d, const double _radius, double &_t,
+    ignition::math::Vector3d &_n)
+{
+  double c = _o.SquaredLength() - _radius * _radius;
+  if (c <= 0)
+  {
+    _t = 0;
+    _n = ignition::math::Vector3d::Zero;
+    return true;
+  }
+
+  double a = _d.SquaredLength();
+  double b = _o.Dot(_d);
+  double disc = b * b - a * c;
+  if (a <= 0 || disc < 0)
+    return false;
+
+  double t = (-b - std::sqrt(disc)) / a;
+  if (t < 0 || t > 1)
+    return false;
+
+  _t = t;
+  _n = (_o + _d * t) / _radius;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a segment with a cylinder centered at the origin, with
+/// its axis along Z.
+/// \param[in] _o Start of the segment.
+/// \param[in] _d Vector from the start to the end of the segment.
+/// \param[in] _radius Radius of the cylinder.
+/// \param[in] _half Half length of the cylinder.
+/// \param[out] _t Fraction of the segment at the hit.
+/// \param[out] _n Normal at the hit, zero if the segment starts inside.
+/// \return True if the segment hits the cylinder.
+static bool RayCylinder(const ignition::math::Vector3d &_o,
+    const ignition::math::Vector3d &_d, const double _radius,
+    const double _half, double &_t, ignition::math::Vector3d &_n)
+{
+  double r2 = _radius * _radius;
+  double c = _o.X() * _o.X() + _o.Y() * _o.Y() - r2;
+  if (c <= 0 && std::abs(_o.Z()) <= _half)
+  {
+    _t = 0;
+    _n = ignition::math::Vector3d::Zero;
+    return true;
+  }
+
+  bool hit = false;
+  double best = 2;
+
+  // Side
+  double a = _d.X() * _d.X() + _d.Y() * _d.Y();
+  if (a > 0)
+  {
+    double b = _o.X() * _d.X() + _o.Y() * _d.Y();
+    double disc = b * b - a * c;
+    if (disc >= 0)
+    {
+      double t = (-b - std::sqrt(disc)) / a;
+      ignition::math::Vector3d p = _o + _d * t;
+      if (t >= 0 && t <= 1 && std::abs(p.Z()) <= _half)
+      {
+        best = t;
+        _n.Set(p.X() / _radius, p.Y() / _radius, 0);
+        hit = true;
+      }
+    }
+  }
+
+  // Caps
+  if (std::abs(_d.Z()) > 0)
+  {
+    for (double side : {-1.0, 1.0})
+    {
+      double t = (side * _half - _o.Z()) / _d.Z();
+      ignition::math::Vector3d p = _o + _d * t;
+      if (t >= 0 && t < best && p.X() * p.X() + p.Y() * p.Y() <= r2)
+      {
+        best = t;
+        _n.Set(0, 0, side);
+        hit = true;
+      }
+    }
+  }
+
+  if (hit)
+    _t = best;
+  return hit;
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a segment with the triangles of a mesh.
+/// \param[in] _o Start of the segment, in the unscaled mesh frame.
+/// \param[in] _d Vector from the start to the end of the segment, in the
+/// unscaled mesh frame.
+/// \param[in] _scale Scale of the mesh.
+/// \param[in] _triangles Vertices of the triangles.
+/// \param[out] _t Fraction of the segment at the hit.
+/// \param[out] _n Normal at the hit, in the scaled mesh frame.
+/// \return True if the segment hits a triangle.
+static bool RayTriangles(const ignition::math::Vector3d &_o,
+    const ignition::math::Vector3d &_d, const ignition::math::Vector3d &_scale,
+    const std::vector<ignition::math::Vector3d> &_triangles, double &_t,
+    ignition::math::Vector3d &_n)
+{
+  bool hit = false;
+  double best = 2;
+  for (size_t i = 0; i + 2 < _triangles.size(); i += 3)
+  {
+    // Moller-Trumbore, from both sides
+    const ignition::math::Vector3d &v0 = _triangles[i];
+    ignition::math::Vector3d e1 = _triangles[i + 1] - v0;
+    ignition::math::Vector3d e2 = _triangles[i + 2] - v0;
+    ignition::math::Vector3d p = _d.Cross(e2);
+    double det = e1.Dot(p);
+    if (std::abs(det) < 1e-15)
+      continue;
+
+    double inv = 1.0 / det;
+    ignition::math::Vector3d s = _o - v0;
+    double u = s.Dot(p) * inv;
+    if (u < 0 || u > 1)
+      continue;
+
+    ignition::math::Vector3d q = s.Cross(e1);
+    double v = _d.Dot(q) * inv;
+    if (v < 0 || u + v > 1)
+      continue;
+
+    double t = e2.Dot(q) * inv;
+    if (t < 0 || t >= best)
+      continue;
+
+    best = t;
+    _n = (e1 * _scale).Cross(e2 * _scale);
+    hit = true;
+  }
+
+  if (!hit || best > 1)
+    return false;
+
+  _t = best;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a segment with a collision.
+/// \param[in] _entry The collision.
+/// \param[in] _start Start of the segment in the world frame.
+/// \param[in] _dir Vector from the start to the end of the segment.
+/// \param[out] _t Fraction of the segment at the hit.
+/// \param[out] _n Normal at the hit in the world frame, zero if the
+/// segment starts inside the collision.
+/// \return True if the segment hits the collision.
+static bool Intersect(const CollisionSnapshotEntry &_entry,
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_dir, double &_t,
+    ignition::math::Vector3d &_n)
+{
+  const ignition::math::Quaterniond &rot = _entry.pose.Rot();
+  ignition::math::Vector3d o =
+    rot.RotateVectorReverse(_start - _entry.pose.Pos());
+  ignition::math::Vector3d d = rot.RotateVectorReverse(_dir);
+
+  bool hit = false;
+  switch (_entry.kind)
+  {
+    case CollisionSnapshotEntry::BOX:
+      hit = RayBox(o, d, -_entry.size, _entry.size, _t, _n);
+      break;
+    case CollisionSnapshotEntry::SPHERE:
+      hit = RaySphere(o, d, _entry.size.X(), _t, _n);
+      break;
+    case CollisionSnapshotEntry::CYLINDER:
+      hit = RayCylinder(o, d, _entry.size.X(), _entry.size.Z(), _t, _n);
+      break;
+    case CollisionSnapshotEntry::PLANE:
+    {
+      // The half space below the plane is solid
+      double height = _entry.size.Dot(_start - _entry.pose.Pos());
+      double speed = _entry.size.Dot(_dir);
+      if (height <= 0)
+      {
+        _t = 0;
+        _n = ignition::math::Vector3d::Zero;
+        return true;
+      }
+      if (speed >= 0 || -height / speed > 1)
+        return false;
+      _t = -height / speed;
+      _n = _entry.size;
+      return true;
+    }
+    case CollisionSnapshotEntry::MESH:
+    {
+      const ignition::math::Vector3d &scale = _entry.size;
+      if (!_entry.triangles || ignition::math::equal(scale.X(), 0.0) ||
+          ignition::math::equal(scale.Y(), 0.0) ||
+          ignition::math::equal(scale.Z(), 0.0))
+      {
+        return false;
+      }
+      hit = RayTriangles(o / scale, d / scale, scale, *_entry.triangles, _t,
+          _n);
+      break;
+    }
+    case CollisionSnapshotEntry::BOUNDS:
+    default:
+      return RayBox(_start, _dir, _entry.box.Min(), _entry.box.Max(), _t, _n);
+  }
+
+  if (hit)
+    _n = rot.RotateVector(_n);
+  return hit;
+}
+
+//////////////////////////////////////////////////
+/// \brief Fill a hit, pointing the normal against the query direction.
+/// \param[in] _entry The collision hit.
+/// \param[in] _point Point of the hit.
+/// \param[in] _distance Distance travelled by the query.
+/// \param[in] _dir Direction of the query.
+/// \param[in] _normal Normal of the collision, may be zero.
+/// \param[out] _hit The hit.
+static void FillHit(const CollisionSnapshotEntry &_entry,
+    const ignition::math::Vector3d &_point, const double _distance,
+    const ignition::math::Vector3d &_dir, ignition::math::Vector3d _normal,
+    CollisionSnapshotHit &_hit)
+{
+  if (_normal == ignition::math::Vector3d::Zero)
+    _normal = -_dir;
+  else if (_normal.Dot(_dir) > 0)
+    _normal = -_normal;
+  if (_normal == ignition::math::Vector3d::Zero)
+    _normal = ignition::math::Vector3d::UnitZ;
+
+  _hit.collision = _entry.id;
+  _hit.name = _entry.name;
+  _hit.distance = _distance;
+  _hit.point = _point;
+  _hit.normal = _normal.Normalized();
+}
+
+//////////////////////////////////////////////////
+/// \brief Add the triangles of a mesh to a list.
+/// \param[in] _mesh The mesh.
+/// \param[in,out] _triangles Vertices of the triangles.
+static void CollectTriangles(const common::Mesh &_mesh,
+    std::vector<ignition::math::Vector3d> &_triangles)
+{
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *submesh = _mesh.GetSubMesh(i);
+    if (!submesh || submesh->GetPrimitiveType() != common::SubMesh::TRIANGLES)
+      continue;
+
+    if (submesh->GetIndexCount() > 0)
+    {
+      for (unsigned int j = 0; j + 2 < submesh->GetIndexCount(); j += 3)
+      {
+        for (unsigned int k = 0; k < 3; ++k)
+          _triangles.push_back(submesh->Vertex(submesh->GetIndex(j + k)));
+      }
+    }
+    else
+    {
+      for (unsigned int j = 0; j + 2 < submesh->GetVertexCount(); j += 3)
+      {
+        for (unsigned int k = 0; k < 3; ++k)
+          _triangles.push_back(submesh->Vertex(j + k));
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+CollisionSnapshot::CollisionSnapshot(const common::Time &_simTime,
+    const uint64_t _iterations)
+  : dataPtr(new CollisionSnapshotPrivate)
+{
+  this->dataPtr->simTime = _simTime;
+  this->dataPtr->iterations = _iterations;
+  this->dataPtr->version = g_nextVersion++;
+}
+
+//////////////////////////////////////////////////
+CollisionSnapshot::~CollisionSnapshot()
+{
+}
+
+//////////////////////////////////////////////////
+CollisionSnapshot::CollisionSnapshot(const CollisionSnapshot &_other,
+    const common::Time &_simTime, const uint64_t _iterations)
+  : dataPtr(new CollisionSnapshotPrivate(*_other.dataPtr))
+{
+  this->dataPtr->simTime = _simTime;
+  this->dataPtr->iterations = _iterations;
+  this->dataPtr->version = g_nextVersion++;
+}
+
+//////////////////////////////////////////////////
+CollisionSnapshotPtr CollisionSnapshot::Build(const Model_V &_models,
+    const common::Time &_simTime, const uint64_t _iterations,
+    const CollisionSnapshotPtr &_previous)
+{
+  auto snapshot = std::make_shared<CollisionSnapshot>(_simTime, _iterations);
+
+  std::vector<ModelPtr> stack(_models.rbegin(), _models.rend());
+  while (!stack.empty())
+  {
+    ModelPtr model = stack.back();
+    stack.pop_back();
+
+    snapshot->AddModel(model, _previous);
+
+    Model_V nested = model->NestedModels();
+    stack.insert(stack.end(), nested.rbegin(), nested.rend());
+  }
+
+  return snapshot;
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddModel(const ModelPtr &_model,
+    const CollisionSnapshotPtr &_previous)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &collision : link->GetCollisions())
+    {
+      ShapePtr shape = collision->GetShape();
+      if (!shape || shape->HasType(Base::RAY_SHAPE) ||
+          shape->HasType(Base::MULTIRAY_SHAPE))
+      {
+        continue;
+      }
+
+      // Sensor volumes do not block anything
+      SurfaceParamsPtr surface = collision->GetSurface();
+      if (surface && surface->collideWithoutContact)
+        continue;
+
+      uint32_t id = collision->GetId();
+      std::string name = collision->GetScopedName();
+      ignition::math::Pose3d pose = collision->WorldPose();
+
+      if (shape->HasType(Base::BOX_SHAPE))
+      {
+        auto box = boost::static_pointer_cast<BoxShape>(shape);
+        this->AddBox(id, name, pose, box->Size());
+      }
+      else if (shape->HasType(Base::SPHERE_SHAPE))
+      {
+        auto sphere = boost::static_pointer_cast<SphereShape>(shape);
+        this->AddSphere(id, name, pose, sphere->GetRadius());
+      }
+      else if (shape->HasType(Base::CYLINDER_SHAPE))
+      {
+        auto cylinder = boost::static_pointer_cast<CylinderShape>(shape);
+        this->AddCylinder(id, name, pose, cylinder->GetRadius(),
+            cylinder->GetLength());
+      }
+      else if (shape->HasType(Base::PLANE_SHAPE))
+      {
+        auto plane = boost::static_pointer_cast<PlaneShape>(shape);
+        this->AddPlane(id, name, pose, plane->Normal());
+      }
+      else if (shape->HasType(Base::MESH_SHAPE))
+      {
+        auto mesh = boost::static_pointer_cast<MeshShape>(shape);
+        sdf::ElementPtr meshElem = mesh->GetSDF();
+        SnapshotTriangles triangles;
+
+        // Submeshes are cut and centered by the shape, use their box
+        bool submesh = meshElem && meshElem->HasElement("submesh") &&
+          meshElem->GetElement("submesh")->Get<std::string>("name") !=
+          "__default__";
+
+        std::string uri = mesh->GetMeshURI();
+        const uint64_t version = this->dataPtr->version;
+        auto &meshes = this->dataPtr->meshes;
+        auto iter = meshes.Get().find(uri);
+        if (!submesh && iter != meshes.Get().end())
+        {
+          triangles = iter->second;
+        }
+        else if (!submesh && _previous &&
+            _previous->dataPtr->meshes.Get().count(uri))
+        {
+          triangles = _previous->dataPtr->meshes.Get().at(uri);
+          meshes.Mutable(version)[uri] = triangles;
+        }
+        else if (!submesh)
+        {
+          common::MeshManager *meshManager = common::MeshManager::Instance();
+          const common::Mesh *meshData = meshManager->GetMesh(uri);
+          if (!meshData)
+            meshData = meshManager->GetMesh(common::find_file(uri));
+
+          if (meshData)
+          {
+            auto vertices =
+              std::make_shared<std::vector<ignition::math::Vector3d>>();
+            CollectTriangles(*meshData, *vertices);
+            triangles = vertices;
+          }
+
+          // Remember failures too, the lookup is not repeated
+          meshes.Mutable(version)[uri] = triangles;
+        }
+
+        if (triangles && !triangles->empty())
+          this->AddMesh(id, name, pose, mesh->Size(), triangles);
+        else
+          this->AddBounds(id, name, pose, collision->BoundingBox());
+      }
+      else
+      {
+        this->AddBounds(id, name, pose, collision->BoundingBox());
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Add an entry to a snapshot, or replace the entry of the same
+/// collision.
+/// \param[in] _data Snapshot data.
+/// \param[in] _entry The entry.
+static void AddEntry(CollisionSnapshotPrivate &_data,
+    CollisionSnapshotEntry &&_entry)
+{
+  const ignition::math::AxisAlignedBox &box = _entry.box;
+  bool bounded = std::isfinite(box.Min().Sum()) &&
+    std::isfinite(box.Max().Sum());
+
+  // Only the blocks, index and lists that change are copied from the
+  // snapshot this one was copied from
+  auto iter = _data.index.Get().find(_entry.id);
+  if (iter != _data.index.Get().end())
+  {
+    uint32_t index = iter->second;
+    CollisionSnapshotEntry &old = _data.MutableEntry(index);
+    if (old.proxy >= 0 && bounded)
+    {
+      _data.tree.Update(old.proxy, box);
+      _entry.proxy = old.proxy;
+    }
+    else if (old.proxy >= 0)
+    {
+      _data.tree.Remove(old.proxy);
+      _data.unbounded.Mutable(_data.version).push_back(index);
+    }
+    else if (bounded)
+    {
+      auto &unbounded = _data.unbounded.Mutable(_data.version);
+      unbounded.erase(std::find(unbounded.begin(), unbounded.end(), index));
+      _entry.proxy = _data.tree.Insert(box, index);
+    }
+    old = std::move(_entry);
+    return;
+  }
+
+  uint32_t index = _data.count++;
+  _data.index.Mutable(_data.version)[_entry.id] = index;
+
+  if (bounded)
+    _entry.proxy = _data.tree.Insert(box, index);
+  else
+    _data.unbounded.Mutable(_data.version).push_back(index);
+
+  if (index % kEntryBlockSize == 0)
+  {
+    _data.blocks.emplace_back();
+    _data.blocks.back().Mutable(_data.version).reserve(kEntryBlockSize);
+  }
+  _data.blocks.back().Mutable(_data.version).push_back(std::move(_entry));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the world bounding box of a box posed in the world.
+/// \param[in] _pose Pose of the box.
+/// \param[in] _center Center of the box in the frame of the pose.
+/// \param[in] _half Half size of the box.
+/// \return The bounding box.
+static ignition::math::AxisAlignedBox OrientedBounds(
+    const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_center,
+    const ignition::math::Vector3d &_half)
+{
+  ignition::math::Matrix3d rot(_pose.Rot());
+  ignition::math::Vector3d extent;
+  for (int i = 0; i < 3; ++i)
+  {
+    extent[i] = std::abs(rot(i, 0)) * _half.X() +
+      std::abs(rot(i, 1)) * _half.Y() + std::abs(rot(i, 2)) * _half.Z();
+  }
+  ignition::math::Vector3d center = _pose.CoordPositionAdd(_center);
+  return ignition::math::AxisAlignedBox(center - extent, center + extent);
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddBox(const uint32_t _id, const std::string &_name,
+    const ignition::math::Pose3d &_pose, const ignition::math::Vector3d &_size)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::BOX;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.size = _size * 0.5;
+  entry.box = OrientedBounds(_pose, ignition::math::Vector3d::Zero,
+      entry.size);
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddSphere(const uint32_t _id,
+    const std::string &_name, const ignition::math::Pose3d &_pose,
+    const double _radius)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::SPHERE;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.size.X(_radius);
+  ignition::math::Vector3d half(_radius, _radius, _radius);
+  entry.box = ignition::math::AxisAlignedBox(_pose.Pos() - half,
+      _pose.Pos() + half);
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddCylinder(const uint32_t _id,
+    const std::string &_name, const ignition::math::Pose3d &_pose,
+    const double _radius, const double _length)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::CYLINDER;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.size.Set(_radius, 0, _length * 0.5);
+  entry.box = OrientedBounds(_pose, ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(_radius, _radius, _length * 0.5));
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddPlane(const uint32_t _id,
+    const std::string &_name, const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_normal)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::PLANE;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.size = _pose.Rot().RotateVector(_normal).Normalized();
+  double inf = ignition::math::INF_D;
+  entry.box = ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(-inf, -inf, -inf),
+      ignition::math::Vector3d(inf, inf, inf));
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddMesh(const uint32_t _id, const std::string &_name,
+    const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_scale,
+    const std::shared_ptr<const std::vector<ignition::math::Vector3d>>
+      &_triangles)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::MESH;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.size = _scale;
+  entry.triangles = _triangles;
+
+  ignition::math::Vector3d min(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  ignition::math::Vector3d max = -min;
+  for (auto const &vertex : *_triangles)
+  {
+    ignition::math::Vector3d v = vertex * _scale;
+    min.Min(v);
+    max.Max(v);
+  }
+  if (_triangles->empty())
+    min = max = ignition::math::Vector3d::Zero;
+
+  entry.meshCenter = (min + max) * 0.5;
+  entry.meshHalf = (max - min) * 0.5;
+  entry.box = OrientedBounds(_pose, entry.meshCenter, entry.meshHalf);
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+void CollisionSnapshot::AddBounds(const uint32_t _id,
+    const std::string &_name, const ignition::math::Pose3d &_pose,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  CollisionSnapshotEntry entry;
+  entry.kind = CollisionSnapshotEntry::BOUNDS;
+  entry.id = _id;
+  entry.name = _name;
+  entry.pose = _pose;
+  entry.box = _box;
+  AddEntry(*this->dataPtr, std::move(entry));
+}
+
+//////////////////////////////////////////////////
+common::Time CollisionSnapshot::SimTime() const
+{
+  return this->dataPtr->simTime;
+}
+
+//////////////////////////////////////////////////
+uint64_t CollisionSnapshot::Iterations() const
+{
+  return this->dataPtr->iterations;
+}
+
+//////////////////////////////////////////////////
+uint64_t CollisionSnapshot::Version() const
+{
+  return this->dataPtr->version;
+}
+
+//////////////////////////////////////////////////
+unsigned int CollisionSnapshot::Count() const
+{
+  return this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+bool CollisionSnapshot::Pose(const uint32_t _id,
+    ignition::math::Pose3d &_pose) const
+{
+  auto iter = this->dataPtr->index.Get().find(_id);
+  if (iter == this->dataPtr->index.Get().end())
+    return false;
+
+  _pose = this->dataPtr->Entry(iter->second).pose;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CollisionSnapshot::BoundingBox(const uint32_t _id,
+    ignition::math::AxisAlignedBox &_box) const
+{
+  auto iter = this->dataPtr->index.Get().find(_id);
+  if (iter == this->dataPtr->index.Get().end())
+    return false;
+
+  _box = this->dataPtr->Entry(iter->second).box;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CollisionSnapshot::Ray(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, CollisionSnapshotHit &_hit) const
+{
+  std::vector<uint32_t> candidates = this->dataPtr->unbounded.Get();
+  this->dataPtr->tree.QueryRay(_start, _end, candidates);
+
+  ignition::math::Vector3d dir = _end - _start;
+  const CollisionSnapshotEntry *best = nullptr;
+  double bestT = 2;
+  ignition::math::Vector3d bestNormal;
+  for (auto const index : candidates)
+  {
+    const CollisionSnapshotEntry &entry = this->dataPtr->Entry(index);
+    double t;
+    ignition::math::Vector3d normal;
+    if (Intersect(entry, _start, dir, t, normal) && t < bestT)
+    {
+      best = &entry;
+      bestT = t;
+      bestNormal = normal;
+    }
+  }
+
+  if (!best)
+    return false;
+
+  FillHit(*best, _start + dir * bestT, bestT * dir.Length(), dir,
+      bestNormal, _hit);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CollisionSnapshot::Sweep(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, const double _radius,
+    CollisionSnapshotHit &_hit) const
+{
+  ignition::math::Vector3d min = _start;
+  ignition::math::Vector3d max = _start;
+  min.Min(_end);
+  max.Max(_end);
+  ignition::math::Vector3d margin(_radius, _radius, _radius);
+
+  std::vector<uint32_t> candidates = this->dataPtr->unbounded.Get();
+  this->dataPtr->tree.QueryBox(
+      ignition::math::AxisAlignedBox(min - margin, max + margin), candidates);
+
+  ignition::math::Vector3d dir = _end - _start;
+  double length = dir.Length();
+  const CollisionSnapshotEntry *best = nullptr;
+  double bestDistance = ignition::math::MAX_D;
+  for (auto const index : candidates)
+  {
+    const CollisionSnapshotEntry &entry = this->dataPtr->Entry(index);
+
+    // Sphere tracing: the signed distance is a step that can not go
+    // through the collision
+    double travelled = 0;
+    for (int i = 0; i < kSweepIterations && travelled < bestDistance; ++i)
+    {
+      ignition::math::Vector3d p = length > 0 ?
+        _start + dir * (travelled / length) : _start;
+      double step = Distance(entry, p) - _radius;
+      if (step < kSweepTolerance)
+      {
+        best = &entry;
+        bestDistance = travelled;
+        break;
+      }
+
+      travelled += step;
+      if (travelled > length)
+        break;
+    }
+  }
+
+  if (!best)
+    return false;
+
+  ignition::math::Vector3d point = length > 0 ?
+    _start + dir * (bestDistance / length) : _start;
+
+  // Normal from the gradient of the distance
+  const double h = 1e-6;
+  ignition::math::Vector3d normal;
+  for (int i = 0; i < 3; ++i)
+  {
+    ignition::math::Vector3d offset;
+    offset[i] = h;
+    normal[i] = Distance(*best, point + offset) -
+      Distance(*best, point - offset);
+  }
+
+  FillHit(*best, point, bestDistance, dir, normal, _hit);
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::vector<uint32_t> CollisionSnapshot::Overlap(
+    const ignition::math::Vector3d &_center, const double _radius) const
+{
+  std::vector<uint32_t> candidates = this->dataPtr->unbounded.Get();
+  this->dataPtr->tree.QuerySphere(_center, _radius, candidates);
+
+  std::vector<uint32_t> result;
+  for (auto const index : candidates)
+  {
+    const CollisionSnapshotEntry &entry = this->dataPtr->Entry(index);
+    if (Distance(entry, _center) <= _radius)
+      result.push_back(entry.id);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<uint32_t> CollisionSnapshot::Overlap(
+    const ignition::math::AxisAlignedBox &_box) const
+{
+  std::vector<uint32_t> candidates;
+  this->dataPtr->tree.QueryBox(_box, candidates);
+
+  std::vector<uint32_t> result;
+  for (auto const index : candidates)
+    result.push_back(this->dataPtr->Entry(index).id);
+
+  // Planes overlap everything that reaches below them
+  for (auto const index : this->dataPtr->unbounded.Get())
+  {
+    const CollisionSnapshotEntry &entry = this->dataPtr->Entry(index);
+    ignition::math::Vector3d corner;
+    for (int i = 0; i < 3; ++i)
+      corner[i] = entry.size[i] > 0 ? _box.Min()[i] : _box.Max()[i];
+    if (entry.kind != CollisionSnapshotEntry::PLANE ||
+        Distance(entry, corner) <= 0)
+    {
+      result.push_back(entry.id);
+    }
+  }
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_COLLISIONSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_COLLISIONSNAPSHOT_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class
+    class CollisionSnapshotPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class CollisionSnapshotHit CollisionSnapshot.hh physics/physics.hh
+    /// \brief Result of a ray or sweep query on a CollisionSnapshot.
+    class GZ_PHYSICS_VISIBLE CollisionSnapshotHit
+    {
+      /// \brief Id of the collision that was hit.
+      public: uint32_t collision = 0;
+
+      /// \brief Scoped name of the collision that was hit.
+      public: std::string name;
+
+      /// \brief Distance travelled along the query before the hit.
+      public: double distance = 0;
+
+      /// \brief Point of the hit in the world frame. For a sweep, this is
+      /// the center of the sphere when it touches the collision.
+      public: ignition::math::Vector3d point;
+
+      /// \brief Unit normal of the collision at the hit, in the world frame.
+      /// It points against the query direction when the query starts inside
+      /// the collision.
+      public: ignition::math::Vector3d normal;
+    };
+
+    /// \class CollisionSnapshot CollisionSnapshot.hh physics/physics.hh
+    /// \brief Immutable copy of the collision geometry of a world at one
+    /// simulation step, for geometric queries that do not touch the
+    /// physics engine.
+    ///
+    /// A snapshot holds the world pose, bounding box and shape parameters
+    /// of every collision, and a bounding box tree over them. Once built,
+    /// it is shared through a CollisionSnapshotPtr and never changes, so
+    /// any number of threads can query it while physics steps on. Use
+    /// World::LatestCollisionSnapshot to get the snapshot of the last step.
+    ///
+    /// Boxes, spheres, cylinders and planes are tested exactly. Ray queries
+    /// test the triangles of meshes, sweep and overlap queries use the box
+    /// of the mesh in its own frame. Other shapes (heightmaps, polylines,
+    /// submeshes) are approximated by their world bounding box. Ray shapes
+    /// and collisions that never create contacts, such as sensor volumes,
+    /// are left out.
+    class GZ_PHYSICS_VISIBLE CollisionSnapshot
+    {
+      /// \brief Constructor of an empty snapshot.
+      /// \param[in] _simTime Simulation time of the snapshot.
+      /// \param[in] _iterations World iterations of the snapshot.
+      public: explicit CollisionSnapshot(
+                  const common::Time &_simTime = common::Time::Zero,
+                  const uint64_t _iterations = 0);
+
+      /// \brief Constructor of a copy of a snapshot at a later step. Only
+      /// the collisions that changed need to be added again. The copy
+      /// shares its collisions with _other until it changes them, so
+      /// _other must not be changed afterwards.
+      /// \param[in] _other Snapshot to copy, which is left unchanged.
+      /// \param[in] _simTime Simulation time of the new snapshot.
+      /// \param[in] _iterations World iterations of the new snapshot.
+      public: CollisionSnapshot(const CollisionSnapshot &_other,
+                  const common::Time &_simTime, const uint64_t _iterations);
+
+      /// \brief Destructor.
+      public: virtual ~CollisionSnapshot();
+
+      /// \brief Build the snapshot of the collisions of models.
+      /// Must be called with the physics update mutex locked.
+      /// \param[in] _models Models, their nested models are included.
+      /// \param[in] _simTime Simulation time of the snapshot.
+      /// \param[in] _iterations World iterations of the snapshot.
+      /// \param[in] _previous Previous snapshot, whose mesh triangles are
+      /// reused. May be null.
+      /// \return The new snapshot.
+      public: static CollisionSnapshotPtr Build(const Model_V &_models,
+                  const common::Time &_simTime, const uint64_t _iterations,
+                  const CollisionSnapshotPtr &_previous);
+
+      /// \brief Add the collisions of the links of a model, replacing the
+      /// ones already in the snapshot. Nested models are not included.
+      /// Must be called with the physics update mutex locked.
+      /// \param[in] _model The model.
+      /// \param[in] _previous Previous snapshot, whose mesh triangles are
+      /// reused. May be null.
+      public: void AddModel(const ModelPtr &_model,
+                  const CollisionSnapshotPtr &_previous = nullptr);
+
+      /// \brief Add a box. The Add functions are only meant to build a
+      /// snapshot before it is shared. A collision that is already in the
+      /// snapshot is replaced.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of the center of the box.
+      /// \param[in] _size Size of the box.
+      public: void AddBox(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose,
+                  const ignition::math::Vector3d &_size);
+
+      /// \brief Add a sphere.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of the center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      public: void AddSphere(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose, const double _radius);
+
+      /// \brief Add a cylinder, whose axis is the z axis of its pose.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of the center of the cylinder.
+      /// \param[in] _radius Radius of the cylinder.
+      /// \param[in] _length Length of the cylinder.
+      public: void AddCylinder(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose, const double _radius,
+                  const double _length);
+
+      /// \brief Add an infinite plane. Everything below the plane is inside
+      /// it, as for the physics engines.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of a point of the plane.
+      /// \param[in] _normal Normal of the plane, in the frame of _pose.
+      public: void AddPlane(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose,
+                  const ignition::math::Vector3d &_normal);
+
+      /// \brief Add a triangle mesh.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of the origin of the mesh.
+      /// \param[in] _scale Scale of the mesh.
+      /// \param[in] _triangles Vertices of the triangles, three per
+      /// triangle, in the unscaled frame of the mesh. Shared between
+      /// snapshots.
+      public: void AddMesh(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose,
+                  const ignition::math::Vector3d &_scale,
+                  const std::shared_ptr<const std::vector<
+                    ignition::math::Vector3d>> &_triangles);
+
+      /// \brief Add a collision that is only known by its bounding box.
+      /// \param[in] _id Id of the collision.
+      /// \param[in] _name Scoped name of the collision.
+      /// \param[in] _pose World pose of the collision.
+      /// \param[in] _box Bounding box in the world frame.
+      public: void AddBounds(const uint32_t _id, const std::string &_name,
+                  const ignition::math::Pose3d &_pose,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Get the simulation time of the snapshot.
+      /// \return Simulation time.
+      public: common::Time SimTime() const;
+
+      /// \brief Get the world iterations of the snapshot.
+      /// \return Number of iterations.
+      public: uint64_t Iterations() const;
+
+      /// \brief Get the version of the snapshot, a number that is unique to
+      /// it and greater than the one of any snapshot created before it.
+      /// \return The version.
+      public: uint64_t Version() const;
+
+      /// \brief Get the number of collisions in the snapshot.
+      /// \return Number of collisions.
+      public: unsigned int Count() const;
+
+      /// \brief Get the world pose of a collision.
+      /// \param[in] _id Id of the collision.
+      /// \param[out] _pose The pose.
+      /// \return False if the collision is not in the snapshot.
+      public: bool Pose(const uint32_t _id,
+                  ignition::math::Pose3d &_pose) const;
+
+      /// \brief Get the world bounding box of a collision.
+      /// \param[in] _id Id of the collision.
+      /// \param[out] _box The box.
+      /// \return False if the collision is not in the snapshot.
+      public: bool BoundingBox(const uint32_t _id,
+                  ignition::math::AxisAlignedBox &_box) const;
+
+      /// \brief Find the first collision hit by a line segment.
+      /// \param[in] _start Start of the segment in the world frame.
+      /// \param[in] _end End of the segment in the world frame.
+      /// \param[out] _hit The closest hit, unchanged if nothing is hit.
+      /// \return True if the segment hits a collision.
+      public: bool Ray(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end,
+                  CollisionSnapshotHit &_hit) const;
+
+      /// \brief Find the first collision touched by a sphere moving along a
+      /// line segment.
+      /// \param[in] _start Start of the center of the sphere.
+      /// \param[in] _end End of the center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[out] _hit The first contact, unchanged if nothing is
+      /// touched.
+      /// \return True if the sphere touches a collision.
+      public: bool Sweep(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end, const double _radius,
+                  CollisionSnapshotHit &_hit) const;
+
+      /// \brief Find the collisions that overlap a sphere.
+      /// \param[in] _center Center of the sphere in the world frame.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return Ids of the collisions, in increasing order.
+      public: std::vector<uint32_t> Overlap(
+                  const ignition::math::Vector3d &_center,
+                  const double _radius) const;
+
+      /// \brief Find the collisions whose bounding box overlaps a box.
+      /// \param[in] _box Box in the world frame.
+      /// \return Ids of the collisions, in increasing order.
+      public: std::vector<uint32_t> Overlap(
+                  const ignition::math::AxisAlignedBox &_box) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<CollisionSnapshotPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/CollisionSnapshot.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class CollisionSnapshotTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, Ray)
+{
+  physics::CollisionSnapshot snapshot(common::Time(1.5), 1500);
+  EXPECT_EQ(common::Time(1.5), snapshot.SimTime());
+  EXPECT_EQ(1500u, snapshot.Iterations());
+
+  // A box rotated by 45 degrees around Z, a sphere, a standing cylinder
+  snapshot.AddBox(1, "box", ignition::math::Pose3d(5, 0, 0, 0, 0, IGN_PI_4),
+      ignition::math::Vector3d(2, 2, 2));
+  snapshot.AddSphere(2, "sphere", ignition::math::Pose3d(0, 5, 0, 0, 0, 0),
+      1.0);
+  snapshot.AddCylinder(3, "cylinder",
+      ignition::math::Pose3d(0, -5, 0, 0, 0, 0), 1.0, 4.0);
+  EXPECT_EQ(3u, snapshot.Count());
+
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(snapshot.Pose(2, pose));
+  EXPECT_EQ(ignition::math::Vector3d(0, 5, 0), pose.Pos());
+  EXPECT_FALSE(snapshot.Pose(4, pose));
+
+  ignition::math::AxisAlignedBox box;
+  EXPECT_TRUE(snapshot.BoundingBox(1, box));
+  EXPECT_NEAR(5 - std::sqrt(2.0), box.Min().X(), 1e-9);
+
+  physics::CollisionSnapshotHit hit;
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(10, 0, 0), hit));
+  EXPECT_EQ(1u, hit.collision);
+  EXPECT_EQ("box", hit.name);
+  EXPECT_NEAR(5 - std::sqrt(2.0), hit.distance, 1e-9);
+
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(0, 10, 0), hit));
+  EXPECT_EQ(2u, hit.collision);
+  EXPECT_NEAR(4.0, hit.distance, 1e-9);
+  EXPECT_EQ(ignition::math::Vector3d(0, -1, 0), hit.normal);
+
+  // Top cap of the cylinder
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(0, -5, 10),
+      ignition::math::Vector3d(0, -5, -10), hit));
+  EXPECT_EQ(3u, hit.collision);
+  EXPECT_NEAR(8.0, hit.distance, 1e-9);
+  EXPECT_EQ(ignition::math::Vector3d(0, 0, 1), hit.normal);
+
+  // Side of the cylinder
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(3, -5, 1),
+      ignition::math::Vector3d(-3, -5, 1), hit));
+  EXPECT_NEAR(2.0, hit.distance, 1e-9);
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 0), hit.normal);
+
+  // Too short, and between the shapes
+  EXPECT_FALSE(snapshot.Ray(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(3, 0, 0), hit));
+  EXPECT_FALSE(snapshot.Ray(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(5, 5, 0), hit));
+
+  // Starting inside
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(0, 5, 0),
+      ignition::math::Vector3d(0, 10, 0), hit));
+  EXPECT_EQ(2u, hit.collision);
+  EXPECT_DOUBLE_EQ(0.0, hit.distance);
+}
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, PlaneAndMesh)
+{
+  physics::CollisionSnapshot snapshot;
+  snapshot.AddPlane(1, "ground", ignition::math::Pose3d::Zero,
+      ignition::math::Vector3d::UnitZ);
+
+  // A unit square in the XZ plane, scaled by two and raised
+  auto triangles = std::make_shared<std::vector<ignition::math::Vector3d>>(
+      std::vector<ignition::math::Vector3d>({
+        {-0.5, 0, -0.5}, {0.5, 0, -0.5}, {0.5, 0, 0.5},
+        {-0.5, 0, -0.5}, {0.5, 0, 0.5}, {-0.5, 0, 0.5}}));
+  snapshot.AddMesh(2, "wall", ignition::math::Pose3d(0, 3, 2, 0, 0, 0),
+      ignition::math::Vector3d(2, 2, 2), triangles);
+
+  physics::CollisionSnapshotHit hit;
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(0, 0, 2),
+      ignition::math::Vector3d(0, 10, 2), hit));
+  EXPECT_EQ(2u, hit.collision);
+  EXPECT_NEAR(3.0, hit.distance, 1e-9);
+  EXPECT_EQ(ignition::math::Vector3d(0, -1, 0), hit.normal);
+
+  // Past the scaled edge of the mesh
+  EXPECT_FALSE(snapshot.Ray(ignition::math::Vector3d(1.2, 0, 2),
+      ignition::math::Vector3d(1.2, 10, 2), hit));
+
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(1, 1, 5),
+      ignition::math::Vector3d(1, 1, -5), hit));
+  EXPECT_EQ(1u, hit.collision);
+  EXPECT_NEAR(5.0, hit.distance, 1e-9);
+  EXPECT_EQ(ignition::math::Vector3d(1, 1, 0), hit.point);
+
+  // Below the ground is inside it
+  ASSERT_TRUE(snapshot.Ray(ignition::math::Vector3d(0, 0, -1),
+      ignition::math::Vector3d(0, 10, -1), hit));
+  EXPECT_EQ(1u, hit.collision);
+  EXPECT_DOUBLE_EQ(0.0, hit.distance);
+
+  EXPECT_EQ(std::vector<uint32_t>({1}), snapshot.Overlap(
+      ignition::math::AxisAlignedBox(ignition::math::Vector3d(-1, -1, -1),
+        ignition::math::Vector3d(1, 1, 1))));
+  EXPECT_EQ(std::vector<uint32_t>({2}), snapshot.Overlap(
+      ignition::math::AxisAlignedBox(ignition::math::Vector3d(-1, 2, 1),
+        ignition::math::Vector3d(1, 4, 3))));
+}
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, SweepOverlap)
+{
+  physics::CollisionSnapshot snapshot;
+  snapshot.AddBox(1, "box", ignition::math::Pose3d(5, 0, 0, 0, 0, 0),
+      ignition::math::Vector3d(2, 2, 2));
+  snapshot.AddSphere(2, "sphere", ignition::math::Pose3d(0, 5, 0, 0, 0, 0),
+      1.0);
+  snapshot.AddBounds(3, "terrain",
+      ignition::math::Pose3d(0, 0, -10, 0, 0, 0),
+      ignition::math::AxisAlignedBox(ignition::math::Vector3d(-10, -10, -11),
+        ignition::math::Vector3d(10, 10, -9)));
+
+  physics::CollisionSnapshotHit hit;
+  ASSERT_TRUE(snapshot.Sweep(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(10, 0, 0), 0.5, hit));
+  EXPECT_EQ(1u, hit.collision);
+  EXPECT_NEAR(3.5, hit.distance, 1e-5);
+  EXPECT_NEAR(3.5, hit.point.X(), 1e-5);
+  EXPECT_NEAR(-1.0, hit.normal.X(), 1e-5);
+
+  // A thin ray misses the sphere, a fat sphere touches it
+  EXPECT_FALSE(snapshot.Ray(ignition::math::Vector3d(1.5, 0, 0),
+      ignition::math::Vector3d(1.5, 10, 0), hit));
+  ASSERT_TRUE(snapshot.Sweep(ignition::math::Vector3d(1.5, 0, 0),
+      ignition::math::Vector3d(1.5, 10, 0), 1.0, hit));
+  EXPECT_EQ(2u, hit.collision);
+  EXPECT_NEAR(5.0 - std::sqrt(1.75), hit.distance, 1e-5);
+
+  // Sweeping down to the bounds
+  ASSERT_TRUE(snapshot.Sweep(ignition::math::Vector3d(0, 0, -2),
+      ignition::math::Vector3d(0, 0, -20), 1.0, hit));
+  EXPECT_EQ(3u, hit.collision);
+  EXPECT_NEAR(6.0, hit.distance, 1e-5);
+  EXPECT_EQ(ignition::math::Vector3d::UnitZ, hit.normal);
+
+  EXPECT_TRUE(snapshot.Overlap(ignition::math::Vector3d::Zero, 1.0).empty());
+  EXPECT_EQ(std::vector<uint32_t>({1, 2}),
+      snapshot.Overlap(ignition::math::Vector3d(3, 3, 0), 2.7));
+
+  // Inside the bounding box of the sphere, but not close enough to it
+  EXPECT_TRUE(snapshot.Overlap(ignition::math::Vector3d(0.95, 5.95, 0),
+      0.3).empty());
+  EXPECT_EQ(std::vector<uint32_t>({2}),
+      snapshot.Overlap(ignition::math::Vector3d(0.9, 5.9, 0), 0.3));
+}
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, Copy)
+{
+  auto snapshot = std::make_shared<physics::CollisionSnapshot>(
+      common::Time(1.0), 1000u);
+  snapshot->AddBox(1, "box", ignition::math::Pose3d(0, 0, 0, 0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  snapshot->AddSphere(2, "sphere",
+      ignition::math::Pose3d(5, 0, 0, 0, 0, 0), 1.0);
+
+  // The copy only gets the collisions that moved again
+  physics::CollisionSnapshot copy(*snapshot, common::Time(2.0), 2000u);
+  copy.AddBox(1, "box", ignition::math::Pose3d(0, 10, 0, 0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  EXPECT_EQ(common::Time(2.0), copy.SimTime());
+  EXPECT_EQ(2000u, copy.Iterations());
+  EXPECT_GT(copy.Version(), snapshot->Version());
+  EXPECT_EQ(2u, copy.Count());
+
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(copy.Pose(1, pose));
+  EXPECT_EQ(ignition::math::Pose3d(0, 10, 0, 0, 0, 0), pose);
+  EXPECT_TRUE(snapshot->Pose(1, pose));
+  EXPECT_EQ(ignition::math::Pose3d::Zero, pose);
+
+  physics::CollisionSnapshotHit hit;
+  EXPECT_FALSE(copy.Ray(ignition::math::Vector3d(0, 0, 5),
+      ignition::math::Vector3d(0, 0, -5), hit));
+  EXPECT_TRUE(copy.Ray(ignition::math::Vector3d(0, 10, 5),
+      ignition::math::Vector3d(0, 10, -5), hit));
+  EXPECT_EQ(1u, hit.collision);
+  EXPECT_TRUE(snapshot->Ray(ignition::math::Vector3d(0, 0, 5),
+      ignition::math::Vector3d(0, 0, -5), hit));
+
+  // A replaced collision can become unbounded and back
+  copy.AddPlane(2, "plane", ignition::math::Pose3d(0, 0, -1, 0, 0, 0),
+      ignition::math::Vector3d::UnitZ);
+  EXPECT_TRUE(copy.Ray(ignition::math::Vector3d(20, 20, 5),
+      ignition::math::Vector3d(20, 20, -5), hit));
+  EXPECT_EQ(2u, hit.collision);
+  copy.AddSphere(2, "sphere", ignition::math::Pose3d(5, 0, 0, 0, 0, 0), 1.0);
+  EXPECT_FALSE(copy.Ray(ignition::math::Vector3d(20, 20, 5),
+      ignition::math::Vector3d(20, 20, -5), hit));
+  EXPECT_EQ(2u, copy.Count());
+}
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, CopyShared)
+{
+  // Enough collisions for several blocks of shared entries
+  auto snapshot = std::make_shared<physics::CollisionSnapshot>();
+  for (uint32_t i = 0; i < 150; ++i)
+  {
+    snapshot->AddBox(i, "box", ignition::math::Pose3d(i * 2.0, 0, 0, 0, 0, 0),
+        ignition::math::Vector3d(1, 1, 1));
+  }
+
+  // Changing and adding collisions in the copy leaves the original as it
+  // was
+  physics::CollisionSnapshot copy(*snapshot, common::Time(1.0), 1u);
+  copy.AddBox(100, "box", ignition::math::Pose3d(200, 10, 0, 0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  copy.AddBox(150, "box", ignition::math::Pose3d(300, 0, 0, 0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  copy.AddPlane(151, "plane", ignition::math::Pose3d(0, 0, -1, 0, 0, 0),
+      ignition::math::Vector3d::UnitZ);
+  EXPECT_EQ(150u, snapshot->Count());
+  EXPECT_EQ(152u, copy.Count());
+
+  ignition::math::Pose3d pose;
+  for (uint32_t i = 0; i < 150; ++i)
+  {
+    EXPECT_TRUE(snapshot->Pose(i, pose));
+    EXPECT_EQ(ignition::math::Pose3d(i * 2.0, 0, 0, 0, 0, 0), pose);
+    EXPECT_TRUE(copy.Pose(i, pose));
+    EXPECT_EQ(ignition::math::Pose3d(i * 2.0, i == 100 ? 10 : 0, 0, 0, 0, 0),
+        pose);
+  }
+  EXPECT_FALSE(snapshot->Pose(150, pose));
+  EXPECT_TRUE(copy.Pose(150, pose));
+
+  physics::CollisionSnapshotHit hit;
+  EXPECT_FALSE(snapshot->Ray(ignition::math::Vector3d(-20, 0, 5),
+      ignition::math::Vector3d(-20, 0, -5), hit));
+  EXPECT_TRUE(copy.Ray(ignition::math::Vector3d(-20, 0, 5),
+      ignition::math::Vector3d(-20, 0, -5), hit));
+  EXPECT_EQ(151u, hit.collision);
+}
+
+/////////////////////////////////////////////////
+TEST_F(CollisionSnapshotTest, Threads)
+{
+  // Queries on a shared snapshot from several threads
+  auto snapshot = std::make_shared<physics::CollisionSnapshot>();
+  for (uint32_t i = 0; i < 100; ++i)
+  {
+    snapshot->AddSphere(i, "sphere",
+        ignition::math::Pose3d(i * 3.0, 0, 0, 0, 0, 0), 1.0);
+  }
+  physics::CollisionSnapshotPtr shared = snapshot;
+
+  std::vector<std::thread> threads;
+  std::vector<int> hits(4, 0);
+  for (size_t t = 0; t < hits.size(); ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+    {
+      for (uint32_t i = 0; i < 100; ++i)
+      {
+        physics::CollisionSnapshotHit hit;
+        if (shared->Ray(ignition::math::Vector3d(i * 3.0, 5, 0),
+              ignition::math::Vector3d(i * 3.0, -5, 0), hit) &&
+            hit.collision == i)
+        {
+          ++hits[t];
+        }
+      }
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (auto const count : hits)
+    EXPECT_EQ(100, count);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -19,23 +19,59 @@
  * Date: 10 Nov 2009
  */
 
+#include <algorithm>
+
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/ContactArena.hh"
 #include "gazebo/physics/Contact.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \internal
+/// \brief Private data class for Contact
+class gazebo::physics::ContactPrivate
+{
+  /// \brief Arena of the arrays, or nullptr if the contact owns them.
+  public: ContactArena *arena = nullptr;
+
+  /// \brief Length of the arrays.
+  public: int capacity = 0;
+
+  /// \brief Owned wrenches.
+  public: std::vector<JointWrench> wrench;
+
+  /// \brief Owned positions.
+  public: std::vector<ignition::math::Vector3d> positions;
+
+  /// \brief Owned normals.
+  public: std::vector<ignition::math::Vector3d> normals;
+
+  /// \brief Owned depths.
+  public: std::vector<double> depths;
+};
 
 //////////////////////////////////////////////////
 Contact::Contact()
+  : dataPtr(new ContactPrivate)
 {
+  this->Reserve(MAX_CONTACT_JOINTS);
+}
+
+//////////////////////////////////////////////////
+Contact::Contact(ContactArena *_arena)
+  : dataPtr(new ContactPrivate)
+{
+  this->dataPtr->arena = _arena;
   this->count = 0;
 }
 
 //////////////////////////////////////////////////
 Contact::Contact(const Contact &_c)
+  : dataPtr(new ContactPrivate)
 {
+  this->count = 0;
   *this = _c;
 }
 
@@ -47,12 +83,16 @@ Contact::~Contact()
 //////////////////////////////////////////////////
 Contact &Contact::operator =(const Contact &_contact)
 {
+  if (this == &_contact)
+    return *this;
+
   this->world = _contact.world;
   this->collision1 = _contact.collision1;
   this->collision2 = _contact.collision2;
 
+  this->Reserve(_contact.count);
   this->count = _contact.count;
-  for (int i = 0; i < MAX_CONTACT_JOINTS; i++)
+  for (int i = 0; i < this->count; i++)
   {
     this->wrench[i] = _contact.wrench[i];
     this->positions[i] = _contact.positions[i];
@@ -68,7 +108,7 @@ Contact &Contact::operator =(const Contact &_contact)
 //////////////////////////////////////////////////
 Contact &Contact::operator =(const msgs::Contact &_contact)
 {
-  this->count = 0;
+  this->Reserve(_contact.position_size());
 
   this->world = physics::get_world(_contact.world());
 
@@ -119,6 +159,53 @@ void Contact::Reset()
   this->count = 0;
 }
 
+//////////////////////////////////////////////////
+void Contact::Reserve(const int _capacity)
+{
+  this->count = 0;
+  const int capacity = std::max(_capacity, 0);
+
+  if (this->dataPtr->arena)
+  {
+    if (capacity == 0)
+    {
+      this->wrench = nullptr;
+      this->positions = nullptr;
+      this->normals = nullptr;
+      this->depths = nullptr;
+    }
+    else
+    {
+      ContactArena *arena = this->dataPtr->arena;
+      this->wrench = arena->AllocateArray<JointWrench>(capacity);
+      this->positions =
+          arena->AllocateArray<ignition::math::Vector3d>(capacity);
+      this->normals = arena->AllocateArray<ignition::math::Vector3d>(capacity);
+      this->depths = arena->AllocateArray<double>(capacity);
+    }
+    this->dataPtr->capacity = capacity;
+  }
+  else if (capacity > this->dataPtr->capacity)
+  {
+    this->dataPtr->wrench.resize(capacity);
+    this->dataPtr->positions.resize(capacity);
+    this->dataPtr->normals.resize(capacity);
+    this->dataPtr->depths.resize(capacity);
+
+    this->wrench = this->dataPtr->wrench.data();
+    this->positions = this->dataPtr->positions.data();
+    this->normals = this->dataPtr->normals.data();
+    this->depths = this->dataPtr->depths.data();
+    this->dataPtr->capacity = capacity;
+  }
+}
+
+//////////////////////////////////////////////////
+int Contact::Capacity() const
+{
+  return this->dataPtr->capacity;
+}
+
 //////////////////////////////////////////////////
 std::string Contact::DebugString() const
 {
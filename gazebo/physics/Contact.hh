@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_CONTACT_HH_
 #define GAZEBO_PHYSICS_CONTACT_HH_
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <ignition/math/Vector3.hh>
@@ -39,17 +40,34 @@ namespace gazebo
   namespace physics
   {
     class Collision;
+    class ContactArena;
+
+    // Forward declare private data class.
+    class ContactPrivate;
+
     /// \addtogroup gazebo_physics
     /// \{
 
     /// \class Contact Contact.hh physics/physics.hh
     /// \brief A contact between two collisions. Each contact can consist of
     /// a number of contact points
+    ///
+    /// The arrays of contact points hold Capacity() elements. A contact
+    /// created with the default constructor owns arrays of
+    /// MAX_CONTACT_JOINTS elements. Contacts of the ContactManager take
+    /// arrays of the size they need from a per step ContactArena, and they
+    /// are only valid until the next ContactManager::ResetCount.
     class GZ_PHYSICS_VISIBLE Contact
     {
       /// \brief Constructor.
       public: Contact();
 
+      /// \brief Constructor of a contact whose arrays come from an arena.
+      /// The contact has no arrays until Reserve is called.
+      /// \param[in] _arena Arena of the arrays, which must outlive the
+      /// contact.
+      public: explicit Contact(ContactArena *_arena);
+
       /// \brief Copy constructor
       /// \param[in] _contact Contact to copy.
       public: Contact(const Contact &_contact);
@@ -78,6 +96,16 @@ namespace gazebo
       /// \brief Reset to default values.
       public: void Reset();
 
+      /// \brief Make room for a number of contact points, and reset the
+      /// count. The current contact points are dropped. A contact with an
+      /// arena gets new arrays from it at each call.
+      /// \param[in] _capacity Number of contact points.
+      public: void Reserve(const int _capacity);
+
+      /// \brief Get the length of the arrays of contact points.
+      /// \return Maximum number of contact points.
+      public: int Capacity() const;
+
       /// \brief Pointer to the first collision object
       public: Collision *collision1;
 
@@ -88,18 +116,18 @@ namespace gazebo
       /// All forces and torques are in the world frame.
       /// All forces and torques are relative to the center of mass of the
       /// respective links that the collision elments are attached to.
-      public: JointWrench wrench[MAX_CONTACT_JOINTS];
+      public: JointWrench *wrench = nullptr;
 
       /// \brief Array of force positions.
-      public: ignition::math::Vector3d positions[MAX_CONTACT_JOINTS];
+      public: ignition::math::Vector3d *positions = nullptr;
 
       /// \brief Array of force normals.
-      public: ignition::math::Vector3d normals[MAX_CONTACT_JOINTS];
+      public: ignition::math::Vector3d *normals = nullptr;
 
       /// \brief Array of contact depths
-      public: double depths[MAX_CONTACT_JOINTS];
+      public: double *depths = nullptr;
 
-      /// \brief Length of all the arrays.
+      /// \brief Number of contact points in all the arrays.
       public: int count;
 
       /// \brief Time at which the contact occurred.
@@ -107,6 +135,10 @@ namespace gazebo
 
       /// \brief World in which the contact occurred
       public: WorldPtr world;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ContactPrivate> dataPtr;
     };
     /// \}
   }
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/ContactArena.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for ContactArena
+class gazebo::physics::ContactArenaPrivate
+{
+  /// \brief A block of memory.
+  public: struct Block
+  {
+    /// \brief Memory of the block.
+    std::unique_ptr<char[]> data;
+
+    /// \brief Size of the block in bytes.
+    std::size_t size;
+
+    /// \brief Number of bytes handed out from the block.
+    std::size_t used;
+  };
+
+  /// \brief Size of new blocks.
+  public: std::size_t blockSize;
+
+  /// \brief Blocks, used in order.
+  public: std::vector<Block> blocks;
+
+  /// \brief Index of the block that allocations come from.
+  public: std::size_t current = 0;
+
+  /// \brief Bytes handed out since the last reset.
+  public: std::size_t used = 0;
+};
+
+/////////////////////////////////////////////////
+ContactArena::ContactArena(const std::size_t _blockSize)
+  : dataPtr(new ContactArenaPrivate)
+{
+  this->dataPtr->blockSize = std::max(_blockSize, std::size_t(1));
+}
+
+/////////////////////////////////////////////////
+ContactArena::~ContactArena()
+{
+}
+
+/////////////////////////////////////////////////
+void *ContactArena::Allocate(const std::size_t _size,
+    const std::size_t _alignment)
+{
+  GZ_ASSERT(_alignment > 0 && (_alignment & (_alignment - 1)) == 0,
+      "Alignment must be a power of two");
+
+  auto &blocks = this->dataPtr->blocks;
+  while (true)
+  {
+    if (this->dataPtr->current < blocks.size())
+    {
+      ContactArenaPrivate::Block &block = blocks[this->dataPtr->current];
+      const std::uintptr_t base =
+          reinterpret_cast<std::uintptr_t>(block.data.get());
+      const std::uintptr_t aligned =
+          (base + block.used + _alignment - 1) & ~(_alignment - 1);
+      const std::size_t offset = aligned - base;
+      if (offset + _size <= block.size)
+      {
+        this->dataPtr->used += offset + _size - block.used;
+        block.used = offset + _size;
+        return block.data.get() + offset;
+      }
+
+      // Blocks after the current one are empty
+      ++this->dataPtr->current;
+      continue;
+    }
+
+    ContactArenaPrivate::Block block;
+    block.size = std::max(this->dataPtr->blockSize, _size + _alignment);
+    block.data.reset(new char[block.size]);
+    block.used = 0;
+    blocks.push_back(std::move(block));
+  }
+}
+
+/////////////////////////////////////////////////
+void ContactArena::Reset()
+{
+  auto &blocks = this->dataPtr->blocks;
+
+  // Keep the blocks used since the last reset, and at least one
+  if (this->dataPtr->current + 1 < blocks.size())
+    blocks.resize(this->dataPtr->current + 1);
+
+  for (auto &block : blocks)
+    block.used = 0;
+
+  this->dataPtr->current = 0;
+  this->dataPtr->used = 0;
+}
+
+/////////////////////////////////////////////////
+std::size_t ContactArena::Used() const
+{
+  return this->dataPtr->used;
+}
+
+/////////////////////////////////////////////////
+std::size_t ContactArena::Capacity() const
+{
+  std::size_t result = 0;
+  for (auto const &block : this->dataPtr->blocks)
+    result += block.size;
+  return result;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_CONTACTARENA_HH_
+#define GAZEBO_PHYSICS_CONTACTARENA_HH_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class ContactArenaPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ContactArena ContactArena.hh physics/physics.hh
+    /// \brief Bump allocator for the contact points of one step.
+    ///
+    /// Memory is handed out sequentially from large blocks and is never
+    /// freed individually. Reset makes all of it available again, and
+    /// frees the blocks, except the first, that were not needed since the
+    /// previous reset, so that the memory held follows the last step
+    /// instead of the busiest step ever. The ContactManager resets its
+    /// arena at ContactManager::ResetCount.
+    ///
+    /// Objects are constructed in place but never destroyed, so only types
+    /// whose destructor has no effect, such as JointWrench, should be
+    /// allocated. The arena is not thread safe.
+    class GZ_PHYSICS_VISIBLE ContactArena
+    {
+      /// \brief Constructor.
+      /// \param[in] _blockSize Size in bytes of the blocks.
+      public: explicit ContactArena(const std::size_t _blockSize = 262144);
+
+      /// \brief Destructor.
+      public: virtual ~ContactArena();
+
+      /// \brief Allocate raw memory, valid until the next Reset.
+      /// \param[in] _size Number of bytes.
+      /// \param[in] _alignment Alignment of the memory, a power of two.
+      /// \return Pointer to the memory.
+      public: void *Allocate(const std::size_t _size,
+                  const std::size_t _alignment);
+
+      /// \brief Allocate and default construct an array, valid until the
+      /// next Reset.
+      /// \param[in] _count Number of elements.
+      /// \return Pointer to the first element.
+      public: template<typename T>
+              T *AllocateArray(const std::size_t _count)
+              {
+                T *result = static_cast<T *>(
+                    this->Allocate(sizeof(T) * _count, alignof(T)));
+                for (std::size_t i = 0; i < _count; ++i)
+                  new (result + i) T();
+                return result;
+              }
+
+      /// \brief Make all the memory available again. Blocks other than the
+      /// first that were not used since the previous reset are freed.
+      public: void Reset();
+
+      /// \brief Get the number of bytes handed out since the last reset,
+      /// including alignment padding.
+      /// \return Number of bytes.
+      public: std::size_t Used() const;
+
+      /// \brief Get the number of bytes held by the arena.
+      /// \return Total size of the blocks.
+      public: std::size_t Capacity() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ContactArenaPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactArena.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ContactArenaTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ContactArenaTest, Allocate)
+{
+  physics::ContactArena arena(1024);
+  EXPECT_EQ(arena.Used(), 0u);
+  EXPECT_EQ(arena.Capacity(), 0u);
+
+  // Alignment is respected
+  arena.Allocate(1, 1);
+  void *mem = arena.Allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mem) % 8, 0u);
+  EXPECT_GE(arena.Used(), 9u);
+  EXPECT_EQ(arena.Capacity(), 1024u);
+
+  // Large requests get their own block
+  double *values = arena.AllocateArray<double>(1000);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_DOUBLE_EQ(values[i], 0.0);
+  EXPECT_GT(arena.Capacity(), 1024u + 8000u);
+
+  // Memory is reused after a reset
+  arena.Reset();
+  EXPECT_EQ(arena.Used(), 0u);
+  const std::size_t capacity = arena.Capacity();
+  arena.AllocateArray<double>(1000);
+  EXPECT_EQ(arena.Capacity(), capacity);
+
+  // A quiet cycle frees the blocks it did not need, except the first
+  arena.Reset();
+  arena.Reset();
+  EXPECT_EQ(arena.Capacity(), 1024u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactArenaTest, Contact)
+{
+  physics::ContactArena arena;
+
+  // Contacts with an arena only hold what they reserve
+  physics::Contact contact(&arena);
+  EXPECT_EQ(contact.Capacity(), 0);
+  EXPECT_EQ(contact.count, 0);
+
+  contact.Reserve(4);
+  EXPECT_EQ(contact.Capacity(), 4);
+  ASSERT_TRUE(contact.positions != nullptr);
+  for (int i = 0; i < 4; ++i)
+  {
+    contact.positions[i].Set(i, 0, 0);
+    contact.normals[i] = ignition::math::Vector3d::UnitZ;
+    contact.depths[i] = 0.1 * i;
+    contact.wrench[i].body1Force.Set(0, 0, i);
+    ++contact.count;
+  }
+
+  // Copies own compact arrays that outlive the arena storage
+  physics::Contact copy(contact);
+  EXPECT_EQ(copy.count, 4);
+  EXPECT_EQ(copy.Capacity(), 4);
+
+  contact.Reserve(0);
+  arena.Reset();
+  EXPECT_EQ(contact.count, 0);
+  EXPECT_TRUE(contact.positions == nullptr);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(copy.positions[i], ignition::math::Vector3d(i, 0, 0));
+    EXPECT_EQ(copy.normals[i], ignition::math::Vector3d::UnitZ);
+    EXPECT_DOUBLE_EQ(copy.depths[i], 0.1 * i);
+    EXPECT_EQ(copy.wrench[i].body1Force, ignition::math::Vector3d(0, 0, i));
+  }
+
+  // Default contacts keep the full arrays
+  physics::Contact standalone;
+  EXPECT_EQ(standalone.Capacity(), MAX_CONTACT_JOINTS);
+  standalone = copy;
+  EXPECT_EQ(standalone.count, 4);
+  EXPECT_EQ(standalone.Capacity(), MAX_CONTACT_JOINTS);
+  EXPECT_EQ(standalone.positions[3], ignition::math::Vector3d(3, 0, 0));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
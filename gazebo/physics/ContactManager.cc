@@ -186,7 +186,8 @@ void ContactManager::GetCustomPublishers(Collision *_collision1,
 /////////////////////////////////////////////////
 Contact *ContactManager::NewContact(Collision *_collision1,
                                     Collision *_collision2,
-                                    const common::Time &_time)
+                                    const common::Time &_time,
+                                    const int _capacity)
 {
   Contact *result = NULL;
 
@@ -215,7 +216,7 @@ Contact *ContactManager::NewContact(Collision *_collision1,
       result = this->contacts[this->contactIndex++];
     else
     {
-      result = new Contact();
+      result = new Contact(&this->arena);
       this->contacts.push_back(result);
       this->contactIndex = this->contacts.size();
     }
@@ -228,7 +229,7 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   if (!result)
     return result;
 
-  result->count = 0;
+  result->Reserve(_capacity);
   result->collision1 = _collision1;
   result->collision2 = _collision2;
   result->time = _time;
@@ -261,9 +262,21 @@ const std::vector<Contact*> &ContactManager::GetContacts() const
 /////////////////////////////////////////////////
 void ContactManager::ResetCount()
 {
+  // Drop the arrays of the contacts of the previous step before the arena
+  // reuses their memory
+  for (unsigned int i = 0; i < this->contactIndex; ++i)
+    this->contacts[i]->Reserve(0);
+  this->arena.Reset();
+
   this->contactIndex = 0;
 }
 
+/////////////////////////////////////////////////
+const ContactArena &ContactManager::Arena() const
+{
+  return this->arena;
+}
+
 /////////////////////////////////////////////////
 void ContactManager::Clear()
 {
@@ -272,6 +285,7 @@ void ContactManager::Clear()
     delete this->contacts[i];
 
   this->contacts.clear();
+  this->arena.Reset();
 
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
@@ -298,7 +312,10 @@ void ContactManager::PublishContacts()
   // publish to default topic, ~/physics/contacts
   if (!transport::getMinimalComms())
   {
-    msgs::Contacts msg;
+    // Reuse the message and the published buffers, clearing a message
+    // keeps the memory of the contacts.
+    msgs::Contacts &msg = this->contactsMsg;
+    msg.Clear();
     for (unsigned int i = 0; i < this->contactIndex; ++i)
     {
       if (this->contacts[i]->count == 0)
@@ -309,7 +326,7 @@ void ContactManager::PublishContacts()
     }
 
     msgs::Set(msg.mutable_time(), this->world->SimTime());
-    this->contactPub->Publish(msg);
+    this->contactPub->PublishSwap(msg);
   }
 
   // publish to other custom topics
@@ -319,7 +336,8 @@ void ContactManager::PublishContacts()
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
+    msgs::Contacts &msg2 = contactPublisher->msg;
+    msg2.Clear();
     for (unsigned int j = 0;
         j < contactPublisher->contacts.size(); ++j)
     {
@@ -330,7 +348,7 @@ void ContactManager::PublishContacts()
       contactPublisher->contacts[j]->FillMsg(*contactMsg);
     }
     msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
+    contactPublisher->publisher->PublishSwap(msg2);
     contactPublisher->contacts.clear();
   }
 }
@@ -27,10 +27,12 @@
 #include <boost/unordered/unordered_map.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactArena.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -56,6 +58,9 @@ namespace gazebo
       /// \brief A list of contacts associated to the collisions.
       public: std::vector<Contact *> contacts;
 
+      /// \brief Message reused to publish the contacts.
+      public: msgs::Contacts msg;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
@@ -98,14 +103,18 @@ namespace gazebo
       /// \param[in] _collision1 the first collision object
       /// \param[in] _collision2 the second collision object
       /// \param[in] _time the time of the contact
+      /// \param[in] _capacity Maximum number of contact points the
+      /// physics engine will store in the contact.
       ///
       /// \return The new contact. The physics engine should populate the
       /// contact's parameters. NULL will be returned if there are no
       /// subscribers to the contact topic and NeverDropContacts()
-      /// returns false (default).
+      /// returns false (default). The contact points of the contact are
+      /// valid until the next call to ResetCount.
       public: Contact *NewContact(Collision *_collision1,
                                   Collision *_collision2,
-                                  const common::Time &_time);
+                                  const common::Time &_time,
+                                  const int _capacity = MAX_CONTACT_JOINTS);
 
       /// \brief If set to true, NewContact() will always add contacts
       /// even if there are no subscribers.
@@ -162,9 +171,15 @@ namespace gazebo
       /// \brief Publish all contacts in a msgs::Contacts message.
       public: void PublishContacts();
 
-      /// \brief Set the contact count to zero.
+      /// \brief Set the contact count to zero, and release the contact
+      /// points of the previous step.
       public: void ResetCount();
 
+      /// \brief Get the arena that holds the contact points of the
+      /// current step.
+      /// \return The arena.
+      public: const ContactArena &Arena() const;
+
       /// \brief Create a filter for contacts. A new publisher will be created
       /// that publishes contacts associated to the input collisions.
       /// param[in] _name Filter name.
@@ -217,6 +232,9 @@ namespace gazebo
 
       private: std::vector<Contact*> contacts;
 
+      /// \brief Contact points of the current step, reset at ResetCount.
+      private: ContactArena arena;
+
       private: unsigned int contactIndex;
 
       /// \brief Node for communication.
@@ -225,6 +243,10 @@ namespace gazebo
       /// \brief Contact publisher.
       private: transport::PublisherPtr contactPub;
 
+      /// \brief Message reused to publish the contacts, see
+      /// transport::Publisher::PublishSwap.
+      private: msgs::Contacts contactsMsg;
+
       /// \brief Pointer to the world.
       private: WorldPtr world;
 
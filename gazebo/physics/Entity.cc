@@ -153,10 +153,18 @@ void Entity::SetStatic(const bool &_s)
 
   for (iter = this->children.begin(); iter != this->children.end(); ++iter)
   {
+    // Links override SetStatic to update the physics engine
+    LinkPtr link = boost::dynamic_pointer_cast<Link>(*iter);
     EntityPtr e = boost::dynamic_pointer_cast<Entity>(*iter);
-    if (e)
+    if (link)
+      link->SetStatic(_s);
+    else if (e)
       e->SetStatic(_s);
   }
+
+  // New clients get the static flag of models from the scene message
+  if (this->world && this->HasType(MODEL))
+    this->world->InvalidateSceneFragment(this->GetParentModel());
 }
 
 //////////////////////////////////////////////////
@@ -486,6 +494,11 @@ void Entity::SetWorldPose(const ignition::math::Pose3d &_pose,
     std::lock_guard<std::mutex> lock(this->GetWorld()->WorldPoseMutex());
     (*this.*setWorldPoseFunc)(_pose, _notify, _publish);
   }
+
+  // Poses set by the physics engine are tracked by World::Update
+  if (_notify)
+    this->GetWorld()->_AddDirtyBounds(this);
+
   if (_publish)
     this->PublishPose();
 }
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/EpisodeRunner.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for EpisodeRunner
+class gazebo::physics::EpisodeRunnerPrivate
+{
+  /// \brief World the episodes are run on.
+  public: WorldPtr world;
+
+  /// \brief State every episode starts from.
+  public: WorldState snapshot;
+
+  /// \brief True once a snapshot has been captured.
+  public: bool hasSnapshot = false;
+
+  /// \brief SDF of each top level model at snapshot time, used to
+  /// re-insert models deleted during an episode.
+  public: std::map<std::string, std::string> modelSDF;
+
+  /// \brief Set to stop a running batch.
+  public: std::atomic<bool> stop{false};
+
+  /// \brief Emitted after a restore, before stepping.
+  public: event::EventT<void (unsigned int, uint32_t)> episodeBegin;
+
+  /// \brief Emitted after an episode finished.
+  public: event::EventT<void (const EpisodeResult &)> episodeEnd;
+};
+
+//////////////////////////////////////////////////
+EpisodeRunner::EpisodeRunner(WorldPtr _world)
+  : dataPtr(new EpisodeRunnerPrivate)
+{
+  GZ_ASSERT(_world != nullptr, "World pointer is null");
+  this->dataPtr->world = _world;
+}
+
+//////////////////////////////////////////////////
+EpisodeRunner::~EpisodeRunner()
+{
+}
+
+//////////////////////////////////////////////////
+void EpisodeRunner::Snapshot()
+{
+  this->dataPtr->snapshot = WorldState(this->dataPtr->world);
+  this->dataPtr->snapshot.SetSimTime(common::Time::Zero);
+  this->dataPtr->snapshot.SetIterations(0);
+
+  this->dataPtr->modelSDF.clear();
+  for (auto const &model : this->dataPtr->world->Models())
+    this->dataPtr->modelSDF[model->GetName()] = model->GetSDF()->ToString("");
+
+  this->dataPtr->hasSnapshot = true;
+}
+
+//////////////////////////////////////////////////
+bool EpisodeRunner::HasSnapshot() const
+{
+  return this->dataPtr->hasSnapshot;
+}
+
+//////////////////////////////////////////////////
+const WorldState &EpisodeRunner::SnapshotState() const
+{
+  return this->dataPtr->snapshot;
+}
+
+//////////////////////////////////////////////////
+void EpisodeRunner::Restore(const uint32_t _seed)
+{
+  if (!this->dataPtr->hasSnapshot)
+    this->Snapshot();
+
+  WorldPtr world = this->dataPtr->world;
+
+  // World::Reset reseeds the physics engine with the global seed, resets
+  // time (and with it the sensor update times), entities, plugins and the
+  // physics engine caches.
+  ignition::math::Rand::Seed(_seed);
+  world->Reset();
+
+  // Undo insertions and deletions made during the previous episode.
+  std::set<std::string> present;
+  for (auto const &model : world->Models())
+    present.insert(model->GetName());
+
+  for (auto const &name : present)
+  {
+    if (this->dataPtr->modelSDF.find(name) == this->dataPtr->modelSDF.end())
+      world->RemoveModel(name);
+  }
+
+  std::vector<std::string> insertions;
+  for (auto const &model : this->dataPtr->modelSDF)
+  {
+    if (present.find(model.first) == present.end())
+      insertions.push_back(model.second);
+  }
+
+  WorldState state = this->dataPtr->snapshot;
+  state.SetInsertions(insertions);
+
+  {
+    boost::recursive_mutex::scoped_lock lock(
+        *world->Physics()->GetPhysicsUpdateMutex());
+    world->ResetPhysicsStates();
+    world->SetState(state);
+  }
+}
+
+//////////////////////////////////////////////////
+EpisodeResult EpisodeRunner::RunEpisode(const unsigned int _index,
+    const uint32_t _seed, const unsigned int _iterations)
+{
+  WorldPtr world = this->dataPtr->world;
+  common::Time startTime = common::Time::GetWallTime();
+
+  this->Restore(_seed);
+  this->dataPtr->episodeBegin(_index, _seed);
+
+  if (world->Running())
+  {
+    // The world thread owns stepping, drive it through World::Step which
+    // blocks until the requested iterations are done.
+    if (!world->IsPaused())
+      world->SetPaused(true);
+    world->Step(_iterations);
+  }
+  else
+  {
+    // RunBlocking only counts iterations that update the world.
+    bool paused = world->IsPaused();
+    world->SetPaused(false);
+    world->RunBlocking(_iterations);
+    world->SetPaused(paused);
+  }
+
+  EpisodeResult result;
+  result.index = _index;
+  result.seed = _seed;
+  result.iterations = world->Iterations();
+  result.simTime = world->SimTime();
+  result.state = WorldState(world);
+  result.wallTime = common::Time::GetWallTime() - startTime;
+
+  this->dataPtr->episodeEnd(result);
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int EpisodeRunner::RunEpisodes(const unsigned int _count,
+    const unsigned int _iterations, const uint32_t _baseSeed)
+{
+  if (_iterations == 0)
+  {
+    gzerr << "Episodes must have a positive number of iterations"
+          << std::endl;
+    return 0;
+  }
+
+  if (!this->dataPtr->hasSnapshot)
+    this->Snapshot();
+
+  this->dataPtr->stop = false;
+
+  unsigned int i = 0;
+  for (; i < _count && !this->dataPtr->stop; ++i)
+    this->RunEpisode(i, _baseSeed + i, _iterations);
+
+  return i;
+}
+
+//////////////////////////////////////////////////
+void EpisodeRunner::Stop()
+{
+  this->dataPtr->stop = true;
+}
+
+//////////////////////////////////////////////////
+event::ConnectionPtr EpisodeRunner::ConnectEpisodeBegin(
+    std::function<void (unsigned int, uint32_t)> _subscriber)
+{
+  return this->dataPtr->episodeBegin.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+event::ConnectionPtr EpisodeRunner::ConnectEpisodeEnd(
+    std::function<void (const EpisodeResult &)> _subscriber)
+{
+  return this->dataPtr->episodeEnd.Connect(_subscriber);
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_EPISODERUNNER_HH_
+#define GAZEBO_PHYSICS_EPISODERUNNER_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class EpisodeRunnerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Summary of a finished episode, passed to the episode end
+    /// callbacks.
+    class GZ_PHYSICS_VISIBLE EpisodeResult
+    {
+      /// \brief Index of the episode within the batch.
+      public: unsigned int index = 0;
+
+      /// \brief Random seed the episode was run with.
+      public: uint32_t seed = 0;
+
+      /// \brief Number of iterations simulated.
+      public: uint64_t iterations = 0;
+
+      /// \brief Simulation time at the end of the episode.
+      public: common::Time simTime;
+
+      /// \brief Wall clock time spent resetting and running the episode.
+      public: common::Time wallTime;
+
+      /// \brief State of the world at the end of the episode.
+      public: WorldState state;
+    };
+
+    /// \class EpisodeRunner EpisodeRunner.hh physics/physics.hh
+    /// \brief Run many short, seeded episodes on a single loaded world.
+    ///
+    /// The runner captures a snapshot of the world once, and before each
+    /// episode restores it in place instead of reloading the world. A
+    /// restore reseeds the random number generators, resets time (which
+    /// also resets sensor update times), calls Reset on every world and
+    /// model plugin, clears the physics engine caches (including the ODE
+    /// warm start impulses), removes models inserted during the previous
+    /// episode, re-inserts models that were deleted and finally applies
+    /// the snapshot state.
+    ///
+    /// If the world is running in its own thread, the world must be paused
+    /// and episodes are advanced through World::Step. Otherwise the runner
+    /// drives the world with World::RunBlocking on the calling thread.
+    class GZ_PHYSICS_VISIBLE EpisodeRunner
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World to run episodes on. The world must be
+      /// loaded and initialized.
+      public: explicit EpisodeRunner(WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~EpisodeRunner();
+
+      /// \brief Capture the current state of the world as the snapshot
+      /// that every episode starts from. Simulation time and iteration
+      /// count of the snapshot are set to zero.
+      public: void Snapshot();
+
+      /// \brief Get whether a snapshot has been captured.
+      /// \return True if Snapshot() has been called.
+      public: bool HasSnapshot() const;
+
+      /// \brief Get the captured snapshot.
+      /// \return The world state episodes start from.
+      public: const WorldState &SnapshotState() const;
+
+      /// \brief Restore the world to the snapshot. A snapshot is captured
+      /// first if none exists.
+      /// \param[in] _seed Random seed to use for the next episode.
+      public: void Restore(const uint32_t _seed);
+
+      /// \brief Restore the world and simulate one episode.
+      /// \param[in] _index Index of the episode, reported to callbacks.
+      /// \param[in] _seed Random seed of the episode.
+      /// \param[in] _iterations Number of iterations to simulate.
+      /// \return Summary of the episode.
+      public: EpisodeResult RunEpisode(const unsigned int _index,
+                  const uint32_t _seed, const unsigned int _iterations);
+
+      /// \brief Run a batch of episodes. Episode i is seeded with
+      /// _baseSeed + i so that a batch is reproducible.
+      /// \param[in] _count Number of episodes to run.
+      /// \param[in] _iterations Number of iterations per episode.
+      /// \param[in] _baseSeed Seed of the first episode.
+      /// \return Number of episodes that completed, which is less than
+      /// _count if Stop() was called.
+      public: unsigned int RunEpisodes(const unsigned int _count,
+                  const unsigned int _iterations, const uint32_t _baseSeed);
+
+      /// \brief Request a running batch to stop after the current episode.
+      public: void Stop();
+
+      /// \brief Connect to the episode begin signal, emitted after the
+      /// world has been restored and before it is stepped.
+      /// \param[in] _subscriber Callback receiving the episode index and
+      /// seed.
+      /// \return Connection pointer, which must be kept in scope.
+      public: event::ConnectionPtr ConnectEpisodeBegin(
+                  std::function<void (unsigned int, uint32_t)> _subscriber);
+
+      /// \brief Connect to the episode end signal.
+      /// \param[in] _subscriber Callback receiving the episode result.
+      /// \return Connection pointer, which must be kept in scope.
+      public: event::ConnectionPtr ConnectEpisodeEnd(
+                  std::function<void (const EpisodeResult &)> _subscriber);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<EpisodeRunnerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/EpisodeRunner.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class EpisodeRunnerTest : public ServerFixture {};
+
+//////////////////////////////////////////////////
+/// \brief Episodes run with the same seed end in the same state, and the
+/// world is restored to the snapshot between episodes.
+TEST_F(EpisodeRunnerTest, Reproducible)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  // Give the box an initial velocity so the episodes are not trivial
+  box->SetLinearVel(ignition::math::Vector3d(1, 0, 2));
+
+  physics::EpisodeRunner runner(world);
+  runner.Snapshot();
+  EXPECT_TRUE(runner.HasSnapshot());
+  auto startPose = box->WorldPose();
+
+  std::vector<physics::EpisodeResult> results;
+  unsigned int begins = 0;
+  auto beginConn = runner.ConnectEpisodeBegin(
+      [&](unsigned int, uint32_t)
+      {
+        ++begins;
+        EXPECT_EQ(world->SimTime(), common::Time::Zero);
+        EXPECT_EQ(box->WorldPose(), startPose);
+      });
+  auto endConn = runner.ConnectEpisodeEnd(
+      [&](const physics::EpisodeResult &_result)
+      {
+        results.push_back(_result);
+      });
+
+  EXPECT_EQ(runner.RunEpisodes(2, 200, 7u), 2u);
+  EXPECT_EQ(runner.RunEpisode(2, 7u, 200).seed, 7u);
+
+  EXPECT_EQ(begins, 3u);
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0].seed, 7u);
+  EXPECT_EQ(results[1].seed, 8u);
+  for (auto const &result : results)
+    EXPECT_EQ(result.iterations, 200u);
+
+  // Same seed, same final state
+  auto pose0 = results[0].state.GetModelState("box").Pose();
+  auto pose2 = results[2].state.GetModelState("box").Pose();
+  EXPECT_EQ(pose0, pose2);
+  EXPECT_NE(pose0, startPose);
+}
+
+//////////////////////////////////////////////////
+/// \brief Models inserted or deleted during an episode are undone by the
+/// next restore.
+TEST_F(EpisodeRunnerTest, InsertionsAndDeletions)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::EpisodeRunner runner(world);
+  runner.Snapshot();
+  unsigned int modelCount = world->ModelCount();
+
+  this->SpawnBox("extra_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 5, 0.5));
+  world->RemoveModel("sphere");
+  EXPECT_TRUE(world->ModelByName("extra_box") != nullptr);
+  EXPECT_TRUE(world->ModelByName("sphere") == nullptr);
+
+  runner.Restore(1u);
+
+  EXPECT_EQ(world->ModelCount(), modelCount);
+  EXPECT_TRUE(world->ModelByName("extra_box") == nullptr);
+  EXPECT_TRUE(world->ModelByName("sphere") != nullptr);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
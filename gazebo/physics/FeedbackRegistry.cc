@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <sdf/sdf.hh>
+
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/FeedbackRegistry.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for FeedbackRegistry
+class gazebo::physics::FeedbackRegistryPrivate
+{
+  /// \brief World of the registry.
+  public: WorldPtr world;
+
+  /// \brief Mutex used before Init is called.
+  public: boost::recursive_mutex initMutex;
+
+  /// \brief Physics update mutex.
+  public: boost::recursive_mutex *mutex = nullptr;
+
+  /// \brief True if only registered items compute wrenches.
+  public: bool onDemand = false;
+
+  /// \brief Number of registrations of each joint. Keys are only
+  /// compared, never dereferenced.
+  public: std::unordered_map<const Joint *, unsigned int> joints;
+
+  /// \brief Number of registrations of each collision. Keys are only
+  /// compared, never dereferenced.
+  public: std::unordered_map<const Collision *, unsigned int> collisions;
+
+  /// \brief Number of contacts that got wrenches during the last step.
+  public: std::atomic<unsigned int> contactWrenchCount{0};
+};
+
+/////////////////////////////////////////////////
+/// \brief Get whether the SDF of a joint enables <provide_feedback>.
+/// \param[in] _joint The joint.
+/// \return True if the joint SDF asks for feedback.
+static bool SdfProvideFeedback(JointPtr _joint)
+{
+  sdf::ElementPtr sdf = _joint->GetSDF();
+  if (!sdf || !sdf->HasElement("physics"))
+    return false;
+
+  sdf::ElementPtr physicsElem = sdf->GetElement("physics");
+  return physicsElem->HasElement("provide_feedback") &&
+      physicsElem->Get<bool>("provide_feedback");
+}
+
+/////////////////////////////////////////////////
+FeedbackRegistry::FeedbackRegistry()
+  : dataPtr(new FeedbackRegistryPrivate)
+{
+  this->dataPtr->mutex = &this->dataPtr->initMutex;
+}
+
+/////////////////////////////////////////////////
+FeedbackRegistry::~FeedbackRegistry()
+{
+  this->dataPtr->world.reset();
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::Init(WorldPtr _world, boost::recursive_mutex *_mutex)
+{
+  this->dataPtr->world = _world;
+  if (_mutex)
+    this->dataPtr->mutex = _mutex;
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::SetOnDemand(const bool _onDemand)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  if (this->dataPtr->onDemand == _onDemand)
+    return;
+
+  this->dataPtr->onDemand = _onDemand;
+
+  if (!this->dataPtr->world)
+    return;
+
+  // Update every joint of the world, including the joints of nested models
+  std::vector<ModelPtr> models = this->dataPtr->world->Models();
+  while (!models.empty())
+  {
+    ModelPtr model = models.back();
+    models.pop_back();
+
+    for (auto const &joint : model->GetJoints())
+      joint->SetProvideFeedback(this->JointFeedbackWanted(joint));
+
+    const Model_V &nested = model->NestedModels();
+    models.insert(models.end(), nested.begin(), nested.end());
+  }
+}
+
+/////////////////////////////////////////////////
+bool FeedbackRegistry::OnDemand() const
+{
+  return this->dataPtr->onDemand;
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::RegisterJoint(JointPtr _joint)
+{
+  if (!_joint)
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  if (this->dataPtr->joints[_joint.get()]++ == 0)
+    _joint->SetProvideFeedback(true);
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::UnregisterJoint(JointPtr _joint)
+{
+  if (!_joint)
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  auto iter = this->dataPtr->joints.find(_joint.get());
+  if (iter == this->dataPtr->joints.end())
+    return;
+
+  if (--iter->second == 0)
+  {
+    this->dataPtr->joints.erase(iter);
+    _joint->SetProvideFeedback(this->JointFeedbackWanted(_joint));
+  }
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::RegisterCollision(CollisionPtr _collision)
+{
+  if (!_collision)
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  ++this->dataPtr->collisions[_collision.get()];
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::UnregisterCollision(CollisionPtr _collision)
+{
+  if (!_collision)
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  auto iter = this->dataPtr->collisions.find(_collision.get());
+  if (iter != this->dataPtr->collisions.end() && --iter->second == 0)
+    this->dataPtr->collisions.erase(iter);
+}
+
+/////////////////////////////////////////////////
+bool FeedbackRegistry::JointFeedbackWanted(JointPtr _joint) const
+{
+  if (!_joint)
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  if (this->dataPtr->joints.count(_joint.get()) > 0)
+    return true;
+
+  return !this->dataPtr->onDemand && SdfProvideFeedback(_joint);
+}
+
+/////////////////////////////////////////////////
+bool FeedbackRegistry::ContactWrenchWanted(const Collision *_collision1,
+    const Collision *_collision2) const
+{
+  if (!this->dataPtr->onDemand)
+    return true;
+
+  // The physics update mutex is held by the caller
+  return this->dataPtr->collisions.count(_collision1) > 0 ||
+      this->dataPtr->collisions.count(_collision2) > 0;
+}
+
+/////////////////////////////////////////////////
+unsigned int FeedbackRegistry::JointCount() const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  return this->dataPtr->joints.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int FeedbackRegistry::CollisionCount() const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  return this->dataPtr->collisions.size();
+}
+
+/////////////////////////////////////////////////
+void FeedbackRegistry::SetContactWrenchCount(const unsigned int _count)
+{
+  this->dataPtr->contactWrenchCount = _count;
+}
+
+/////////////////////////////////////////////////
+unsigned int FeedbackRegistry::ContactWrenchCount() const
+{
+  return this->dataPtr->contactWrenchCount;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_FEEDBACKREGISTRY_HH_
+#define GAZEBO_PHYSICS_FEEDBACKREGISTRY_HH_
+
+#include <memory>
+#include <boost/thread/recursive_mutex.hpp>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class FeedbackRegistryPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class FeedbackRegistry FeedbackRegistry.hh physics/physics.hh
+    /// \brief Keeps track of the joints and collisions whose wrenches are
+    /// consumed, so that physics engines only compute those.
+    ///
+    /// Consumers such as sensors and plugins register the joints they call
+    /// Joint::GetForceTorque on, and the collisions whose contact wrenches
+    /// they read, and unregister them when they are done. Registrations are
+    /// counted, so several consumers can share a joint or a collision.
+    ///
+    /// By default registration only adds to the previous behavior: the
+    /// <provide_feedback> element of a joint still turns on its feedback,
+    /// and every contact reported by the ContactManager gets wrenches.
+    /// When on demand feedback is enabled, with SetOnDemand or the
+    /// "feedback_on_demand" physics parameter, only registered joints
+    /// compute feedback and only contacts that involve a registered
+    /// collision get wrenches. Other contacts still report positions,
+    /// normals and depths, with zero wrenches.
+    ///
+    /// The registry is owned by the PhysicsEngine, see
+    /// PhysicsEngine::GetFeedbackRegistry. Changes lock the physics update
+    /// mutex.
+    class GZ_PHYSICS_VISIBLE FeedbackRegistry
+    {
+      /// \brief Constructor.
+      public: FeedbackRegistry();
+
+      /// \brief Destructor.
+      public: virtual ~FeedbackRegistry();
+
+      /// \brief Initialize the registry.
+      /// \param[in] _world World whose joints are updated when on demand
+      /// feedback is toggled.
+      /// \param[in] _mutex Physics update mutex.
+      public: void Init(WorldPtr _world, boost::recursive_mutex *_mutex);
+
+      /// \brief Enable or disable on demand feedback. Feedback of every
+      /// joint of the world is updated.
+      /// \param[in] _onDemand True to only compute the wrenches of
+      /// registered joints and collisions.
+      public: void SetOnDemand(const bool _onDemand);
+
+      /// \brief Get whether on demand feedback is enabled.
+      /// \return True if only registered items compute wrenches.
+      public: bool OnDemand() const;
+
+      /// \brief Register interest in the wrench of a joint, which turns
+      /// on its feedback.
+      /// \param[in] _joint Joint to register.
+      public: void RegisterJoint(JointPtr _joint);
+
+      /// \brief Remove one registration of a joint. Its feedback is turned
+      /// off with the last registration, unless feedback is not on demand
+      /// and the joint SDF asks for it.
+      /// \param[in] _joint Joint to unregister.
+      public: void UnregisterJoint(JointPtr _joint);
+
+      /// \brief Register interest in the contact wrenches of a collision.
+      /// \param[in] _collision Collision to register.
+      public: void RegisterCollision(CollisionPtr _collision);
+
+      /// \brief Remove one registration of a collision.
+      /// \param[in] _collision Collision to unregister.
+      public: void UnregisterCollision(CollisionPtr _collision);
+
+      /// \brief Get whether a joint should compute feedback, from its
+      /// registrations, its SDF and the on demand setting.
+      /// \param[in] _joint Joint to check.
+      /// \return True if the joint feedback is needed.
+      public: bool JointFeedbackWanted(JointPtr _joint) const;
+
+      /// \brief Get whether a contact between two collisions needs
+      /// wrenches. Called by the physics engines for every contact, with
+      /// the physics update mutex locked.
+      /// \param[in] _collision1 First collision of the contact.
+      /// \param[in] _collision2 Second collision of the contact.
+      /// \return True if feedback is not on demand, or if one of the
+      /// collisions is registered.
+      public: bool ContactWrenchWanted(const Collision *_collision1,
+                  const Collision *_collision2) const;
+
+      /// \brief Get the number of registered joints.
+      /// \return Number of distinct joints with a registration.
+      public: unsigned int JointCount() const;
+
+      /// \brief Get the number of registered collisions.
+      /// \return Number of distinct collisions with a registration.
+      public: unsigned int CollisionCount() const;
+
+      /// \brief Set the number of contacts that got wrenches during the
+      /// last step. Called by the physics engines.
+      /// \param[in] _count Number of contacts.
+      public: void SetContactWrenchCount(const unsigned int _count);
+
+      /// \brief Get the number of contacts that got wrenches during the
+      /// last step.
+      /// \return Number of contacts.
+      public: unsigned int ContactWrenchCount() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<FeedbackRegistryPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class FeedbackRegistryTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(FeedbackRegistryTest, Joints)
+{
+  Load("worlds/force_torque_test.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  ASSERT_EQ(physics->GetType(), "ode");
+
+  physics::FeedbackRegistry *registry = physics->GetFeedbackRegistry();
+  ASSERT_TRUE(registry != nullptr);
+  EXPECT_FALSE(registry->OnDemand());
+
+  // Each joint has a force torque sensor, which registers it
+  for (int i = 0; i < 100 && registry->JointCount() < 2u; ++i)
+    common::Time::MSleep(50);
+  EXPECT_EQ(registry->JointCount(), 2u);
+
+  physics::ModelPtr model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != nullptr);
+  auto joint01 = boost::dynamic_pointer_cast<physics::ODEJoint>(
+      model->GetJoint("joint_01"));
+  auto joint12 = boost::dynamic_pointer_cast<physics::ODEJoint>(
+      model->GetJoint("joint_12"));
+  ASSERT_TRUE(joint01 != nullptr);
+  ASSERT_TRUE(joint12 != nullptr);
+  EXPECT_TRUE(joint01->GetFeedback() != nullptr);
+  EXPECT_TRUE(joint12->GetFeedback() != nullptr);
+
+  // Both joints set <provide_feedback>, so feedback stays on without
+  // registrations unless it is on demand
+  registry->UnregisterJoint(joint12);
+  EXPECT_EQ(registry->JointCount(), 1u);
+  EXPECT_TRUE(joint12->GetFeedback() != nullptr);
+
+  EXPECT_TRUE(physics->SetParam("feedback_on_demand", true));
+  EXPECT_TRUE(boost::any_cast<bool>(physics->GetParam("feedback_on_demand")));
+  EXPECT_TRUE(registry->OnDemand());
+  EXPECT_TRUE(joint01->GetFeedback() != nullptr);
+  EXPECT_TRUE(joint12->GetFeedback() == nullptr);
+
+  // Registrations are counted
+  registry->RegisterJoint(joint12);
+  registry->RegisterJoint(joint12);
+  EXPECT_EQ(registry->JointCount(), 2u);
+  EXPECT_TRUE(joint12->GetFeedback() != nullptr);
+  registry->UnregisterJoint(joint12);
+  EXPECT_TRUE(joint12->GetFeedback() != nullptr);
+  world->Step(10);
+  EXPECT_GT(joint12->GetForceTorque(0u).body2Force.Length(), 0.0);
+
+  registry->UnregisterJoint(joint12);
+  EXPECT_TRUE(joint12->GetFeedback() == nullptr);
+
+  // Back to the SDF settings
+  EXPECT_TRUE(physics->SetParam("feedback_on_demand", false));
+  EXPECT_FALSE(registry->OnDemand());
+  EXPECT_TRUE(joint12->GetFeedback() != nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(FeedbackRegistryTest, Contacts)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  physics::FeedbackRegistry *registry = physics->GetFeedbackRegistry();
+  ASSERT_TRUE(registry != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  ASSERT_FALSE(model->GetLinks().empty());
+  ASSERT_FALSE(model->GetLinks()[0]->GetCollisions().empty());
+  physics::CollisionPtr collision = model->GetLinks()[0]->GetCollisions()[0];
+
+  physics->GetContactManager()->SetNeverDropContacts(true);
+
+  // Every contact gets wrenches by default
+  world->Step(10);
+  EXPECT_GT(physics->GetContactManager()->GetContactCount(), 0u);
+  EXPECT_EQ(registry->ContactWrenchCount(),
+      physics->GetContactManager()->GetContactCount());
+
+  // On demand, unregistered contacts keep their points but not wrenches
+  registry->SetOnDemand(true);
+  world->Step(1);
+  ASSERT_GT(physics->GetContactManager()->GetContactCount(), 0u);
+  EXPECT_EQ(registry->ContactWrenchCount(), 0u);
+  physics::Contact *contact = physics->GetContactManager()->GetContact(0);
+  ASSERT_TRUE(contact != nullptr);
+  ASSERT_GT(contact->count, 0);
+  EXPECT_DOUBLE_EQ(contact->wrench[0].body1Force.Length(), 0.0);
+  EXPECT_DOUBLE_EQ(contact->wrench[0].body2Force.Length(), 0.0);
+
+  // Registering the box collision brings them back
+  registry->RegisterCollision(collision);
+  EXPECT_EQ(registry->CollisionCount(), 1u);
+  world->Step(1);
+  EXPECT_EQ(registry->ContactWrenchCount(),
+      physics->GetContactManager()->GetContactCount());
+  contact = physics->GetContactManager()->GetContact(0);
+  ASSERT_TRUE(contact != nullptr);
+  EXPECT_GT(contact->wrench[0].body1Force.Length() +
+      contact->wrench[0].body2Force.Length(), 0.0);
+
+  registry->UnregisterCollision(collision);
+  EXPECT_EQ(registry->CollisionCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cmath>
 #include <string>
+#include <vector>
 #include <ignition/math/Helpers.hh>
 #include <gazebo/gazebo_config.h>
 
@@ -26,12 +27,17 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
 #include "gazebo/physics/HeightmapShape.hh"
+#include "gazebo/physics/HeightmapTileCache.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/transport/transport.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Heightmaps with more vertices than this are built in tiles on
+/// demand, if the physics engine allows it. This is a 4097x4097 table, or
+/// 64MB of float heights.
+static const uint64_t kMaxResidentVertices = 4097u * 4097u;
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
@@ -257,7 +263,23 @@ void HeightmapShape::Init()
     this->scale.Z() = fabs(terrainSize.Z()) / heightmapSizeZ;
 
   // Construct the heightmap lookup table
-  this->FillHeightfield(this->heights);
+  this->heights.clear();
+  this->tileCache.reset();
+  if (this->tilingAllowed && static_cast<uint64_t>(this->vertSize) *
+      this->vertSize > kMaxResidentVertices)
+  {
+    this->tileCache.reset(new HeightmapTileCache(this->heightmapData,
+        this->subSampling, this->vertSize, this->Size(), this->scale,
+        this->flipY));
+    gzmsg << "Heightmap [" << this->GetURI() << "] has " << this->vertSize
+          << "x" << this->vertSize << " vertices, heights are built in "
+          << this->tileCache->TileSize() << "x"
+          << this->tileCache->TileSize() << " tiles on demand" << std::endl;
+  }
+  else
+  {
+    this->FillHeightfield(this->heights);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -305,12 +327,37 @@ void HeightmapShape::FillMsg(msgs::Geometry &_msg)
 //////////////////////////////////////////////////
 void HeightmapShape::FillHeights(msgs::Geometry &_msg) const
 {
-  for (unsigned int y = 0; y < this->vertSize; ++y)
+  // The message holds the rows of the table in reverse order
+  auto *msgHeights = _msg.mutable_heightmap()->mutable_heights();
+  const int start = msgHeights->size();
+  const unsigned int count = this->vertSize * this->vertSize;
+  msgHeights->Resize(start + count, 0.0f);
+  float *dst = msgHeights->mutable_data() + start;
+
+  if (!this->tileCache)
+  {
+    if (this->heights.size() < count)
+      return;
+    for (unsigned int y = 0; y < this->vertSize; ++y)
+    {
+      std::copy_n(this->heights.begin() +
+          (this->vertSize - y - 1) * this->vertSize, this->vertSize,
+          dst + y * this->vertSize);
+    }
+    return;
+  }
+
+  // Copy a row of tiles at a time, so that each tile is built once
+  const unsigned int band = this->tileCache->TileSize();
+  std::vector<float> rows;
+  for (unsigned int y0 = 0; y0 < this->vertSize; y0 += band)
   {
-    for (unsigned int x = 0; x < this->vertSize; ++x)
+    const unsigned int n = std::min(band, this->vertSize - y0);
+    this->tileCache->FillRegion(0, y0, this->vertSize, n, rows);
+    for (unsigned int r = 0; r < n; ++r)
     {
-      int index = (this->vertSize - y - 1) * this->vertSize + x;
-      _msg.mutable_heightmap()->add_heights(this->heights[index]);
+      std::copy_n(rows.begin() + r * this->vertSize, this->vertSize,
+          dst + (this->vertSize - y0 - r - 1) * this->vertSize);
     }
   }
 }
@@ -330,6 +377,9 @@ ignition::math::Vector2i HeightmapShape::VertexCount() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 {
+  if (this->tileCache)
+    return this->tileCache->Height(_x, _y);
+
   int index =  _y * this->vertSize + _x;
   if (_x < 0 || _y < 0 || index >= static_cast<int>(this->heights.size()))
     return 0.0;
@@ -340,6 +390,9 @@ HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 {
+  if (this->tileCache)
+    return this->tileCache->MaxHeight();
+
   HeightType max = -std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -353,6 +406,9 @@ HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
 {
+  if (this->tileCache)
+    return this->tileCache->MinHeight();
+
   HeightType min = std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -363,6 +419,12 @@ HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
   return min;
 }
 
+/////////////////////////////////////////////////
+bool HeightmapShape::Tiled() const
+{
+  return this->tileCache != nullptr;
+}
+
 //////////////////////////////////////////////////
 common::Image HeightmapShape::GetImage() const
 {
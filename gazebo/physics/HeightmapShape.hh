@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 #define GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <ignition/transport/Node.hh>
@@ -35,6 +36,8 @@ namespace gazebo
 {
   namespace physics
   {
+    class HeightmapTileCache;
+
     /// \addtogroup gazebo_physics
     /// \{
 
@@ -123,6 +126,14 @@ namespace gazebo
       /// \return Amount of subsampling.
       public: int GetSubSampling() const;
 
+      /// \brief Get whether the height lookup table is built in tiles on
+      /// demand instead of being held in memory as a whole. Tiling is used
+      /// for large heightmaps by physics engines that query heights through
+      /// GetHeight.
+      /// \return True if the heights are tiled.
+      /// \sa HeightmapTileCache
+      public: bool Tiled() const;
+
       /// \brief Return an image representation of the heightmap.
       /// \return Image where white pixels represents the highest locations,
       /// and black pixels the lowest.
@@ -166,6 +177,14 @@ namespace gazebo
       /// \brief The amount of subsampling. Default is 2.
       protected: int subSampling;
 
+      /// \brief True if the physics engine supports a tiled height lookup
+      /// table, in which case \e heights stays empty for large heightmaps.
+      protected: bool tilingAllowed = false;
+
+      /// \brief Tiled height lookup table, used instead of \e heights for
+      /// large heightmaps.
+      protected: std::unique_ptr<HeightmapTileCache> tileCache;
+
       /// \brief Transportation node.
       private: transport::NodePtr node;
 
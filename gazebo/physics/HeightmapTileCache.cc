@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/HeightmapTileCache.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief A square block of the height lookup table.
+struct HeightmapTile
+{
+  /// \brief Key of the tile, see HeightmapTileCachePrivate::Key.
+  uint64_t key;
+
+  /// \brief Number of vertices per row of the tile. Tiles on the last
+  /// column of the table may be narrower than the tile size.
+  unsigned int width;
+
+  /// \brief Number of rows of the tile. Tiles on the last row of the
+  /// table may be shorter than the tile size.
+  unsigned int height;
+
+  /// \brief Heights of the tile, row by row.
+  std::vector<float> heights;
+};
+
+/// \internal
+/// \brief Tile a thread queried last, which it reads again without
+/// locking the cache.
+struct HeightmapTilePin
+{
+  /// \brief Id of the cache, see HeightmapTileCachePrivate::id.
+  uint64_t cache = 0;
+
+  /// \brief The tile, kept alive if it is evicted.
+  std::shared_ptr<const HeightmapTile> tile;
+};
+
+/// \brief Id of the next cache created.
+static std::atomic<uint64_t> g_nextHeightmapTileCacheId{1};
+
+/// \brief Tile pinned by the calling thread.
+static thread_local HeightmapTilePin t_heightmapTilePin;
+
+/// \internal
+/// \brief Private data class for HeightmapTileCache
+class gazebo::physics::HeightmapTileCachePrivate
+{
+  /// \brief Compute the key of a tile.
+  /// \param[in] _tx Tile column.
+  /// \param[in] _ty Tile row.
+  /// \return Key of the tile.
+  public: static uint64_t Key(const unsigned int _tx, const unsigned int _ty)
+  {
+    return (static_cast<uint64_t>(_ty) << 32) | _tx;
+  }
+
+  /// \brief Evict least recently used tiles until at most maxTiles are
+  /// resident. The mutex must be locked.
+  public: void Trim()
+  {
+    while (this->tiles.size() > this->maxTiles)
+    {
+      this->index.erase(this->tiles.back()->key);
+      this->tiles.pop_back();
+      ++this->evictions;
+    }
+  }
+
+  /// \brief Get a tile, building it if it is not resident, and make it
+  /// the most recently used one. The mutex must be locked.
+  /// \param[in] _tx Tile column.
+  /// \param[in] _ty Tile row.
+  /// \return The tile, null if it could not be built.
+  public: std::shared_ptr<const HeightmapTile> Tile(const unsigned int _tx,
+      const unsigned int _ty)
+  {
+    const uint64_t key = Key(_tx, _ty);
+
+    // Consecutive lookups usually fall in the same tile
+    if (!this->tiles.empty() && this->tiles.front()->key == key)
+    {
+      ++this->hits;
+      return this->tiles.front();
+    }
+
+    auto iter = this->index.find(key);
+    if (iter != this->index.end())
+    {
+      this->tiles.splice(this->tiles.begin(), this->tiles, iter->second);
+      ++this->hits;
+      return this->tiles.front();
+    }
+
+    auto tile = std::make_shared<HeightmapTile>();
+    tile->key = key;
+    tile->width = std::min(this->tileSize,
+        this->vertSize - _tx * this->tileSize);
+    tile->height = std::min(this->tileSize,
+        this->vertSize - _ty * this->tileSize);
+
+    this->data->FillHeightMapRegion(this->subSampling, this->vertSize,
+        this->size, this->scale, this->flipY, _tx * this->tileSize,
+        _ty * this->tileSize, tile->width, tile->height, tile->heights);
+
+    if (tile->heights.size() !=
+        static_cast<size_t>(tile->width) * tile->height)
+    {
+      return nullptr;
+    }
+
+    this->tiles.push_front(tile);
+    this->index[key] = this->tiles.begin();
+    ++this->misses;
+    this->Trim();
+    return tile;
+  }
+
+  /// \brief Id of the cache, unique to it.
+  public: uint64_t id = 0;
+
+  /// \brief Heightmap data the tiles are built from.
+  public: common::HeightmapData *data = nullptr;
+
+  /// \brief Multiplier used to increase the resolution.
+  public: int subSampling = 1;
+
+  /// \brief Number of vertices per row of the table.
+  public: unsigned int vertSize = 0;
+
+  /// \brief Real dimensions of the terrain.
+  public: ignition::math::Vector3d size;
+
+  /// \brief Height scale.
+  public: ignition::math::Vector3d scale;
+
+  /// \brief True to flip the table along the y direction.
+  public: bool flipY = false;
+
+  /// \brief Number of vertices per side of a tile.
+  public: unsigned int tileSize = 256;
+
+  /// \brief Maximum number of resident tiles.
+  public: unsigned int maxTiles = 256;
+
+  /// \brief Minimum height of the table.
+  public: float minHeight = 0;
+
+  /// \brief Maximum height of the table.
+  public: float maxHeight = 0;
+
+  /// \brief Resident tiles, most recently used first.
+  public: std::list<std::shared_ptr<const HeightmapTile>> tiles;
+
+  /// \brief Resident tiles by key.
+  public: std::unordered_map<uint64_t,
+          std::list<std::shared_ptr<const HeightmapTile>>::iterator> index;
+
+  /// \brief Number of cache hits. Hits on a pinned tile are counted
+  /// without locking the mutex.
+  public: std::atomic<uint64_t> hits{0};
+
+  /// \brief Number of cache misses.
+  public: uint64_t misses = 0;
+
+  /// \brief Number of evictions.
+  public: uint64_t evictions = 0;
+
+  /// \brief Protects the tiles and the counters.
+  public: mutable std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+HeightmapTileCache::HeightmapTileCache(common::HeightmapData *_data,
+    const int _subSampling, const unsigned int _vertSize,
+    const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, const bool _flipY,
+    const unsigned int _tileSize, const unsigned int _maxTiles)
+  : dataPtr(new HeightmapTileCachePrivate)
+{
+  GZ_ASSERT(_data != nullptr, "Heightmap data is null");
+  GZ_ASSERT(_subSampling > 0, "Heightmap subsampling must be positive");
+
+  this->dataPtr->id = g_nextHeightmapTileCacheId++;
+  this->dataPtr->data = _data;
+  this->dataPtr->subSampling = _subSampling;
+  this->dataPtr->vertSize = _vertSize;
+  this->dataPtr->size = _size;
+  this->dataPtr->scale = _scale;
+  this->dataPtr->flipY = _flipY;
+  this->dataPtr->tileSize = std::max(1u, _tileSize);
+  this->dataPtr->maxTiles = std::max(1u, _maxTiles);
+
+  // The vertices between two samples of the heightmap data are bilinear
+  // interpolations of the samples, so the bounds of the table are the
+  // bounds of the samples. Stream the samples in strips to compute them
+  // without building the table.
+  const unsigned int width = _data->GetWidth();
+  const unsigned int strip =
+      std::max(1u, (1u << 20) / std::max(1u, width));
+
+  float min = std::numeric_limits<float>::max();
+  float max = -std::numeric_limits<float>::max();
+  std::vector<float> samples;
+  for (unsigned int y = 0; y < width; y += strip)
+  {
+    _data->FillHeightMapRegion(1, width, _size, _scale, false,
+        0, y, width, std::min(strip, width - y), samples);
+    for (auto const h : samples)
+    {
+      min = std::min(min, h);
+      max = std::max(max, h);
+    }
+  }
+
+  if (min <= max)
+  {
+    this->dataPtr->minHeight = min;
+    this->dataPtr->maxHeight = max;
+  }
+}
+
+//////////////////////////////////////////////////
+HeightmapTileCache::~HeightmapTileCache()
+{
+}
+
+//////////////////////////////////////////////////
+float HeightmapTileCache::Height(const int _x, const int _y)
+{
+  const unsigned int vertSize = this->dataPtr->vertSize;
+  if (_x < 0 || _y < 0 || static_cast<unsigned int>(_x) >= vertSize ||
+      static_cast<unsigned int>(_y) >= vertSize)
+  {
+    return 0.0;
+  }
+
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  const unsigned int tx = _x / tileSize;
+  const unsigned int ty = _y / tileSize;
+
+  // The physics engines query the vertices under a body one at a time, so
+  // the tile of the last query is read again without locking
+  HeightmapTilePin &pin = t_heightmapTilePin;
+  if (pin.cache == this->dataPtr->id && pin.tile &&
+      pin.tile->key == HeightmapTileCachePrivate::Key(tx, ty))
+  {
+    ++this->dataPtr->hits;
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    pin.cache = this->dataPtr->id;
+    pin.tile = this->dataPtr->Tile(tx, ty);
+    if (!pin.tile)
+      return 0.0;
+  }
+
+  return pin.tile->heights[(_y - ty * tileSize) * pin.tile->width +
+      (_x - tx * tileSize)];
+}
+
+//////////////////////////////////////////////////
+void HeightmapTileCache::FillRegion(const unsigned int _x,
+    const unsigned int _y, const unsigned int _width,
+    const unsigned int _height, std::vector<float> &_heights)
+{
+  _heights.assign(static_cast<size_t>(_width) * _height, 0.0f);
+
+  const unsigned int vertSize = this->dataPtr->vertSize;
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  const unsigned int xEnd = std::min(vertSize, _x + _width);
+  const unsigned int yEnd = std::min(vertSize, _y + _height);
+
+  // The mutex is locked once per tile, and whole rows of the tile are
+  // copied after it is released
+  for (unsigned int ty = _y / tileSize; ty * tileSize < yEnd; ++ty)
+  {
+    for (unsigned int tx = _x / tileSize; tx * tileSize < xEnd; ++tx)
+    {
+      std::shared_ptr<const HeightmapTile> tile;
+      {
+        std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+        tile = this->dataPtr->Tile(tx, ty);
+      }
+      if (!tile)
+        continue;
+
+      const unsigned int x0 = std::max(_x, tx * tileSize);
+      const unsigned int x1 = std::min(xEnd, tx * tileSize + tile->width);
+      const unsigned int y0 = std::max(_y, ty * tileSize);
+      const unsigned int y1 = std::min(yEnd, ty * tileSize + tile->height);
+      for (unsigned int y = y0; y < y1; ++y)
+      {
+        std::copy_n(tile->heights.begin() +
+            (y - ty * tileSize) * tile->width + (x0 - tx * tileSize),
+            x1 - x0, _heights.begin() +
+            static_cast<size_t>(y - _y) * _width + (x0 - _x));
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+float HeightmapTileCache::MinHeight() const
+{
+  return this->dataPtr->minHeight;
+}
+
+//////////////////////////////////////////////////
+float HeightmapTileCache::MaxHeight() const
+{
+  return this->dataPtr->maxHeight;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTileCache::VertSize() const
+{
+  return this->dataPtr->vertSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTileCache::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTileCache::MaxTiles() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxTiles;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTileCache::SetMaxTiles(const unsigned int _maxTiles)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxTiles = std::max(1u, _maxTiles);
+  this->dataPtr->Trim();
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTileCache::ResidentTiles() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->tiles.size();
+}
+
+//////////////////////////////////////////////////
+uint64_t HeightmapTileCache::Hits() const
+{
+  return this->dataPtr->hits;
+}
+
+//////////////////////////////////////////////////
+uint64_t HeightmapTileCache::Misses() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->misses;
+}
+
+//////////////////////////////////////////////////
+uint64_t HeightmapTileCache::Evictions() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->evictions;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTileCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->tiles.clear();
+  this->dataPtr->index.clear();
+}
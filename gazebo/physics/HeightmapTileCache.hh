@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HEIGHTMAPTILECACHE_HH_
+#define GAZEBO_PHYSICS_HEIGHTMAPTILECACHE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/HeightmapData.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class HeightmapTileCachePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class HeightmapTileCache HeightmapTileCache.hh physics/physics.hh
+    /// \brief Height lookup table of a heightmap that is built in square
+    /// tiles on demand instead of all at once.
+    ///
+    /// The table has the same layout as the one filled by
+    /// common::HeightmapData::FillHeightMap. A tile is computed from the
+    /// heightmap data the first time one of its vertices is queried, and
+    /// the least recently used tiles are evicted once more than
+    /// MaxTiles() are resident. Since the physics engines only query the
+    /// vertices under the bodies that touch the terrain, only the tiles
+    /// near those bodies stay in memory.
+    ///
+    /// Queries are thread safe. Each thread keeps the tile of its last
+    /// query, and reads it again without locking while its queries stay in
+    /// that tile. Such a tile stays in memory until the thread queries
+    /// another tile, even if it is evicted.
+    class GZ_PHYSICS_VISIBLE HeightmapTileCache
+    {
+      /// \brief Constructor.
+      /// \param[in] _data Heightmap data the tiles are built from. The data
+      /// must outlive the cache.
+      /// \param[in] _subSampling Multiplier used to increase the resolution.
+      /// \param[in] _vertSize Number of vertices per row of the table.
+      /// \param[in] _size Real dimensions of the terrain.
+      /// \param[in] _scale Vector3 used to scale the height.
+      /// \param[in] _flipY True to flip the table along the y direction.
+      /// \param[in] _tileSize Number of vertices per side of a tile.
+      /// \param[in] _maxTiles Maximum number of resident tiles.
+      public: HeightmapTileCache(common::HeightmapData *_data,
+                  const int _subSampling, const unsigned int _vertSize,
+                  const ignition::math::Vector3d &_size,
+                  const ignition::math::Vector3d &_scale, const bool _flipY,
+                  const unsigned int _tileSize = 256,
+                  const unsigned int _maxTiles = 256);
+
+      /// \brief Destructor.
+      public: virtual ~HeightmapTileCache();
+
+      /// \brief Get the height of a vertex, building its tile if needed.
+      /// \param[in] _x Column of the vertex.
+      /// \param[in] _y Row of the vertex.
+      /// \return Height of the vertex, or 0 if it is outside of the table.
+      public: float Height(const int _x, const int _y);
+
+      /// \brief Copy a rectangular region of the table, building its tiles
+      /// if needed. The cache is locked once per tile instead of once per
+      /// vertex.
+      /// \param[in] _x Column of the first vertex of the region.
+      /// \param[in] _y Row of the first vertex of the region.
+      /// \param[in] _width Number of vertices per row of the region.
+      /// \param[in] _height Number of rows of the region.
+      /// \param[out] _heights Heights of the region, row by row. Vertices
+      /// outside of the table are 0.
+      public: void FillRegion(const unsigned int _x, const unsigned int _y,
+                  const unsigned int _width, const unsigned int _height,
+                  std::vector<float> &_heights);
+
+      /// \brief Get the minimum height of the table.
+      /// \return The minimum height.
+      public: float MinHeight() const;
+
+      /// \brief Get the maximum height of the table.
+      /// \return The maximum height.
+      public: float MaxHeight() const;
+
+      /// \brief Get the number of vertices per row of the table.
+      /// \return Number of vertices per row.
+      public: unsigned int VertSize() const;
+
+      /// \brief Get the number of vertices per side of a tile.
+      /// \return Tile size.
+      public: unsigned int TileSize() const;
+
+      /// \brief Get the maximum number of resident tiles.
+      /// \return Maximum number of tiles.
+      public: unsigned int MaxTiles() const;
+
+      /// \brief Set the maximum number of resident tiles. Tiles are evicted
+      /// immediately if more are resident.
+      /// \param[in] _maxTiles Maximum number of tiles, at least 1.
+      public: void SetMaxTiles(const unsigned int _maxTiles);
+
+      /// \brief Get the number of tiles currently in memory.
+      /// \return Number of resident tiles.
+      public: unsigned int ResidentTiles() const;
+
+      /// \brief Get the number of queries answered by a resident tile.
+      /// \return Number of cache hits.
+      public: uint64_t Hits() const;
+
+      /// \brief Get the number of tiles that were built.
+      /// \return Number of cache misses.
+      public: uint64_t Misses() const;
+
+      /// \brief Get the number of tiles that were evicted.
+      /// \return Number of evictions.
+      public: uint64_t Evictions() const;
+
+      /// \brief Evict all tiles.
+      public: void Clear();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<HeightmapTileCachePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
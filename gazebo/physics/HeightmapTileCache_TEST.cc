@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "gazebo/common/ImageHeightmap.hh"
+#include "gazebo/physics/HeightmapTileCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HeightmapTileCacheTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Load the bowl heightmap and compute the parameters of its
+/// height lookup table the same way HeightmapShape does.
+void LoadBowl(common::ImageHeightmap &_img, unsigned int &_vertSize,
+    ignition::math::Vector3d &_size, ignition::math::Vector3d &_scale)
+{
+  ASSERT_EQ(0, _img.Load("file://media/materials/textures/heightmap_bowl.png"));
+
+  const int subSampling = 2;
+  _vertSize = (_img.GetWidth() * subSampling) - subSampling + 1;
+  _size.Set(129, 129, 10);
+  _scale.Set(_size.X() / _vertSize, _size.Y() / _vertSize,
+      _size.Z() / _img.GetMaxElevation());
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, MatchesFullTable)
+{
+  for (bool flipY : {false, true})
+  {
+    common::ImageHeightmap img;
+    unsigned int vertSize;
+    ignition::math::Vector3d size, scale;
+    LoadBowl(img, vertSize, size, scale);
+
+    std::vector<float> heights;
+    img.FillHeightMap(2, vertSize, size, scale, flipY, heights);
+    ASSERT_EQ(heights.size(), vertSize * vertSize);
+
+    // Tile size that does not divide the table, so that the last row and
+    // column of tiles are partial.
+    physics::HeightmapTileCache cache(&img, 2, vertSize, size, scale, flipY,
+        30, 4);
+    EXPECT_EQ(cache.VertSize(), vertSize);
+    EXPECT_EQ(cache.TileSize(), 30u);
+    EXPECT_EQ(cache.MaxTiles(), 4u);
+
+    for (unsigned int y = 0; y < vertSize; ++y)
+    {
+      for (unsigned int x = 0; x < vertSize; ++x)
+      {
+        ASSERT_FLOAT_EQ(heights[y * vertSize + x], cache.Height(x, y))
+          << x << " " << y << " " << flipY;
+      }
+    }
+
+    EXPECT_FLOAT_EQ(*std::min_element(heights.begin(), heights.end()),
+        cache.MinHeight());
+    EXPECT_FLOAT_EQ(*std::max_element(heights.begin(), heights.end()),
+        cache.MaxHeight());
+
+    // Out of bounds
+    EXPECT_FLOAT_EQ(0.0f, cache.Height(-1, 0));
+    EXPECT_FLOAT_EQ(0.0f, cache.Height(0, vertSize));
+
+    // A region across several tiles, partly outside of the table
+    std::vector<float> region;
+    const unsigned int x0 = 17;
+    const unsigned int y0 = vertSize - 40;
+    cache.FillRegion(x0, y0, 70, 50, region);
+    ASSERT_EQ(70u * 50u, region.size());
+    for (unsigned int y = 0; y < 50; ++y)
+    {
+      for (unsigned int x = 0; x < 70; ++x)
+      {
+        float expected = y0 + y < vertSize ?
+          heights[(y0 + y) * vertSize + x0 + x] : 0.0f;
+        ASSERT_FLOAT_EQ(expected, region[y * 70 + x]) << x << " " << y;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, Eviction)
+{
+  common::ImageHeightmap img;
+  unsigned int vertSize;
+  ignition::math::Vector3d size, scale;
+  LoadBowl(img, vertSize, size, scale);
+
+  physics::HeightmapTileCache cache(&img, 2, vertSize, size, scale, false,
+      64, 2);
+  EXPECT_EQ(cache.ResidentTiles(), 0u);
+
+  // First query of a tile builds it
+  float h = cache.Height(0, 0);
+  EXPECT_EQ(cache.Misses(), 1u);
+  EXPECT_EQ(cache.ResidentTiles(), 1u);
+
+  // Queries in the same tile are hits
+  EXPECT_FLOAT_EQ(h, cache.Height(0, 0));
+  cache.Height(63, 63);
+  EXPECT_EQ(cache.Misses(), 1u);
+  EXPECT_EQ(cache.Hits(), 2u);
+
+  // Fill the cache, then touch the first tile so that it is the most
+  // recently used one.
+  cache.Height(64, 0);
+  EXPECT_EQ(cache.ResidentTiles(), 2u);
+  cache.Height(0, 0);
+  EXPECT_EQ(cache.Misses(), 2u);
+
+  // A third tile evicts the least recently used one, which is (64, 0)
+  cache.Height(0, 64);
+  EXPECT_EQ(cache.ResidentTiles(), 2u);
+  EXPECT_EQ(cache.Evictions(), 1u);
+  cache.Height(0, 0);
+  EXPECT_EQ(cache.Misses(), 3u);
+  cache.Height(64, 0);
+  EXPECT_EQ(cache.Misses(), 4u);
+  EXPECT_EQ(cache.Evictions(), 2u);
+
+  // Shrinking the cache evicts immediately
+  cache.SetMaxTiles(1);
+  EXPECT_EQ(cache.ResidentTiles(), 1u);
+  EXPECT_EQ(cache.Evictions(), 3u);
+
+  cache.Clear();
+  EXPECT_EQ(cache.ResidentTiles(), 0u);
+  EXPECT_FLOAT_EQ(h, cache.Height(0, 0));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -24,6 +24,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
 
+#include "gazebo/physics/FeedbackRegistry.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
@@ -120,7 +121,10 @@ void Joint::Load(sdf::ElementPtr _sdf)
   if (_sdf->HasElement("physics"))
   {
     sdf::ElementPtr physicsElem = _sdf->GetElement("physics");
-    if (physicsElem->HasElement("provide_feedback"))
+    // With on demand feedback, only joints registered with the
+    // FeedbackRegistry provide feedback.
+    FeedbackRegistry *registry = this->world->Physics()->GetFeedbackRegistry();
+    if (physicsElem->HasElement("provide_feedback") && !registry->OnDemand())
     {
       this->SetProvideFeedback(physicsElem->Get<bool>("provide_feedback"));
     }
@@ -449,6 +453,10 @@ void Joint::SetEffortLimit(unsigned int _index, double _effort)
   if (_index < this->DOF())
   {
     this->effortLimit[_index] = _effort;
+
+    // New clients get the limits from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
     return;
   }
 
@@ -461,6 +469,10 @@ void Joint::SetVelocityLimit(unsigned int _index, double _velocity)
   if (_index < this->DOF())
   {
     this->velocityLimit[_index] = _velocity;
+
+    // New clients get the limits from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
     return;
   }
 
@@ -1135,7 +1147,12 @@ void Joint::SetLowerLimit(const unsigned int _index, const double _limit)
     gzwarn << "SetLowerLimit for joint [" << this->GetName()
            << "] index [" << _index
            << "] not supported\n";
+    return;
   }
+
+  // New clients get the limits from the scene message
+  if (this->world)
+    this->world->InvalidateSceneFragment(this->model);
 }
 
 //////////////////////////////////////////////////
@@ -1172,7 +1189,12 @@ void Joint::SetUpperLimit(const unsigned int _index, const double _limit)
     gzwarn << "SetUpperLimit for joint [" << this->GetName()
            << "] index [" << _index
            << "] not supported\n";
+    return;
   }
+
+  // New clients get the limits from the scene message
+  if (this->world)
+    this->world->InvalidateSceneFragment(this->model);
 }
 
 //////////////////////////////////////////////////
@@ -40,6 +40,7 @@
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/Link.hh"
+#include "gazebo/physics/PublicationPlanner.hh"
 #include "gazebo/physics/Wind.hh"
 
 #include "gazebo/util/IntrospectionManager.hh"
@@ -70,17 +71,12 @@ class gazebo::physics::LinkPrivate
   /// \brief All the attached models.
   public: std::vector<ModelPtr> attachedModels;
 
-  /// \brief Link data publisher
-  public: transport::PublisherPtr dataPub;
-
-  /// \brief Link data message
-  public: msgs::LinkData linkDataMsg;
-
-  /// \brief True to publish data, false otherwise
+  /// \brief True if this link added a consumer of its data to the
+  /// publication planner of the world.
   public: bool publishData = false;
 
   /// \brief Mutex to protect the publishData variable
-  public: std::recursive_mutex *publishDataMutex;
+  public: std::recursive_mutex publishDataMutex;
 
   /// \brief Cached list of collisions. This is here for performance.
   public: Collision_V collisions;
@@ -130,7 +126,6 @@ Link::Link(EntityPtr _parent)
   this->inertial.reset(new Inertial);
   this->dataPtr->parentJoints.clear();
   this->dataPtr->childJoints.clear();
-  this->dataPtr->publishDataMutex = new std::recursive_mutex();
 }
 
 //////////////////////////////////////////////////
@@ -405,15 +400,15 @@ void Link::Fini()
 
   // Clean transport
   {
-    this->dataPtr->dataPub.reset();
     this->visPub.reset();
 
     this->dataPtr->wrenchSub.reset();
   }
   this->connections.clear();
 
-  delete this->dataPtr->publishDataMutex;
-  this->dataPtr->publishDataMutex = NULL;
+  if (this->world)
+    this->world->Publications()->RemoveLink(this);
+  this->dataPtr->publishData = false;
 
   Entity::Fini();
 }
@@ -846,6 +841,9 @@ void Link::SetWindMode(const bool _mode)
     this->SetWindEnabled(false);
   else if (this->WindMode() && !this->dataPtr->updateConnection)
     this->SetWindEnabled(true);
+
+  // New clients get the wind mode from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 /////////////////////////////////////////////////
@@ -1219,49 +1217,24 @@ void Link::SetKinematic(const bool &/*_kinematic*/)
 /////////////////////////////////////////////////
 void Link::SetPublishData(bool _enable)
 {
-  // Skip if we're trying to disable after the publisher has already been
-  // cleared
-  if (!_enable && !this->dataPtr->dataPub)
+  if (!this->world)
     return;
 
   {
     std::lock_guard<std::recursive_mutex> lock(
-        *this->dataPtr->publishDataMutex);
+        this->dataPtr->publishDataMutex);
     if (this->dataPtr->publishData == _enable)
       return;
 
     this->dataPtr->publishData = _enable;
   }
+
+  // The world publishes the data of every enabled link once per step
+  LinkPtr self = boost::static_pointer_cast<Link>(shared_from_this());
   if (_enable)
-  {
-    std::string topic = "~/" + this->GetScopedName();
-    this->dataPtr->dataPub = this->node->Advertise<msgs::LinkData>(topic);
-    this->connections.push_back(
-      event::Events::ConnectWorldUpdateEnd(
-        std::bind(&Link::PublishData, this)));
-  }
+    this->world->Publications()->AddLinkData(self);
   else
-  {
-    this->dataPtr->dataPub.reset();
-    // Do we want to clear all of them though?
-    this->connections.clear();
-  }
-}
-
-/////////////////////////////////////////////////
-void Link::PublishData()
-{
-  if (this->dataPtr->publishData && this->dataPtr->dataPub->HasConnections())
-  {
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_time(),
-        this->world->SimTime());
-    this->dataPtr->linkDataMsg.set_name(this->GetScopedName());
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_linear_velocity(),
-        this->WorldLinearVel());
-    msgs::Set(this->dataPtr->linkDataMsg.mutable_angular_velocity(),
-        this->WorldAngularVel());
-    this->dataPtr->dataPub->Publish(this->dataPtr->linkDataMsg);
-  }
+    this->world->Publications()->RemoveLinkData(self);
 }
 
 //////////////////////////////////////////////////
@@ -1375,6 +1348,9 @@ bool Link::SetVisualPose(const uint32_t _id,
   visual.set_parent_id(this->GetId());
   msgs::Set(visual.mutable_pose(), _pose);
   this->visPub->Publish(visual);
+
+  // New clients get the visual pose from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
   return true;
 }
 
@@ -480,7 +480,9 @@ namespace gazebo
       /// \return Vector of parent Links connected by joints.
       public: Link_V GetParentJointsLinks() const;
 
-      /// \brief Enable/Disable link data publishing
+      /// \brief Enable/Disable link data publishing. The data is published
+      /// by the publication planner of the world, see World::Publications,
+      /// and only while the topic has subscribers.
       /// \param[in] _enable True to enable publishing, false to stop publishing
       public: void SetPublishData(bool _enable);
 
@@ -624,9 +626,6 @@ namespace gazebo
       /// \return a map of unique ID to visual message
       public: const Visuals_M &Visuals() const;
 
-      /// \brief Publish timestamped link data such as velocity.
-      private: void PublishData();
-
       /// \brief Load a new collision helper function.
       /// \param[in] _sdf SDF element used to load the collision.
       private: void LoadCollision(sdf::ElementPtr _sdf);
@@ -36,6 +36,7 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/common/URI.hh"
 
 #include "gazebo/physics/Gripper.hh"
@@ -46,6 +47,7 @@
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/StateBatch.hh"
 
 #include "gazebo/transport/Node.hh"
 
@@ -883,6 +885,35 @@ JointPtr Model::GetJoint(const std::string &_name)
   return result;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr Model::CreateStateBatch() const
+{
+  Joint_V joints;
+  Link_V links;
+  this->StateBatchEntities(joints, links);
+  return this->GetWorld()->Physics()->CreateStateBatch(joints, links);
+}
+
+//////////////////////////////////////////////////
+void Model::StateBatchEntities(Joint_V &_joints, Link_V &_links) const
+{
+  std::vector<const Model *> stack(1, this);
+  while (!stack.empty())
+  {
+    const Model *model = stack.back();
+    stack.pop_back();
+
+    _joints.insert(_joints.end(), model->joints.begin(), model->joints.end());
+    _links.insert(_links.end(), model->links.begin(), model->links.end());
+
+    for (auto iter = model->models.rbegin(); iter != model->models.rend();
+        ++iter)
+    {
+      stack.push_back(iter->get());
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 const Model_V &Model::NestedModels() const
 {
@@ -1130,6 +1161,7 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     try
     {
+      common::StartupScope startupScope(pluginName, "plugin");
       plugin->Load(myself, _sdf);
     }
     catch(...)
@@ -1483,6 +1515,9 @@ bool Model::GetAutoDisable() const
 void Model::SetSelfCollide(bool _self_collide)
 {
   this->sdf->GetElement("self_collide")->Set(_self_collide);
+
+  // New clients get the self collide flag from the scene message
+  this->world->InvalidateSceneFragment(shared_from_this());
 }
 
 /////////////////////////////////////////////////
@@ -1653,6 +1688,9 @@ void Model::SetWindMode(const bool _enable)
   this->sdf->GetElement("enable_wind")->Set(_enable);
   for (auto &link : this->links)
     link->SetWindMode(_enable);
+
+  // New clients get the wind mode from the scene message
+  this->world->InvalidateSceneFragment(shared_from_this());
 }
 
 /////////////////////////////////////////////////
@@ -201,6 +201,19 @@ namespace gazebo
       /// \return Pointer to the joint
       public: JointPtr GetJoint(const std::string &name);
 
+      /// \brief Create a batch to read and write the state of all the
+      /// joints and links of this model and its nested models, in a depth
+      /// first order with the joints and links of a model before those of
+      /// its nested models. See StateBatch for the array layouts.
+      /// \return The new batch, created by the physics engine.
+      public: StateBatchPtr CreateStateBatch() const;
+
+      /// \brief Append the joints and links of this model and its nested
+      /// models, in the order of CreateStateBatch.
+      /// \param[in,out] _joints Joints to append to.
+      /// \param[in,out] _links Links to append to.
+      public: void StateBatchEntities(Joint_V &_joints, Link_V &_links) const;
+
       /// \cond
       /// This is an internal function
       /// \brief Get a link by id.
@@ -28,11 +28,13 @@
 #include "gazebo/transport/Node.hh"
 
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/FeedbackRegistry.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PresetManager.hh"
+#include "gazebo/physics/StateBatch.hh"
 
 using namespace gazebo;
 using namespace physics;
@@ -64,6 +66,9 @@ PhysicsEngine::PhysicsEngine(WorldPtr _world)
   // Create and initialized the contact manager.
   this->contactManager = new ContactManager();
   this->contactManager->Init(this->world);
+
+  this->feedbackRegistry = new FeedbackRegistry();
+  this->feedbackRegistry->Init(this->world, this->physicsUpdateMutex);
 }
 
 //////////////////////////////////////////////////
@@ -105,6 +110,12 @@ void PhysicsEngine::Fini()
     this->contactManager = NULL;
   }
 
+  if (this->feedbackRegistry)
+  {
+    delete this->feedbackRegistry;
+    this->feedbackRegistry = NULL;
+  }
+
   if (this->physicsUpdateMutex)
   {
     delete this->physicsUpdateMutex;
@@ -153,6 +164,13 @@ ModelPtr PhysicsEngine::CreateModel(BasePtr _base)
   return ret;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr PhysicsEngine::CreateStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+{
+  return StateBatchPtr(new StateBatch(_joints, _links));
+}
+
 //////////////////////////////////////////////////
 double PhysicsEngine::GetTargetRealTimeFactor() const
 {
@@ -243,6 +261,8 @@ bool PhysicsEngine::SetParam(const std::string &_key,
       this->world->SetMagneticField(
           any_cast<ignition::math::Vector3d>(copy));
     }
+    else if (_key == "feedback_on_demand")
+      this->feedbackRegistry->SetOnDemand(any_cast<bool>(_value));
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in physics engine "
@@ -295,6 +315,8 @@ bool PhysicsEngine::GetParam(const std::string &_key,
     _value = this->world->Gravity();
   else if (_key == "magnetic_field")
     _value = this->world->MagneticField();
+  else if (_key == "feedback_on_demand")
+    _value = this->feedbackRegistry->OnDemand();
   else
   {
     gzwarn << "GetParam failed for [" << _key << "] in physics engine "
@@ -311,6 +333,12 @@ ContactManager *PhysicsEngine::GetContactManager() const
   return this->contactManager;
 }
 
+//////////////////////////////////////////////////
+FeedbackRegistry *PhysicsEngine::GetFeedbackRegistry() const
+{
+  return this->feedbackRegistry;
+}
+
 //////////////////////////////////////////////////
 sdf::ElementPtr PhysicsEngine::GetSDF() const
 {
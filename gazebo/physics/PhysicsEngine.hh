@@ -163,6 +163,15 @@ namespace gazebo
       public: virtual JointPtr CreateJoint(const std::string &_type,
                                            ModelPtr _parent = ModelPtr()) = 0;
 
+      /// \brief Create a batch to read and write the state of a set of
+      /// joints and links through contiguous arrays. The default batch
+      /// uses the Joint and Link API, engines may return a subclass that
+      /// accesses their own state directly.
+      /// \param[in] _joints Joints of the batch, in array order.
+      /// \param[in] _links Links of the batch, in array order.
+      /// \return The new batch.
+      public: virtual StateBatchPtr CreateStateBatch(const Joint_V &_joints,
+                  const Link_V &_links);
 
       /// \brief Set the gravity vector.
       /// \param[in] _gravity New gravity vector.
@@ -246,6 +255,11 @@ namespace gazebo
       /// \return Pointer to the contact manager.
       public: ContactManager *GetContactManager() const;
 
+      /// \brief Get a pointer to the feedback registry, which tells the
+      /// physics engine which joint and contact wrenches to compute.
+      /// \return Pointer to the feedback registry.
+      public: FeedbackRegistry *GetFeedbackRegistry() const;
+
       /// \brief returns a pointer to the PhysicsEngine#physicsUpdateMutex.
       /// \return Pointer to the physics mutex.
       public: boost::recursive_mutex *GetPhysicsUpdateMutex() const
@@ -313,6 +327,9 @@ namespace gazebo
       /// engine.
       protected: ContactManager *contactManager;
 
+      /// \brief Joints and collisions whose wrenches are consumed.
+      protected: FeedbackRegistry *feedbackRegistry;
+
       /// \brief Real time update rate.
       protected: double realTimeUpdateRate;
 
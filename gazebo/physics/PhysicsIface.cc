@@ -78,6 +78,18 @@ physics::WorldPtr physics::get_world(const std::string &_name)
   gzthrow("Unable to find world by name in physics::get_world(world_name)");
 }
 
+/////////////////////////////////////////////////
+std::vector<physics::WorldPtr> physics::get_worlds()
+{
+  return g_worlds;
+}
+
+/////////////////////////////////////////////////
+size_t physics::get_world_count()
+{
+  return g_worlds.size();
+}
+
 /////////////////////////////////////////////////
 bool physics::has_world(const std::string &_name)
 {
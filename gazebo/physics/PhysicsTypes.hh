@@ -42,6 +42,8 @@ namespace gazebo
     class Light;
     class Link;
     class Collision;
+    class CollisionSnapshot;
+    class FeedbackRegistry;
     class FrictionPyramid;
     class Gripper;
     class Joint;
@@ -51,6 +53,7 @@ namespace gazebo
     class UserCmd;
     class UserCmdManager;
     class PhysicsEngine;
+    class PublicationPlanner;
     class Wind;
     class Atmosphere;
     class Mass;
@@ -71,6 +74,7 @@ namespace gazebo
     class LightState;
     class LinkState;
     class JointState;
+    class StateBatch;
     class TrajectoryInfo;
 
     /// \def BasePtr
@@ -113,10 +117,18 @@ namespace gazebo
     /// \brief Boost shared pointer to a Collision object
     typedef boost::shared_ptr<Collision> CollisionPtr;
 
+    /// \def CollisionSnapshotPtr
+    /// \brief Shared pointer to an immutable CollisionSnapshot object
+    typedef std::shared_ptr<const CollisionSnapshot> CollisionSnapshotPtr;
+
     /// \def JointPtr
     /// \brief Boost shared pointer to a Joint object
     typedef boost::shared_ptr<Joint> JointPtr;
 
+    /// \def StateBatchPtr
+    /// \brief Shared pointer to a StateBatch object
+    typedef std::shared_ptr<StateBatch> StateBatchPtr;
+
     /// \def JointControllerPtr
     /// \brief Boost shared pointer to a JointController object
     typedef boost::shared_ptr<JointController> JointControllerPtr;
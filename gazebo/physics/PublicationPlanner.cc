@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/PublicationPlanner.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for PublicationPlanner
+class gazebo::physics::PublicationPlannerPrivate
+{
+  /// \brief A link published by the planner.
+  public: struct LinkDataEntry
+  {
+    /// \brief The link. Entries are removed when the link is destroyed.
+    Link *link;
+
+    /// \brief Publisher of the link topic.
+    transport::PublisherPtr pub;
+
+    /// \brief Connection to the subscriber changes of the link topic,
+    /// reset before pub.
+    event::ConnectionPtr connectionsChanged;
+
+    /// \brief Number of consumers.
+    unsigned int consumers;
+
+    /// \brief Index in active, or kInactive.
+    std::size_t activeIndex;
+  };
+
+  /// \brief Value of LinkDataEntry::activeIndex for links that are not
+  /// published.
+  public: static const std::size_t kInactive = static_cast<std::size_t>(-1);
+
+  /// \brief Add or remove an entry from the active list.
+  /// \param[in] _index Index of the entry.
+  /// \param[in] _active True to publish the link.
+  public: void SetActive(const std::size_t _index, const bool _active)
+  {
+    LinkDataEntry &entry = this->entries[_index];
+    if (_active && entry.activeIndex == kInactive)
+    {
+      entry.activeIndex = this->active.size();
+      this->active.push_back(_index);
+    }
+    else if (!_active && entry.activeIndex != kInactive)
+    {
+      const std::size_t last = this->active.back();
+      this->active[entry.activeIndex] = last;
+      this->entries[last].activeIndex = entry.activeIndex;
+      this->active.pop_back();
+      entry.activeIndex = kInactive;
+    }
+  }
+
+  /// \brief Remove an entry, moving the last entry in its place.
+  /// \param[in] _index Index of the entry.
+  public: void Erase(const std::size_t _index)
+  {
+    // Disconnect while the publisher keeps its publication alive
+    this->entries[_index].connectionsChanged.reset();
+    this->SetActive(_index, false);
+    this->indices.erase(this->entries[_index].link);
+    if (_index + 1 < this->entries.size())
+    {
+      this->entries[_index] = std::move(this->entries.back());
+      this->indices[this->entries[_index].link] = _index;
+      if (this->entries[_index].activeIndex != kInactive)
+        this->active[this->entries[_index].activeIndex] = _index;
+    }
+    this->entries.pop_back();
+  }
+
+  /// \brief Record that the subscribers of a link topic changed, called
+  /// from the transport threads.
+  /// \param[in] _link The link.
+  public: void OnConnectionsChanged(const Link *_link)
+  {
+    std::lock_guard<std::mutex> lock(this->changedMutex);
+    this->changed.push_back(_link);
+  }
+
+  /// \brief Node used to advertise topics.
+  public: transport::NodePtr node;
+
+  /// \brief Dense list of the links with consumers.
+  public: std::vector<LinkDataEntry> entries;
+
+  /// \brief Index in entries of each link.
+  public: std::unordered_map<const Link *, std::size_t> indices;
+
+  /// \brief Indices in entries of the links whose topic has subscribers.
+  public: std::vector<std::size_t> active;
+
+  /// \brief Message reused for every link.
+  public: msgs::LinkData linkDataMsg;
+
+  /// \brief Protects the members above.
+  public: mutable std::mutex mutex;
+
+  /// \brief Links whose topic gained or lost subscribers since the last
+  /// update. The pointers are only used as keys of indices.
+  public: std::vector<const Link *> changed;
+
+  /// \brief Protects changed. Separate from mutex, since the publisher
+  /// events can be signaled while mutex is held, for example by Advertise.
+  public: std::mutex changedMutex;
+};
+
+/////////////////////////////////////////////////
+PublicationPlanner::PublicationPlanner()
+  : dataPtr(new PublicationPlannerPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PublicationPlanner::~PublicationPlanner()
+{
+  this->Fini();
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::Init(transport::NodePtr _node)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->node = _node;
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::Fini()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &entry : this->dataPtr->entries)
+    entry.connectionsChanged.reset();
+  this->dataPtr->entries.clear();
+  this->dataPtr->indices.clear();
+  this->dataPtr->active.clear();
+  this->dataPtr->node.reset();
+
+  std::lock_guard<std::mutex> changedLock(this->dataPtr->changedMutex);
+  this->dataPtr->changed.clear();
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::AddLinkData(LinkPtr _link)
+{
+  if (!_link)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link.get());
+  if (iter != this->dataPtr->indices.end())
+  {
+    ++this->dataPtr->entries[iter->second].consumers;
+    return;
+  }
+
+  if (!this->dataPtr->node)
+  {
+    gzerr << "Unable to publish the data of link [" << _link->GetScopedName()
+          << "], the publication planner is not initialized" << std::endl;
+    return;
+  }
+
+  PublicationPlannerPrivate::LinkDataEntry entry;
+  entry.link = _link.get();
+  entry.pub = this->dataPtr->node->Advertise<msgs::LinkData>(
+      "~/" + _link->GetScopedName());
+  entry.consumers = 1;
+  entry.activeIndex = PublicationPlannerPrivate::kInactive;
+
+  PublicationPlannerPrivate *dataPtr = this->dataPtr.get();
+  const Link *link = entry.link;
+  entry.connectionsChanged = entry.pub->ConnectConnectionsChanged(
+      [dataPtr, link](const bool)
+      {
+        dataPtr->OnConnectionsChanged(link);
+      });
+
+  // The topic may already have subscribers, check it on the next update
+  this->dataPtr->OnConnectionsChanged(link);
+
+  this->dataPtr->indices[entry.link] = this->dataPtr->entries.size();
+  this->dataPtr->entries.push_back(std::move(entry));
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::RemoveLinkData(LinkPtr _link)
+{
+  if (!_link)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link.get());
+  if (iter == this->dataPtr->indices.end())
+    return;
+
+  if (--this->dataPtr->entries[iter->second].consumers == 0)
+    this->dataPtr->Erase(iter->second);
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::RemoveLink(const Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->indices.find(_link);
+  if (iter != this->dataPtr->indices.end())
+    this->dataPtr->Erase(iter->second);
+}
+
+/////////////////////////////////////////////////
+bool PublicationPlanner::LinkDataEnabled(const Link *_link) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->indices.count(_link) > 0;
+}
+
+/////////////////////////////////////////////////
+unsigned int PublicationPlanner::LinkDataCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int PublicationPlanner::ActiveLinkDataCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->active.size();
+}
+
+/////////////////////////////////////////////////
+void PublicationPlanner::Update(const common::Time &_simTime)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Plan the step: only the links whose topic gained or lost subscribers
+  // since the last update are checked
+  std::vector<const Link *> changed;
+  {
+    std::lock_guard<std::mutex> changedLock(this->dataPtr->changedMutex);
+    changed.swap(this->dataPtr->changed);
+  }
+  for (auto const link : changed)
+  {
+    auto iter = this->dataPtr->indices.find(link);
+    if (iter != this->dataPtr->indices.end())
+    {
+      this->dataPtr->SetActive(iter->second,
+          this->dataPtr->entries[iter->second].pub->HasConnections());
+    }
+  }
+
+  if (this->dataPtr->active.empty())
+    return;
+
+  msgs::LinkData &msg = this->dataPtr->linkDataMsg;
+  msgs::Set(msg.mutable_time(), _simTime);
+  for (auto const index : this->dataPtr->active)
+  {
+    auto &entry = this->dataPtr->entries[index];
+    msg.set_name(entry.link->GetScopedName());
+    msgs::Set(msg.mutable_linear_velocity(), entry.link->WorldLinearVel());
+    msgs::Set(msg.mutable_angular_velocity(), entry.link->WorldAngularVel());
+    entry.pub->Publish(msg);
+  }
+}
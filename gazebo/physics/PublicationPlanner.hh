@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_PUBLICATIONPLANNER_HH_
+#define GAZEBO_PHYSICS_PUBLICATIONPLANNER_HH_
+
+#include <memory>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class PublicationPlannerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class PublicationPlanner PublicationPlanner.hh physics/physics.hh
+    /// \brief Publishes per link data, such as velocities on the
+    /// ~/<link scoped name> topic, for the links that have consumers.
+    ///
+    /// Links are added by their consumers, for example with
+    /// Link::SetPublishData from a sensor or a plugin, and are kept in a
+    /// dense list. Additions are counted, so several consumers can share a
+    /// link. The links whose topic has subscribers are kept in an active
+    /// list, which is updated from the subscriber changes signaled by the
+    /// link publishers, see transport::Publisher::ConnectConnectionsChanged.
+    /// Once per step, World::Update calls Update, which applies the changes
+    /// and publishes only the active links. Links without subscribers, and
+    /// links that were never added, cost nothing per step.
+    ///
+    /// The planner is owned by the World, see World::Publications. It is
+    /// thread safe.
+    class GZ_PHYSICS_VISIBLE PublicationPlanner
+    {
+      /// \brief Constructor.
+      public: PublicationPlanner();
+
+      /// \brief Destructor.
+      public: virtual ~PublicationPlanner();
+
+      /// \brief Initialize the planner.
+      /// \param[in] _node Transport node used to advertise link topics.
+      public: void Init(transport::NodePtr _node);
+
+      /// \brief Remove all links and publishers.
+      public: void Fini();
+
+      /// \brief Add a consumer of the data of a link. The first addition
+      /// advertises the link topic.
+      /// \param[in] _link Link to publish.
+      public: void AddLinkData(LinkPtr _link);
+
+      /// \brief Remove one consumer of the data of a link. The link is
+      /// no longer published after its last consumer is removed.
+      /// \param[in] _link Link to stop publishing.
+      public: void RemoveLinkData(LinkPtr _link);
+
+      /// \brief Remove a link regardless of its number of consumers. Called
+      /// when the link is destroyed.
+      /// \param[in] _link Link to remove.
+      public: void RemoveLink(const Link *_link);
+
+      /// \brief Get whether a link has consumers.
+      /// \param[in] _link Link to check.
+      /// \return True if the link was added and not removed.
+      public: bool LinkDataEnabled(const Link *_link) const;
+
+      /// \brief Get the number of links with consumers.
+      /// \return Number of links added.
+      public: unsigned int LinkDataCount() const;
+
+      /// \brief Get the number of links whose topic had subscribers at the
+      /// last update, which are the links it published.
+      /// \return Number of links published.
+      public: unsigned int ActiveLinkDataCount() const;
+
+      /// \brief Plan the step and publish the data of the active links.
+      /// Called by World::Update once per step.
+      /// \param[in] _simTime Simulation time stamped on the messages.
+      public: void Update(const common::Time &_simTime);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PublicationPlannerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/PublicationPlanner.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class PublicationPlannerTest : public ServerFixture
+{
+};
+
+std::atomic<unsigned int> g_linkDataCount{0};
+std::string g_linkDataName;
+
+/////////////////////////////////////////////////
+void OnLinkData(ConstLinkDataPtr &_msg)
+{
+  g_linkDataName = _msg->name();
+  ++g_linkDataCount;
+}
+
+/////////////////////////////////////////////////
+TEST_F(PublicationPlannerTest, LinkData)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PublicationPlanner *planner = world->Publications();
+  ASSERT_TRUE(planner != nullptr);
+  EXPECT_EQ(planner->LinkDataCount(), 0u);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 2));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  ASSERT_FALSE(model->GetLinks().empty());
+  physics::LinkPtr link = model->GetLinks()[0];
+
+  // Enabled without subscribers: planned out of every step
+  link->SetPublishData(true);
+  EXPECT_TRUE(planner->LinkDataEnabled(link.get()));
+  EXPECT_EQ(planner->LinkDataCount(), 1u);
+  world->Step(1);
+  EXPECT_EQ(planner->ActiveLinkDataCount(), 0u);
+
+  transport::SubscriberPtr sub = this->node->Subscribe(
+      "~/" + link->GetScopedName(), &OnLinkData);
+
+  // With a subscriber the link is published every step
+  g_linkDataCount = 0;
+  world->Step(10);
+  EXPECT_EQ(planner->ActiveLinkDataCount(), 1u);
+  for (int i = 0; i < 50 && g_linkDataCount == 0u; ++i)
+    common::Time::MSleep(10);
+  EXPECT_GT(g_linkDataCount, 0u);
+  EXPECT_EQ(g_linkDataName, link->GetScopedName());
+
+  // Once the subscriber is gone the link is planned out again. A removal
+  // that races with a publication is only applied by the next one.
+  sub.reset();
+  world->Step(2);
+  EXPECT_EQ(planner->ActiveLinkDataCount(), 0u);
+  g_linkDataCount = 0;
+  sub = this->node->Subscribe("~/" + link->GetScopedName(), &OnLinkData);
+  world->Step(1);
+  EXPECT_EQ(planner->ActiveLinkDataCount(), 1u);
+
+  // Consumers are counted
+  planner->AddLinkData(link);
+  link->SetPublishData(false);
+  EXPECT_TRUE(planner->LinkDataEnabled(link.get()));
+  planner->RemoveLinkData(link);
+  EXPECT_FALSE(planner->LinkDataEnabled(link.get()));
+  EXPECT_EQ(planner->LinkDataCount(), 0u);
+
+  world->Step(1);
+  EXPECT_EQ(planner->ActiveLinkDataCount(), 0u);
+
+  // Deleted links are removed
+  link->SetPublishData(true);
+  EXPECT_EQ(planner->LinkDataCount(), 1u);
+  link.reset();
+  model.reset();
+  sub.reset();
+  world->RemoveModel("box");
+  EXPECT_EQ(planner->LinkDataCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
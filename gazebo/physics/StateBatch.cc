@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/StateBatch.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for StateBatch
+class gazebo::physics::StateBatchPrivate
+{
+  /// \brief Joints of the batch.
+  public: Joint_V joints;
+
+  /// \brief Links of the batch.
+  public: Link_V links;
+
+  /// \brief Offset of each joint in a joint array, with the total size
+  /// as the last element.
+  public: std::vector<unsigned int> offsets;
+
+  /// \brief Mutex locked by an empty batch, which has no world.
+  public: boost::recursive_mutex emptyMutex;
+
+  /// \brief Physics update mutex of the world of the entities.
+  public: boost::recursive_mutex *mutex = nullptr;
+};
+
+//////////////////////////////////////////////////
+StateBatch::StateBatch(const Joint_V &_joints, const Link_V &_links)
+  : dataPtr(new StateBatchPrivate)
+{
+  this->dataPtr->joints = _joints;
+  this->dataPtr->links = _links;
+
+  this->dataPtr->offsets.reserve(_joints.size() + 1);
+  unsigned int offset = 0;
+  for (auto const &joint : _joints)
+  {
+    GZ_ASSERT(joint, "Joint of a state batch is null");
+    this->dataPtr->offsets.push_back(offset);
+    offset += joint->DOF();
+  }
+  this->dataPtr->offsets.push_back(offset);
+
+  WorldPtr world;
+  if (!_joints.empty())
+    world = _joints.front()->GetWorld();
+  else if (!_links.empty())
+    world = _links.front()->GetWorld();
+
+  if (world && world->Physics())
+    this->dataPtr->mutex = world->Physics()->GetPhysicsUpdateMutex();
+  else
+    this->dataPtr->mutex = &this->dataPtr->emptyMutex;
+}
+
+//////////////////////////////////////////////////
+StateBatch::~StateBatch()
+{
+}
+
+//////////////////////////////////////////////////
+const Joint_V &StateBatch::Joints() const
+{
+  return this->dataPtr->joints;
+}
+
+//////////////////////////////////////////////////
+const Link_V &StateBatch::Links() const
+{
+  return this->dataPtr->links;
+}
+
+//////////////////////////////////////////////////
+unsigned int StateBatch::JointCoordinateCount() const
+{
+  return this->dataPtr->offsets.back();
+}
+
+//////////////////////////////////////////////////
+unsigned int StateBatch::LinkCount() const
+{
+  return this->dataPtr->links.size();
+}
+
+//////////////////////////////////////////////////
+unsigned int StateBatch::JointOffset(const unsigned int _joint) const
+{
+  GZ_ASSERT(_joint < this->dataPtr->joints.size(),
+      "Joint index out of range");
+  return this->dataPtr->offsets[_joint];
+}
+
+//////////////////////////////////////////////////
+boost::recursive_mutex *StateBatch::UpdateMutex() const
+{
+  return this->dataPtr->mutex;
+}
+
+//////////////////////////////////////////////////
+void StateBatch::JointPositions(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      *_out++ = joint->Position(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::JointVelocities(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      *_out++ = joint->GetVelocity(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::JointForces(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      *_out++ = joint->GetForce(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::LinkPoses(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &link : this->dataPtr->links)
+  {
+    const ignition::math::Pose3d &pose = link->WorldPose();
+    _out[0] = pose.Pos().X();
+    _out[1] = pose.Pos().Y();
+    _out[2] = pose.Pos().Z();
+    _out[3] = pose.Rot().W();
+    _out[4] = pose.Rot().X();
+    _out[5] = pose.Rot().Y();
+    _out[6] = pose.Rot().Z();
+    _out += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::LinkTwists(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &link : this->dataPtr->links)
+  {
+    const ignition::math::Vector3d lin = link->WorldCoGLinearVel();
+    const ignition::math::Vector3d ang = link->WorldAngularVel();
+    _out[0] = lin.X();
+    _out[1] = lin.Y();
+    _out[2] = lin.Z();
+    _out[3] = ang.X();
+    _out[4] = ang.Y();
+    _out[5] = ang.Z();
+    _out += TwistSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::SetJointPositions(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      joint->SetPosition(i, *_in++);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::SetJointVelocities(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      joint->SetVelocity(i, *_in++);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::SetJointForces(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &joint : this->dataPtr->joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+      joint->SetForce(i, *_in++);
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::SetLinkPoses(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &link : this->dataPtr->links)
+  {
+    link->SetWorldPose(ignition::math::Pose3d(
+        _in[0], _in[1], _in[2], _in[3], _in[4], _in[5], _in[6]));
+    _in += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void StateBatch::SetLinkTwists(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->dataPtr->mutex);
+  for (auto const &link : this->dataPtr->links)
+  {
+    link->SetLinearVel(ignition::math::Vector3d(_in[0], _in[1], _in[2]));
+    link->SetAngularVel(ignition::math::Vector3d(_in[3], _in[4], _in[5]));
+    _in += TwistSize;
+  }
+}
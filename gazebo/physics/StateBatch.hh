@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_STATEBATCH_HH_
+#define GAZEBO_PHYSICS_STATEBATCH_HH_
+
+#include <memory>
+#include <boost/thread/recursive_mutex.hpp>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class StateBatchPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class StateBatch StateBatch.hh physics/physics.hh
+    /// \brief Read and write the state of a fixed set of joints and links
+    /// through contiguous arrays, in one call per quantity.
+    ///
+    /// A batch is created once with PhysicsEngine::CreateStateBatch,
+    /// Model::CreateStateBatch or World::CreateStateBatch, and can then be
+    /// used every step without name lookups or JointState/LinkState
+    /// objects. Each call locks the physics update mutex once for the
+    /// whole array.
+    ///
+    /// Joint arrays hold one value per degree of freedom, joints in the
+    /// order of the batch and the axes of a joint in index order, for a
+    /// total of JointCoordinateCount() values. Link pose arrays hold 7
+    /// values per link: world position x, y, z followed by the world
+    /// orientation quaternion w, x, y, z. Link twist arrays hold 6 values
+    /// per link: world linear velocity of the center of mass followed by
+    /// world angular velocity.
+    ///
+    /// The base class uses the Joint and Link API of each entity, so it
+    /// works with every physics engine. Engines can return a subclass from
+    /// PhysicsEngine::CreateStateBatch that reads engine state directly.
+    class GZ_PHYSICS_VISIBLE StateBatch
+    {
+      /// \brief Number of values per link in a pose array.
+      public: static const unsigned int PoseSize = 7;
+
+      /// \brief Number of values per link in a twist array.
+      public: static const unsigned int TwistSize = 6;
+
+      /// \brief Constructor.
+      /// \param[in] _joints Joints of the batch, in array order.
+      /// \param[in] _links Links of the batch, in array order.
+      public: StateBatch(const Joint_V &_joints, const Link_V &_links);
+
+      /// \brief Destructor.
+      public: virtual ~StateBatch();
+
+      /// \brief Get the joints of the batch.
+      /// \return Joints in array order.
+      public: const Joint_V &Joints() const;
+
+      /// \brief Get the links of the batch.
+      /// \return Links in array order.
+      public: const Link_V &Links() const;
+
+      /// \brief Get the size of a joint array, which is the sum of the
+      /// degrees of freedom of all joints.
+      /// \return Number of values in a joint array.
+      public: unsigned int JointCoordinateCount() const;
+
+      /// \brief Get the number of links in the batch.
+      /// \return Number of links.
+      public: unsigned int LinkCount() const;
+
+      /// \brief Get the index of the first value of a joint in a joint
+      /// array.
+      /// \param[in] _joint Index of the joint in Joints().
+      /// \return Offset of the joint in a joint array.
+      public: unsigned int JointOffset(const unsigned int _joint) const;
+
+      /// \brief Read joint positions.
+      /// \param[out] _out Array of JointCoordinateCount() values.
+      public: virtual void JointPositions(double *_out) const;
+
+      /// \brief Read joint velocities.
+      /// \param[out] _out Array of JointCoordinateCount() values.
+      public: virtual void JointVelocities(double *_out) const;
+
+      /// \brief Read the joint efforts applied during the current step,
+      /// see Joint::GetForce.
+      /// \param[out] _out Array of JointCoordinateCount() values.
+      public: virtual void JointForces(double *_out) const;
+
+      /// \brief Read link world poses.
+      /// \param[out] _out Array of LinkCount() * PoseSize values.
+      public: virtual void LinkPoses(double *_out) const;
+
+      /// \brief Read link world twists.
+      /// \param[out] _out Array of LinkCount() * TwistSize values.
+      public: virtual void LinkTwists(double *_out) const;
+
+      /// \brief Set joint positions, see Joint::SetPosition.
+      /// \param[in] _in Array of JointCoordinateCount() values.
+      public: virtual void SetJointPositions(const double *_in);
+
+      /// \brief Set joint velocities, see Joint::SetVelocity.
+      /// \param[in] _in Array of JointCoordinateCount() values.
+      public: virtual void SetJointVelocities(const double *_in);
+
+      /// \brief Apply joint efforts for the next step, see Joint::SetForce.
+      /// \param[in] _in Array of JointCoordinateCount() values.
+      public: virtual void SetJointForces(const double *_in);
+
+      /// \brief Set link world poses.
+      /// \param[in] _in Array of LinkCount() * PoseSize values.
+      public: virtual void SetLinkPoses(const double *_in);
+
+      /// \brief Set link world twists.
+      /// \param[in] _in Array of LinkCount() * TwistSize values.
+      public: virtual void SetLinkTwists(const double *_in);
+
+      /// \brief Get the mutex that every call locks, which is the physics
+      /// update mutex of the world of the batch entities.
+      /// \return Pointer to the mutex.
+      protected: boost::recursive_mutex *UpdateMutex() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StateBatchPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -22,13 +22,20 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
 #include <deque>
+#include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <ignition/math/Rand.hh>
 #include <ignition/math/SemanticVersion.hh>
 
@@ -52,9 +59,11 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/URI.hh"
 
@@ -71,6 +80,7 @@
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PhysicsFactory.hh"
+#include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/Atmosphere.hh"
 #include "gazebo/physics/AtmosphereFactory.hh"
 #include "gazebo/physics/PresetManager.hh"
@@ -84,8 +94,10 @@
 #include "gazebo/common/SphericalCoordinates.hh"
 
 #include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CollisionSnapshot.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/Population.hh"
+#include "gazebo/physics/StateBatch.hh"
 
 using namespace gazebo;
 using namespace physics;
@@ -108,6 +120,482 @@ class ModelUpdate_TBB
   private: Model_V *models;
 };
 
+/// \brief A file that LoadEntities reads ahead of constructing the models.
+struct LoadPrefetchJob
+{
+  /// \brief Full path to the file.
+  std::string path;
+
+  /// \brief True if the file is a plugin library, false if it is a mesh.
+  bool plugin;
+
+  /// \brief Handle of the plugin library once it is open.
+  void *handle = nullptr;
+};
+
+/// \brief Reads mesh files and plugin libraries on the TBB worker pool so
+/// that the sequential construction of the models finds them in the
+/// MeshManager and in the process.
+class LoadPrefetch_TBB
+{
+  public: explicit LoadPrefetch_TBB(std::vector<LoadPrefetchJob> *_jobs)
+          : jobs(_jobs) {}
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    for (size_t i = _r.begin(); i != _r.end(); i++)
+    {
+      LoadPrefetchJob &job = (*this->jobs)[i];
+      if (job.plugin)
+      {
+        // The handle is kept open until the plugins are loaded. PluginT::
+        // Create opens the library again and the loader returns the
+        // resident copy.
+        job.handle = dlopen(job.path.c_str(), RTLD_LAZY|RTLD_GLOBAL);
+      }
+      else
+      {
+        try
+        {
+          common::MeshManager::Instance()->Load(job.path);
+        }
+        catch(...)
+        {
+          // The error is reported again when the model loads the mesh.
+        }
+      }
+    }
+  }
+
+  private: std::vector<LoadPrefetchJob> *jobs;
+};
+
+//////////////////////////////////////////////////
+/// \brief Close the plugin libraries opened by LoadPrefetch_TBB. The
+/// libraries of the loaded plugins stay resident.
+/// \param[in,out] _handles Handles to close, cleared on return.
+static void CloseLoadPrefetchHandles(std::vector<void *> &_handles)
+{
+  for (auto handle : _handles)
+    dlclose(handle);
+  _handles.clear();
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the collision meshes and plugin libraries referenced by
+/// an element and its descendants.
+/// \param[in] _elem Element to walk.
+/// \param[in,out] _seen Paths already collected.
+/// \param[in,out] _jobs Files to prefetch.
+static void CollectLoadPrefetchJobs(sdf::ElementPtr _elem,
+    std::set<std::string> &_seen, std::vector<LoadPrefetchJob> &_jobs)
+{
+  const std::string &name = _elem->GetName();
+  if (name == "plugin" && _elem->HasAttribute("filename"))
+  {
+    std::string filename = _elem->Get<std::string>("filename");
+    std::string fullname = ModelPlugin::FindLibrary(filename);
+    if (_seen.insert(fullname).second)
+      _jobs.push_back({fullname, true});
+    return;
+  }
+
+  // Visual meshes are loaded by the rendering engine, only collision meshes
+  // are needed to construct the models.
+  if (name == "visual")
+    return;
+
+  if (name == "mesh" && _elem->HasElement("uri") &&
+      _elem->GetParent() && _elem->GetParent()->GetParent() &&
+      _elem->GetParent()->GetParent()->GetName() == "collision")
+  {
+    // Resolve the uri the same way MeshShape::Init does
+    std::string uri = common::asFullPath(_elem->Get<std::string>("uri"),
+        _elem->FilePath());
+    std::string path = common::find_file(uri);
+    if (!path.empty() && path != "__default__" && _seen.insert(path).second)
+      _jobs.push_back({path, false});
+    return;
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    CollectLoadPrefetchJobs(child, _seen, _jobs);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Insert, move or remove the box of a model in the tree of the
+/// world. The modelTreeMutex must be locked.
+/// \param[in] _data World data.
+/// \param[in] _model The model.
+/// \param[in,out] _entry Entry of the model.
+static void RefreshModelTreeEntry(WorldPrivate *_data, const ModelPtr &_model,
+    ModelTreeEntry &_entry)
+{
+  ignition::math::AxisAlignedBox box = _model->BoundingBox();
+
+  // Models without links have an empty box
+  if (box.Min().X() > box.Max().X() || box.Min().Y() > box.Max().Y() ||
+      box.Min().Z() > box.Max().Z())
+  {
+    if (_entry.proxy >= 0)
+    {
+      _data->modelTree.Remove(_entry.proxy);
+      _entry.proxy = -1;
+    }
+    return;
+  }
+
+  if (_entry.proxy < 0)
+    _entry.proxy = _data->modelTree.Insert(box, _model->GetId());
+  else
+    _data->modelTree.Update(_entry.proxy, box);
+}
+
+//////////////////////////////////////////////////
+/// \brief Refresh the box of a model and of its nested models, which move
+/// with it. The modelTreeMutex must be locked.
+/// \param[in] _data World data.
+/// \param[in] _model The model.
+static void RefreshModelTreeModel(WorldPrivate *_data, const ModelPtr &_model)
+{
+  auto iter = _data->modelTreeEntries.find(_model->GetId());
+  if (iter != _data->modelTreeEntries.end())
+    RefreshModelTreeEntry(_data, _model, iter->second);
+
+  for (auto const &nested : _model->NestedModels())
+    RefreshModelTreeModel(_data, nested);
+}
+
+//////////////////////////////////////////////////
+/// \brief Add models and their nested models to the entries of the tree,
+/// depth first, reusing the previous entries of the models.
+/// \param[in] _models Models to add.
+/// \param[in,out] _old Previous entries. Reused entries are removed.
+/// \param[in,out] _entries New entries.
+static void CollectModelTreeEntries(const Model_V &_models,
+    std::map<uint32_t, ModelTreeEntry> &_old,
+    std::map<uint32_t, ModelTreeEntry> &_entries)
+{
+  for (auto const &model : _models)
+  {
+    ModelTreeEntry entry;
+    auto iter = _old.find(model->GetId());
+    if (iter != _old.end())
+    {
+      entry = iter->second;
+      _old.erase(iter);
+    }
+    entry.model = model;
+    entry.order = _entries.size();
+    _entries[model->GetId()] = entry;
+
+    CollectModelTreeEntries(model->NestedModels(), _old, _entries);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Bring the collision snapshot up to date with the models that
+/// moved, and make it the latest. Only called by the world thread.
+/// \param[in] _data World data.
+static void RefreshCollisionSnapshot(WorldPrivate *_data)
+{
+  if (!_data->physicsEngine || !_data->collisionSnapshotEnabled)
+    return;
+
+  CollisionSnapshotPtr previous = std::atomic_load(&_data->collisionSnapshot);
+
+  bool rebuild;
+  Model_V models;
+  std::set<uint32_t> moved;
+  {
+    std::lock_guard<std::mutex> lock(_data->modelTreeMutex);
+    rebuild = !previous || _data->collisionSnapshotModelsChanged;
+    _data->collisionSnapshotModelsChanged = false;
+    moved.swap(_data->collisionSnapshotDirty);
+    if (rebuild || !moved.empty())
+      models = _data->models;
+  }
+
+  if (!rebuild && moved.empty())
+    return;
+
+  CollisionSnapshotPtr snapshot;
+  if (rebuild)
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *_data->physicsEngine->GetPhysicsUpdateMutex());
+    snapshot = CollisionSnapshot::Build(models, _data->simTime,
+        _data->iterations, previous);
+  }
+  else
+  {
+    // The copy is made outside of the physics lock, only the collisions of
+    // the models that moved are read from the engine.
+    auto updated = std::make_shared<CollisionSnapshot>(*previous,
+        _data->simTime, _data->iterations);
+
+    boost::recursive_mutex::scoped_lock plock(
+        *_data->physicsEngine->GetPhysicsUpdateMutex());
+    std::vector<ModelPtr> stack(models.rbegin(), models.rend());
+    while (!stack.empty())
+    {
+      ModelPtr model = stack.back();
+      stack.pop_back();
+
+      if (moved.count(model->GetId()))
+        updated->AddModel(model);
+
+      Model_V nested = model->NestedModels();
+      stack.insert(stack.end(), nested.rbegin(), nested.rend());
+    }
+    snapshot = updated;
+  }
+
+  std::atomic_store(&_data->collisionSnapshot, snapshot);
+}
+
+//////////////////////////////////////////////////
+/// \brief Bring the tree of model boxes up to date and run a query on it.
+/// \param[in] _data World data.
+/// \param[in] _query Function that appends the ids of the models found
+/// to its second argument.
+/// \return The models found, in depth first order.
+static Model_V QueryModelTree(WorldPrivate *_data,
+    const std::function<void(const BoundingBoxTree &,
+      std::vector<uint32_t> &)> &_query)
+{
+  std::lock_guard<std::mutex> lock(_data->modelTreeMutex);
+
+  if (_data->modelTreeStale)
+  {
+    std::map<uint32_t, ModelTreeEntry> entries;
+    CollectModelTreeEntries(_data->models, _data->modelTreeEntries, entries);
+
+    // Whatever is left was removed from the world
+    for (auto const &old : _data->modelTreeEntries)
+    {
+      if (old.second.proxy >= 0)
+        _data->modelTree.Remove(old.second.proxy);
+    }
+    _data->modelTreeEntries.swap(entries);
+
+    // Membership changes are rare, refresh everything
+    for (auto const &model : _data->models)
+      RefreshModelTreeModel(_data, model);
+
+    _data->modelTreeDirty.clear();
+    _data->modelTreeStale = false;
+  }
+  else
+  {
+    for (auto const id : _data->modelTreeDirty)
+    {
+      auto iter = _data->modelTreeEntries.find(id);
+      if (iter == _data->modelTreeEntries.end())
+        continue;
+
+      ModelPtr model = iter->second.model.lock();
+      if (model)
+        RefreshModelTreeModel(_data, model);
+    }
+    _data->modelTreeDirty.clear();
+  }
+
+  std::vector<uint32_t> ids;
+  _query(_data->modelTree, ids);
+
+  std::vector<std::pair<unsigned int, ModelPtr>> found;
+  found.reserve(ids.size());
+  for (auto const id : ids)
+  {
+    auto iter = _data->modelTreeEntries.find(id);
+    if (iter == _data->modelTreeEntries.end())
+      continue;
+
+    ModelPtr model = iter->second.model.lock();
+    if (model)
+      found.push_back(std::make_pair(iter->second.order, model));
+  }
+
+  std::sort(found.begin(), found.end(),
+      [](const std::pair<unsigned int, ModelPtr> &_a,
+         const std::pair<unsigned int, ModelPtr> &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  Model_V result;
+  result.reserve(found.size());
+  for (auto const &f : found)
+    result.push_back(f.second);
+  return result;
+}
+
+/// \brief Default number of models in each chunk of a scene requested
+/// with "scene_info_chunked".
+static const unsigned int DefaultSceneChunkSize = 100;
+
+/// \brief Number of chunks that World::SceneStreamWorker builds ahead of
+/// the world thread, which publishes them.
+static const size_t MaxSceneChunksReady = 4;
+
+//////////////////////////////////////////////////
+/// \brief Collect the ids of a model and of its nested models.
+/// \param[in] _model The model.
+/// \param[in,out] _ids The ids found.
+static void CollectModelIds(const ModelPtr &_model,
+    std::vector<uint32_t> &_ids)
+{
+  _ids.push_back(_model->GetId());
+  for (auto const &nested : _model->NestedModels())
+    CollectModelIds(nested, _ids);
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the entities that make up a scene message, in the order
+/// used by World::BuildSceneMsg. Nested models are listed after their
+/// parents as well as inside them.
+/// \param[in] _root Root element of the world.
+/// \param[in] _entity Entity to walk.
+/// \param[in,out] _models The models found.
+/// \param[in,out] _lights The lights found whose parent is the root.
+static void CollectSceneEntities(const BasePtr &_root, const BasePtr &_entity,
+    Model_V &_models, Light_V &_lights)
+{
+  if (!_entity)
+    return;
+
+  if (_entity->HasType(Base::MODEL))
+  {
+    _models.push_back(boost::static_pointer_cast<Model>(_entity));
+  }
+  else if (_entity->HasType(Base::LIGHT))
+  {
+    if (_entity->GetParent() == _root)
+      _lights.push_back(boost::static_pointer_cast<Light>(_entity));
+    return;
+  }
+  else if (_entity != _root)
+  {
+    // Links, joints and collisions are part of their model's message
+    return;
+  }
+
+  for (unsigned int i = 0; i < _entity->GetChildCount(); ++i)
+    CollectSceneEntities(_root, _entity->GetChild(i), _models, _lights);
+}
+
+//////////////////////////////////////////////////
+/// \brief Drop the scene fragments of the models that moved since the last
+/// call.
+/// \param[in] _data World data.
+static void DropMovedSceneFragments(WorldPrivate *_data)
+{
+  std::set<uint32_t> moved;
+  {
+    std::lock_guard<std::mutex> lock(_data->modelTreeMutex);
+    moved.swap(_data->sceneFragmentsMoved);
+  }
+
+  if (moved.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(_data->sceneStreamMutex);
+  ++_data->sceneFragmentsGeneration;
+  for (auto iter = _data->sceneFragments.begin();
+       iter != _data->sceneFragments.end();)
+  {
+    const std::vector<uint32_t> &ids = iter->second.ids;
+    if (std::any_of(ids.begin(), ids.end(),
+          [&moved](const uint32_t _id) {return moved.count(_id) > 0;}))
+    {
+      iter = _data->sceneFragments.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the serialized scene message of a model, reusing the cached
+/// one when the model didn't change since it was built.
+/// \param[in] _data World data.
+/// \param[in] _model The model.
+/// \return The msgs::Model of the model, serialized.
+static std::string SceneFragmentData(WorldPrivate *_data,
+    const ModelPtr &_model)
+{
+  const uint32_t id = _model->GetId();
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(_data->sceneStreamMutex);
+    auto iter = _data->sceneFragments.find(id);
+    if (iter != _data->sceneFragments.end())
+      return iter->second.data;
+    generation = _data->sceneFragmentsGeneration;
+  }
+
+  msgs::Model msg;
+  _model->FillMsg(msg);
+
+  SceneFragment fragment;
+  msg.SerializeToString(&fragment.data);
+  CollectModelIds(_model, fragment.ids);
+
+  // A fragment invalidated while it was built is only used once
+  std::lock_guard<std::mutex> lock(_data->sceneStreamMutex);
+  if (generation != _data->sceneFragmentsGeneration)
+    return fragment.data;
+  return _data->sceneFragments.emplace(id, std::move(fragment)).first->
+    second.data;
+}
+
+//////////////////////////////////////////////////
+/// \brief Serialize a chunk of a scene. The bytes are those of a
+/// msgs::Scene with the name of the world and the models, written without
+/// parsing the cached model messages.
+/// \param[in] _data World data.
+/// \param[in] _models Models of the chunk.
+/// \return The serialized msgs::Scene.
+static std::string SceneChunkData(WorldPrivate *_data, const Model_V &_models)
+{
+  using google::protobuf::internal::WireFormatLite;
+
+  std::string data;
+  {
+    google::protobuf::io::StringOutputStream stream(&data);
+    google::protobuf::io::CodedOutputStream out(&stream);
+    WireFormatLite::WriteString(msgs::Scene::kNameFieldNumber, _data->name,
+        &out);
+    for (auto const &model : _models)
+    {
+      WireFormatLite::WriteBytes(msgs::Scene::kModelFieldNumber,
+          SceneFragmentData(_data, model), &out);
+    }
+  }
+  return data;
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish the scene chunks built by World::SceneStreamWorker.
+/// \param[in] _data World data.
+static void PublishSceneChunks(WorldPrivate *_data)
+{
+  std::vector<msgs::Response> chunks;
+  {
+    std::lock_guard<std::mutex> lock(_data->sceneStreamMutex);
+    if (_data->sceneChunks.empty())
+      return;
+    chunks.swap(_data->sceneChunks);
+  }
+  _data->sceneStreamCondition.notify_all();
+
+  for (auto const &chunk : chunks)
+    _data->responsePub->Publish(chunk);
+}
+
 //////////////////////////////////////////////////
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
@@ -222,6 +710,7 @@ void World::Load(sdf::ElementPtr _sdf)
 
   this->dataPtr->node = transport::NodePtr(new transport::Node());
   this->dataPtr->node->Init(this->Name());
+  this->dataPtr->publicationPlanner.Init(this->dataPtr->node);
 
   // pose pub for server side, mainly used for updating and timestamping
   // Scene, which in turn will be used by rendering sensors.
@@ -288,13 +777,16 @@ void World::Load(sdf::ElementPtr _sdf)
   sdf::ElementPtr physicsElem = this->dataPtr->sdf->GetElement("physics");
 
   std::string type = physicsElem->Get<std::string>("type");
-  this->dataPtr->physicsEngine = PhysicsFactory::NewPhysicsEngine(type,
-      shared_from_this());
+  {
+    common::StartupScope startupScope("Physics engine " + type, "physics");
+    this->dataPtr->physicsEngine = PhysicsFactory::NewPhysicsEngine(type,
+        shared_from_this());
 
-  if (this->dataPtr->physicsEngine == nullptr)
-    gzthrow("Unable to create physics engine\n");
+    if (this->dataPtr->physicsEngine == nullptr)
+      gzthrow("Unable to create physics engine\n");
 
-  this->dataPtr->physicsEngine->Load(physicsElem);
+    this->dataPtr->physicsEngine->Load(physicsElem);
+  }
 
   // This should come before loading of entities
   sdf::ElementPtr windElem = this->dataPtr->sdf->GetElement("wind");
@@ -424,11 +916,26 @@ void World::Init(UpdateScenePosesFunc _func)
   }
 
   // Initialize all the entities (i.e. Model)
-  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
-    this->dataPtr->rootElement->GetChild(i)->Init();
+  {
+    common::StartupScope startupScope("Init entities", "physics");
+    for (unsigned int i = 0;
+         i < this->dataPtr->rootElement->GetChildCount(); ++i)
+    {
+      this->dataPtr->rootElement->GetChild(i)->Init();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->modelTreeMutex);
+    this->dataPtr->modelTreeStale = true;
+    this->dataPtr->collisionSnapshotModelsChanged = true;
+  }
 
   // Initialize the physics engine
-  this->dataPtr->physicsEngine->Init();
+  {
+    common::StartupScope startupScope("Init physics engine", "physics");
+    this->dataPtr->physicsEngine->Init();
+  }
 
   this->dataPtr->presetManager = PresetManagerPtr(
       new PresetManager(this->dataPtr->physicsEngine, this->dataPtr->sdf));
@@ -530,7 +1037,10 @@ void World::Stop()
     this->dataPtr->thread = nullptr;
   }
 
-  event::Events::stop();
+  // The stop event is process wide, only signal it once the last world
+  // stopped.
+  if (!physics::worlds_running())
+    event::Events::stop();
 }
 
 //////////////////////////////////////////////////
@@ -554,6 +1064,9 @@ void World::RunLoop()
   this->dataPtr->logThread =
     new std::thread(std::bind(&World::LogWorker, this));
 
+  this->dataPtr->sceneStreamThread =
+    new std::thread(std::bind(&World::SceneStreamWorker, this));
+
   if (!util::LogPlay::Instance()->IsOpen())
   {
     for (this->dataPtr->iterations = 0; !this->dataPtr->stop &&
@@ -587,6 +1100,17 @@ void World::RunLoop()
     delete this->dataPtr->logThread;
     this->dataPtr->logThread = nullptr;
   }
+
+  if (this->dataPtr->sceneStreamThread)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->sceneStreamMutex);
+      this->dataPtr->sceneStreamCondition.notify_all();
+    }
+    this->dataPtr->sceneStreamThread->join();
+    delete this->dataPtr->sceneStreamThread;
+    this->dataPtr->sceneStreamThread = nullptr;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -675,6 +1199,12 @@ bool World::SensorsInitialized() const
   return this->dataPtr->sensorsInitialized;
 }
 
+/////////////////////////////////////////////////
+bool World::PluginsLoaded() const
+{
+  return this->dataPtr->pluginsLoaded;
+}
+
 /////////////////////////////////////////////////
 void World::SetSensorWaitFunc(std::function<void(double, double)> _func)
 {
@@ -694,7 +1224,12 @@ void World::Step()
   /// one iteration of the physics engine. Do not remove this.
   if (!this->dataPtr->pluginsLoaded && this->SensorsInitialized())
   {
-    this->LoadPlugins();
+    {
+      common::StartupScope startupScope("Load plugins " + this->Name(),
+          "server");
+      this->LoadPlugins();
+    }
+    CloseLoadPrefetchHandles(this->dataPtr->prefetchHandles);
     this->dataPtr->pluginsLoaded = true;
   }
 
@@ -768,6 +1303,9 @@ void World::Step()
       if (util::LogRecord::Instance()->BufferSize() > 0)
         util::LogRecord::Instance()->Notify();
       this->dataPtr->pauseTime += stepTime;
+
+      // Models added, removed or moved while paused
+      RefreshCollisionSnapshot(this->dataPtr.get());
     }
   }
   IGN_PROFILE_END();
@@ -893,11 +1431,20 @@ void World::Update()
       boost::recursive_mutex::scoped_lock plock(
           *this->Physics()->GetPhysicsUpdateMutex());
 
+      std::lock_guard<std::mutex> tlock(this->dataPtr->modelTreeMutex);
       for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
       {
         dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
-      }
 
+        // The bounding box of the model of the entity moved
+        uint32_t id = dirtyEntity->HasType(MODEL) ? dirtyEntity->GetId() :
+          static_cast<uint32_t>(dirtyEntity->GetParentId());
+        this->dataPtr->modelTreeDirty.insert(id);
+        if (this->dataPtr->collisionSnapshotEnabled)
+          this->dataPtr->collisionSnapshotDirty.insert(id);
+        if (this->dataPtr->sceneFragmentsEnabled)
+          this->dataPtr->sceneFragmentsMoved.insert(id);
+      }
       this->dataPtr->dirtyPoses.clear();
       IGN_PROFILE_END();
     }
@@ -919,8 +1466,19 @@ void World::Update()
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
 
+  IGN_PROFILE_BEGIN("CollisionSnapshot");
+  // Sensors and plugins query this snapshot while the next step runs
+  RefreshCollisionSnapshot(this->dataPtr.get());
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "CollisionSnapshot");
+
   event::Events::worldUpdateEnd();
 
+  IGN_PROFILE_BEGIN("PublishLinkData");
+  // Only links with consumers are visited
+  this->dataPtr->publicationPlanner.Update(this->SimTime());
+  IGN_PROFILE_END();
+
   gazebo::util::IntrospectionManager::Instance()->Update();
 
   DIAG_TIMER_STOP("World::Update");
@@ -932,6 +1490,9 @@ void World::Fini()
   this->dataPtr->stop = true;
   this->dataPtr->enablePhysicsEngine = false;
 
+  // The world was stopped before its plugins were loaded
+  CloseLoadPrefetchHandles(this->dataPtr->prefetchHandles);
+
 #ifdef HAVE_OPENAL
   util::OpenAL::Instance()->Fini();
 #endif
@@ -965,6 +1526,8 @@ void World::Fini()
     this->dataPtr->lightModifySub.reset();
     this->dataPtr->modelSub.reset();
 
+    this->dataPtr->publicationPlanner.Fini();
+
     if (this->dataPtr->node)
       this->dataPtr->node->Fini();
     this->dataPtr->node.reset();
@@ -1195,6 +1758,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
       }
     }
 
+    common::StartupScope startupScope(modelName, "physics");
     model = this->dataPtr->physicsEngine->CreateModel(_parent);
     model->SetWorld(shared_from_this());
     model->Load(_sdf);
@@ -1213,7 +1777,13 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
   }
 
   this->PublishModelPose(model);
-  this->dataPtr->models.push_back(model);
+
+  {
+    std::lock_guard<std::mutex> tlock(this->dataPtr->modelTreeMutex);
+    this->dataPtr->models.push_back(model);
+    this->dataPtr->modelTreeStale = true;
+    this->dataPtr->collisionSnapshotModelsChanged = true;
+  }
   return model;
 }
 
@@ -1268,7 +1838,13 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->EnableAllModels();
   this->PublishModelPose(actor);
-  this->dataPtr->models.push_back(actor);
+
+  {
+    std::lock_guard<std::mutex> tlock(this->dataPtr->modelTreeMutex);
+    this->dataPtr->models.push_back(actor);
+    this->dataPtr->modelTreeStale = true;
+    this->dataPtr->collisionSnapshotModelsChanged = true;
+  }
 
   return actor;
 }
@@ -1285,6 +1861,33 @@ RoadPtr World::LoadRoad(sdf::ElementPtr _sdf , BasePtr _parent)
 //////////////////////////////////////////////////
 void World::LoadEntities(sdf::ElementPtr _sdf, BasePtr _parent)
 {
+  // Parsing meshes and opening plugin libraries dominates the load time of
+  // large worlds. Do it in parallel up front, then construct the models
+  // sequentially so that entity ids and the order of registration with the
+  // physics engine do not depend on thread scheduling.
+  {
+    std::set<std::string> seen;
+    std::vector<LoadPrefetchJob> jobs;
+    for (sdf::ElementPtr elem = _sdf->GetFirstElement(); elem;
+         elem = elem->GetNextElement())
+    {
+      if (elem->GetName() == "plugin" || elem->GetName() == "model")
+        CollectLoadPrefetchJobs(elem, seen, jobs);
+    }
+
+    if (jobs.size() > 1u)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, jobs.size(), 1),
+          LoadPrefetch_TBB(&jobs));
+
+      for (auto const &job : jobs)
+      {
+        if (job.handle)
+          this->dataPtr->prefetchHandles.push_back(job.handle);
+      }
+    }
+  }
+
   if (_sdf->HasElement("light"))
   {
     sdf::ElementPtr childElem = _sdf->GetElement("light");
@@ -1365,6 +1968,79 @@ Model_V World::Models() const
   return this->dataPtr->models;
 }
 
+//////////////////////////////////////////////////
+Model_V World::ModelsInBox(const ignition::math::AxisAlignedBox &_box) const
+{
+  return QueryModelTree(this->dataPtr.get(),
+      [&](const BoundingBoxTree &_tree, std::vector<uint32_t> &_ids)
+      {
+        _tree.QueryBox(_box, _ids);
+      });
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInSphere(const ignition::math::Vector3d &_center,
+    const double _radius) const
+{
+  return QueryModelTree(this->dataPtr.get(),
+      [&](const BoundingBoxTree &_tree, std::vector<uint32_t> &_ids)
+      {
+        _tree.QuerySphere(_center, _radius, _ids);
+      });
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInFrustum(const ignition::math::Frustum &_frustum) const
+{
+  return QueryModelTree(this->dataPtr.get(),
+      [&](const BoundingBoxTree &_tree, std::vector<uint32_t> &_ids)
+      {
+        _tree.QueryFrustum(_frustum, _ids);
+      });
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsOnRay(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end) const
+{
+  return QueryModelTree(this->dataPtr.get(),
+      [&](const BoundingBoxTree &_tree, std::vector<uint32_t> &_ids)
+      {
+        _tree.QueryRay(_start, _end, _ids);
+      });
+}
+
+//////////////////////////////////////////////////
+CollisionSnapshotPtr World::LatestCollisionSnapshot() const
+{
+  this->dataPtr->collisionSnapshotEnabled = true;
+
+  CollisionSnapshotPtr snapshot =
+    std::atomic_load(&this->dataPtr->collisionSnapshot);
+  if (snapshot)
+    return snapshot;
+
+  // The world thread builds the first one at the end of its next step
+  return std::make_shared<CollisionSnapshot>();
+}
+
+//////////////////////////////////////////////////
+StateBatchPtr World::CreateStateBatch(const Model_V &_models) const
+{
+  Joint_V joints;
+  Link_V links;
+  for (auto const &model : _models)
+    model->StateBatchEntities(joints, links);
+
+  return this->dataPtr->physicsEngine->CreateStateBatch(joints, links);
+}
+
+//////////////////////////////////////////////////
+PublicationPlanner *World::Publications() const
+{
+  return &this->dataPtr->publicationPlanner;
+}
+
 //////////////////////////////////////////////////
 Light_V World::Lights() const
 {
@@ -1659,27 +2335,23 @@ void World::OnModelMsg(ConstModelPtr &_msg)
 //////////////////////////////////////////////////
 void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 {
-  if (_entity)
-  {
-    if (_entity->HasType(Entity::MODEL))
-    {
-      msgs::Model *modelMsg = _scene.add_model();
-      boost::static_pointer_cast<Model>(_entity)->FillMsg(*modelMsg);
-    }
-    else if (_entity->HasType(Entity::LIGHT) &&
-        _entity->GetParent() == this->dataPtr->rootElement)
-    {
-      msgs::Light *lightMsg = _scene.add_light();
-      boost::static_pointer_cast<physics::Light>(_entity)->FillMsg(*lightMsg);
-    }
+  Model_V models;
+  Light_V lights;
+  CollectSceneEntities(this->dataPtr->rootElement, _entity, models, lights);
 
-    for (unsigned int i = 0; i < _entity->GetChildCount(); ++i)
-    {
-      this->BuildSceneMsg(_scene, _entity->GetChild(i));
-    }
+  // Models that moved since the last scene mustn't be reused
+  this->dataPtr->sceneFragmentsEnabled = true;
+  DropMovedSceneFragments(this->dataPtr.get());
+
+  for (auto const &model : models)
+  {
+    _scene.add_model()->ParseFromString(
+        SceneFragmentData(this->dataPtr.get(), model));
   }
-}
 
+  for (auto const &light : lights)
+    light->FillMsg(*_scene.add_light());
+}
 
 //////////////////////////////////////////////////
 // void World::ModelUpdateTBB()
@@ -1741,7 +2413,10 @@ void World::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
-    plugin->Load(shared_from_this(), _sdf);
+    {
+      common::StartupScope startupScope(_name, "plugin");
+      plugin->Load(shared_from_this(), _sdf);
+    }
     this->dataPtr->plugins.push_back(plugin);
 
     if (this->dataPtr->initialized)
@@ -1939,6 +2614,59 @@ void World::ProcessRequestMsgs()
         road->Init();
       }
     }
+    else if (requestMsg.request() == "scene_info_chunked")
+    {
+      SceneStream stream;
+      stream.request = requestMsg;
+      stream.chunkSize = DefaultSceneChunkSize;
+      if (requestMsg.has_data() && !requestMsg.data().empty())
+      {
+        try
+        {
+          stream.chunkSize = std::max(std::stoi(requestMsg.data()), 1);
+        }
+        catch(...)
+        {
+          gzwarn << "Invalid scene chunk size [" << requestMsg.data()
+                 << "], using " << DefaultSceneChunkSize << std::endl;
+        }
+      }
+
+      // The first response has everything but the models, which follow in
+      // chunks, see SceneStreamWorker
+      Model_V models;
+      Light_V lights;
+      CollectSceneEntities(this->dataPtr->rootElement,
+          this->dataPtr->rootElement, models, lights);
+
+      msgs::Scene sceneMsg(this->dataPtr->sceneMsg);
+      sceneMsg.clear_model();
+      sceneMsg.clear_light();
+      for (auto const &light : lights)
+        light->FillMsg(*sceneMsg.add_light());
+
+      std::string *serializedData = response.mutable_serialized_data();
+      sceneMsg.SerializeToString(serializedData);
+      response.set_type(sceneMsg.GetTypeName());
+
+      if (!models.empty())
+      {
+        response.set_response("partial");
+        stream.models.assign(models.begin(), models.end());
+        this->dataPtr->sceneFragmentsEnabled = true;
+        {
+          std::lock_guard<std::mutex> lock2(this->dataPtr->sceneStreamMutex);
+          this->dataPtr->sceneStreams.push_back(std::move(stream));
+        }
+        this->dataPtr->sceneStreamCondition.notify_all();
+      }
+
+      for (auto road : this->dataPtr->roads)
+      {
+        // this causes the roads to publish road msgs.
+        road->Init();
+      }
+    }
     else if (requestMsg.request() == "spherical_coordinates_info")
     {
       msgs::SphericalCoordinates sphereCoordMsg;
@@ -1977,7 +2705,12 @@ void World::ProcessModelMsgs()
             << modelMsg.name() << "] Id[" << modelMsg.id() << "]\n";
     else
     {
-      model->ProcessMsg(modelMsg);
+      {
+        // World::SceneStreamWorker reads the models under this mutex
+        std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+        model->ProcessMsg(modelMsg);
+      }
+      this->InvalidateSceneFragment(model);
 
       // May 30, 2013: The following code was removed because it has a
       // major performance impact when dragging complex object via the GUI.
@@ -2230,6 +2963,7 @@ void World::ProcessFactoryMsgs()
       {
         ActorPtr actor = this->LoadActor(elem, this->dataPtr->rootElement);
         actor->Init();
+        this->_AddDirtyBounds(actor.get());
         actor->LoadPlugins();
       }
       else if (isModel)
@@ -2278,6 +3012,7 @@ void World::ProcessFactoryMsgs()
       if (model != nullptr)
       {
         model->Init();
+        this->_AddDirtyBounds(model.get());
         model->LoadPlugins();
       }
     }
@@ -2403,6 +3138,7 @@ void World::SetState(const WorldState &_state)
         if (model != nullptr)
         {
           model->Init();
+          this->_AddDirtyBounds(model.get());
           if (!util::LogPlay::Instance()->IsOpen())
             model->LoadPlugins();
         }
@@ -2702,12 +3438,17 @@ void World::ProcessMessages()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    if ((this->dataPtr->posePub && this->dataPtr->posePub->HasConnections()) ||
+    // Check the subscribers of the pose topics once per step
+    const bool posePubActive =
+        this->dataPtr->posePub && this->dataPtr->posePub->HasConnections();
+    const bool poseLocalPubActive = this->dataPtr->poseLocalPub &&
+        this->dataPtr->poseLocalPub->HasConnections();
+
+    if (posePubActive ||
       // When ready to use the direct API for updating scene poses from server,
       // uncomment the following line:
          this->dataPtr->updateScenePoses ||
-        (this->dataPtr->poseLocalPub &&
-         this->dataPtr->poseLocalPub->HasConnections()))
+        poseLocalPubActive)
     {
       msgs::PosesStamped msg;
 
@@ -2759,12 +3500,11 @@ void World::ProcessMessages()
           msgs::Set(poseMsg, light->RelativePose());
         }
 
-        if (this->dataPtr->posePub && this->dataPtr->posePub->HasConnections())
+        if (posePubActive)
           this->dataPtr->posePub->Publish(msg);
       }
 
-      if (this->dataPtr->poseLocalPub &&
-          this->dataPtr->poseLocalPub->HasConnections())
+      if (poseLocalPubActive)
       {
         // rendering::Scene depends on this timestamp, which is used by
         // rendering sensors to time stamp their data
@@ -2864,6 +3604,10 @@ void World::ProcessMessages()
     this->ProcessLightModifyMsgs();
     this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
   }
+
+  // Scene chunks are published every step, independently of the request
+  // throttle
+  PublishSceneChunks(this->dataPtr.get());
 }
 
 //////////////////////////////////////////////////
@@ -2894,7 +3638,7 @@ void World::PublishWorldStats()
   }
 
   if (this->dataPtr->statPub && this->dataPtr->statPub->HasConnections())
-    this->dataPtr->statPub->Publish(this->dataPtr->worldStatsMsg);
+    this->dataPtr->statPub->PublishSwap(this->dataPtr->worldStatsMsg);
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
 }
 
@@ -2920,6 +3664,23 @@ void World::PublishModelScale(physics::ModelPtr _model)
 
   // Only add if the model name is not in the list
   this->dataPtr->publishModelScales.insert(_model);
+
+  this->InvalidateSceneFragment(_model);
+}
+
+//////////////////////////////////////////////////
+void World::InvalidateSceneFragment(ModelPtr _model)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->sceneStreamMutex);
+  ++this->dataPtr->sceneFragmentsGeneration;
+
+  // The fragment of a model is also part of the fragments of its ancestors
+  BasePtr entity = _model;
+  while (entity && entity->HasType(Base::MODEL))
+  {
+    this->dataPtr->sceneFragments.erase(entity->GetId());
+    entity = entity->GetParent();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -3022,6 +3783,65 @@ void World::LogWorker()
   this->dataPtr->logContinueCondition.notify_all();
 }
 
+//////////////////////////////////////////////////
+void World::SceneStreamWorker()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->dataPtr->sceneStreamMutex);
+      this->dataPtr->sceneStreamCondition.wait(lock, [this]
+          {
+            return this->dataPtr->stop ||
+                (!this->dataPtr->sceneStreams.empty() &&
+                 this->dataPtr->sceneChunks.size() < MaxSceneChunksReady);
+          });
+      if (this->dataPtr->stop)
+        return;
+    }
+
+    DropMovedSceneFragments(this->dataPtr.get());
+
+    // Models aren't removed or changed by model messages while the chunk is
+    // built, see ProcessEntityMsgs and ProcessModelMsgs. Poses that change
+    // meanwhile drop the fragments at the next chunk.
+    std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+
+    msgs::Response response;
+    Model_V models;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->sceneStreamMutex);
+      if (this->dataPtr->sceneStreams.empty())
+        continue;
+
+      // Each stream gets one chunk in turn
+      auto &streams = this->dataPtr->sceneStreams;
+      SceneStream &stream = streams.front();
+      while (!stream.models.empty() && models.size() < stream.chunkSize)
+      {
+        models.push_back(stream.models.front());
+        stream.models.pop_front();
+      }
+
+      response.set_id(stream.request.id());
+      response.set_request(stream.request.request());
+      response.set_response(stream.models.empty() ? "success" : "partial");
+      if (stream.models.empty())
+        streams.pop_front();
+      else
+        streams.splice(streams.end(), streams, streams.begin());
+    }
+
+    response.set_type(msgs::Scene::default_instance().GetTypeName());
+    *response.mutable_serialized_data() =
+      SceneChunkData(this->dataPtr.get(), models);
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->sceneStreamMutex);
+    this->dataPtr->sceneChunks.emplace_back();
+    this->dataPtr->sceneChunks.back().Swap(&response);
+  }
+}
+
 /////////////////////////////////////////////////
 uint32_t World::Iterations() const
 {
@@ -3074,6 +3894,10 @@ void World::RemoveModel(const std::string &_name)
     }
   }
 
+  // Removed model, and the ids of it and its nested models
+  ModelPtr removedModel;
+  std::vector<uint32_t> removedModelIds;
+
   // remove objects in world
   {
     boost::recursive_mutex::scoped_lock lock(
@@ -3085,7 +3909,14 @@ void World::RemoveModel(const std::string &_name)
     {
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
-        this->dataPtr->models.erase(model);
+        removedModel = *model;
+        CollectModelIds(removedModel, removedModelIds);
+        {
+          std::lock_guard<std::mutex> tlock(this->dataPtr->modelTreeMutex);
+          this->dataPtr->models.erase(model);
+          this->dataPtr->modelTreeStale = true;
+          this->dataPtr->collisionSnapshotModelsChanged = true;
+        }
         this->dataPtr->rootElement->RemoveChild(_name);
         break;
       }
@@ -3125,6 +3956,29 @@ void World::RemoveModel(const std::string &_name)
     }
   }
 
+  // Cleanup the scene fragments and the scenes being sent.
+  if (removedModel)
+  {
+    std::lock_guard<std::mutex> lock2(this->dataPtr->sceneStreamMutex);
+    ++this->dataPtr->sceneFragmentsGeneration;
+    for (auto const id : removedModelIds)
+      this->dataPtr->sceneFragments.erase(id);
+
+    for (auto &stream : this->dataPtr->sceneStreams)
+    {
+      for (auto iter = stream.models.begin(); iter != stream.models.end();)
+      {
+        if (std::find(removedModelIds.begin(), removedModelIds.end(),
+              (*iter)->GetId()) != removedModelIds.end())
+        {
+          iter = stream.models.erase(iter);
+        }
+        else
+          ++iter;
+      }
+    }
+  }
+
   // Cleanup the publishModelPoses list.
   {
     std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
@@ -3235,6 +4089,27 @@ void World::_AddDirty(Entity *_entity)
   this->dataPtr->dirtyPoses.push_back(_entity);
 }
 
+/////////////////////////////////////////////////
+void World::_AddDirtyBounds(const Entity *_entity)
+{
+  GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
+
+  uint32_t id;
+  if (_entity->HasType(MODEL))
+    id = _entity->GetId();
+  else if (_entity->HasType(LINK))
+    id = static_cast<uint32_t>(_entity->GetParentId());
+  else
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelTreeMutex);
+  this->dataPtr->modelTreeDirty.insert(id);
+  if (this->dataPtr->collisionSnapshotEnabled)
+    this->dataPtr->collisionSnapshotDirty.insert(id);
+  if (this->dataPtr->sceneFragmentsEnabled)
+    this->dataPtr->sceneFragmentsMoved.insert(id);
+}
+
 /////////////////////////////////////////////////
 void World::ResetPhysicsStates()
 {
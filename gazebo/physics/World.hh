@@ -26,6 +26,10 @@
 
 #include <boost/enable_shared_from_this.hpp>
 
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -194,6 +198,65 @@ namespace gazebo
       /// \return A list of all the Models in the world.
       public: Model_V Models() const;
 
+      /// \brief Get the models whose bounding box intersects a box.
+      /// The models are found with a bounding box tree maintained by the
+      /// World, which is refreshed with the models that moved since the
+      /// last query. Nested models are included. Models without a valid
+      /// bounding box (e.g. without links) are never returned.
+      /// \param[in] _box Box in the world frame.
+      /// \return The models found, in the order of a depth first traversal
+      /// of Models().
+      public: Model_V ModelsInBox(
+                  const ignition::math::AxisAlignedBox &_box) const;
+
+      /// \brief Get the models whose bounding box intersects a sphere.
+      /// \param[in] _center Center of the sphere in the world frame.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return The models found, see ModelsInBox.
+      public: Model_V ModelsInSphere(const ignition::math::Vector3d &_center,
+                  const double _radius) const;
+
+      /// \brief Get the models whose bounding box is inside a frustum,
+      /// according to ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Frustum, posed in the world frame.
+      /// \return The models found, see ModelsInBox.
+      public: Model_V ModelsInFrustum(
+                  const ignition::math::Frustum &_frustum) const;
+
+      /// \brief Get the models whose bounding box intersects a line
+      /// segment. Unlike a RayShape, this does not use the physics engine and
+      /// only tests bounding boxes.
+      /// \param[in] _start Start of the segment in the world frame.
+      /// \param[in] _end End of the segment in the world frame.
+      /// \return The models found, see ModelsInBox.
+      public: Model_V ModelsOnRay(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end) const;
+
+      /// \brief Get the collision snapshot of the last step, for ray, sweep
+      /// and overlap queries that do not lock the physics engine.
+      /// Snapshots are only produced once this has been called, by the
+      /// world thread at the end of each step in which models were added,
+      /// removed or moved. Only the collisions of the models that moved are
+      /// read again. Until the first snapshot is built, an empty one is
+      /// returned. Changes of the size of shapes are only included once a
+      /// model moves.
+      /// \return The snapshot, shared and never modified.
+      public: CollisionSnapshotPtr LatestCollisionSnapshot() const;
+
+      /// \brief Create a batch to read and write the state of the joints
+      /// and links of several models through contiguous arrays, for
+      /// example one model per agent. The arrays hold the entities of
+      /// Model::CreateStateBatch for each model in turn.
+      /// \param[in] _models Models of the batch, in array order.
+      /// \return The new batch, created by the physics engine.
+      public: StateBatchPtr CreateStateBatch(const Model_V &_models) const;
+
+      /// \brief Get the planner that publishes per link data once per step,
+      /// such as the data enabled by Link::SetPublishData. Plugins can add
+      /// the links they consume to it.
+      /// \return Pointer to the planner, owned by the world.
+      public: PublicationPlanner *Publications() const;
+
       /// \brief Get the number of lights.
       /// \return The number of lights in the World.
       public: unsigned int LightCount() const;
@@ -394,6 +457,17 @@ namespace gazebo
       /// \param[in] _model Pointer to the model to publish.
       public: void PublishModelScale(physics::ModelPtr _model);
 
+      /// \brief Drop the cached scene message of a model, and of the models
+      /// that contain it. Motion of the model drops it too, and so do the
+      /// setters of the scale, the static, self collide, gravity, wind and
+      /// kinematic flags, joint limits and damping. Call this when a model
+      /// changes in another way that a new client must see, such as a
+      /// visual change. The enabled flag of links, which the physics engine
+      /// changes on its own, is the one of the last time the message was
+      /// built.
+      /// \param[in] _model Pointer to the model that changed.
+      public: void InvalidateSceneFragment(physics::ModelPtr _model);
+
       /// \brief Publish pose updates for a light.
       /// Adds light to a list of lights to publish, which is processed and
       /// cleared once every iteration.
@@ -438,10 +512,22 @@ namespace gazebo
       /// \param[in] _entity Entity that has moved.
       public: void _AddDirty(Entity *_entity);
 
+      /// \internal
+      /// \brief Inform the World that the bounding box of a model may have
+      /// changed, so that it is refreshed in the tree used by ModelsInBox
+      /// and the related queries. Called by Entity::SetWorldPose.
+      /// \param[in] _entity A model, or a link of the model.
+      public: void _AddDirtyBounds(const Entity *_entity);
+
       /// \brief Get whether sensors have been initialized.
       /// \return True if sensors have been initialized.
       public: bool SensorsInitialized() const;
 
+      /// \brief Get whether the world and model plugins have been loaded,
+      /// which happens during the first update of the world.
+      /// \return True if the plugins have been loaded.
+      public: bool PluginsLoaded() const;
+
       /// \internal
       /// \brief Set whether sensors have been initialized. This should only
       /// be called by SensorManager.
@@ -616,6 +702,10 @@ namespace gazebo
       /// \brief Thread function for logging state data.
       private: void LogWorker();
 
+      /// \brief Thread function that builds the chunks of the scenes
+      /// requested with "scene_info_chunked".
+      private: void SceneStreamWorker();
+
       /// \brief Register items in the introspection service.
       private: void RegisterIntrospectionItems();
 
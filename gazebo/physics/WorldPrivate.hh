@@ -21,6 +21,7 @@
 #include <deque>
 #include <vector>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <sdf/sdf.hh>
@@ -29,6 +30,8 @@
 #include <thread>
 #include <condition_variable>
 
+#include <boost/weak_ptr.hpp>
+
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
@@ -39,13 +42,58 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/BoundingBoxTree.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/PublicationPlanner.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
 {
   namespace physics
   {
+    /// \internal
+    /// \brief A model in the bounding box tree of the world.
+    struct ModelTreeEntry
+    {
+      /// \brief The model.
+      boost::weak_ptr<Model> model;
+
+      /// \brief Proxy id of the model's box in the tree, -1 if the model
+      /// has no valid bounding box yet.
+      int proxy = -1;
+
+      /// \brief Position of the model in a depth first traversal of the
+      /// world's models, used to sort query results.
+      unsigned int order = 0;
+    };
+
+    /// \internal
+    /// \brief A scene sent in chunks, in answer to a "scene_info_chunked"
+    /// request.
+    struct SceneStream
+    {
+      /// \brief Request being answered.
+      msgs::Request request;
+
+      /// \brief Models left to send, in order.
+      std::deque<ModelPtr> models;
+
+      /// \brief Maximum number of models per chunk.
+      unsigned int chunkSize = 1;
+    };
+
+    /// \internal
+    /// \brief Cached scene message of a model.
+    struct SceneFragment
+    {
+      /// \brief The msgs::Model of the model, serialized.
+      std::string data;
+
+      /// \brief Ids of the model and of its nested models. The
+      /// fragment is dropped when one of them moves.
+      std::vector<uint32_t> ids;
+    };
+
     /// \brief Private data class for World.
     class WorldPrivate
     {
@@ -155,6 +203,38 @@ namespace gazebo
       /// \brief Outgoing scene message.
       public: msgs::Scene sceneMsg;
 
+      /// \brief Scene message of each model, by id.
+      public: std::map<uint32_t, SceneFragment> sceneFragments;
+
+      /// \brief Incremented whenever scene fragments are invalidated. A
+      /// fragment built while it changed is used once but not cached.
+      public: uint64_t sceneFragmentsGeneration = 0;
+
+      /// \brief Scenes being sent in chunks.
+      public: std::list<SceneStream> sceneStreams;
+
+      /// \brief Chunks built by the scene stream thread, waiting to be
+      /// published by the world thread.
+      public: std::vector<msgs::Response> sceneChunks;
+
+      /// \brief Protects the scene fragments, streams and chunks above.
+      public: std::mutex sceneStreamMutex;
+
+      /// \brief Wakes up the scene stream thread when a scene is requested,
+      /// when its chunks are published, and when the world stops.
+      public: std::condition_variable sceneStreamCondition;
+
+      /// \brief Thread that builds the chunks of the scenes being sent.
+      public: std::thread *sceneStreamThread = nullptr;
+
+      /// \brief True once a scene message was requested, which turns on
+      /// the tracking of sceneFragmentsMoved by the world thread.
+      public: std::atomic_bool sceneFragmentsEnabled{false};
+
+      /// \brief Ids of the models that moved since the scene fragments
+      /// were last checked. Protected by modelTreeMutex.
+      public: std::set<uint32_t> sceneFragmentsMoved;
+
       /// \brief Function pointer to the model update function.
       public: void (World::*modelUpdateFunc)();
 
@@ -248,7 +328,11 @@ namespace gazebo
       public: RayShapePtr testRay;
 
       /// \brief True if the plugins have been loaded.
-      public: bool pluginsLoaded;
+      public: std::atomic_bool pluginsLoaded;
+
+      /// \brief Plugin libraries opened ahead of the load of the models,
+      /// closed once the plugins have been loaded.
+      public: std::vector<void *> prefetchHandles;
 
       /// \brief sleep timing error offset due to clock wake up latency
       public: common::Time sleepOffset;
@@ -385,6 +469,46 @@ namespace gazebo
 
       /// \brief SDF World DOM object
       public: std::unique_ptr<sdf::World> worldSDFDom;
+
+      /// \brief Bounding boxes of the models, including nested models. The
+      /// user value of each box is the id of its model.
+      public: BoundingBoxTree modelTree;
+
+      /// \brief Models in modelTree, by id.
+      public: std::map<uint32_t, ModelTreeEntry> modelTreeEntries;
+
+      /// \brief Ids of the models whose box must be refreshed before the
+      /// next query.
+      public: std::set<uint32_t> modelTreeDirty;
+
+      /// \brief True if models were added or removed since modelTreeEntries
+      /// was last rebuilt.
+      public: bool modelTreeStale = true;
+
+      /// \brief Protects modelTree and the members above.
+      public: std::mutex modelTreeMutex;
+
+      /// \brief Collision snapshot of the last step, see
+      /// World::LatestCollisionSnapshot. Only replaced by the world thread,
+      /// read and written with std::atomic_load and std::atomic_store.
+      public: CollisionSnapshotPtr collisionSnapshot;
+
+      /// \brief True once a collision snapshot was requested, which turns
+      /// on the production of snapshots by the world thread.
+      public: std::atomic_bool collisionSnapshotEnabled{false};
+
+      /// \brief Ids of the models that moved since the collision snapshot
+      /// was built. Protected by modelTreeMutex.
+      public: std::set<uint32_t> collisionSnapshotDirty;
+
+      /// \brief True if models were added or removed since the collision
+      /// snapshot was built. Set with modelTreeMutex locked, along with the
+      /// change of models.
+      public: std::atomic_bool collisionSnapshotModelsChanged{true};
+
+      /// \brief Publishes the data of the links that have consumers, once
+      /// per step.
+      public: PublicationPlanner publicationPlanner;
     };
   }
 }
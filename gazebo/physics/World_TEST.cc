@@ -15,6 +15,11 @@
  *
 */
 
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -22,7 +27,22 @@
 
 using namespace gazebo;
 
-class WorldTest : public ServerFixture {};
+class WorldTest : public ServerFixture
+{
+  /// \brief Callback for "~/response".
+  /// \param[in] _msg Message received from topic.
+  public: void OnResponse(ConstResponsePtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->responseMutex);
+    this->responses.push_back(*_msg);
+  }
+
+  /// \brief Mutex to protect responses.
+  public: std::mutex responseMutex;
+
+  /// \brief Responses received.
+  public: std::vector<msgs::Response> responses;
+};
 
 //////////////////////////////////////////////////
 /// \brief Test the factory message's allow_renaming flag and unique model name
@@ -216,6 +236,119 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldTest, SceneInfoChunked)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  for (int i = 0; i < 5; ++i)
+  {
+    this->SpawnBox("box_" + std::to_string(i),
+        ignition::math::Vector3d::One, ignition::math::Vector3d(i * 2, 0, 5));
+  }
+  // ground_plane and the boxes
+  ASSERT_EQ(6u, world->ModelCount());
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  transport::PublisherPtr requestPub =
+      node->Advertise<msgs::Request>("~/request");
+  transport::SubscriberPtr responseSub =
+      node->Subscribe("~/response", &WorldTest::OnResponse, this);
+
+  // Two models per chunk, after a header without models
+  msgs::Request *request = msgs::CreateRequest("scene_info_chunked", "2");
+  requestPub->Publish(*request);
+
+  bool done = false;
+  for (int i = 0; i < 300 && !done; ++i)
+  {
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(this->responseMutex);
+    for (auto const &response : this->responses)
+    {
+      if (response.id() == request->id() && response.response() == "success")
+        done = true;
+    }
+  }
+  ASSERT_TRUE(done);
+
+  std::set<std::string> names;
+  unsigned int chunks = 0;
+  {
+    std::lock_guard<std::mutex> lock(this->responseMutex);
+    for (auto const &response : this->responses)
+    {
+      if (response.id() != request->id())
+        continue;
+
+      msgs::Scene sceneMsg;
+      ASSERT_TRUE(sceneMsg.ParseFromString(response.serialized_data()));
+      if (chunks++ == 0)
+      {
+        EXPECT_EQ("partial", response.response());
+        EXPECT_EQ(0, sceneMsg.model_size());
+        EXPECT_LT(0, sceneMsg.light_size());
+        continue;
+      }
+
+      EXPECT_GE(2, sceneMsg.model_size());
+      for (auto const &model : sceneMsg.model())
+        names.insert(model.name());
+    }
+  }
+  EXPECT_EQ(4u, chunks);
+  EXPECT_EQ(6u, names.size());
+
+  // The single message scene matches, with the cached fragments and the
+  // poses of the models after they fell, and the flags changed through the
+  // C++ API
+  world->Step(100);
+  auto box = world->ModelByName("box_0");
+  ASSERT_NE(nullptr, box);
+  ASSERT_EQ(1u, box->GetLinks().size());
+  box->SetSelfCollide(true);
+  box->GetLinks()[0]->SetGravityMode(false);
+
+  msgs::Request *full = msgs::CreateRequest("scene_info");
+  requestPub->Publish(*full);
+
+  msgs::Scene sceneMsg;
+  done = false;
+  for (int i = 0; i < 300 && !done; ++i)
+  {
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(this->responseMutex);
+    for (auto const &response : this->responses)
+    {
+      if (response.id() == full->id())
+      {
+        done = sceneMsg.ParseFromString(response.serialized_data());
+      }
+    }
+  }
+  ASSERT_TRUE(done);
+  ASSERT_EQ(6, sceneMsg.model_size());
+
+  bool found = false;
+  for (auto const &model : sceneMsg.model())
+  {
+    if (model.name() != "box_0")
+      continue;
+    found = true;
+    EXPECT_EQ(box->RelativePose(), msgs::ConvertIgn(model.pose()));
+    EXPECT_TRUE(model.self_collide());
+    ASSERT_EQ(1, model.link_size());
+    EXPECT_FALSE(model.link(0).gravity());
+  }
+  EXPECT_TRUE(found);
+
+  delete request;
+  delete full;
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -388,6 +388,11 @@ void BulletJoint::SetupJointFeedback()
     else
       gzerr << "Bullet Joint [" << this->GetName() << "] ID is invalid\n";
   }
+  else if (this->constraint)
+  {
+    // Stop Bullet from computing the applied forces of this joint.
+    this->constraint->setJointFeedback(nullptr);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -397,6 +402,10 @@ void BulletJoint::SetDamping(unsigned int _index, double _damping)
   {
     this->SetStiffnessDamping(_index, this->stiffnessCoefficient[_index],
       _damping);
+
+    // New clients get the damping from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
   }
   else
   {
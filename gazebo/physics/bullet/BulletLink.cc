@@ -269,6 +269,9 @@ void BulletLink::SetGravityMode(bool _mode)
     this->rigidLink->setMassProps(btMass, fallInertia);
     */
   }
+
+  // New clients get the gravity mode from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
@@ -292,6 +295,9 @@ bool BulletLink::GetGravityMode() const
 void BulletLink::SetSelfCollide(bool _collide)
 {
   this->sdf->GetElement("self_collide")->Set(_collide);
+
+  // New clients get the self collide flag from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
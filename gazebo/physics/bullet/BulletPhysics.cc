@@ -42,6 +42,7 @@
 #include "gazebo/physics/bullet/BulletHinge2Joint.hh"
 #include "gazebo/physics/bullet/BulletScrewJoint.hh"
 #include "gazebo/physics/bullet/BulletFixedJoint.hh"
+#include "gazebo/physics/bullet/BulletStateBatch.hh"
 
 #include "gazebo/transport/Publisher.hh"
 
@@ -54,6 +55,7 @@
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/MapShape.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/FeedbackRegistry.hh"
 
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -134,6 +136,10 @@ struct CollisionFilter : public btOverlapFilterCallback
 // and sets the contact feedback information.
 void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
 {
+  FeedbackRegistry *registry = static_cast<BulletPhysics *>(
+      _world->getWorldUserInfo())->GetFeedbackRegistry();
+  unsigned int wrenchCount = 0;
+
   int numManifolds = _world->getDispatcher()->getNumManifolds();
   for (int i = 0; i < numManifolds; ++i)
   {
@@ -175,11 +181,17 @@ void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
     // listening for contact information.
     Contact *contactFeedback = bulletPhysics->GetContactManager()->NewContact(
         collisionPtr1.get(), collisionPtr2.get(),
-        collisionPtr1->GetWorld()->SimTime());
+        collisionPtr1->GetWorld()->SimTime(), numContacts);
 
     if (!contactFeedback)
       continue;
 
+    // Skip the wrenches if no one reads them
+    const bool wrenchWanted = registry->ContactWrenchWanted(
+        collisionPtr1.get(), collisionPtr2.get());
+    if (wrenchWanted)
+      ++wrenchCount;
+
     auto body1Pose = link1->WorldPose();
     auto body2Pose = link2->WorldPose();
     ignition::math::Vector3d localForce1;
@@ -194,6 +206,18 @@ void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
       {
         const btVector3 &ptB = pt.getPositionWorldOnB();
         const btVector3 &normalOnB = pt.m_normalWorldOnB;
+
+        contactFeedback->positions[j] = BulletTypes::ConvertVector3Ign(ptB);
+        contactFeedback->normals[j] = BulletTypes::ConvertVector3Ign(normalOnB);
+        contactFeedback->depths[j] = -pt.getDistance();
+
+        if (!wrenchWanted)
+        {
+          contactFeedback->wrench[j] = JointWrench();
+          contactFeedback->count++;
+          continue;
+        }
+
         btVector3 impulse = pt.m_appliedImpulse * normalOnB;
 
         // calculate force in world frame
@@ -213,9 +237,6 @@ void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
         localTorque2 = body2Pose.Rot().RotateVectorReverse(
             BulletTypes::ConvertVector3Ign(torqueB));
 
-        contactFeedback->positions[j] = BulletTypes::ConvertVector3Ign(ptB);
-        contactFeedback->normals[j] = BulletTypes::ConvertVector3Ign(normalOnB);
-        contactFeedback->depths[j] = -pt.getDistance();
         if (!link1->IsStatic())
         {
           contactFeedback->wrench[j].body1Force = localForce1;
@@ -230,6 +251,8 @@ void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
       }
     }
   }
+
+  registry->SetContactWrenchCount(wrenchCount);
 }
 
 //////////////////////////////////////////////////
@@ -815,6 +838,13 @@ JointPtr BulletPhysics::CreateJoint(const std::string &_type, ModelPtr _parent)
   return joint;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr BulletPhysics::CreateStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+{
+  return StateBatchPtr(new BulletStateBatch(_joints, _links));
+}
+
 //////////////////////////////////////////////////
 void BulletPhysics::ConvertMass(InertialPtr /*_inertial*/,
                                 void * /*_engineMass*/)
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <vector>
+
+#include "gazebo/physics/Inertial.hh"
+#include "gazebo/physics/bullet/BulletLink.hh"
+#include "gazebo/physics/bullet/BulletStateBatch.hh"
+#include "gazebo/physics/bullet/BulletTypes.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \internal
+/// \brief Private data class for BulletStateBatch
+class gazebo::physics::BulletStateBatchPrivate
+{
+  /// \brief Links of the batch as Bullet links, in array order.
+  public: std::vector<BulletLink *> links;
+};
+
+//////////////////////////////////////////////////
+BulletStateBatch::BulletStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+  : StateBatch(_joints, _links), dataPtr(new BulletStateBatchPrivate)
+{
+  this->dataPtr->links.reserve(_links.size());
+  for (auto const &link : _links)
+    this->dataPtr->links.push_back(dynamic_cast<BulletLink *>(link.get()));
+}
+
+//////////////////////////////////////////////////
+BulletStateBatch::~BulletStateBatch()
+{
+}
+
+//////////////////////////////////////////////////
+void BulletStateBatch::LinkPoses(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    BulletLink *bulletLink = this->dataPtr->links[i];
+    btRigidBody *body = bulletLink ? bulletLink->GetBulletLink() : nullptr;
+
+    ignition::math::Pose3d pose;
+    if (body)
+    {
+      // From the center of mass to the link frame, as in
+      // BulletMotionState::setWorldTransform
+      pose = -bulletLink->GetInertial()->Pose() +
+          BulletTypes::ConvertPoseIgn(body->getCenterOfMassTransform());
+    }
+    else
+    {
+      pose = this->Links()[i]->WorldPose();
+    }
+
+    _out[0] = pose.Pos().X();
+    _out[1] = pose.Pos().Y();
+    _out[2] = pose.Pos().Z();
+    _out[3] = pose.Rot().W();
+    _out[4] = pose.Rot().X();
+    _out[5] = pose.Rot().Y();
+    _out[6] = pose.Rot().Z();
+    _out += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void BulletStateBatch::LinkTwists(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    BulletLink *bulletLink = this->dataPtr->links[i];
+    btRigidBody *body = bulletLink ? bulletLink->GetBulletLink() : nullptr;
+    if (body)
+    {
+      const btVector3 &lin = body->getLinearVelocity();
+      const btVector3 &ang = body->getAngularVelocity();
+      _out[0] = lin.getX();
+      _out[1] = lin.getY();
+      _out[2] = lin.getZ();
+      _out[3] = ang.getX();
+      _out[4] = ang.getY();
+      _out[5] = ang.getZ();
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      const ignition::math::Vector3d lin = link->WorldCoGLinearVel();
+      const ignition::math::Vector3d ang = link->WorldAngularVel();
+      _out[0] = lin.X();
+      _out[1] = lin.Y();
+      _out[2] = lin.Z();
+      _out[3] = ang.X();
+      _out[4] = ang.Y();
+      _out[5] = ang.Z();
+    }
+    _out += TwistSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void BulletStateBatch::SetLinkTwists(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    BulletLink *bulletLink = this->dataPtr->links[i];
+    btRigidBody *body = bulletLink ? bulletLink->GetBulletLink() : nullptr;
+    if (body)
+    {
+      body->setLinearVelocity(btVector3(_in[0], _in[1], _in[2]));
+      body->setAngularVelocity(btVector3(_in[3], _in[4], _in[5]));
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      link->SetLinearVel(ignition::math::Vector3d(_in[0], _in[1], _in[2]));
+      link->SetAngularVel(ignition::math::Vector3d(_in[3], _in[4], _in[5]));
+    }
+    _in += TwistSize;
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BULLET_BULLETSTATEBATCH_HH_
+#define GAZEBO_PHYSICS_BULLET_BULLETSTATEBATCH_HH_
+
+#include <memory>
+
+#include "gazebo/physics/StateBatch.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BulletStateBatchPrivate;
+
+    /// \addtogroup gazebo_physics_bullet
+    /// \{
+
+    /// \brief State batch that reads the Bullet rigid bodies directly.
+    /// The poses and twists of links with a rigid body skip the Link
+    /// virtual calls. Joints, whose state Bullet computes from the bodies,
+    /// and links without a rigid body go through the StateBatch base
+    /// class.
+    class GZ_PHYSICS_VISIBLE BulletStateBatch : public StateBatch
+    {
+      /// \brief Constructor.
+      /// \param[in] _joints Joints of the batch, in array order.
+      /// \param[in] _links Links of the batch, in array order.
+      public: BulletStateBatch(const Joint_V &_joints, const Link_V &_links);
+
+      /// \brief Destructor.
+      public: virtual ~BulletStateBatch();
+
+      // Documentation inherited
+      public: virtual void LinkPoses(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void LinkTwists(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void SetLinkTwists(const double *_in) override;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BulletStateBatchPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
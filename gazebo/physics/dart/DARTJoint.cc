@@ -271,6 +271,10 @@ void DARTJoint::SetDamping(unsigned int _index, double _damping)
   {
     this->SetStiffnessDamping(_index, this->stiffnessCoefficient[_index],
                               _damping);
+
+    // New clients get the damping from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
   }
   else
   {
@@ -374,6 +378,10 @@ void DARTJoint::SetUpperLimit(const unsigned int _index, const double _limit)
 
   GZ_ASSERT(this->dataPtr->dtJoint, "dtJoint is null pointer.\n");
   this->dataPtr->dtJoint->setPositionUpperLimit(_index, _limit);
+
+  // New clients get the limits from the scene message
+  if (this->world)
+    this->world->InvalidateSceneFragment(this->model);
 }
 
 //////////////////////////////////////////////////
@@ -398,6 +406,10 @@ void DARTJoint::SetLowerLimit(const unsigned int _index, const double _limit)
 
   GZ_ASSERT(this->dataPtr->dtJoint, "dtJoint is null pointer.\n");
   this->dataPtr->dtJoint->setPositionLowerLimit(_index, _limit);
+
+  // New clients get the limits from the scene message
+  if (this->world)
+    this->world->InvalidateSceneFragment(this->model);
 }
 
 //////////////////////////////////////////////////
@@ -722,6 +722,9 @@ void DARTLink::SetGravityMode(bool _mode)
 {
   this->sdf->GetElement("gravity")->Set(_mode);
 
+  // New clients get the gravity mode from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
+
   if (!this->dataPtr->IsInitialized())
   {
     this->dataPtr->Cache(
@@ -752,6 +755,9 @@ void DARTLink::SetSelfCollide(bool _collide)
 {
   this->sdf->GetElement("self_collide")->Set(_collide);
 
+  // New clients get the self collide flag from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
+
   if (!this->dataPtr->IsInitialized())
   {
     this->dataPtr->Cache(
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+
 // required for HAVE_DART_BULLET define
 #include <gazebo/gazebo_config.h>
 
@@ -63,6 +65,7 @@
 
 #include "gazebo/physics/dart/DARTModel.hh"
 #include "gazebo/physics/dart/DARTLink.hh"
+#include "gazebo/physics/dart/DARTStateBatch.hh"
 
 #include "gazebo/physics/dart/DARTPhysics.hh"
 
@@ -342,7 +345,9 @@ static void RetrieveDARTCollisions(
     // will return NULL!
     Contact *contactFeedback = _mgr->NewContact(
                                  collisionPtr1.get(), collisionPtr2.get(),
-                                 _dtPhysics->World()->SimTime());
+                                 _dtPhysics->World()->SimTime(),
+                                 std::min(static_cast<int>(dtContacts.size()),
+                                          MAX_CONTACT_JOINTS));
     if (!contactFeedback)
       continue;
 
@@ -587,6 +592,13 @@ JointPtr DARTPhysics::CreateJoint(const std::string &_type, ModelPtr _parent)
   return joint;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr DARTPhysics::CreateStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+{
+  return StateBatchPtr(new DARTStateBatch(_joints, _links));
+}
+
 //////////////////////////////////////////////////
 std::string DARTPhysics::GetSolverType() const
 {
@@ -122,6 +122,10 @@ namespace gazebo
       public: virtual JointPtr CreateJoint(const std::string &_type,
                                            ModelPtr _parent);
 
+      // Documentation inherited
+      public: virtual StateBatchPtr CreateStateBatch(const Joint_V &_joints,
+                  const Link_V &_links);
+
       // Documentation inherited
       public: virtual ShapePtr CreateShape(const std::string &_shapeType,
                                            CollisionPtr _collision);
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <vector>
+
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/dart/DARTJoint.hh"
+#include "gazebo/physics/dart/DARTLink.hh"
+#include "gazebo/physics/dart/DARTStateBatch.hh"
+#include "gazebo/physics/dart/DARTTypes.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Cached lookup of a joint of the batch.
+  struct JointEntry
+  {
+    /// \brief The joint, owned by the batch.
+    Joint *joint = nullptr;
+
+    /// \brief The joint as a DART joint, or nullptr.
+    DARTJoint *dartJoint = nullptr;
+
+    /// \brief Model of the joint, or nullptr.
+    Model *model = nullptr;
+  };
+
+  /// \brief Get the DART joint to read, if the joint can be read directly.
+  /// \param[in] _entry Joint of the batch.
+  /// \return The DART joint, or nullptr to go through the Joint API.
+  dart::dynamics::Joint *NativeJoint(const JointEntry &_entry)
+  {
+    if (!_entry.dartJoint || !_entry.model || _entry.model->IsStatic())
+      return nullptr;
+
+    // Joints of static models report the position they were set to, and
+    // joints are only created in DART when the model is initialized.
+    dart::dynamics::Joint *dtJoint = _entry.dartJoint->GetDARTJoint();
+    if (!dtJoint || dtJoint->getNumDofs() != _entry.joint->DOF())
+      return nullptr;
+
+    return dtJoint;
+  }
+}
+
+/// \internal
+/// \brief Private data class for DARTStateBatch
+class gazebo::physics::DARTStateBatchPrivate
+{
+  /// \brief Joints of the batch, in array order.
+  public: std::vector<JointEntry> joints;
+
+  /// \brief Links of the batch as DART links, in array order.
+  public: std::vector<DARTLink *> links;
+};
+
+//////////////////////////////////////////////////
+DARTStateBatch::DARTStateBatch(const Joint_V &_joints, const Link_V &_links)
+  : StateBatch(_joints, _links), dataPtr(new DARTStateBatchPrivate)
+{
+  this->dataPtr->joints.resize(_joints.size());
+  for (unsigned int i = 0; i < _joints.size(); ++i)
+  {
+    JointEntry &entry = this->dataPtr->joints[i];
+    entry.joint = _joints[i].get();
+    entry.dartJoint = dynamic_cast<DARTJoint *>(entry.joint);
+    entry.model = dynamic_cast<Model *>(entry.joint->GetParent().get());
+  }
+
+  this->dataPtr->links.reserve(_links.size());
+  for (auto const &link : _links)
+    this->dataPtr->links.push_back(dynamic_cast<DARTLink *>(link.get()));
+}
+
+//////////////////////////////////////////////////
+DARTStateBatch::~DARTStateBatch()
+{
+}
+
+//////////////////////////////////////////////////
+void DARTStateBatch::JointPositions(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    dart::dynamics::Joint *dtJoint = NativeJoint(entry);
+    for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+      *_out++ = dtJoint ? dtJoint->getPosition(i) : entry.joint->Position(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTStateBatch::JointVelocities(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    dart::dynamics::Joint *dtJoint = NativeJoint(entry);
+    for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+    {
+      *_out++ = dtJoint ? dtJoint->getVelocity(i) :
+          entry.joint->GetVelocity(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTStateBatch::LinkPoses(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    DARTLink *dartLink = this->dataPtr->links[i];
+    dart::dynamics::BodyNode *body =
+        dartLink ? dartLink->DARTBodyNode() : nullptr;
+
+    // The body node frame is the link frame
+    const ignition::math::Pose3d pose = body ?
+        DARTTypes::ConvPoseIgn(body->getTransform()) :
+        this->Links()[i]->WorldPose();
+    _out[0] = pose.Pos().X();
+    _out[1] = pose.Pos().Y();
+    _out[2] = pose.Pos().Z();
+    _out[3] = pose.Rot().W();
+    _out[4] = pose.Rot().X();
+    _out[5] = pose.Rot().Y();
+    _out[6] = pose.Rot().Z();
+    _out += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTStateBatch::LinkTwists(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    DARTLink *dartLink = this->dataPtr->links[i];
+    dart::dynamics::BodyNode *body =
+        dartLink ? dartLink->DARTBodyNode() : nullptr;
+    if (body)
+    {
+      const Eigen::Vector3d lin = body->getCOMLinearVelocity();
+      const Eigen::Vector3d ang = body->getAngularVelocity();
+      _out[0] = lin.x();
+      _out[1] = lin.y();
+      _out[2] = lin.z();
+      _out[3] = ang.x();
+      _out[4] = ang.y();
+      _out[5] = ang.z();
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      const ignition::math::Vector3d lin = link->WorldCoGLinearVel();
+      const ignition::math::Vector3d ang = link->WorldAngularVel();
+      _out[0] = lin.X();
+      _out[1] = lin.Y();
+      _out[2] = lin.Z();
+      _out[3] = ang.X();
+      _out[4] = ang.Y();
+      _out[5] = ang.Z();
+    }
+    _out += TwistSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTStateBatch::SetJointVelocities(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    dart::dynamics::Joint *dtJoint = NativeJoint(entry);
+    for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+    {
+      if (dtJoint)
+        dtJoint->setVelocity(i, *_in++);
+      else
+        entry.joint->SetVelocity(i, *_in++);
+    }
+  }
+}
@@ -162,6 +162,12 @@ LinkPtr ODEJoint::GetJointLink(unsigned int _index) const
   return result;
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::GetJointId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 bool ODEJoint::AreConnected(LinkPtr _one, LinkPtr _two) const
 {
@@ -836,8 +842,9 @@ JointWrench ODEJoint::GetForceTorque(unsigned int /*_index*/)
   }
   else
   {
-    // forgot to set provide_feedback?
-    gzwarn << "GetForceTorque: forgot to set <provide_feedback>?\n";
+    // forgot to set provide_feedback or to register the joint?
+    gzwarn << "GetForceTorque: forgot to set <provide_feedback> or to "
+           << "register the joint with the FeedbackRegistry?\n";
   }
 
   return this->wrench;
@@ -1001,6 +1008,10 @@ void ODEJoint::SetDamping(unsigned int _index, double _damping)
   {
     this->SetStiffnessDamping(_index, this->stiffnessCoefficient[_index],
       _damping);
+
+    // New clients get the damping from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
   }
   else
   {
@@ -1111,6 +1122,11 @@ void ODEJoint::SetProvideFeedback(bool _enable)
     else
       gzerr << "ODE Joint ID is invalid\n";
   }
+  else if (this->jointId)
+  {
+    // Stop ODE from computing the constraint forces of this joint.
+    dJointSetFeedback(this->jointId, nullptr);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -64,6 +64,10 @@ namespace gazebo
       // Documentation inherited.
       public: virtual LinkPtr GetJointLink(unsigned int _index) const override;
 
+      /// \brief Get the ODE id of this joint.
+      /// \return ODE joint id.
+      public: dJointID GetJointId() const;
+
       // Documentation inherited.
       public: virtual bool AreConnected(LinkPtr _one, LinkPtr _two) const
             override;
@@ -296,6 +300,10 @@ namespace gazebo
       /// \brief Save time at which force is applied by user
       /// This will let us know if it's time to clean up forceApplied.
       private: common::Time forceAppliedTime;
+
+      /// \brief The state batch reads and records the applied efforts
+      /// without the virtual calls.
+      private: friend class ODEStateBatch;
     };
     /// \}
   }
@@ -38,6 +38,8 @@ ODELink::ODELink(EntityPtr _parent)
     : Link(_parent)
 {
   this->linkId = nullptr;
+  if (_parent)
+    this->modelId = _parent->GetId();
 }
 
 //////////////////////////////////////////////////
@@ -181,6 +183,9 @@ void ODELink::Fini()
     dBodyDestroy(this->linkId);
   this->linkId = nullptr;
 
+  // The destructor finalizes the link again, after odePhysics is reset
+  if (this->odePhysics)
+    this->odePhysics->ReleaseModelSpace(this->modelId);
   this->odePhysics.reset();
 
   Link::Fini();
@@ -200,6 +205,9 @@ void ODELink::SetGravityMode(bool _mode)
     gzlog << "ODE body for link [" << this->GetScopedName() << "]"
           << " does not exist, unable to SetGravityMode" << std::endl;
   }
+
+  // New clients get the gravity mode from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
@@ -226,6 +234,9 @@ void ODELink::SetSelfCollide(bool _collide)
   this->sdf->GetElement("self_collide")->Set(_collide);
   if (_collide)
     this->spaceId = dSimpleSpaceCreate(this->odePhysics->GetSpaceId());
+
+  // New clients get the self collide flag from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
@@ -744,6 +755,9 @@ void ODELink::SetKinematic(const bool &_state)
   else if (!this->IsStatic() && this->initialized)
     gzlog << "ODE body for link [" << this->GetScopedName() << "]"
           << " does not exist, unable to SetKinematic" << std::endl;
+
+  // New clients get the kinematic flag from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
@@ -782,3 +796,13 @@ void ODELink::SetLinkStatic(bool /*_static*/)
 {
   gzlog << "To be implemented\n";
 }
+
+//////////////////////////////////////////////////
+void ODELink::SetStatic(const bool &_static)
+{
+  Link::SetStatic(_static);
+
+  // The links of a model share its collision space
+  if (this->odePhysics)
+    this->odePhysics->SetModelSpaceStatic(this->modelId, _static);
+}
@@ -182,6 +182,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetLinkStatic(bool _static);
 
+      // Documentation inherited
+      public: virtual void SetStatic(const bool &_static);
+
       /// \brief ODE link handle
       private: dBodyID linkId;
 
@@ -191,6 +194,9 @@ namespace gazebo
       /// \brief Collision space id.
       private: dSpaceID spaceId;
 
+      /// \brief Id of the model whose collision space the link uses.
+      private: uint32_t modelId = 0;
+
       /// \brief Cache force applied on body
       private: ignition::math::Vector3d force;
 
@@ -48,6 +48,7 @@
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/MapShape.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/FeedbackRegistry.hh"
 
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODELink.hh"
@@ -72,6 +73,7 @@
 
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODESurfaceParams.hh"
+#include "gazebo/physics/ode/ODEStateBatch.hh"
 
 #include "gazebo/physics/ode/ODEPhysicsPrivate.hh"
 
@@ -130,6 +132,105 @@ extern "C" void dMessageQuiet(int, const char *, va_list)
 {
 }
 
+//////////////////////////////////////////////////
+/// \brief Create a top-level space.
+/// \param[in] _type Broadphase of the space: hash, sap or tree.
+/// \return The space, null if the type is unknown.
+static dSpaceID CreateBroadphaseSpace(const std::string &_type)
+{
+  if (_type == "hash")
+  {
+    dSpaceID space = dHashSpaceCreate(0);
+    dHashSpaceSetLevels(space, -2, 8);
+    return space;
+  }
+  else if (_type == "sap")
+    return dSweepAndPruneSpaceCreate(0, dSAP_AXES_XYZ);
+  else if (_type == "tree")
+    return dTreeSpaceCreate(0);
+
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+/// \brief Move all the geoms and spaces of a space to another space.
+/// \param[in] _from Space to empty.
+/// \param[in] _to Space that receives the geoms.
+static void MoveSpaceGeoms(dSpaceID _from, dSpaceID _to)
+{
+  while (dSpaceGetNumGeoms(_from) > 0)
+  {
+    dGeomID geom = dSpaceGetGeom(_from, 0);
+    dSpaceRemove(_from, geom);
+    dSpaceAdd(_to, geom);
+  }
+}
+
+/// \brief Distance under which a contact point is taken to be the same
+/// point as a contact of the previous step, for warm starting.
+static const double kContactWarmStartDistance = 0.01;
+
+//////////////////////////////////////////////////
+/// \brief Read the impulses of the contact joints of the last step, before
+/// the joints are destroyed.
+/// \param[in] _data ODE physics data.
+static void SaveContactImpulses(ODEPhysicsPrivate *_data)
+{
+  _data->contactImpulses.swap(_data->contactJoints);
+  _data->contactJoints.clear();
+  for (auto &impulse : _data->contactImpulses)
+  {
+    dJointGetLambda(impulse.joint, impulse.lambda, impulse.lambdaErp);
+    impulse.joint = nullptr;
+  }
+  std::sort(_data->contactImpulses.begin(), _data->contactImpulses.end());
+}
+
+//////////////////////////////////////////////////
+/// \brief Warm start a new contact joint from the closest unused contact
+/// of the previous step between the same geoms and features.
+/// \param[in] _data ODE physics data.
+/// \param[in] _joint The new contact joint.
+/// \param[in] _geom Contact point of the joint.
+static void WarmStartContact(ODEPhysicsPrivate *_data, dJointID _joint,
+    const dContactGeom &_geom)
+{
+  ODEContactImpulse key;
+  key.geom1 = _geom.g1;
+  key.geom2 = _geom.g2;
+  key.side1 = _geom.side1;
+  key.side2 = _geom.side2;
+  key.pos[0] = _geom.pos[0];
+  key.pos[1] = _geom.pos[1];
+  key.pos[2] = _geom.pos[2];
+  key.joint = _joint;
+
+  auto range = std::equal_range(_data->contactImpulses.begin(),
+      _data->contactImpulses.end(), key);
+  ODEContactImpulse *closest = nullptr;
+  double closestDist = kContactWarmStartDistance * kContactWarmStartDistance;
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if (iter->used)
+      continue;
+    double dist = 0;
+    for (int i = 0; i < 3; ++i)
+      dist += (iter->pos[i] - key.pos[i]) * (iter->pos[i] - key.pos[i]);
+    if (dist < closestDist)
+    {
+      closestDist = dist;
+      closest = &(*iter);
+    }
+  }
+
+  if (closest)
+  {
+    dJointSetLambda(_joint, closest->lambda, closest->lambdaErp);
+    closest->used = true;
+  }
+  _data->contactJoints.push_back(key);
+}
+
 //////////////////////////////////////////////////
 ODEPhysics::ODEPhysics(WorldPtr _world)
     : PhysicsEngine(_world), dataPtr(new ODEPhysicsPrivate)
@@ -144,8 +245,7 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
 
   this->dataPtr->worldId = dWorldCreate();
 
-  this->dataPtr->spaceId = dHashSpaceCreate(0);
-  dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
+  this->dataPtr->spaceId = CreateBroadphaseSpace(this->dataPtr->broadphase);
 
   this->dataPtr->contactGroup = dJointGroupCreate(0);
 
@@ -355,6 +455,7 @@ void ODEPhysics::InitForThread()
 {
   IGN_PROFILE_THREAD_NAME("ODEPhysics");
   dAllocateODEDataForThread(dAllocateMaskAll);
+  dRandSetSeed(this->dataPtr->seed);
 }
 
 //////////////////////////////////////////////////
@@ -365,6 +466,8 @@ void ODEPhysics::UpdateCollision()
   IGN_PROFILE_BEGIN("dSpaceCollide");
 
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (this->dataPtr->contactWarmStart)
+    SaveContactImpulses(this->dataPtr);
   dJointGroupEmpty(this->dataPtr->contactGroup);
 
   unsigned int i = 0;
@@ -416,6 +519,16 @@ void ODEPhysics::UpdatePhysics()
   {
     boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+    // The seed may have been set from another thread, e.g. by a reset.
+    // The islands of a step are seeded from the seed of the ODE world,
+    // whichever thread solves them.
+    if (this->dataPtr->seedDirty)
+    {
+      dRandSetSeed(this->dataPtr->seed);
+      dWorldSetRandSeed(this->dataPtr->worldId, this->dataPtr->seed);
+      this->dataPtr->seedDirty = false;
+    }
+
     // Update the dynamical model
     (*(this->dataPtr->physicsStepFunc))
       (this->dataPtr->worldId, this->maxStepSize);
@@ -451,6 +564,9 @@ void ODEPhysics::UpdatePhysics()
              col2->GetLink()->WorldPose().Rot().RotateVectorReverse(t2);
       }
     }
+
+    this->feedbackRegistry->SetContactWrenchCount(
+        this->dataPtr->jointFeedbackIndex);
   }
 
   DIAG_TIMER_STOP("ODEPhysics::UpdatePhysics");
@@ -473,6 +589,14 @@ void ODEPhysics::Fini()
   }
   this->dataPtr->jointFeedbacks.clear();
 
+  if (this->dataPtr->staticSpaceId)
+  {
+    dSpaceSetCleanup(this->dataPtr->staticSpaceId, 0);
+    dSpaceDestroy(this->dataPtr->staticSpaceId);
+    this->dataPtr->staticSpaceId = nullptr;
+  }
+  this->dataPtr->staticSpaces.clear();
+
   if (this->dataPtr->spaceId)
   {
     dSpaceSetCleanup(this->dataPtr->spaceId, 0);
@@ -494,6 +618,12 @@ void ODEPhysics::Reset()
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   // Very important to clear out the contact group
   dJointGroupEmpty(this->dataPtr->contactGroup);
+
+  // Discard impulses cached for warm starting, they belong to the
+  // configuration before the reset.
+  dWorldResetQuickStepWarmStart(this->dataPtr->worldId);
+  this->dataPtr->contactJoints.clear();
+  this->dataPtr->contactImpulses.clear();
 }
 
 //////////////////////////////////////////////////
@@ -502,21 +632,78 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   if (_parent == nullptr)
     gzthrow("Link must have a parent\n");
 
-  std::map<std::string, dSpaceID>::iterator iter;
-  iter = this->dataPtr->spaces.find(_parent->GetName());
-
-  if (iter == this->dataPtr->spaces.end())
-    this->dataPtr->spaces[_parent->GetName()] =
-      dSimpleSpaceCreate(this->dataPtr->spaceId);
+  // The links of a model share a space, created with the first link
+  ODEModelSpace &modelSpace = this->dataPtr->spaces[_parent->GetId()];
+  if (!modelSpace.space)
+  {
+    // Static models go to the static space, where they are only collided
+    // with the other models and never with each other.
+    dSpaceID parentSpace = this->dataPtr->spaceId;
+    if (_parent->IsStatic() && this->dataPtr->staticSpaceId)
+      parentSpace = this->dataPtr->staticSpaceId;
+
+    modelSpace.space = dSimpleSpaceCreate(parentSpace);
+    if (_parent->IsStatic())
+      this->dataPtr->staticSpaces.insert(modelSpace.space);
+  }
+  ++modelSpace.links;
 
   ODELinkPtr link(new ODELink(_parent));
 
-  link->SetSpaceId(this->dataPtr->spaces[_parent->GetName()]);
+  link->SetSpaceId(modelSpace.space);
   link->SetWorld(_parent->GetWorld());
 
   return link;
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::SetModelSpaceStatic(const uint32_t _modelId,
+    const bool _static)
+{
+  // The spaces are used by the physics thread
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  auto iter = this->dataPtr->spaces.find(_modelId);
+  if (iter == this->dataPtr->spaces.end())
+    return;
+
+  dSpaceID space = iter->second.space;
+  dSpaceID parentSpace = this->dataPtr->spaceId;
+  if (_static)
+  {
+    this->dataPtr->staticSpaces.insert(space);
+    if (this->dataPtr->staticSpaceId)
+      parentSpace = this->dataPtr->staticSpaceId;
+  }
+  else
+  {
+    this->dataPtr->staticSpaces.erase(space);
+  }
+
+  dSpaceID currentSpace = dGeomGetSpace((dGeomID)space);
+  if (currentSpace != parentSpace)
+  {
+    dSpaceRemove(currentSpace, (dGeomID)space);
+    dSpaceAdd(parentSpace, (dGeomID)space);
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::ReleaseModelSpace(const uint32_t _modelId)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  auto iter = this->dataPtr->spaces.find(_modelId);
+  if (iter == this->dataPtr->spaces.end() || --iter->second.links > 0)
+    return;
+
+  // The geoms of the links are destroyed with their collisions, so they
+  // are only taken out of the space here
+  dSpaceID space = iter->second.space;
+  this->dataPtr->staticSpaces.erase(space);
+  this->dataPtr->spaces.erase(iter);
+  dSpaceSetCleanup(space, 0);
+  dSpaceDestroy(space);
+}
+
 //////////////////////////////////////////////////
 CollisionPtr ODEPhysics::CreateCollision(const std::string &_type,
                                          LinkPtr _body)
@@ -906,6 +1093,13 @@ JointPtr ODEPhysics::CreateJoint(const std::string &_type, ModelPtr _parent)
   return joint;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr ODEPhysics::CreateStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+{
+  return StateBatchPtr(new ODEStateBatch(_joints, _links));
+}
+
 //////////////////////////////////////////////////
 dSpaceID ODEPhysics::GetSpaceId() const
 {
@@ -1265,12 +1459,14 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   // Add a new contact to the manager. This will return nullptr if no one is
   // listening for contact information.
   Contact *contactFeedback = this->contactManager->NewContact(_collision1,
-      _collision2, this->world->SimTime());
+      _collision2, this->world->SimTime(), numc);
 
   ODEJointFeedback *jointFeedback = nullptr;
 
-  // Create a joint feedback mechanism
-  if (contactFeedback)
+  // Create a joint feedback mechanism, unless no one reads the wrenches of
+  // this contact.
+  if (contactFeedback &&
+      this->feedbackRegistry->ContactWrenchWanted(_collision1, _collision2))
   {
     if (this->dataPtr->jointFeedbackIndex <
         this->dataPtr->jointFeedbacks.size())
@@ -1298,7 +1494,7 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
       this->dataPtr->contactGroup, &contact);
 
     // Store contact information.
-    if (contactFeedback && jointFeedback)
+    if (contactFeedback)
     {
       // Store the contact depth
       contactFeedback->depths[j] =
@@ -1316,18 +1512,29 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
           _contactCollisions[this->dataPtr->indices[j]].normal[1],
           _contactCollisions[this->dataPtr->indices[j]].normal[2]);
 
-      // Set the joint feedback.
-      dJointSetFeedback(contactJoint, &(jointFeedback->feedbacks[j]));
+      // Set the joint feedback, or report a zero wrench.
+      if (jointFeedback)
+      {
+        dJointSetFeedback(contactJoint, &(jointFeedback->feedbacks[j]));
+        jointFeedback->count++;
+      }
+      else
+        contactFeedback->wrench[j] = JointWrench();
 
-      // Increase the counters
+      // Increase the counter
       contactFeedback->count++;
-      jointFeedback->count++;
     }
 
     // Attach the contact joint if collideWithoutContact flags aren't set.
     if (!_collision1->GetSurface()->collideWithoutContact &&
         !_collision2->GetSurface()->collideWithoutContact)
+    {
       dJointAttach(contactJoint, b1, b2);
+
+      // Start from the impulses of the same contact on the previous step
+      if (this->dataPtr->contactWarmStart)
+        WarmStartContact(this->dataPtr, contactJoint, contact.geom);
+    }
   }
 }
 
@@ -1414,6 +1621,8 @@ void ODEPhysics::DebugPrint() const
 /////////////////////////////////////////////////
 void ODEPhysics::SetSeed(uint32_t _seed)
 {
+  this->dataPtr->seed = _seed;
+  this->dataPtr->seedDirty = true;
   dRandSetSeed(_seed);
 }
 
@@ -1531,6 +1740,11 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       dWorldSetQuickStepExperimentalRowReordering(this->dataPtr->worldId,
         any_cast<bool>(_value));
     }
+    else if (_key == "simd_rows")
+    {
+      dWorldSetQuickStepSIMDRows(this->dataPtr->worldId,
+        any_cast<bool>(_value));
+    }
     else if (_key == "warm_start_factor")
     {
       dWorldSetQuickStepWarmStartFactor(this->dataPtr->worldId,
@@ -1555,6 +1769,73 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "contact_warm_start")
+    {
+      // The cache is used by the physics thread
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      this->dataPtr->contactWarmStart = any_cast<bool>(_value);
+      this->dataPtr->contactJoints.clear();
+      this->dataPtr->contactImpulses.clear();
+    }
+    else if (_key == "broadphase")
+    {
+      const std::string type = any_cast<std::string>(_value);
+      dSpaceID space = CreateBroadphaseSpace(type);
+      if (!space)
+      {
+        gzerr << "Unknown broadphase [" << type
+              << "], valid types are hash, sap and tree" << std::endl;
+        return false;
+      }
+
+      // The spaces are used by the physics thread
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      MoveSpaceGeoms(this->dataPtr->spaceId, space);
+      dSpaceSetCleanup(this->dataPtr->spaceId, 0);
+      dSpaceDestroy(this->dataPtr->spaceId);
+      this->dataPtr->spaceId = space;
+      this->dataPtr->broadphase = type;
+    }
+    else if (_key == "static_space")
+    {
+      const bool value = any_cast<bool>(_value);
+
+      // The spaces are used by the physics thread
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      if (value && !this->dataPtr->staticSpaceId)
+      {
+        // Static geoms never move, so their boxes need no margin
+        this->dataPtr->staticSpaceId =
+            dTreeSpaceCreate(this->dataPtr->spaceId);
+        dTreeSpaceSetMargin(this->dataPtr->staticSpaceId, 0);
+        for (auto const space : this->dataPtr->staticSpaces)
+        {
+          dSpaceRemove(dGeomGetSpace((dGeomID)space), (dGeomID)space);
+          dSpaceAdd(this->dataPtr->staticSpaceId, (dGeomID)space);
+        }
+      }
+      else if (!value && this->dataPtr->staticSpaceId)
+      {
+        MoveSpaceGeoms(this->dataPtr->staticSpaceId, this->dataPtr->spaceId);
+        dSpaceSetCleanup(this->dataPtr->staticSpaceId, 0);
+        dSpaceDestroy(this->dataPtr->staticSpaceId);
+        this->dataPtr->staticSpaceId = nullptr;
+      }
+    }
+    else if (_key == "colored_row_threads")
+    {
+      int value;
+      try
+      {
+        value = any_cast<int>(_value);
+      }
+      catch(const boost::bad_any_cast &e)
+      {
+        gzerr << "boost any_cast error:" << e.what() << "\n";
+        return false;
+      }
+      dWorldSetQuickStepColoredRows(this->dataPtr->worldId, value);
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1654,6 +1935,8 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = dWorldGetQuickStepExperimentalRowReordering
         (this->dataPtr->worldId);
   }
+  else if (_key == "simd_rows")
+    _value = dWorldGetQuickStepSIMDRows(this->dataPtr->worldId);
   else if (_key == "warm_start_factor")
     _value = dWorldGetQuickStepWarmStartFactor(this->dataPtr->worldId);
   else if (_key == "extra_friction_iterations")
@@ -1662,6 +1945,14 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "colored_row_threads")
+    _value = dWorldGetQuickStepColoredRows(this->dataPtr->worldId);
+  else if (_key == "contact_warm_start")
+    _value = this->dataPtr->contactWarmStart;
+  else if (_key == "broadphase")
+    _value = this->dataPtr->broadphase;
+  else if (_key == "static_space")
+    _value = this->dataPtr->staticSpaceId != nullptr;
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
@@ -139,6 +139,10 @@ namespace gazebo
       public: virtual JointPtr CreateJoint(const std::string &_type,
                                            ModelPtr _parent);
 
+      // Documentation inherited
+      public: virtual StateBatchPtr CreateStateBatch(const Joint_V &_joints,
+                  const Link_V &_links);
+
       // Documentation inherited
       public: virtual void SetGravity(const ignition::math::Vector3d &_gravity);
 
@@ -232,6 +236,19 @@ namespace gazebo
       /// \return The world id.
       public: dWorldID GetWorldId();
 
+      /// \brief Move the collision space of a model to the space of the
+      /// static or of the dynamic models.
+      /// \param[in] _modelId Id of the model.
+      /// \param[in] _static True if the model became static.
+      public: void SetModelSpaceStatic(const uint32_t _modelId,
+                  const bool _static);
+
+      /// \brief Release the collision space of a model for one of its
+      /// links. The space is destroyed once all the links created by
+      /// CreateLink have released it.
+      /// \param[in] _modelId Id of the model.
+      public: void ReleaseModelSpace(const uint32_t _modelId);
+
       /// \brief Convert an ODE mass to Inertial.
       /// \param[out] _intertial Pointer to an Inertial object.
       /// \param[in] _odeMass Pointer to an ODE mass that will be converted.
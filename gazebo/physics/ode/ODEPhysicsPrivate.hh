@@ -18,7 +18,9 @@
 #ifndef _ODEPHYSICS_PRIVATE_HH_
 #define _ODEPHYSICS_PRIVATE_HH_
 
+#include <atomic>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <utility>
@@ -45,6 +47,65 @@ namespace gazebo
       public: dJointFeedback feedbacks[MAX_CONTACT_JOINTS];
     };
 
+    /// \brief Impulses of a contact point at the end of a step, used to
+    /// warm start the contact that replaces it on the next step.
+    class ODEContactImpulse
+    {
+      /// \brief Order by geoms and features, the key of the cache.
+      /// \param[in] _other Impulse to compare to.
+      /// \return True if this impulse comes first.
+      public: bool operator<(const ODEContactImpulse &_other) const
+      {
+        if (this->geom1 != _other.geom1)
+          return this->geom1 < _other.geom1;
+        if (this->geom2 != _other.geom2)
+          return this->geom2 < _other.geom2;
+        if (this->side1 != _other.side1)
+          return this->side1 < _other.side1;
+        return this->side2 < _other.side2;
+      }
+
+      /// \brief First geom of the contact.
+      public: dGeomID geom1 = nullptr;
+
+      /// \brief Second geom of the contact.
+      public: dGeomID geom2 = nullptr;
+
+      /// \brief Feature of the first geom, such as a triangle index.
+      /// -1 for shapes that do not report features.
+      public: int side1 = -1;
+
+      /// \brief Feature of the second geom.
+      public: int side2 = -1;
+
+      /// \brief World position of the contact point.
+      public: dVector3 pos;
+
+      /// \brief Contact joint of the current step, until its impulses are
+      /// read.
+      public: dJointID joint = nullptr;
+
+      /// \brief Impulses of the contact joint rows.
+      public: dReal lambda[6];
+
+      /// \brief Impulses of the position correction rows.
+      public: dReal lambdaErp[6];
+
+      /// \brief True once a contact of the next step took the impulses.
+      public: bool used = false;
+    };
+
+    /// \brief Collision space shared by the links of a model.
+    class ODEModelSpace
+    {
+      /// \brief The space.
+      public: dSpaceID space = nullptr;
+
+      /// \brief Number of links of the model that use the space. The space
+      /// is destroyed when the last of them is finalized.
+      public: unsigned int links = 0;
+    };
+
     class ODEPhysicsPrivate
     {
       /// \brief Top-level world for all bodies
@@ -53,6 +114,16 @@ namespace gazebo
       /// \brief Top-level space for all sub-spaces/collisions
       public: dSpaceID spaceId;
 
+      /// \brief Broadphase type of the top-level space: hash, sap or tree.
+      public: std::string broadphase = "hash";
+
+      /// \brief Space of the static models, inside the top-level space.
+      /// Null when the static models are in the top-level space.
+      public: dSpaceID staticSpaceId = nullptr;
+
+      /// \brief Spaces of the static models, wherever they are.
+      public: std::set<dSpaceID> staticSpaces;
+
       /// \brief Collision attributes
       public: dJointGroupID contactGroup;
 
@@ -65,8 +136,8 @@ namespace gazebo
       /// \brief Physics step function.
       public: int (*physicsStepFunc)(dxWorld*, dReal);
 
-      /// \brief All the collsiion spaces.
-      public: std::map<std::string, dSpaceID> spaces;
+      /// \brief Collision spaces of the models, by model id.
+      public: std::map<uint32_t, ODEModelSpace> spaces;
 
       /// \brief All the normal colliders.
       public: std::vector< std::pair<ODECollision*, ODECollision*> > colliders;
@@ -92,6 +163,26 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Random seed of the solver. ODE keeps one generator per
+      /// thread, which each step seeds per island from the seed of the ODE
+      /// world. The seed is applied on the thread that steps the world.
+      public: uint32_t seed = 0;
+
+      /// \brief True when the seed changed and has to be applied on the
+      /// stepping thread.
+      public: std::atomic<bool> seedDirty{false};
+
+      /// \brief True to warm start contacts from the impulses of the
+      /// matching contacts of the previous step.
+      public: bool contactWarmStart = false;
+
+      /// \brief Contact joints created for the current step.
+      public: std::vector<ODEContactImpulse> contactJoints;
+
+      /// \brief Impulses of the contacts of the previous step, sorted by
+      /// geoms and features.
+      public: std::vector<ODEContactImpulse> contactImpulses;
     };
   }
 }
@@ -17,6 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
@@ -37,6 +43,72 @@ class ODEPhysics_TEST : public ServerFixture
 msgs::Physics ODEPhysics_TEST::physicsPubMsg;
 msgs::Physics ODEPhysics_TEST::physicsResponseMsg;
 
+/////////////////////////////////////////////////
+/// \brief Check the default value of a physics parameter, then that each
+/// value set is read back.
+/// \param[in] _physics Physics engine.
+/// \param[in] _key Name of the parameter.
+/// \param[in] _default Expected default value.
+/// \param[in] _values Values to set, in order.
+template<typename T>
+static void ExpectParam(PhysicsEnginePtr _physics, const std::string &_key,
+    const T &_default, const std::vector<T> &_values)
+{
+  T value = T();
+  EXPECT_NO_THROW(value = boost::any_cast<T>(_physics->GetParam(_key)));
+  EXPECT_EQ(_default, value) << _key;
+
+  for (const T valueSet : _values)
+  {
+    EXPECT_TRUE(_physics->SetParam(_key, valueSet)) << _key;
+    EXPECT_NO_THROW(value = boost::any_cast<T>(_physics->GetParam(_key)));
+    EXPECT_EQ(valueSet, value) << _key;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Reset a world, set physics parameters and step the world.
+/// \param[in] _world The world.
+/// \param[in] _params Physics parameters to set after the reset.
+/// \param[in] _steps Number of steps.
+/// \return Poses of the models after the steps.
+static std::vector<ignition::math::Pose3d> StepAndCollectPoses(
+    WorldPtr _world, const std::map<std::string, boost::any> &_params,
+    const unsigned int _steps)
+{
+  _world->Reset();
+  for (auto const &param : _params)
+    EXPECT_TRUE(_world->Physics()->SetParam(param.first, param.second))
+        << param.first;
+  _world->Step(_steps);
+
+  std::vector<ignition::math::Pose3d> poses;
+  for (auto const &model : _world->Models())
+    poses.push_back(model->WorldPose());
+  return poses;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that two sets of poses are the same, bit for bit.
+/// \param[in] _expected Expected poses.
+/// \param[in] _actual Actual poses.
+static void ExpectPosesEqual(
+    const std::vector<ignition::math::Pose3d> &_expected,
+    const std::vector<ignition::math::Pose3d> &_actual)
+{
+  ASSERT_EQ(_expected.size(), _actual.size());
+  for (size_t i = 0; i < _expected.size(); ++i)
+  {
+    EXPECT_EQ(_expected[i].Pos().X(), _actual[i].Pos().X());
+    EXPECT_EQ(_expected[i].Pos().Y(), _actual[i].Pos().Y());
+    EXPECT_EQ(_expected[i].Pos().Z(), _actual[i].Pos().Z());
+    EXPECT_EQ(_expected[i].Rot().W(), _actual[i].Rot().W());
+    EXPECT_EQ(_expected[i].Rot().X(), _actual[i].Rot().X());
+    EXPECT_EQ(_expected[i].Rot().Y(), _actual[i].Rot().Y());
+    EXPECT_EQ(_expected[i].Rot().Z(), _actual[i].Rot().Z());
+  }
+}
+
 /////////////////////////////////////////////////
 /// Test setting and getting ode physics params
 TEST_F(ODEPhysics_TEST, PhysicsParam)
@@ -301,6 +373,12 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     EXPECT_EQ(param, frictionModel);
   }
 
+  // Test the solver and collision options
+  ExpectParam<bool>(odePhysics, "simd_rows", false, {true, false});
+  ExpectParam<int>(odePhysics, "colored_row_threads", 0, {1, 4, 0});
+  ExpectParam<bool>(odePhysics, "contact_warm_start", false, {true, false});
+  ExpectParam<bool>(odePhysics, "static_space", false, {true, false});
+
   // Test island_threads
   {
     // island_threads should be 0 by default
@@ -320,6 +398,17 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     }
   }
 
+  // Test broadphase
+  {
+    ExpectParam<std::string>(odePhysics, "broadphase", "hash",
+        {"sap", "tree", "hash"});
+
+    // unknown types are refused
+    EXPECT_FALSE(odePhysics->SetParam("broadphase", std::string("grid")));
+    EXPECT_EQ("hash",
+      boost::any_cast<std::string>(odePhysics->GetParam("broadphase")));
+  }
+
   // Test ode_quiet
   // convenient for disabling LCP internal error messages from world solver
   {
@@ -374,6 +463,161 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
   }
 }
 
+/////////////////////////////////////////////////
+/// Test that the packed vector row kernel gives the same poses, bit for
+/// bit, as the default kernel
+TEST_F(ODEPhysics_TEST, SIMDRows)
+{
+  Load("worlds/pgs_benchmark.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Poses after stepping from the initial state, with and without the
+  // vector kernel
+  ExpectPosesEqual(
+      StepAndCollectPoses(world, {{"simd_rows", false}}, 500),
+      StepAndCollectPoses(world, {{"simd_rows", true}}, 500));
+
+  // The stacks have settled on the ground, so contacts were solved
+  ModelPtr top = world->ModelByName("box_3");
+  ASSERT_TRUE(top != nullptr);
+  EXPECT_NEAR(1.75, top->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Test that the colored solve of a single large island gives the same
+/// poses, bit for bit, whatever the number of threads
+TEST_F(ODEPhysics_TEST, ColoredRows)
+{
+  // The solver never runs more threads than there are cores, so a single
+  // core would compare the single threaded solve with itself
+  const unsigned int cores = std::thread::hardware_concurrency();
+  if (cores < 2)
+  {
+    gzerr << "Only one core, skipping test for colored_row_threads."
+          << std::endl;
+    return;
+  }
+  const int threads = static_cast<int>(std::min(4u, cores));
+
+  Load("worlds/pgs_pile.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ExpectPosesEqual(
+      StepAndCollectPoses(world, {{"colored_row_threads", 1}}, 500),
+      StepAndCollectPoses(world, {{"colored_row_threads", threads}}, 500));
+
+  // The pile still stands
+  ModelPtr top = world->ModelByName("box_203");
+  ASSERT_TRUE(top != nullptr);
+  EXPECT_NEAR(3.75, top->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Test that stacks stay up with few iterations when contacts are warm
+/// started from the previous step
+TEST_F(ODEPhysics_TEST, ContactWarmStart)
+{
+  Load("worlds/pgs_benchmark.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  EXPECT_TRUE(world->Physics()->SetParam("iters", 5));
+
+  std::vector<std::vector<ignition::math::Pose3d>> poses;
+  for (const bool warmStart : {false, true})
+  {
+    poses.push_back(StepAndCollectPoses(world,
+        {{"contact_warm_start", warmStart}}, 1000));
+
+    // The stacks still stand
+    ModelPtr top = world->ModelByName("box_3");
+    ASSERT_TRUE(top != nullptr);
+    EXPECT_NEAR(1.75, top->WorldPose().Pos().Z(), 0.01);
+  }
+
+  // The impulses carried over change the solution
+  ASSERT_EQ(poses[0].size(), poses[1].size());
+  EXPECT_NE(poses[0], poses[1]);
+}
+
+/////////////////////////////////////////////////
+/// Test that all the broadphases find the same contacts, with and without
+/// a separate space for the static models
+TEST_F(ODEPhysics_TEST, Broadphase)
+{
+  Load("worlds/pgs_benchmark.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  int expectedContacts = -1;
+  for (const std::string broadphase : {"hash", "sap", "tree"})
+  {
+    for (const bool staticSpace : {false, true})
+    {
+      StepAndCollectPoses(world,
+          {{"broadphase", broadphase}, {"static_space", staticSpace}}, 500);
+
+      // The stacks stand on the static ground plane
+      ModelPtr top = world->ModelByName("box_3");
+      ASSERT_TRUE(top != nullptr);
+      EXPECT_NEAR(1.75, top->WorldPose().Pos().Z(), 0.01);
+
+      const int contacts =
+          boost::any_cast<int>(world->Physics()->GetParam("num_contacts"));
+      EXPECT_GT(contacts, 0);
+      if (expectedContacts < 0)
+        expectedContacts = contacts;
+      EXPECT_EQ(expectedContacts, contacts)
+          << broadphase << " static_space " << staticSpace;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// Test that the collision space of a model follows its static flag and is
+/// destroyed with the model
+TEST_F(ODEPhysics_TEST, ModelSpaces)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr physics =
+      boost::static_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_TRUE(physics->SetParam("static_space", true));
+
+  // The ground plane is in the static space, inside the top-level space
+  dSpaceID space = physics->GetSpaceId();
+  const int geoms = dSpaceGetNumGeoms(space);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_EQ(geoms + 1, dSpaceGetNumGeoms(space));
+
+  // A static model moves to the static space, and back
+  box->SetStatic(true);
+  EXPECT_EQ(geoms, dSpaceGetNumGeoms(space));
+  box->SetStatic(false);
+  EXPECT_EQ(geoms + 1, dSpaceGetNumGeoms(space));
+
+  // A model spawned again under the same name gets a new space
+  box.reset();
+  world->RemoveModel("box");
+  EXPECT_EQ(geoms, dSpaceGetNumGeoms(space));
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  EXPECT_EQ(geoms + 1, dSpaceGetNumGeoms(space));
+  world->Step(100);
+  box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_NEAR(0.5, box->WorldPose().Pos().Z(), 0.01);
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics_TEST::OnPhysicsMsgResponse(ConstResponsePtr &_msg)
 {
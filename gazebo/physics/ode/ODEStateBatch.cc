@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <vector>
+
+#include "gazebo/physics/Inertial.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
+#include "gazebo/physics/ode/ODELink.hh"
+#include "gazebo/physics/ode/ODEStateBatch.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief How the coordinates of a joint are read.
+  enum class JointAccess
+  {
+    /// \brief Through the Joint API.
+    GENERIC,
+
+    /// \brief With dJointGetHingeAngle and dJointGetHingeAngleRate.
+    HINGE,
+
+    /// \brief With dJointGetSliderPosition and
+    /// dJointGetSliderPositionRate.
+    SLIDER
+  };
+
+  /// \brief Cached lookup of a joint of the batch.
+  struct JointEntry
+  {
+    /// \brief The joint, owned by the batch.
+    Joint *joint = nullptr;
+
+    /// \brief The joint as an ODE joint, or nullptr.
+    ODEJoint *odeJoint = nullptr;
+
+    /// \brief Model of the joint, or nullptr.
+    Model *model = nullptr;
+
+    /// \brief How the joint is read.
+    JointAccess access = JointAccess::GENERIC;
+  };
+}
+
+/// \internal
+/// \brief Private data class for ODEStateBatch
+class gazebo::physics::ODEStateBatchPrivate
+{
+  /// \brief Joints of the batch, in array order.
+  public: std::vector<JointEntry> joints;
+
+  /// \brief Links of the batch as ODE links, in array order.
+  public: std::vector<ODELink *> links;
+};
+
+//////////////////////////////////////////////////
+ODEStateBatch::ODEStateBatch(const Joint_V &_joints, const Link_V &_links)
+  : StateBatch(_joints, _links), dataPtr(new ODEStateBatchPrivate)
+{
+  this->dataPtr->joints.resize(_joints.size());
+  for (unsigned int i = 0; i < _joints.size(); ++i)
+  {
+    JointEntry &entry = this->dataPtr->joints[i];
+    entry.joint = _joints[i].get();
+    entry.odeJoint = dynamic_cast<ODEJoint *>(entry.joint);
+    entry.model = dynamic_cast<Model *>(entry.joint->GetParent().get());
+
+    dJointID id = entry.odeJoint ? entry.odeJoint->GetJointId() : nullptr;
+    if (!id || !entry.model)
+      continue;
+
+    switch (dJointGetType(id))
+    {
+      case dJointTypeHinge:
+        entry.access = JointAccess::HINGE;
+        break;
+      case dJointTypeSlider:
+        entry.access = JointAccess::SLIDER;
+        break;
+      default:
+        break;
+    }
+  }
+
+  this->dataPtr->links.reserve(_links.size());
+  for (auto const &link : _links)
+    this->dataPtr->links.push_back(dynamic_cast<ODELink *>(link.get()));
+}
+
+//////////////////////////////////////////////////
+ODEStateBatch::~ODEStateBatch()
+{
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::JointPositions(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    // Joints of static models report the position they were set to.
+    dJointID id = entry.odeJoint ? entry.odeJoint->GetJointId() : nullptr;
+    if (id && entry.access == JointAccess::HINGE && !entry.model->IsStatic())
+    {
+      *_out++ = dJointGetHingeAngle(id);
+    }
+    else if (id && entry.access == JointAccess::SLIDER &&
+        !entry.model->IsStatic())
+    {
+      *_out++ = dJointGetSliderPosition(id);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.joint->Position(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::JointVelocities(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    dJointID id = entry.odeJoint ? entry.odeJoint->GetJointId() : nullptr;
+    if (id && entry.access == JointAccess::HINGE)
+    {
+      *_out++ = dJointGetHingeAngleRate(id);
+    }
+    else if (id && entry.access == JointAccess::SLIDER)
+    {
+      *_out++ = dJointGetSliderPositionRate(id);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.joint->GetVelocity(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::JointForces(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    if (entry.odeJoint)
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.odeJoint->forceApplied[i];
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.joint->GetForce(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::LinkPoses(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    ODELink *odeLink = this->dataPtr->links[i];
+    dBodyID body = odeLink ? odeLink->GetODEId() : nullptr;
+    if (body)
+    {
+      // The body is at the center of mass, as in ODELink::MoveCallback
+      const dReal *p = dBodyGetPosition(body);
+      const dReal *r = dBodyGetQuaternion(body);
+      const ignition::math::Quaterniond rot(r[0], r[1], r[2], r[3]);
+      const ignition::math::Vector3d cog =
+          rot.RotateVector(odeLink->GetInertial()->CoG());
+      _out[0] = p[0] - cog.X();
+      _out[1] = p[1] - cog.Y();
+      _out[2] = p[2] - cog.Z();
+      _out[3] = rot.W();
+      _out[4] = rot.X();
+      _out[5] = rot.Y();
+      _out[6] = rot.Z();
+    }
+    else
+    {
+      const ignition::math::Pose3d &pose = this->Links()[i]->WorldPose();
+      _out[0] = pose.Pos().X();
+      _out[1] = pose.Pos().Y();
+      _out[2] = pose.Pos().Z();
+      _out[3] = pose.Rot().W();
+      _out[4] = pose.Rot().X();
+      _out[5] = pose.Rot().Y();
+      _out[6] = pose.Rot().Z();
+    }
+    _out += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::LinkTwists(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    ODELink *odeLink = this->dataPtr->links[i];
+    dBodyID body = odeLink ? odeLink->GetODEId() : nullptr;
+    if (body)
+    {
+      const dReal *lin = dBodyGetLinearVel(body);
+      const dReal *ang = dBodyGetAngularVel(body);
+      _out[0] = lin[0];
+      _out[1] = lin[1];
+      _out[2] = lin[2];
+      _out[3] = ang[0];
+      _out[4] = ang[1];
+      _out[5] = ang[2];
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      const ignition::math::Vector3d lin = link->WorldCoGLinearVel();
+      const ignition::math::Vector3d ang = link->WorldAngularVel();
+      _out[0] = lin.X();
+      _out[1] = lin.Y();
+      _out[2] = lin.Z();
+      _out[3] = ang.X();
+      _out[4] = ang.Y();
+      _out[5] = ang.Z();
+    }
+    _out += TwistSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::SetLinkTwists(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    ODELink *odeLink = this->dataPtr->links[i];
+    dBodyID body = odeLink ? odeLink->GetODEId() : nullptr;
+    if (body)
+    {
+      dBodySetLinearVel(body, _in[0], _in[1], _in[2]);
+      dBodySetAngularVel(body, _in[3], _in[4], _in[5]);
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      link->SetLinearVel(ignition::math::Vector3d(_in[0], _in[1], _in[2]));
+      link->SetAngularVel(ignition::math::Vector3d(_in[3], _in[4], _in[5]));
+    }
+    _in += TwistSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEStateBatch::SetJointForces(const double *_in)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    dJointID id = entry.odeJoint ? entry.odeJoint->GetJointId() : nullptr;
+    if (id && entry.access != JointAccess::GENERIC &&
+        !entry.model->IsStatic())
+    {
+      // Same as ODEJoint::SetForce, without the virtual calls
+      const double force = entry.joint->CheckAndTruncateForce(0, *_in++);
+      entry.odeJoint->SaveForce(0, force);
+      if (entry.access == JointAccess::HINGE)
+        dJointAddHingeTorque(id, force);
+      else
+        dJointAddSliderForce(id, force);
+
+      for (int b = 0; b < 2; ++b)
+      {
+        dBodyID body = dJointGetBody(id, b);
+        if (body)
+          dBodyEnable(body);
+      }
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        entry.joint->SetForce(i, *_in++);
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODESTATEBATCH_HH_
+#define GAZEBO_PHYSICS_ODE_ODESTATEBATCH_HH_
+
+#include <memory>
+
+#include "gazebo/physics/StateBatch.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class ODEStateBatchPrivate;
+
+    /// \addtogroup gazebo_physics_ode
+    /// \{
+
+    /// \brief State batch that reads the ODE joints and bodies directly.
+    /// Positions, velocities and efforts of hinge and slider joints, and
+    /// the poses and twists of dynamic links, skip the Joint and Link
+    /// virtual calls. Other joint types, joints of static models, links
+    /// without a body and the joint position and velocity setters go
+    /// through the StateBatch base class.
+    class GZ_PHYSICS_VISIBLE ODEStateBatch : public StateBatch
+    {
+      /// \brief Constructor.
+      /// \param[in] _joints Joints of the batch, in array order.
+      /// \param[in] _links Links of the batch, in array order.
+      public: ODEStateBatch(const Joint_V &_joints, const Link_V &_links);
+
+      /// \brief Destructor.
+      public: virtual ~ODEStateBatch();
+
+      // Documentation inherited
+      public: virtual void JointPositions(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void JointVelocities(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void JointForces(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void LinkPoses(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void LinkTwists(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void SetJointForces(const double *_in) override;
+
+      // Documentation inherited
+      public: virtual void SetLinkTwists(const double *_in) override;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ODEStateBatchPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
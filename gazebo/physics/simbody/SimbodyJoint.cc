@@ -391,6 +391,10 @@ void SimbodyJoint::SetDamping(unsigned int _index, const double _damping)
   {
     this->SetStiffnessDamping(_index, this->stiffnessCoefficient[_index],
       _damping);
+
+    // New clients get the damping from the scene message
+    if (this->world)
+      this->world->InvalidateSceneFragment(this->model);
   }
   else
   {
@@ -128,6 +128,9 @@ void SimbodyLink::SetGravityMode(bool _mode)
   else
     gzerr << "Trying to SetGravityMode for link [" << this->GetScopedName()
           << "] before last setting is processed.\n";
+
+  // New clients get the gravity mode from the scene message
+  this->world->InvalidateSceneFragment(this->GetModel());
 }
 
 //////////////////////////////////////////////////
@@ -42,6 +42,7 @@
 #include "gazebo/physics/simbody/SimbodyHinge2Joint.hh"
 #include "gazebo/physics/simbody/SimbodyScrewJoint.hh"
 #include "gazebo/physics/simbody/SimbodyFixedJoint.hh"
+#include "gazebo/physics/simbody/SimbodyStateBatch.hh"
 
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -808,6 +809,15 @@ JointPtr SimbodyPhysics::CreateJoint(const std::string &_type,
   return joint;
 }
 
+//////////////////////////////////////////////////
+StateBatchPtr SimbodyPhysics::CreateStateBatch(const Joint_V &_joints,
+    const Link_V &_links)
+{
+  return StateBatchPtr(new SimbodyStateBatch(
+      boost::dynamic_pointer_cast<SimbodyPhysics>(this->world->Physics()),
+      _joints, _links));
+}
+
 //////////////////////////////////////////////////
 void SimbodyPhysics::SetGravity(const ignition::math::Vector3d &_gravity)
 {
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <vector>
+
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/simbody/SimbodyJoint.hh"
+#include "gazebo/physics/simbody/SimbodyLink.hh"
+#include "gazebo/physics/simbody/SimbodyPhysics.hh"
+#include "gazebo/physics/simbody/SimbodyStateBatch.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Cached lookup of a joint of the batch.
+  struct JointEntry
+  {
+    /// \brief The joint, owned by the batch.
+    Joint *joint = nullptr;
+
+    /// \brief The joint as a Simbody hinge or slider joint, or nullptr.
+    SimbodyJoint *simbodyJoint = nullptr;
+
+    /// \brief Model of the joint, or nullptr.
+    Model *model = nullptr;
+  };
+}
+
+/// \internal
+/// \brief Private data class for SimbodyStateBatch
+class gazebo::physics::SimbodyStateBatchPrivate
+{
+  /// \brief Get the Simbody state to read.
+  /// \return The state, or nullptr if Simbody is not initialized.
+  public: const SimTK::State *State() const
+  {
+    if (!this->physics || !this->physics->simbodyPhysicsInitialized)
+      return nullptr;
+    return &this->physics->integ->getState();
+  }
+
+  /// \brief Get the joint mobilizer to read, if the joint can be read
+  /// directly.
+  /// \param[in] _entry Joint of the batch.
+  /// \return The mobilizer, or nullptr to go through the Joint API.
+  public: static const SimTK::MobilizedBody *Mobod(const JointEntry &_entry)
+  {
+    // Joints of static models report the position they were set to.
+    if (!_entry.simbodyJoint || !_entry.simbodyJoint->physicsInitialized ||
+        _entry.simbodyJoint->mobod.isEmptyHandle() ||
+        _entry.model->IsStatic())
+    {
+      return nullptr;
+    }
+    return &_entry.simbodyJoint->mobod;
+  }
+
+  /// \brief Simbody engine of the world.
+  public: SimbodyPhysicsPtr physics;
+
+  /// \brief Joints of the batch, in array order.
+  public: std::vector<JointEntry> joints;
+
+  /// \brief Links of the batch as Simbody links, in array order.
+  public: std::vector<SimbodyLink *> links;
+};
+
+//////////////////////////////////////////////////
+SimbodyStateBatch::SimbodyStateBatch(SimbodyPhysicsPtr _physics,
+    const Joint_V &_joints, const Link_V &_links)
+  : StateBatch(_joints, _links), dataPtr(new SimbodyStateBatchPrivate)
+{
+  this->dataPtr->physics = _physics;
+
+  this->dataPtr->joints.resize(_joints.size());
+  for (unsigned int i = 0; i < _joints.size(); ++i)
+  {
+    JointEntry &entry = this->dataPtr->joints[i];
+    entry.joint = _joints[i].get();
+    entry.model = dynamic_cast<Model *>(entry.joint->GetParent().get());
+
+    // The mobilizers of hinge and slider joints have a single q and u.
+    if (entry.model && (entry.joint->HasType(Base::HINGE_JOINT) ||
+        entry.joint->HasType(Base::SLIDER_JOINT)))
+    {
+      entry.simbodyJoint = dynamic_cast<SimbodyJoint *>(entry.joint);
+    }
+  }
+
+  this->dataPtr->links.reserve(_links.size());
+  for (auto const &link : _links)
+    this->dataPtr->links.push_back(dynamic_cast<SimbodyLink *>(link.get()));
+}
+
+//////////////////////////////////////////////////
+SimbodyStateBatch::~SimbodyStateBatch()
+{
+}
+
+//////////////////////////////////////////////////
+void SimbodyStateBatch::JointPositions(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  const SimTK::State *state = this->dataPtr->State();
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    const SimTK::MobilizedBody *mobod =
+        state ? SimbodyStateBatchPrivate::Mobod(entry) : nullptr;
+    if (mobod)
+    {
+      *_out++ = mobod->getOneQ(*state, 0);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.joint->Position(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void SimbodyStateBatch::JointVelocities(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  const SimTK::State *state = this->dataPtr->State();
+  for (auto const &entry : this->dataPtr->joints)
+  {
+    const SimTK::MobilizedBody *mobod =
+        state ? SimbodyStateBatchPrivate::Mobod(entry) : nullptr;
+    if (mobod)
+    {
+      *_out++ = mobod->getOneU(*state, SimTK::MobilizerUIndex(0));
+    }
+    else
+    {
+      for (unsigned int i = 0; i < entry.joint->DOF(); ++i)
+        *_out++ = entry.joint->GetVelocity(i);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void SimbodyStateBatch::LinkPoses(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  const SimTK::State *state = this->dataPtr->State();
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    SimbodyLink *simbodyLink = this->dataPtr->links[i];
+
+    // The master body frame is the link frame
+    const ignition::math::Pose3d pose =
+        state && simbodyLink && simbodyLink->physicsInitialized ?
+        SimbodyPhysics::Transform2PoseIgn(
+            simbodyLink->masterMobod.getBodyTransform(*state)) :
+        this->Links()[i]->WorldPose();
+    _out[0] = pose.Pos().X();
+    _out[1] = pose.Pos().Y();
+    _out[2] = pose.Pos().Z();
+    _out[3] = pose.Rot().W();
+    _out[4] = pose.Rot().X();
+    _out[5] = pose.Rot().Y();
+    _out[6] = pose.Rot().Z();
+    _out += PoseSize;
+  }
+}
+
+//////////////////////////////////////////////////
+void SimbodyStateBatch::LinkTwists(double *_out) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->UpdateMutex());
+  const SimTK::State *state = this->dataPtr->State();
+  for (unsigned int i = 0; i < this->dataPtr->links.size(); ++i)
+  {
+    SimbodyLink *simbodyLink = this->dataPtr->links[i];
+    ignition::math::Vector3d lin;
+    ignition::math::Vector3d ang;
+    if (state && simbodyLink && simbodyLink->physicsInitialized)
+    {
+      const SimTK::MobilizedBody &body = simbodyLink->masterMobod;
+      const SimTK::Vec3 station = body.getBodyMassCenterStation(*state);
+      lin = SimbodyPhysics::Vec3ToVector3Ign(
+          body.findStationVelocityInGround(*state, station));
+      ang = SimbodyPhysics::Vec3ToVector3Ign(
+          body.getBodyAngularVelocity(*state));
+    }
+    else
+    {
+      const LinkPtr &link = this->Links()[i];
+      lin = link->WorldCoGLinearVel();
+      ang = link->WorldAngularVel();
+    }
+    _out[0] = lin.X();
+    _out[1] = lin.Y();
+    _out[2] = lin.Z();
+    _out[3] = ang.X();
+    _out[4] = ang.Y();
+    _out[5] = ang.Z();
+    _out += TwistSize;
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SIMBODY_SIMBODYSTATEBATCH_HH_
+#define GAZEBO_PHYSICS_SIMBODY_SIMBODYSTATEBATCH_HH_
+
+#include <memory>
+
+#include "gazebo/physics/StateBatch.hh"
+#include "gazebo/physics/simbody/SimbodyTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SimbodyStateBatchPrivate;
+
+    /// \addtogroup gazebo_physics_simbody
+    /// \{
+
+    /// \brief State batch that reads the Simbody state directly, fetching
+    /// it once per call. Positions and velocities of hinge and slider
+    /// joints are the q and u of their mobilizers, and link poses and
+    /// twists come from the master mobilized bodies. Other joints, joints
+    /// of static models, entities that Simbody has not created yet,
+    /// efforts and all the setters go through the StateBatch base class.
+    class GZ_PHYSICS_VISIBLE SimbodyStateBatch : public StateBatch
+    {
+      /// \brief Constructor.
+      /// \param[in] _physics Simbody engine of the world.
+      /// \param[in] _joints Joints of the batch, in array order.
+      /// \param[in] _links Links of the batch, in array order.
+      public: SimbodyStateBatch(SimbodyPhysicsPtr _physics,
+                  const Joint_V &_joints, const Link_V &_links);
+
+      /// \brief Destructor.
+      public: virtual ~SimbodyStateBatch();
+
+      // Documentation inherited
+      public: virtual void JointPositions(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void JointVelocities(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void LinkPoses(double *_out) const override;
+
+      // Documentation inherited
+      public: virtual void LinkTwists(double *_out) const override;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SimbodyStateBatchPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -18,7 +18,6 @@
 #include <functional>
 
 #include <boost/lexical_cast.hpp>
-#include <boost/make_shared.hpp>
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Helpers.hh>
@@ -89,6 +88,11 @@ using namespace rendering;
 
 uint32_t ScenePrivate::idCounter = 0;
 
+/// \brief Seconds to wait for the answer to a chunked scene request before
+/// requesting the whole scene. Servers older than "scene_info_chunked"
+/// don't answer it.
+static const double SceneRequestTimeout = 3.0;
+
 struct VisualMessageLess {
     bool operator() (boost::shared_ptr<msgs::Visual const> _i,
                      boost::shared_ptr<msgs::Visual const> _j)
@@ -97,6 +101,68 @@ struct VisualMessageLess {
     }
 } VisualMessageLessOp;
 
+//////////////////////////////////////////////////
+/// \brief Write the poses of a message to the back pose table and publish
+/// it to the render thread.
+/// \param[in] _data Private data of the scene.
+/// \param[in] _msg Pose message.
+static void WritePoses(ScenePrivate &_data, const msgs::PosesStamped &_msg)
+{
+  std::lock_guard<std::mutex> lock(_data.poseWriteMutex);
+
+  ScenePoseTable *table = &_data.poseBuffer.Back();
+  if (table->generation == 0)
+    table->generation = ++_data.poseGeneration;
+
+  // Overwrite the ids already in the table, append the others
+  for (int i = 0; i < _msg.pose_size(); ++i)
+  {
+    const msgs::Pose &p = _msg.pose(i);
+    ScenePoseSlot &slot = _data.poseSlots[p.id()];
+    if (slot.generation == table->generation)
+    {
+      table->poses[slot.index].second = msgs::ConvertIgn(p);
+    }
+    else
+    {
+      slot.generation = table->generation;
+      slot.index = table->poses.size();
+      table->poses.emplace_back(p.id(), msgs::ConvertIgn(p));
+    }
+  }
+  table->time = common::Time(_msg.time().sec(), _msg.time().nsec());
+
+  if (_data.poseBuffer.Publish())
+  {
+    // The render thread skipped the table returned by Publish. Merge it
+    // with the table just published, which is only read by the render
+    // thread, so that poses of ids missing from the latter are not lost,
+    // and publish the result instead.
+    const ScenePoseTable &published = *table;
+    table = &_data.poseBuffer.Back();
+
+    size_t count = 0;
+    for (auto const &entry : table->poses)
+    {
+      if (_data.poseSlots[entry.first].generation != published.generation)
+        table->poses[count++] = entry;
+    }
+    table->poses.erase(table->poses.begin() + count, table->poses.end());
+    table->poses.insert(table->poses.end(), published.poses.begin(),
+        published.poses.end());
+    table->time = published.time;
+    table->generation = ++_data.poseGeneration;
+
+    // The table returned now is either the one merged in above, or one the
+    // render thread is done with
+    _data.poseBuffer.Publish();
+  }
+
+  table = &_data.poseBuffer.Back();
+  table->poses.clear();
+  table->generation = ++_data.poseGeneration;
+}
+
 //////////////////////////////////////////////////
 Scene::Scene()
   : dataPtr(new ScenePrivate)
@@ -205,7 +271,6 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
   this->dataPtr->selectedVis.reset();
 
   this->dataPtr->sceneSimTimePosesApplied = common::Time();
-  this->dataPtr->sceneSimTimePosesReceived = common::Time();
 }
 
 //////////////////////////////////////////////////
@@ -249,9 +314,12 @@ void Scene::Clear()
   }
 
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-    this->dataPtr->poseMsgs.clear();
+    std::lock_guard<std::mutex> lock(this->dataPtr->poseWriteMutex);
+    this->dataPtr->poseBuffer.Back().poses.clear();
+    this->dataPtr->poseSlots.clear();
   }
+  this->dataPtr->poseBuffer.Consume();
+  this->dataPtr->pendingPoses.clear();
 
   this->dataPtr->joints.clear();
 
@@ -411,8 +479,17 @@ void Scene::Init()
   this->dataPtr->originVisual->Load();
 
   this->dataPtr->requestPub->WaitForConnection();
-  this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
-  this->dataPtr->requestPub->Publish(*this->dataPtr->requestMsg);
+  // The models follow the rest of the scene in chunks, so that a large
+  // world doesn't have to be serialized in a single message.
+  msgs::Request request;
+  {
+    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+    this->dataPtr->requestMsg = msgs::CreateRequest("scene_info_chunked");
+    this->dataPtr->requestTime = common::Time::GetWallTime();
+    this->dataPtr->requestAnswered = false;
+    request = *this->dataPtr->requestMsg;
+  }
+  this->dataPtr->requestPub->Publish(request);
 
   if (!this->dataPtr->isServer)
   {
@@ -1532,24 +1609,12 @@ void Scene::MeshInformation(const Ogre::Mesh *_mesh,
 /////////////////////////////////////////////////
 bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
 {
+  for (int i = 0; i < _msg->model_size(); ++i)
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-    for (int i = 0; i < _msg->model_size(); ++i)
-    {
-      PoseMsgs_M::iterator iter =
-          this->dataPtr->poseMsgs.find(_msg->model(i).id());
-      if (iter != this->dataPtr->poseMsgs.end())
-        iter->second.CopyFrom(_msg->model(i).pose());
-      else
-        this->dataPtr->poseMsgs.insert(
-            std::make_pair(_msg->model(i).id(), _msg->model(i).pose()));
-
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_name(
-          _msg->model(i).name());
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_id(_msg->model(i).id());
+    this->dataPtr->pendingPoses[_msg->model(i).id()] =
+        msgs::ConvertIgn(_msg->model(i).pose());
 
-      this->ProcessModelMsg(_msg->model(i));
-    }
+    this->ProcessModelMsg(_msg->model(i));
   }
 
   for (int i = 0; i < _msg->light_size(); ++i)
@@ -1630,9 +1695,6 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
 //////////////////////////////////////////////////
 bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 {
-  std::string modelName, linkName;
-
-  modelName = _msg.name() + "::";
   for (int j = 0; j < _msg.visual_size(); ++j)
   {
     boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
@@ -1671,23 +1733,10 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 
   for (int j = 0; j < _msg.link_size(); ++j)
   {
-    linkName = modelName + _msg.link(j).name();
-
+    if (_msg.link(j).has_pose())
     {
-      std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-      if (_msg.link(j).has_pose())
-      {
-        PoseMsgs_M::iterator iter =
-            this->dataPtr->poseMsgs.find(_msg.link(j).id());
-        if (iter != this->dataPtr->poseMsgs.end())
-          iter->second.CopyFrom(_msg.link(j).pose());
-        else
-          this->dataPtr->poseMsgs.insert(
-              std::make_pair(_msg.link(j).id(), _msg.link(j).pose()));
-
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_name(linkName);
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_id(_msg.link(j).id());
-      }
+      this->dataPtr->pendingPoses[_msg.link(j).id()] =
+          msgs::ConvertIgn(_msg.link(j).pose());
     }
 
     if (_msg.link(j).has_inertial())
@@ -1813,7 +1862,6 @@ void Scene::PreRender()
   static ModelMsgs_L::iterator modelIter;
   static VisualMsgs_L::iterator visualIter;
   static LightMsgs_L::iterator lightIter;
-  static PoseMsgs_M::iterator pIter;
   static SkeletonPoseMsgs_L::iterator spIter;
   static JointMsgs_L::iterator jointIter;
   static SensorMsgs_L::iterator sensorIter;
@@ -1831,67 +1879,42 @@ void Scene::PreRender()
   JointMsgs_L jointMsgsCopy;
   LinkMsgs_L linkMsgsCopy;
   RoadMsgs_L roadMsgsCopy;
+  msgs::Request fallbackRequest;
 
+  // Take the lists in constant time, messages arriving while they are
+  // processed are appended to the now empty lists.
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(this->dataPtr->sceneMsgs.begin(), this->dataPtr->sceneMsgs.end(),
-              std::back_inserter(sceneMsgsCopy));
-    this->dataPtr->sceneMsgs.clear();
-
-    std::copy(this->dataPtr->modelMsgs.begin(), this->dataPtr->modelMsgs.end(),
-              std::back_inserter(modelMsgsCopy));
-    this->dataPtr->modelMsgs.clear();
-
-    std::copy(this->dataPtr->sensorMsgs.begin(),
-              this->dataPtr->sensorMsgs.end(),
-              std::back_inserter(sensorMsgsCopy));
-    this->dataPtr->sensorMsgs.clear();
-
-    std::copy(this->dataPtr->lightFactoryMsgs.begin(),
-              this->dataPtr->lightFactoryMsgs.end(),
-              std::back_inserter(lightFactoryMsgsCopy));
-    this->dataPtr->lightFactoryMsgs.clear();
-
-    std::copy(this->dataPtr->lightModifyMsgs.begin(),
-              this->dataPtr->lightModifyMsgs.end(),
-              std::back_inserter(lightModifyMsgsCopy));
-    this->dataPtr->lightModifyMsgs.clear();
-
-    std::copy(this->dataPtr->modelVisualMsgs.begin(),
-              this->dataPtr->modelVisualMsgs.end(),
-              std::back_inserter(modelVisualMsgsCopy));
-    this->dataPtr->modelVisualMsgs.clear();
-
-    std::copy(this->dataPtr->linkVisualMsgs.begin(),
-              this->dataPtr->linkVisualMsgs.end(),
-              std::back_inserter(linkVisualMsgsCopy));
-    this->dataPtr->linkVisualMsgs.clear();
-
-    this->dataPtr->visualMsgs.sort(VisualMessageLessOp);
-    std::copy(this->dataPtr->visualMsgs.begin(),
-              this->dataPtr->visualMsgs.end(),
-              std::back_inserter(visualMsgsCopy));
-    this->dataPtr->visualMsgs.clear();
-
-    std::copy(this->dataPtr->collisionVisualMsgs.begin(),
-              this->dataPtr->collisionVisualMsgs.end(),
-              std::back_inserter(collisionVisualMsgsCopy));
-    this->dataPtr->collisionVisualMsgs.clear();
-
-    std::copy(this->dataPtr->jointMsgs.begin(), this->dataPtr->jointMsgs.end(),
-              std::back_inserter(jointMsgsCopy));
-    this->dataPtr->jointMsgs.clear();
-
-    std::copy(this->dataPtr->linkMsgs.begin(), this->dataPtr->linkMsgs.end(),
-              std::back_inserter(linkMsgsCopy));
-    this->dataPtr->linkMsgs.clear();
+    // Fall back to the whole scene if the chunked request isn't answered
+    if (this->dataPtr->requestMsg && !this->dataPtr->requestAnswered &&
+        this->dataPtr->requestMsg->request() == "scene_info_chunked" &&
+        (common::Time::GetWallTime() - this->dataPtr->requestTime).Double() >
+        SceneRequestTimeout)
+    {
+      delete this->dataPtr->requestMsg;
+      this->dataPtr->requestMsg = msgs::CreateRequest("scene_info");
+      fallbackRequest = *this->dataPtr->requestMsg;
+    }
 
-    std::copy(this->dataPtr->roadMsgs.begin(), this->dataPtr->roadMsgs.end(),
-              std::back_inserter(roadMsgsCopy));
-    this->dataPtr->roadMsgs.clear();
+    sceneMsgsCopy.swap(this->dataPtr->sceneMsgs);
+    modelMsgsCopy.swap(this->dataPtr->modelMsgs);
+    sensorMsgsCopy.swap(this->dataPtr->sensorMsgs);
+    lightFactoryMsgsCopy.swap(this->dataPtr->lightFactoryMsgs);
+    lightModifyMsgsCopy.swap(this->dataPtr->lightModifyMsgs);
+    modelVisualMsgsCopy.swap(this->dataPtr->modelVisualMsgs);
+    linkVisualMsgsCopy.swap(this->dataPtr->linkVisualMsgs);
+    visualMsgsCopy.swap(this->dataPtr->visualMsgs);
+    collisionVisualMsgsCopy.swap(this->dataPtr->collisionVisualMsgs);
+    jointMsgsCopy.swap(this->dataPtr->jointMsgs);
+    linkMsgsCopy.swap(this->dataPtr->linkMsgs);
+    roadMsgsCopy.swap(this->dataPtr->roadMsgs);
   }
 
+  if (fallbackRequest.has_request())
+    this->dataPtr->requestPub->Publish(fallbackRequest);
+  visualMsgsCopy.sort(VisualMessageLessOp);
+
   // Process the scene messages. DO THIS FIRST
   for (sIter = sceneMsgsCopy.begin(); sIter != sceneMsgsCopy.end();)
   {
@@ -2014,89 +2037,93 @@ void Scene::PreRender()
   }
   this->dataPtr->requestMsgs.clear();
 
+  // Put the unprocessed messages back in front of the ones that arrived
+  // in the meantime.
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(sceneMsgsCopy.begin(), sceneMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sceneMsgs));
-
-    std::copy(modelMsgsCopy.begin(), modelMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelMsgs));
-
-    std::copy(sensorMsgsCopy.begin(), sensorMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sensorMsgs));
-
-    std::copy(lightFactoryMsgsCopy.begin(), lightFactoryMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightFactoryMsgs));
-
-    std::copy(lightModifyMsgsCopy.begin(), lightModifyMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightModifyMsgs));
-
-    std::copy(modelVisualMsgsCopy.begin(), modelVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelVisualMsgs));
-
-    std::copy(linkVisualMsgsCopy.begin(), linkVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkVisualMsgs));
-
-    std::copy(visualMsgsCopy.begin(), visualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->visualMsgs));
-
-    std::copy(collisionVisualMsgsCopy.begin(), collisionVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->collisionVisualMsgs));
-
-    std::copy(jointMsgsCopy.begin(), jointMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->jointMsgs));
-
-    std::copy(linkMsgsCopy.begin(), linkMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkMsgs));
+    this->dataPtr->sceneMsgs.splice(
+        this->dataPtr->sceneMsgs.begin(), sceneMsgsCopy);
+    this->dataPtr->modelMsgs.splice(
+        this->dataPtr->modelMsgs.begin(), modelMsgsCopy);
+    this->dataPtr->sensorMsgs.splice(
+        this->dataPtr->sensorMsgs.begin(), sensorMsgsCopy);
+    this->dataPtr->lightFactoryMsgs.splice(
+        this->dataPtr->lightFactoryMsgs.begin(), lightFactoryMsgsCopy);
+    this->dataPtr->lightModifyMsgs.splice(
+        this->dataPtr->lightModifyMsgs.begin(), lightModifyMsgsCopy);
+    this->dataPtr->modelVisualMsgs.splice(
+        this->dataPtr->modelVisualMsgs.begin(), modelVisualMsgsCopy);
+    this->dataPtr->linkVisualMsgs.splice(
+        this->dataPtr->linkVisualMsgs.begin(), linkVisualMsgsCopy);
+    this->dataPtr->visualMsgs.splice(
+        this->dataPtr->visualMsgs.begin(), visualMsgsCopy);
+    this->dataPtr->collisionVisualMsgs.splice(
+        this->dataPtr->collisionVisualMsgs.begin(), collisionVisualMsgsCopy);
+    this->dataPtr->jointMsgs.splice(
+        this->dataPtr->jointMsgs.begin(), jointMsgsCopy);
+    this->dataPtr->linkMsgs.splice(
+        this->dataPtr->linkMsgs.begin(), linkMsgsCopy);
   }
 
   // update the rt shader
   RTShaderSystem::Instance()->Update();
 
+  // Apply a pose to a visual or a light, returns false if the pose has to
+  // be kept for later.
+  auto applyPose = [this](const uint32_t _id,
+      const ignition::math::Pose3d &_pose) -> bool
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-
-    // Process all the model messages last. Remove pose message from the list
-    // only when a corresponding visual exits. We may receive pose updates
-    // over the wire before  we recieve the visual
-    pIter = this->dataPtr->poseMsgs.begin();
-    while (pIter != this->dataPtr->poseMsgs.end())
+    Visual_M::iterator iter = this->dataPtr->visuals.find(_id);
+    if (iter != this->dataPtr->visuals.end() && iter->second)
     {
-      Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
-      if (iter != this->dataPtr->visuals.end() && iter->second)
-      {
-        // If an object is selected, don't let the physics engine move it.
-        if (!this->dataPtr->selectedVis
-            || this->dataPtr->selectionMode != "move" ||
-            (iter->first != this->dataPtr->selectedVis->GetId() &&
-            !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          GZ_ASSERT(iter->second, "Visual pointer is NULL");
-          iter->second->SetPose(pose);
-          PoseMsgs_M::iterator prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
-      }
-      else
+      // If an object is selected, don't let the physics engine move it.
+      if (this->dataPtr->selectedVis && this->dataPtr->selectionMode == "move"
+          && (iter->first == this->dataPtr->selectedVis->GetId() ||
+          this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
       {
-        // process light pose messages
-        auto lIter = this->dataPtr->lights.find(pIter->first);
-        if (lIter != this->dataPtr->lights.end())
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          lIter->second->SetPosition(pose.Pos());
-          lIter->second->SetRotation(pose.Rot());
-          auto prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
+        return false;
       }
+      iter->second->SetPose(_pose);
+      return true;
+    }
+
+    auto lIter = this->dataPtr->lights.find(_id);
+    if (lIter != this->dataPtr->lights.end())
+    {
+      lIter->second->SetPosition(_pose.Pos());
+      lIter->second->SetRotation(_pose.Rot());
+      return true;
+    }
+    return false;
+  };
+
+  // Process all the poses last. We may receive pose updates over the wire
+  // before we receive the visual, those are kept until it exists.
+  Poses_M &pending = this->dataPtr->pendingPoses;
+  for (auto iter = pending.begin(); iter != pending.end();)
+  {
+    if (applyPose(iter->first, iter->second))
+      iter = pending.erase(iter);
+    else
+      ++iter;
+  }
+
+  const bool newPoses = this->dataPtr->poseBuffer.Consume();
+  const ScenePoseTable &poseTable = this->dataPtr->poseBuffer.Front();
+  if (newPoses)
+  {
+    for (auto const &entry : poseTable.poses)
+    {
+      if (!applyPose(entry.first, entry.second))
+        pending[entry.first] = entry.second;
+      else if (!pending.empty())
+        pending.erase(entry.first);
     }
+  }
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
 
     // process skeleton pose msgs
     spIter = this->dataPtr->skeletonPoseMsgs.begin();
@@ -2158,8 +2185,8 @@ void Scene::PreRender()
     }
 
     // official time stamp of approval
-    this->dataPtr->sceneSimTimePosesApplied =
-        this->dataPtr->sceneSimTimePosesReceived;
+    if (newPoses)
+      this->dataPtr->sceneSimTimePosesApplied = poseTable.time;
   }
 }
 
@@ -2423,17 +2450,26 @@ void Scene::OnScene(ConstScenePtr &_msg)
 /////////////////////////////////////////////////
 void Scene::OnResponse(ConstResponsePtr &_msg)
 {
-  if (!this->dataPtr->requestMsg ||
-      _msg->id() != this->dataPtr->requestMsg->id())
-    return;
+  {
+    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+    if (!this->dataPtr->requestMsg ||
+        _msg->id() != this->dataPtr->requestMsg->id())
+      return;
+    this->dataPtr->requestAnswered = true;
+  }
 
-  msgs::Scene sceneMsg;
-  sceneMsg.ParseFromString(_msg->serialized_data());
-  boost::shared_ptr<msgs::Scene> sm(new msgs::Scene(sceneMsg));
+  boost::shared_ptr<msgs::Scene> sm(new msgs::Scene);
+  sm->ParseFromString(_msg->serialized_data());
 
   std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
   this->dataPtr->sceneMsgs.push_back(sm);
-  this->dataPtr->requestMsg = NULL;
+
+  // More chunks of the scene are on their way
+  if (_msg->response() != "partial" && this->dataPtr->requestMsg &&
+      _msg->id() == this->dataPtr->requestMsg->id())
+  {
+    this->dataPtr->requestMsg = NULL;
+  }
 }
 
 /////////////////////////////////////////////////
@@ -2867,27 +2903,13 @@ common::Time Scene::SimTime() const
 /////////////////////////////////////////////////
 void Scene::OnPoseMsg(ConstPosesStampedPtr &_msg)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-  this->dataPtr->sceneSimTimePosesReceived =
-    common::Time(_msg->time().sec(), _msg->time().nsec());
-
-  for (int i = 0; i < _msg->pose_size(); ++i)
-  {
-    auto p = _msg->pose(i);
-    PoseMsgs_M::iterator iter =
-        this->dataPtr->poseMsgs.find(p.id());
-    if (iter != this->dataPtr->poseMsgs.end())
-      iter->second.CopyFrom(p);
-    else
-      this->dataPtr->poseMsgs.insert(std::make_pair(p.id(), p));
-  }
+  WritePoses(*this->dataPtr, *_msg);
 }
 
 /////////////////////////////////////////////////
 void Scene::UpdatePoses(const msgs::PosesStamped &_msg)
 {
-  auto msgptr = boost::make_shared<const msgs::PosesStamped>(_msg);
-  this->OnPoseMsg(msgptr);
+  WritePoses(*this->dataPtr, _msg);
 
   std::unique_lock<std::mutex> lck(this->dataPtr->newPoseMutex);
   this->dataPtr->newPoseAvailable = true;
@@ -20,15 +20,20 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 
 #include <boost/unordered/unordered_map.hpp>
 
+#include <ignition/math/Pose3.hh>
 #include <sdf/sdf.hh>
 
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/common/TripleBuffer.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/rendering/MarkerManager.hh"
@@ -68,9 +73,9 @@ namespace gazebo
     /// \brief List of light messages.
     typedef std::list<boost::shared_ptr<msgs::Light const> > LightMsgs_L;
 
-    /// \typedef PoseMsgs_M.
-    /// \brief List of messages.
-    typedef std::map<uint32_t, msgs::Pose> PoseMsgs_M;
+    /// \typedef Poses_M
+    /// \brief Map of poses and the id of the visual or light they belong to.
+    typedef std::unordered_map<uint32_t, ignition::math::Pose3d> Poses_M;
 
     /// \typedef LightPoseMsgs_M.
     /// \brief List of messages.
@@ -118,6 +123,34 @@ namespace gazebo
     /// \brief List of road messages
     typedef std::list<boost::shared_ptr<msgs::Road const> > RoadMsgs_L;
 
+    /// \internal
+    /// \brief Poses received from the world in one or more pose messages,
+    /// exchanged between the transport thread and the render thread. Each
+    /// id appears at most once.
+    class ScenePoseTable
+    {
+      /// \brief Id of the visual or light and its pose, in the order the
+      /// ids were first received.
+      public: std::vector<std::pair<uint32_t, ignition::math::Pose3d>> poses;
+
+      /// \brief Generation of the table, see ScenePoseSlot.
+      public: uint64_t generation = 0;
+
+      /// \brief Sim time of the latest pose message written to the table.
+      public: common::Time time;
+    };
+
+    /// \internal
+    /// \brief Position of an id in the pose table being written.
+    class ScenePoseSlot
+    {
+      /// \brief Generation of the table the id was last written to.
+      public: uint64_t generation = 0;
+
+      /// \brief Index of the id in the poses of that table.
+      public: size_t index = 0;
+    };
+
     /// \brief Private data for the Visual class
     class ScenePrivate
     {
@@ -181,8 +214,25 @@ namespace gazebo
       /// \brief List of light modify message to process.
       public: LightMsgs_L lightModifyMsgs;
 
-      /// \brief List of pose message to process.
-      public: PoseMsgs_M poseMsgs;
+      /// \brief Pose tables written by the transport thread and applied by
+      /// PreRender.
+      public: common::TripleBuffer<ScenePoseTable> poseBuffer;
+
+      /// \brief Slots of the ids in the back pose table. Protected by
+      /// poseWriteMutex.
+      public: std::unordered_map<uint32_t, ScenePoseSlot> poseSlots;
+
+      /// \brief Generation of the last pose table handed to the writer.
+      /// Protected by poseWriteMutex.
+      public: uint64_t poseGeneration = 0;
+
+      /// \brief Serializes the writers of the back pose table.
+      public: std::mutex poseWriteMutex;
+
+      /// \brief Poses that could not be applied yet, because the visual
+      /// does not exist yet or is being moved by the user. Only used by
+      /// the render thread.
+      public: Poses_M pendingPoses;
 
       /// \brief List of pose message to process.
       public: LightPoseMsgs_M lightPoseMsgs;
@@ -229,7 +279,7 @@ namespace gazebo
       /// \brief Mutex to lock the various message buffers.
       public: std::mutex *receiveMutex = nullptr;
 
-      /// \brief Mutex to lock the pose message buffers.
+      /// \brief Mutex to lock the skeleton pose message buffers.
       public: std::recursive_mutex poseMsgMutex;
 
       /// \brief Communication Node
@@ -302,6 +352,12 @@ namespace gazebo
       /// \brief Keep around our request message.
       public: msgs::Request *requestMsg = nullptr;
 
+      /// \brief Wall time at which requestMsg was sent.
+      public: common::Time requestTime;
+
+      /// \brief True once requestMsg got a response.
+      public: bool requestAnswered = false;
+
       /// \brief True if visualizations should be rendered.
       public: bool enableVisualizations;
 
@@ -353,10 +409,6 @@ namespace gazebo
       /// \brief Initialized.
       public: bool initialized;
 
-      /// \brief SimTime of this Scene, as we receive PosesStamped from
-      /// the world, we update this time accordingly.
-      public: common::Time sceneSimTimePosesReceived;
-
       /// \brief SimTime of this Scene, after applying PosesStamped to
       /// scene, we update this time accordingly.
       public: common::Time sceneSimTimePosesApplied;
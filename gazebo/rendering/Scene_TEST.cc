@@ -402,6 +402,70 @@ TEST_F(Scene_TEST, AddRemoveLights)
   EXPECT_FALSE(scene->LightByName("light1"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, UpdatePoses)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::VisualPtr visual1(new rendering::Visual("pose_visual1", scene));
+  visual1->Load();
+  scene->AddVisual(visual1);
+  rendering::VisualPtr visual2(new rendering::Visual("pose_visual2", scene));
+  visual2->Load();
+  scene->AddVisual(visual2);
+
+  // Id of a visual that does not exist yet
+  const uint32_t laterId = 987654321u;
+
+  ignition::math::Pose3d pose1(1, 2, 3, 0, 0, 0.5);
+  ignition::math::Pose3d pose2(4, 5, 6, 0.1, 0, 0);
+  ignition::math::Pose3d pose3(7, 8, 9, 0, 0.2, 0);
+  ignition::math::Pose3d laterPose(-1, -2, -3, 0, 0, 0);
+
+  // Several messages before the scene is rendered, only the latest pose
+  // of each id is applied and ids missing from later messages are kept
+  msgs::PosesStamped msg;
+  msgs::Set(msg.mutable_time(), common::Time(1, 0));
+  msgs::Pose *p = msg.add_pose();
+  msgs::Set(p, pose3);
+  p->set_id(visual1->GetId());
+  p = msg.add_pose();
+  msgs::Set(p, pose2);
+  p->set_id(visual2->GetId());
+  p = msg.add_pose();
+  msgs::Set(p, laterPose);
+  p->set_id(laterId);
+  scene->UpdatePoses(msg);
+
+  msg.Clear();
+  msgs::Set(msg.mutable_time(), common::Time(2, 0));
+  p = msg.add_pose();
+  msgs::Set(p, pose1);
+  p->set_id(visual1->GetId());
+  scene->UpdatePoses(msg);
+
+  scene->PreRender();
+  EXPECT_EQ(pose1, visual1->Pose());
+  EXPECT_EQ(pose2, visual2->Pose());
+  EXPECT_EQ(pose1,
+      visual1->GetSDF()->Get<ignition::math::Pose3d>("pose"));
+
+  // Poses that arrive before their visual are applied once it exists
+  rendering::VisualPtr later(new rendering::Visual("pose_later", scene));
+  later->Load();
+  later->SetId(laterId);
+  scene->AddVisual(later);
+  scene->PreRender();
+  EXPECT_EQ(laterPose, later->Pose());
+
+  // Nothing new, the poses set by the user stay
+  visual2->SetPose(pose3);
+  scene->PreRender();
+  EXPECT_EQ(pose3, visual2->Pose());
+}
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
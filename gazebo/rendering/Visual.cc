@@ -58,6 +58,22 @@ using namespace rendering;
 // Note: The value of ignition::math::MAX_UI32 is reserved as a flag.
 uint32_t VisualPrivate::visualIdCount = ignition::math::MAX_UI32 - 1;
 
+//////////////////////////////////////////////////
+/// \brief Write the pose of the scene node of a visual to its SDF element.
+/// Poses are set on the scene node every frame, so the SDF element is only
+/// updated when it is read.
+/// \param[in] _data Private data of the visual.
+static void SyncSdfPose(VisualPrivate &_data)
+{
+  if (!_data.sdfPoseDirty || !_data.sdf || !_data.sceneNode)
+    return;
+
+  _data.sdfPoseDirty = false;
+  _data.sdf->GetElement("pose")->Set(ignition::math::Pose3d(
+      Conversions::ConvertIgn(_data.sceneNode->getPosition()),
+      Conversions::ConvertIgn(_data.sceneNode->getOrientation())));
+}
+
 //////////////////////////////////////////////////
 Visual::Visual(const std::string &_name, VisualPtr _parent, bool _useRTShader)
   : dataPtr(new VisualPrivate)
@@ -242,6 +258,7 @@ void Visual::Fini()
 VisualPtr Visual::Clone(const std::string &_name, VisualPtr _newParent)
 {
   VisualPtr result(new Visual(_name, _newParent));
+  SyncSdfPose(*this->dataPtr);
   result->Load(this->dataPtr->sdf);
   result->SetScale(this->dataPtr->scale);
   result->SetVisibilityFlags(this->dataPtr->visibilityFlags);
@@ -340,6 +357,7 @@ void Visual::LoadFromMsg(const boost::shared_ptr< msgs::Visual const> &_msg)
 void Visual::Load(sdf::ElementPtr _sdf)
 {
   this->dataPtr->sdf->Copy(_sdf);
+  this->dataPtr->sdfPoseDirty = false;
   this->Load();
 }
 
@@ -354,6 +372,7 @@ void Visual::Load()
     this->dataPtr->parent->AttachVisual(shared_from_this());
 
   // Read the desired position and rotation of the mesh
+  SyncSdfPose(*this->dataPtr);
   pose = this->dataPtr->sdf->Get<ignition::math::Pose3d>("pose");
 
   std::string mesh = this->GetMeshName();
@@ -1899,8 +1918,7 @@ void Visual::SetPosition(const ignition::math::Vector3d &_pos)
 {
   GZ_ASSERT(this->dataPtr->sceneNode, "Visual SceneNode is NULL");
   this->dataPtr->sceneNode->setPosition(_pos.X(), _pos.Y(), _pos.Z());
-
-  this->dataPtr->sdf->GetElement("pose")->Set(this->Pose());
+  this->dataPtr->sdfPoseDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -1909,15 +1927,18 @@ void Visual::SetRotation(const ignition::math::Quaterniond &_rot)
   GZ_ASSERT(this->dataPtr->sceneNode, "Visual SceneNode is null");
   this->dataPtr->sceneNode->setOrientation(
       Ogre::Quaternion(_rot.W(), _rot.X(), _rot.Y(), _rot.Z()));
-
-  this->dataPtr->sdf->GetElement("pose")->Set(this->Pose());
+  this->dataPtr->sdfPoseDirty = true;
 }
 
 //////////////////////////////////////////////////
 void Visual::SetPose(const ignition::math::Pose3d &_pose)
 {
-  this->SetPosition(_pose.Pos());
-  this->SetRotation(_pose.Rot());
+  GZ_ASSERT(this->dataPtr->sceneNode, "Visual SceneNode is NULL");
+  this->dataPtr->sceneNode->setPosition(
+      _pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z());
+  this->dataPtr->sceneNode->setOrientation(Ogre::Quaternion(
+      _pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(), _pose.Rot().Z()));
+  this->dataPtr->sdfPoseDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -3495,6 +3516,7 @@ void Visual::SetId(uint32_t _id)
 //////////////////////////////////////////////////
 sdf::ElementPtr Visual::GetSDF() const
 {
+  SyncSdfPose(*this->dataPtr);
   return this->dataPtr->sdf;
 }
 
@@ -94,6 +94,10 @@ namespace gazebo
       /// \brief The SDF element for the visual.
       public: sdf::ElementPtr sdf;
 
+      /// \brief True if the pose of the scene node changed since it was
+      /// last written to the SDF element.
+      public: bool sdfPoseDirty = false;
+
       /// \brief The unique name for the visual's material.
       public: std::string myMaterialName;
 
@@ -28,6 +28,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/FeedbackRegistry.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
@@ -106,6 +107,17 @@ void ContactSensor::Load(const std::string &_worldName)
 
     this->dataPtr->collisions.push_back(collisionScopedName);
 
+    // Ask the physics engine to compute the contact wrenches
+    physics::CollisionPtr collision =
+        boost::dynamic_pointer_cast<physics::Collision>(
+        this->world->EntityByName(collisionScopedName));
+    if (collision)
+    {
+      this->world->Physics()->GetFeedbackRegistry()->RegisterCollision(
+          collision);
+      this->dataPtr->feedbackCollisions.push_back(collision);
+    }
+
     collisionElem = collisionElem->GetNextElement("collision");
   }
 
@@ -222,6 +234,15 @@ void ContactSensor::Fini()
     mgr->RemoveFilter(this->dataPtr->filterName);
   }
 
+  if (this->world && this->world->Physics())
+  {
+    physics::FeedbackRegistry *registry =
+        this->world->Physics()->GetFeedbackRegistry();
+    for (auto const &collision : this->dataPtr->feedbackCollisions)
+      registry->UnregisterCollision(collision);
+  }
+  this->dataPtr->feedbackCollisions.clear();
+
   this->dataPtr->contactSub.reset();
   this->dataPtr->contactsPub.reset();
   Sensor::Fini();
@@ -22,6 +22,7 @@
 #include <string>
 #include <mutex>
 
+#include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
 
@@ -57,6 +58,10 @@ namespace gazebo
 
       /// \brief Name of filter used to filter contact messages.
       public: std::string filterName;
+
+      /// \brief Collisions registered with the physics engine feedback
+      /// registry, so that their contacts get wrenches.
+      public: physics::Collision_V feedbackCollisions;
     };
   }
 }
@@ -18,6 +18,7 @@
 
 #include <ignition/common/Profiler.hh>
 
+#include "gazebo/physics/FeedbackRegistry.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Joint.hh"
@@ -169,12 +170,24 @@ void ForceTorqueSensor::Load(const std::string &_worldName)
 void ForceTorqueSensor::Init()
 {
   Sensor::Init();
-  this->dataPtr->parentJoint->SetProvideFeedback(true);
+
+  // Ask the physics engine to compute the wrench of the joint
+  this->world->Physics()->GetFeedbackRegistry()->RegisterJoint(
+      this->dataPtr->parentJoint);
+  this->dataPtr->feedbackRegistered = true;
 }
 
 //////////////////////////////////////////////////
 void ForceTorqueSensor::Fini()
 {
+  if (this->dataPtr->feedbackRegistered && this->world &&
+      this->world->Physics())
+  {
+    this->world->Physics()->GetFeedbackRegistry()->UnregisterJoint(
+        this->dataPtr->parentJoint);
+  }
+  this->dataPtr->feedbackRegistered = false;
+
   this->dataPtr->wrenchPub.reset();
   this->dataPtr->parentJoint.reset();
 
@@ -37,6 +37,10 @@ namespace gazebo
       /// \brief Parent joint, from which we get force torque info.
       public: physics::JointPtr parentJoint;
 
+      /// \brief True once parentJoint is registered with the physics
+      /// engine feedback registry.
+      public: bool feedbackRegistered = false;
+
       /// \brief Publishes the wrenchMsg.
       public: transport::PublisherPtr wrenchPub;
 
@@ -24,6 +24,7 @@
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/PublicationPlanner.hh"
 
 #include "gazebo/sensors/Noise.hh"
 #include "gazebo/sensors/SensorFactory.hh"
@@ -184,8 +185,10 @@ void ImuSensor::Load(const std::string &_worldName, sdf::ElementPtr _sdf)
     gzlog << out.str();
   }
 
-  // Start publishing measurements on the topic.
-  this->dataPtr->parentEntity->SetPublishData(true);
+  // Start publishing measurements on the topic. Consumers are counted, so
+  // several sensors can share the link.
+  this->dataPtr->parentEntity->GetWorld()->Publications()->AddLinkData(
+      this->dataPtr->parentEntity);
 
   std::string topic = "~/" + this->dataPtr->parentEntity->GetScopedName();
   this->dataPtr->linkDataSub = this->node->Subscribe(topic,
@@ -232,7 +235,10 @@ void ImuSensor::Fini()
   }
 
   if (this->dataPtr->parentEntity)
-    this->dataPtr->parentEntity->SetPublishData(false);
+  {
+    this->dataPtr->parentEntity->GetWorld()->Publications()->RemoveLinkData(
+        this->dataPtr->parentEntity);
+  }
   this->dataPtr->parentEntity.reset();
 
   this->dataPtr->incomingLinkData[0].reset();
@@ -29,6 +29,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
+#include "gazebo/common/StartupProfiler.hh"
 
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/Distortion.hh"
@@ -344,6 +345,7 @@ void Sensor::LoadPlugin(sdf::ElementPtr _sdf)
     }
 
     SensorPtr myself = shared_from_this();
+    common::StartupScope startupScope(name, "plugin");
     plugin->Load(myself, _sdf);
     plugin->Init();
     this->plugins.push_back(plugin);
@@ -418,6 +420,15 @@ common::Time Sensor::LastMeasurementTime() const
   return this->lastMeasurementTime;
 }
 
+//////////////////////////////////////////////////
+common::Time Sensor::NextUpdateTime() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+
+  // Matches the update condition in Sensor::Update
+  return this->lastUpdateTime + this->updatePeriod - this->dataPtr->updateDelay;
+}
+
 //////////////////////////////////////////////////
 std::string Sensor::Type() const
 {
@@ -134,6 +134,12 @@ namespace gazebo
       /// \return Time of last measurement.
       public: common::Time LastMeasurementTime() const;
 
+      /// \brief Get the sim time at which the sensor is next due for an
+      /// update, given its update rate and the delay of its last update.
+      /// Update does nothing before that time unless forced.
+      /// \return Sim time of the next update.
+      public: common::Time NextUpdateTime() const;
+
       /// \brief Return true if user requests the sensor to be visualized
       ///        via tag:  <visualize>true</visualize> in SDF.
       /// \return True if visualized, false if not.
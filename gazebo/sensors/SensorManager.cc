@@ -15,9 +15,11 @@
  *
 */
 
+#include <algorithm>
 #include <functional>
 #include <boost/bind.hpp>
 
+#include "gazebo/common/StartupProfiler.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/PhysicsIface.hh"
@@ -42,10 +44,6 @@ using namespace sensors;
 /// for timing coordination.
 boost::mutex g_sensorTimingMutex;
 
-/// \brief Flag to indicate if number of sensors has changed and that the
-/// max update rate needs to be recalculated
-bool g_sensorsDirty = true;
-
 /// Performance metrics variables
 /// \brief last sensor measurement sim time
 std::map<std::string, gazebo::common::Time> sensorsLastMeasurementTime;
@@ -145,7 +143,10 @@ void SensorManager::Stop()
   }
 
   if (!physics::worlds_running())
+  {
     this->worlds.clear();
+    this->worldCount = 0;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -299,11 +300,20 @@ void SensorManager::Update(bool _force)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
 
-    if (this->worlds.empty() && physics::worlds_running() && this->initialized)
+    // Worlds without sensors are ready as soon as the manager is. The
+    // worlds of the process are scanned again whenever their number
+    // changes, as worlds may be loaded after the first one runs.
+    bool worldsReady = false;
+    if (physics::worlds_running() && this->initialized &&
+        physics::get_world_count() != this->worldCount)
     {
-      auto world = physics::get_world();
-      this->worlds[world->Name()] = world;
-      world->_SetSensorsInitialized(true);
+      std::vector<physics::WorldPtr> all = physics::get_worlds();
+      for (auto const &world : all)
+      {
+        if (this->worlds.emplace(world->Name(), world).second)
+          worldsReady = true;
+      }
+      this->worldCount = all.size();
     }
 
     if (!this->initSensors.empty())
@@ -317,10 +327,20 @@ void SensorManager::Update(bool _force)
         GZ_ASSERT(this->sensorContainers[sensor->Category()] != nullptr,
             "Sensor container is null");
 
-        sensor->Init();
+        {
+          common::StartupScope startupScope(sensor->ScopedName(), "sensors");
+          sensor->Init();
+        }
         this->sensorContainers[sensor->Category()]->AddSensor(sensor);
       }
       this->initSensors.clear();
+      worldsReady = true;
+    }
+
+    // Only once the pending sensors of the worlds exist, otherwise a world
+    // could load its plugins before its sensors are initialized
+    if (worldsReady)
+    {
       for (auto &worldName_worldPtr : this->worlds)
         worldName_worldPtr.second->_SetSensorsInitialized(true);
     }
@@ -360,6 +380,7 @@ void SensorManager::Update(bool _force)
 
       // Also clear the list of worlds
       this->worlds.clear();
+      this->worldCount = 0;
 
       this->removeAllSensors = false;
     }
@@ -378,6 +399,21 @@ bool SensorManager::SensorsInitialized()
   return result;
 }
 
+//////////////////////////////////////////////////
+SensorLateness SensorManager::Lateness(const std::string &_name) const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  SensorLateness result;
+  for (auto const &container : this->sensorContainers)
+  {
+    GZ_ASSERT(container != nullptr, "SensorContainer is null");
+    if (container->Lateness(_name, result))
+      break;
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 void SensorManager::ResetLastUpdateTimes()
 {
@@ -415,6 +451,7 @@ double SensorManager::NextRequiredTimestamp()
 void SensorManager::Init()
 {
   boost::recursive_mutex::scoped_lock lock(this->mutex);
+  common::StartupScope startupScope("SensorManager::Init", "sensors");
 
   this->simTimeEventHandler = new SimTimeEventHandler();
 
@@ -460,6 +497,7 @@ void SensorManager::Fini()
   this->removeSensors.clear();
   this->initSensors.clear();
   this->worlds.clear();
+  this->worldCount = 0;
 
   delete this->simTimeEventHandler;
   this->simTimeEventHandler = nullptr;
@@ -501,7 +539,14 @@ std::string SensorManager::CreateSensor(sdf::ElementPtr _elem,
   sensor->SetParent(_parentName, _parentId);
 
   // Load the sensor
-  sensor->Load(_worldName, _elem);
+  {
+    // The span name is only built while the startup is profiled
+    std::string spanName;
+    if (common::StartupProfiler::Instance()->Enabled())
+      spanName = _parentName + "::" + _elem->Get<std::string>("name");
+    common::StartupScope startupScope(spanName, "sensors");
+    sensor->Load(_worldName, _elem);
+  }
   this->worlds[_worldName] = physics::get_world(_worldName);
 
   // Provide the wait function to the given world
@@ -719,6 +764,8 @@ void SensorManager::SensorContainer::RunLoop()
 {
   this->stop = false;
 
+  // The sensor threads time their updates against the first world of the
+  // process, also for the sensors of other worlds.
   physics::WorldPtr world = physics::get_world();
   GZ_ASSERT(world != nullptr, "Pointer to World is null");
 
@@ -735,8 +782,7 @@ void SensorManager::SensorContainer::RunLoop()
   // Release engine pointer, we don't need it in the loop
   engine.reset();
 
-  common::Time sleepTime, startTime, eventTime, diffTime;
-  double maxUpdateRate = 0;
+  common::Time startTime, nextTime, diffTime;
 
   boost::mutex tmpMutex;
   boost::mutex::scoped_lock lock2(tmpMutex);
@@ -750,35 +796,6 @@ void SensorManager::SensorContainer::RunLoop()
       return;
   }
 
-
-  auto computeMaxUpdateRate = [&]()
-  {
-    {
-      boost::recursive_mutex::scoped_lock lock(this->mutex);
-
-      if (!g_sensorsDirty)
-        return;
-
-      // Get the minimum update rate from the sensors.
-      for (Sensor_V::iterator iter = this->sensors.begin();
-          iter != this->sensors.end() && !this->stop; ++iter)
-      {
-        GZ_ASSERT((*iter) != nullptr, "Sensor is null");
-        maxUpdateRate = std::max((*iter)->UpdateRate(), maxUpdateRate);
-      }
-
-      g_sensorsDirty = false;
-    }
-
-    // Calculate an appropriate sleep time.
-    if (maxUpdateRate > 0)
-      sleepTime.Set(1.0 / (maxUpdateRate));
-    else
-      sleepTime.Set(0, 1e6);
-  };
-
-  computeMaxUpdateRate();
-
   IGN_PROFILE_THREAD_NAME("SensorManager");
 
   while (!this->stop)
@@ -794,13 +811,11 @@ void SensorManager::SensorContainer::RunLoop()
         return;
     }
 
-    computeMaxUpdateRate();
-
     // Get the start time of the update.
     startTime = world->SimTime();
 
     IGN_PROFILE_BEGIN("UpdateSensors");
-    this->Update(false);
+    nextTime = this->UpdateDue(startTime);
     IGN_PROFILE_END();
 
     // Compute the time it took to update the sensors.
@@ -808,9 +823,6 @@ void SensorManager::SensorContainer::RunLoop()
     // would case a negative diffTime. Instead, just use a event time of zero
     diffTime = std::max(common::Time::Zero, world->SimTime() - startTime);
 
-    // Set the default sleep time
-    eventTime = std::max(common::Time::Zero, sleepTime - diffTime);
-
     // Make sure update time is reasonable.
     // During log playback, time can jump forward an arbitrary amount.
     if (diffTime.sec >= maxSensorUpdate && !util::LogPlay::Instance()->IsOpen())
@@ -821,19 +833,13 @@ void SensorManager::SensorContainer::RunLoop()
         << "This warning can be ignored during log playback" << std::endl;
     }
 
-    // Make sure eventTime is not negative.
-    if (eventTime < common::Time::Zero)
-    {
-      gzerr << "Time to next sensor update is negative." << std::endl;
-      continue;
-    }
-
     boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
 
-    // Add an event to trigger when the appropriate simulation time has been
-    // reached.
-    SensorManager::Instance()->simTimeEventHandler->AddRelativeEvent(
-        eventTime, &this->runCondition);
+    // Add an event to trigger when the next sensor is due. If that time
+    // has already been reached, the event triggers on the next world
+    // update.
+    SensorManager::Instance()->simTimeEventHandler->AddEvent(
+        nextTime, &this->runCondition);
 
     // This if statement helps prevent deadlock on osx during teardown.
     IGN_PROFILE_BEGIN("Sleeping");
@@ -845,6 +851,98 @@ void SensorManager::SensorContainer::RunLoop()
   }
 }
 
+//////////////////////////////////////////////////
+common::Time SensorManager::SensorContainer::UpdateDue(
+    const common::Time &_simTime)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  PublishPerformanceMetrics();
+
+  // Earliest deadline first
+  auto later = [](const Deadline &_a, const Deadline &_b)
+  {
+    return _a.time > _b.time;
+  };
+
+  if (this->scheduleDirty)
+  {
+    this->schedule.clear();
+    for (auto const &sensor : this->sensors)
+    {
+      GZ_ASSERT(sensor != nullptr, "Sensor is null");
+      this->schedule.push_back({sensor->NextUpdateTime(), sensor, false});
+    }
+    std::make_heap(this->schedule.begin(), this->schedule.end(), later);
+
+    for (auto iter = this->lateness.begin(); iter != this->lateness.end();)
+    {
+      if (!this->GetSensor(iter->first))
+        iter = this->lateness.erase(iter);
+      else
+        ++iter;
+    }
+    this->scheduleDirty = false;
+  }
+
+  // A sensor updates at most once per sim time, so it is not due again
+  // before the next world update.
+  const common::Time nextStep = _simTime + common::Time(0, 1);
+
+  // Only touch the sensors that are due
+  while (!this->schedule.empty() && this->schedule.front().time <= _simTime)
+  {
+    std::pop_heap(this->schedule.begin(), this->schedule.end(), later);
+    Deadline &due = this->schedule.back();
+    Sensor *sensor = due.sensor.get();
+
+    const common::Time lastUpdate = sensor->LastUpdateTime();
+    IGN_PROFILE_BEGIN(sensor->Name().c_str());
+    sensor->Update(false);
+    IGN_PROFILE_END();
+
+    const common::Time updateTime = sensor->LastUpdateTime();
+    if (updateTime != lastUpdate && due.measured)
+    {
+      const common::Time late =
+          std::max(common::Time::Zero, updateTime - due.time);
+      SensorLateness &stats = this->lateness[sensor->ScopedName()];
+      ++stats.updates;
+      stats.last = late;
+      stats.max = std::max(stats.max, late);
+      stats.total += late;
+    }
+
+    // Inactive sensors are polled at their update rate, in case they are
+    // activated.
+    if (sensor->IsActive())
+      due.time = std::max(sensor->NextUpdateTime(), nextStep);
+    else
+      due.time = std::max(_simTime + common::Time(1.0 / std::max(
+          sensor->UpdateRate(), 1.0)), nextStep);
+    due.measured = sensor->IsActive();
+    std::push_heap(this->schedule.begin(), this->schedule.end(), later);
+  }
+
+  if (this->schedule.empty())
+    return nextStep;
+  return this->schedule.front().time;
+}
+
+//////////////////////////////////////////////////
+bool SensorManager::SensorContainer::Lateness(const std::string &_name,
+    SensorLateness &_lateness) const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  if (!this->GetSensor(_name))
+    return false;
+
+  auto iter = this->lateness.find(_name);
+  _lateness = iter != this->lateness.end() ? iter->second : SensorLateness();
+  return true;
+}
+
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Update(bool _force)
 {
@@ -901,7 +999,7 @@ void SensorManager::SensorContainer::AddSensor(SensorPtr _sensor)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
     this->sensors.push_back(_sensor);
-    g_sensorsDirty = true;
+    this->scheduleDirty = true;
   }
 
   // Tell the run loop that we have received a sensor
@@ -931,7 +1029,7 @@ bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
     }
   }
 
-  g_sensorsDirty = true;
+  this->scheduleDirty = true;
 
   return removed;
 }
@@ -949,6 +1047,7 @@ void SensorManager::SensorContainer::ResetLastUpdateTimes()
     GZ_ASSERT((*iter) != nullptr, "Sensor is null");
     (*iter)->ResetLastUpdateTime();
   }
+  this->scheduleDirty = true;
 
   // Tell the run loop that world time has been reset.
   this->runCondition.notify_one();
@@ -968,7 +1067,7 @@ void SensorManager::SensorContainer::RemoveSensors()
     (*iter)->Fini();
   }
 
-  g_sensorsDirty = true;
+  this->scheduleDirty = true;
 
   this->sensors.clear();
 }
@@ -1015,32 +1114,24 @@ SimTimeEventHandler::SimTimeEventHandler()
 /////////////////////////////////////////////////
 SimTimeEventHandler::~SimTimeEventHandler()
 {
-  // Cleanup the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-       iter != this->events.end(); ++iter)
-  {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
-    delete *iter;
-  }
-  this->events.clear();
 }
 
 /////////////////////////////////////////////////
 void SimTimeEventHandler::AddRelativeEvent(const common::Time &_time,
                                            boost::condition_variable *_var)
 {
-  boost::mutex::scoped_lock lock(this->mutex);
-
   physics::WorldPtr world = physics::get_world();
   GZ_ASSERT(world != nullptr, "World pointer is null");
 
-  // Create the new event.
-  SimTimeEvent *event = new SimTimeEvent;
-  event->time = world->SimTime() + _time;
-  event->condition = _var;
+  this->AddEvent(world->SimTime() + _time, _var);
+}
 
-  // Add the event to the list.
-  this->events.push_back(event);
+/////////////////////////////////////////////////
+void SimTimeEventHandler::AddEvent(const common::Time &_time,
+                                   boost::condition_variable *_var)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->events.emplace(_time, _var);
 }
 
 /////////////////////////////////////////////////
@@ -1049,24 +1140,21 @@ void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
   boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
   boost::mutex::scoped_lock lock(this->mutex);
 
-  // Iterate over all the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-      iter != this->events.end();)
+  // Notify the events that have a time less than or equal to simulation
+  // time. They are ordered by time, so stop at the first one in the future.
+  auto end = this->events.upper_bound(_info.simTime);
+  for (auto iter = this->events.begin(); iter != end; ++iter)
   {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
-
-    // Find events that have a time less than or equal to simulation
-    // time.
-    if ((*iter)->time <= _info.simTime)
-    {
-      // Notify the event by triggering its condition.
-      (*iter)->condition->notify_all();
-
-      // Remove the event.
-      delete *iter;
-      this->events.erase(iter++);
-    }
-    else
-      ++iter;
+    GZ_ASSERT(iter->second != nullptr, "SimTimeEvent condition is null");
+    iter->second->notify_all();
   }
+  this->events.erase(this->events.begin(), end);
+}
+
+//////////////////////////////////////////////////
+common::Time SensorLateness::Mean() const
+{
+  if (this->updates == 0)
+    return common::Time::Zero;
+  return common::Time(this->total.Double() / this->updates);
 }
@@ -71,6 +71,13 @@ namespace gazebo
       public: void AddRelativeEvent(const common::Time &_time,
                   boost::condition_variable *_var);
 
+      /// \brief Add a new event to the handler.
+      /// \param[in] _time Sim time of the new event.
+      /// \param[in] _var Condition to notify when the time has been
+      /// reached.
+      public: void AddEvent(const common::Time &_time,
+                  boost::condition_variable *_var);
+
       /// \brief Called when the world is updated.
       /// \param[in] _info Update timing information.
       private: void OnUpdate(const common::UpdateInfo &_info);
@@ -78,8 +85,9 @@ namespace gazebo
       /// \brief Mutex to mantain thread safety.
       private: boost::mutex mutex;
 
-      /// \brief The list of events to handle.
-      private: std::list<SimTimeEvent*> events;
+      /// \brief The conditions to notify, by sim time.
+      private: std::multimap<common::Time, boost::condition_variable *>
+               events;
 
       /// \brief Connect to the World::UpdateBegin event.
       private: event::ConnectionPtr updateConnection;
@@ -88,6 +96,29 @@ namespace gazebo
 
     /// \addtogroup gazebo_sensors
     /// \{
+
+    /// \class SensorLateness SensorManager.hh sensors/sensors.hh
+    /// \brief Statistics of how late, in sim time, the updates of a sensor
+    /// ran with respect to the time they were due.
+    class GZ_SENSORS_VISIBLE SensorLateness
+    {
+      /// \brief Get the mean lateness.
+      /// \return Mean lateness, zero if there were no updates.
+      public: common::Time Mean() const;
+
+      /// \brief Number of updates.
+      public: uint64_t updates = 0;
+
+      /// \brief Lateness of the last update.
+      public: common::Time last;
+
+      /// \brief Largest lateness.
+      public: common::Time max;
+
+      /// \brief Sum of the lateness of all updates.
+      public: common::Time total;
+    };
+
     /// \class SensorManager SensorManager.hh sensors/sensors.hh
     /// \brief Class to manage and update all sensors
     class GZ_SENSORS_VISIBLE SensorManager : public SingletonT<SensorManager>
@@ -179,6 +210,14 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Get how late the updates of a sensor ran. Only sensors
+      /// that are not rendering based are updated on a schedule by the
+      /// sensor threads, see RunThreads.
+      /// \param[in] _name Scoped name of the sensor.
+      /// \return Lateness statistics, empty if the sensor was not updated
+      /// by a sensor thread.
+      public: SensorLateness Lateness(const std::string &_name) const;
+
       /// \brief Block until all sensors do not need current world tick
       /// \param[in] _clk simulated clock of the world
       /// \param[in] _dt world time step
@@ -251,10 +290,38 @@ namespace gazebo
                  /// \brief Reset last update times in all sensors.
                  public: void ResetLastUpdateTimes();
 
+                 /// \brief Get how late the updates of a sensor ran.
+                 /// \param[in] _name Scoped name of the sensor.
+                 /// \param[out] _lateness Lateness statistics.
+                 /// \return True if the sensor is in this container.
+                 public: bool Lateness(const std::string &_name,
+                                       SensorLateness &_lateness) const;
+
                  /// \brief A loop to update the sensor. Used by the
                  /// runThread.
                  private: void RunLoop();
 
+                 /// \brief Update the sensors that are due, and schedule
+                 /// their next update.
+                 /// \param[in] _simTime Current sim time.
+                 /// \return Sim time at which the next sensor is due.
+                 private: common::Time UpdateDue(const common::Time &_simTime);
+
+                 /// \brief A sensor and the sim time of its next update.
+                 private: class Deadline
+                          {
+                            /// \brief Sim time the sensor is due.
+                            public: common::Time time;
+
+                            /// \brief The sensor.
+                            public: SensorPtr sensor;
+
+                            /// \brief True if the time was computed after
+                            /// an update of the sensor, false if it was
+                            /// computed when the schedule was built.
+                            public: bool measured;
+                          };
+
                  /// \brief The set of sensors to maintain.
                  public: Sensor_V sensors;
 
@@ -274,6 +341,16 @@ namespace gazebo
                  /// \brief Condition used to block the RunLoop if no
                  /// sensors are present.
                  private: boost::condition_variable runCondition;
+
+                 /// \brief Min heap of the next updates of the sensors.
+                 private: std::vector<Deadline> schedule;
+
+                 /// \brief True if the sensors changed and the schedule
+                 /// has to be rebuilt.
+                 private: bool scheduleDirty = true;
+
+                 /// \brief Lateness statistics by scoped sensor name.
+                 private: std::map<std::string, SensorLateness> lateness;
                };
       /// \endcond
 
@@ -332,6 +409,10 @@ namespace gazebo
       /// includes worlds without sensors..
       private: std::map<std::string, physics::WorldPtr> worlds;
 
+      /// \brief Number of worlds of the process when they were last added
+      /// to worlds.
+      private: size_t worldCount = 0;
+
       /// \brief Connect to the time reset event.
       private: event::ConnectionPtr timeResetConnection;
 
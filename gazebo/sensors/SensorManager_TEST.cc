@@ -159,6 +159,63 @@ TEST_F(SensorManager_TEST, InitRemove)
   printf("Done done\n");
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that sensors of one thread are updated at their own rate.
+TEST_F(SensorManager_TEST, Schedule)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  SpawnImuSensor("fast_model", "fast_imu");
+  SpawnImuSensor("slow_model", "slow_imu",
+      ignition::math::Vector3d(1, 0, 0));
+
+  sensors::SensorPtr fast = mgr->GetSensor("fast_imu");
+  sensors::SensorPtr slow = mgr->GetSensor("slow_imu");
+  ASSERT_TRUE(fast != nullptr);
+  ASSERT_TRUE(slow != nullptr);
+  fast->SetUpdateRate(1000);
+  slow->SetUpdateRate(10);
+  fast->SetActive(true);
+  slow->SetActive(true);
+
+  int fastCount = 0;
+  int slowCount = 0;
+  event::ConnectionPtr fastConnection =
+      fast->ConnectUpdated([&fastCount]() {++fastCount;});
+  event::ConnectionPtr slowConnection =
+      slow->ConnectUpdated([&slowCount]() {++slowCount;});
+
+  // Run one second of sim time
+  const double stepSize = world->Physics()->GetMaxStepSize();
+  const int steps = static_cast<int>(1.0 / stepSize);
+  for (int i = 0; i < steps; ++i)
+  {
+    world->Step(1);
+    // Give the sensor thread a chance to keep up
+    if (i % 10 == 0)
+      common::Time::MSleep(1);
+  }
+  common::Time::MSleep(100);
+
+  EXPECT_GT(slowCount, 0);
+  EXPECT_LE(slowCount, 11);
+  EXPECT_GT(fastCount, slowCount);
+
+  // Lateness of the updates
+  sensors::SensorLateness lateness = mgr->Lateness(slow->ScopedName());
+  EXPECT_GT(lateness.updates, 0u);
+  EXPECT_LE(lateness.updates, static_cast<uint64_t>(slowCount));
+  EXPECT_LE(lateness.last, lateness.max);
+  EXPECT_LE(lateness.Mean(), lateness.max);
+  EXPECT_GE(lateness.Mean(), common::Time::Zero);
+
+  // Unknown sensors have no statistics
+  EXPECT_EQ(0u, mgr->Lateness("no_such_sensor").updates);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -14,6 +14,13 @@
  * limitations under the License.
  *
 */
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -36,6 +43,30 @@ const double WirelessTransmitterPrivate::NObstacle = 12.0;
 const double WirelessTransmitterPrivate::ModelStdDev = 6.0;
 const double WirelessTransmitterPrivate::Step = 1.0;
 const double WirelessTransmitterPrivate::MaxRadius = 10.0;
+const uint64_t WirelessTransmitterPrivate::PairLifetime = 100;
+
+/////////////////////////////////////////////////
+/// \brief Describe the collisions that may block the rays within a box.
+/// \param[in] _snapshot Collision snapshot the rays are cast in.
+/// \param[in] _box Box that holds the rays, in the world frame.
+/// \return Fingerprint of the collisions.
+static PropagationFingerprint Fingerprint(const CollisionSnapshot &_snapshot,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  std::vector<uint32_t> ids = _snapshot.Overlap(_box);
+
+  PropagationFingerprint result;
+  result.reserve(ids.size());
+  for (auto const id : ids)
+  {
+    ignition::math::Pose3d pose;
+    ignition::math::AxisAlignedBox box;
+    _snapshot.Pose(id, pose);
+    _snapshot.BoundingBox(id, box);
+    result.push_back(std::make_tuple(id, pose, box));
+  }
+  return result;
+}
 
 /////////////////////////////////////////////////
 WirelessTransmitter::WirelessTransmitter()
@@ -79,10 +110,9 @@ void WirelessTransmitter::Init()
 {
   WirelessTransceiver::Init();
 
-  // This ray will be used in SignalStrength() for checking obstacles
-  // between the transmitter and a given point.
-  this->dataPtr->testRay = boost::dynamic_pointer_cast<RayShape>(
-      this->world->Physics()->CreateShape("ray", CollisionPtr()));
+  // Obstacles are looked for in the collision snapshots of the world,
+  // which are produced from now on
+  this->world->LatestCollisionSnapshot();
 }
 
 //////////////////////////////////////////////////
@@ -90,41 +120,96 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
 {
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
-  if (this->dataPtr->visualize)
+  std::lock_guard<std::mutex> lock(this->dataPtr->propagationMutex);
+  ++this->dataPtr->updateCount;
+
+  // Forget the receiver positions that were not seen for a while
+  for (auto iter = this->dataPtr->pairs.begin();
+       iter != this->dataPtr->pairs.end();)
   {
-    msgs::PropagationGrid msg;
-    ignition::math::Pose3d pos;
-    ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
+    if (iter->second.lastUpdate + this->dataPtr->PairLifetime <
+        this->dataPtr->updateCount)
+      iter = this->dataPtr->pairs.erase(iter);
+    else
+      ++iter;
+  }
 
+  if (this->dataPtr->visualize)
+  {
     // Iterate using a rectangular grid, but only choose the points within
     // a circunference of radius MaxRadius
-    for (double x = -this->dataPtr->MaxRadius;
-         x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+    if (this->dataPtr->gridCells.empty())
     {
-      for (double y = -this->dataPtr->MaxRadius;
-           y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
+      for (double x = -this->dataPtr->MaxRadius;
+           x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
       {
-        pos.Set(x, y, 0.0, 0, 0, 0);
-
-        worldPose = pos + this->referencePose;
-
-        if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
-            this->dataPtr->MaxRadius)
+        for (double y = -this->dataPtr->MaxRadius;
+             y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
         {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
+          ignition::math::Vector3d cell(x, y, 0.0);
+          if (cell.Length() <= this->dataPtr->MaxRadius)
+            this->dataPtr->gridCells.push_back(cell);
         }
       }
     }
+
+    // Cast the whole grid in one snapshot, so that all the cells see the
+    // same state of the world.
+    CollisionSnapshotPtr snapshot = this->world->LatestCollisionSnapshot();
+
+    // The obstacle tests of the grid only change if the transmitter or a
+    // collision within MaxRadius moved. The fingerprint is taken from the
+    // snapshot the rays are cast in, so motion elsewhere in the world
+    // keeps the grid.
+    ignition::math::Vector3d radius(this->dataPtr->MaxRadius,
+        this->dataPtr->MaxRadius, this->dataPtr->MaxRadius);
+    PropagationFingerprint fingerprint = Fingerprint(*snapshot,
+        ignition::math::AxisAlignedBox(this->referencePose.Pos() - radius,
+          this->referencePose.Pos() + radius));
+
+    if (!this->dataPtr->gridValid ||
+        this->dataPtr->gridPose != this->referencePose ||
+        this->dataPtr->gridFingerprint != fingerprint)
+    {
+      this->dataPtr->gridObstacles.resize(this->dataPtr->gridCells.size());
+
+      // The snapshot is immutable, the rays are cast in parallel without
+      // touching the world
+      tbb::parallel_for(tbb::blocked_range<size_t>(0,
+            this->dataPtr->gridCells.size(), 16),
+          [&](const tbb::blocked_range<size_t> &_r)
+          {
+            for (size_t i = _r.begin(); i != _r.end(); ++i)
+            {
+              ignition::math::Vector3d end =
+                this->referencePose.CoordPositionAdd(
+                    this->dataPtr->gridCells[i]);
+              this->dataPtr->gridObstacles[i] = this->Obstructed(
+                  this->referencePose.Pos(), end, *snapshot);
+            }
+          });
+
+      this->dataPtr->gridPose = this->referencePose;
+      this->dataPtr->gridFingerprint.swap(fingerprint);
+      this->dataPtr->gridValid = true;
+    }
+
+    msgs::PropagationGrid msg;
+    for (size_t i = 0; i < this->dataPtr->gridCells.size(); ++i)
+    {
+      const ignition::math::Vector3d &cell = this->dataPtr->gridCells[i];
+
+      // For the propagation model assume the receiver antenna has the same
+      // gain as the transmitter
+      double strength = this->Propagate(cell.Length(),
+          this->dataPtr->gridObstacles[i], this->Gain());
+
+      // Add a new particle to the grid
+      msgs::PropagationParticle *p = msg.add_particle();
+      p->set_x(cell.X());
+      p->set_y(cell.Y());
+      p->set_signal_level(strength);
+    }
     this->pub->Publish(msg);
   }
 
@@ -148,37 +233,68 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
-  ignition::math::Vector3d end = _receiver.Pos();
   ignition::math::Vector3d start = this->referencePose.Pos();
+  ignition::math::Vector3d end = _receiver.Pos();
 
-  // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
-  if (start == end)
+  bool obstacle = false;
   {
-    end.Z() += 0.00001;
+    std::lock_guard<std::mutex> lock(this->dataPtr->propagationMutex);
+
+    // Nothing can block the ray if no collision box is on its way
+    CollisionSnapshotPtr snapshot = this->world->LatestCollisionSnapshot();
+    PropagationFingerprint fingerprint = Fingerprint(*snapshot,
+        ignition::math::AxisAlignedBox(start, end));
+    if (!fingerprint.empty())
+    {
+      PropagationPair &pair = this->dataPtr->pairs[
+        std::make_tuple(end.X(), end.Y(), end.Z())];
+
+      if (pair.lastUpdate == 0 || pair.start != start ||
+          pair.fingerprint != fingerprint)
+      {
+        pair.obstacle = this->Obstructed(start, end, *snapshot);
+        pair.start = start;
+        pair.fingerprint.swap(fingerprint);
+      }
+
+      pair.lastUpdate = std::max<uint64_t>(1, this->dataPtr->updateCount);
+      obstacle = pair.obstacle;
+    }
   }
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
+  return this->Propagate(start.Distance(end), obstacle, _rxGain);
+}
 
-  // Compute the value of n depending on the obstacles between Tx and Rx
-  double n = WirelessTransmitterPrivate::NEmpty;
+/////////////////////////////////////////////////
+bool WirelessTransmitter::Obstructed(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, const CollisionSnapshot &_snapshot)
+{
+  ignition::math::Vector3d end = _end;
+
+  // Avoid computing the intersection of coincident points, the ray would
+  // have no direction
+  if (_start == end)
+  {
+    end.Z() += 0.00001;
+  }
 
   // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
+  CollisionSnapshotHit hit;
+  ++this->dataPtr->rayCasts;
 
   // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
-  {
-    n = WirelessTransmitterPrivate::NObstacle;
-  }
+  return _snapshot.Ray(_start, end, hit);
+}
 
-  double distance = std::max(1.0,
-      this->referencePose.Pos().Distance(_receiver.Pos()));
+/////////////////////////////////////////////////
+double WirelessTransmitter::Propagate(const double _distance,
+    const bool _obstacle, const double _rxGain) const
+{
+  // Compute the value of n depending on the obstacles between Tx and Rx
+  double n = _obstacle ? WirelessTransmitterPrivate::NObstacle :
+    WirelessTransmitterPrivate::NEmpty;
+
+  double distance = std::max(1.0, _distance);
   double x = std::abs(ignition::math::Rand::DblNormal(0.0,
         WirelessTransmitterPrivate::ModelStdDev));
   double wavelength = common::SpeedOfLight / (this->Freq() * 1000000);
@@ -190,6 +306,13 @@ double WirelessTransmitter::SignalStrength(
   return rxPower;
 }
 
+/////////////////////////////////////////////////
+uint64_t WirelessTransmitter::RayCasts() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->propagationMutex);
+  return this->dataPtr->rayCasts;
+}
+
 /////////////////////////////////////////////////
 double WirelessTransmitter::ModelStdDev() const
 {
@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_HH_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include "gazebo/physics/physics.hh"
@@ -73,6 +74,31 @@ namespace gazebo
       /// \return The standard deviation of the propagation model.
       public: double ModelStdDev() const;
 
+      /// \brief Get the number of rays cast in collision snapshots to look
+      /// for obstacles. Obstacle tests are cached while nothing moves
+      /// near the rays, so this grows slower than the number of signal
+      /// strengths computed.
+      /// \return Number of rays cast.
+      public: uint64_t RayCasts() const;
+
+      /// \brief Test whether there is an obstacle between two points.
+      /// \param[in] _start Start point, in the world frame.
+      /// \param[in] _end End point, in the world frame.
+      /// \param[in] _snapshot Collision snapshot the ray is cast in.
+      /// \return True if the ray between the points hits an entity.
+      /// Safe to call from several threads at once.
+      private: bool Obstructed(const ignition::math::Vector3d &_start,
+          const ignition::math::Vector3d &_end,
+          const physics::CollisionSnapshot &_snapshot);
+
+      /// \brief Apply the propagation model.
+      /// \param[in] _distance Distance between transmitter and receiver.
+      /// \param[in] _obstacle True if there are obstacles between them.
+      /// \param[in] _rxGain Receiver gain value.
+      /// \return Signal strength (dBm).
+      private: double Propagate(const double _distance, const bool _obstacle,
+          const double _rxGain) const;
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<WirelessTransmitterPrivate> dataPtr;
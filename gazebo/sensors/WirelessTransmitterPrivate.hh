@@ -17,13 +17,48 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
 {
   namespace sensors
   {
+    /// \internal
+    /// \brief Id, pose and bounding box of the collisions that may block a
+    /// set of rays, as seen in a collision snapshot. A ray cast is only
+    /// repeated if this changes.
+    using PropagationFingerprint = std::vector<std::tuple<uint32_t,
+          ignition::math::Pose3d, ignition::math::AxisAlignedBox>>;
+
+    /// \internal
+    /// \brief Cached obstacle test between the transmitter and a receiver.
+    class PropagationPair
+    {
+      /// \brief Start of the ray.
+      public: ignition::math::Vector3d start;
+
+      /// \brief Collisions around the ray when it was cast.
+      public: PropagationFingerprint fingerprint;
+
+      /// \brief True if the ray hit an obstacle.
+      public: bool obstacle = false;
+
+      /// \brief Transmitter update during which the entry was last used.
+      public: uint64_t lastUpdate = 0;
+    };
+
     /// \internal
     /// \brief Wireless transmitter private data
     class WirelessTransmitterPrivate
@@ -47,6 +82,10 @@ namespace gazebo
       /// grid, where the maximum radius covered is MaxRadius
       public: static const double MaxRadius;
 
+      /// \brief Number of transmitter updates after which a cached obstacle
+      /// test with a receiver that was not seen again is dropped.
+      public: static const uint64_t PairLifetime;
+
       // \brief When true it will publish the propagation grid to be used
       // by the transmitter visual layer
       public: bool visualize = false;
@@ -57,8 +96,36 @@ namespace gazebo
       /// \brief Reception frequency (MHz).
       public: double freq = 2442.0;
 
-      // \brief Ray used to test for collisions when placing entities
-      public: physics::RayShapePtr testRay;
+      /// \brief Positions of the cells of the visualization grid, in the
+      /// frame of the transmitter.
+      public: std::vector<ignition::math::Vector3d> gridCells;
+
+      /// \brief Obstacle test result of each grid cell. Not a vector of
+      /// bool, the cells are written by several threads.
+      public: std::vector<uint8_t> gridObstacles;
+
+      /// \brief Transmitter pose the grid obstacles were computed at.
+      public: ignition::math::Pose3d gridPose;
+
+      /// \brief Collisions within MaxRadius when the grid obstacles were
+      /// computed.
+      public: PropagationFingerprint gridFingerprint;
+
+      /// \brief True if gridObstacles holds valid results.
+      public: bool gridValid = false;
+
+      /// \brief Cached obstacle tests with receivers, by receiver position.
+      public: std::map<std::tuple<double, double, double>,
+              PropagationPair> pairs;
+
+      /// \brief Number of updates of the transmitter, used to expire pairs.
+      public: uint64_t updateCount = 0;
+
+      /// \brief Number of rays cast in collision snapshots.
+      public: std::atomic<uint64_t> rayCasts{0};
+
+      /// \brief Protects the cached results.
+      public: std::mutex propagationMutex;
     };
   }
 }
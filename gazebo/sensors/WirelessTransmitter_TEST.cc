@@ -24,6 +24,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: WirelessTransmitter_TEST();
     public: void TestCreateWirelessTransmitter();
     public: void TestSignalStrength();
+    public: void TestSignalStrengthCache();
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
@@ -159,6 +160,64 @@ void WirelessTransmitter_TEST::TestSignalStrength()
   EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that obstacle tests are reused until something moves
+void WirelessTransmitter_TEST::TestSignalStrengthCache()
+{
+  int samples = 100;
+  ignition::math::Pose3d rxPose(
+      ignition::math::Vector3d(-3.0, -3.0, 0.055),
+      ignition::math::Quaterniond(0, 0, 0));
+
+  this->tx->Update(true);
+  this->tx->SignalStrength(rxPose, tx->Gain());
+  uint64_t rayCasts = this->tx->RayCasts();
+
+  double signStrengthAvg = 0.0;
+  for (int i = 0; i < samples; ++i)
+    signStrengthAvg += this->tx->SignalStrength(rxPose, tx->Gain());
+  signStrengthAvg /= samples;
+
+  // Nothing moved, no new ray was cast
+  EXPECT_EQ(rayCasts, this->tx->RayCasts());
+  EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
+
+  // A model far from the ray doesn't invalidate the cache
+  SpawnBox("far_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(50, 50, 0.5),
+      ignition::math::Vector3d::Zero, true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  for (int i = 0; i < 100 && world->LatestCollisionSnapshot()->Overlap(
+        ignition::math::Vector3d(50, 50, 0.5), 0.1).empty(); ++i)
+  {
+    common::Time::MSleep(10);
+  }
+
+  this->tx->SignalStrength(rxPose, tx->Gain());
+  EXPECT_EQ(rayCasts, this->tx->RayCasts());
+
+  // An obstacle between the transmitter and the receiver
+  SpawnBox("obstacle", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(-1.5, -1.5, 0.5),
+      ignition::math::Vector3d::Zero, true);
+
+  // The world thread adds it to the next collision snapshot
+  for (int i = 0; i < 100 && world->LatestCollisionSnapshot()->Overlap(
+        ignition::math::Vector3d(-1.5, -1.5, 0.5), 0.1).empty(); ++i)
+  {
+    common::Time::MSleep(10);
+  }
+
+  signStrengthAvg = 0.0;
+  for (int i = 0; i < samples; ++i)
+    signStrengthAvg += this->tx->SignalStrength(rxPose, tx->Gain());
+  signStrengthAvg /= samples;
+
+  EXPECT_GT(this->tx->RayCasts(), rayCasts);
+  EXPECT_LT(signStrengthAvg, -62.0 - 3 * this->tx->ModelStdDev());
+}
+
 /////////////////////////////////////////////////
 /// \brief Callback executed for every propagation grid message received
 void WirelessTransmitter_TEST::TxMsg(const ConstPropagationGridPtr &_msg)
@@ -254,6 +313,12 @@ TEST_F(WirelessTransmitter_TEST, TestSignalStrength)
   TestSignalStrength();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestSignalStrengthCache)
+{
+  TestSignalStrengthCache();
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestUpdateImpl)
 {
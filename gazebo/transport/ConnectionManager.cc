@@ -281,6 +281,8 @@ void ConnectionManager::RunUpdate()
   boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
 
   TopicManager::Instance()->ProcessNodes();
+  this->ReportDroppedCounts();
+
   iter = this->connections.begin();
   endIter = this->connections.end();
 
@@ -298,6 +300,34 @@ void ConnectionManager::RunUpdate()
   }
 }
 
+//////////////////////////////////////////////////
+void ConnectionManager::ReportDroppedCounts()
+{
+  if (!this->masterConn || !this->serverConn)
+    return;
+
+  common::Time now = common::Time::GetWallTime();
+  if (now - this->droppedCountsTime < common::Time(1, 0))
+    return;
+  this->droppedCountsTime = now;
+
+  for (auto const &dropped : TopicManager::Instance()->DroppedCounts())
+  {
+    uint64_t &reported = this->reportedDroppedCounts[dropped.first];
+    if (reported == dropped.second)
+      continue;
+    reported = dropped.second;
+
+    msgs::Subscribe msg;
+    msg.set_topic(dropped.first);
+    msg.set_msg_type("");
+    msg.set_host(this->serverConn->GetLocalAddress());
+    msg.set_port(this->serverConn->GetLocalPort());
+    msg.set_dropped(dropped.second);
+    this->masterConn->EnqueueMsg(msgs::Package("subscriber_stats", msg));
+  }
+}
+
 //////////////////////////////////////////////////
 void ConnectionManager::Run()
 {
@@ -22,6 +22,7 @@
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
 #include <string>
 #include <list>
+#include <map>
 #include <vector>
 
 #include "gazebo/msgs/msgs.hh"
@@ -164,6 +165,11 @@ namespace gazebo
       /// \brief Run the manager update loop once
       private: void RunUpdate();
 
+      /// \brief Send the number of incoming messages dropped by the nodes
+      /// of this process to the master, at most once per second and only
+      /// for the topics whose count changed.
+      private: void ReportDroppedCounts();
+
       /// \brief Condition used to trigger an update.
       private: boost::condition_variable updateCondition;
 
@@ -194,6 +200,12 @@ namespace gazebo
       /// \brief Condition used for synchronization
       private: boost::condition_variable namespaceCondition;
 
+      /// \brief Dropped message counts last sent to the master, by topic.
+      private: std::map<std::string, uint64_t> reportedDroppedCounts;
+
+      /// \brief Wall time of the last dropped message report.
+      private: common::Time droppedCountsTime;
+
       // Singleton implementation
       private: friend class SingletonT<ConnectionManager>;
     };
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gazebo/transport/Executor.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+/// \internal
+/// \brief Private data class for Executor
+class gazebo::transport::ExecutorPrivate
+{
+  /// \brief Worker thread loop.
+  public: void Run()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true)
+    {
+      this->condition.wait(lock, [this]
+          {
+            return this->stop || !this->jobs.empty();
+          });
+
+      if (this->stop)
+        return;
+
+      std::function<void()> job = std::move(this->jobs.front());
+      this->jobs.pop_front();
+
+      lock.unlock();
+      job();
+      lock.lock();
+    }
+  }
+
+  /// \brief Worker threads.
+  public: std::vector<std::thread> threads;
+
+  /// \brief Jobs that did not start yet.
+  public: std::deque<std::function<void()>> jobs;
+
+  /// \brief True when the executor is destroyed.
+  public: bool stop = false;
+
+  /// \brief Protects the jobs and the stop flag.
+  public: std::mutex mutex;
+
+  /// \brief Signaled when a job is posted or the executor is destroyed.
+  public: std::condition_variable condition;
+};
+
+//////////////////////////////////////////////////
+Executor::Executor(const unsigned int _threads)
+  : dataPtr(new ExecutorPrivate)
+{
+  std::shared_ptr<ExecutorPrivate> data = this->dataPtr;
+  for (unsigned int i = 0; i < std::max(1u, _threads); ++i)
+    this->dataPtr->threads.emplace_back([data]() { data->Run(); });
+}
+
+//////////////////////////////////////////////////
+Executor::~Executor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+    this->dataPtr->jobs.clear();
+  }
+  this->dataPtr->condition.notify_all();
+
+  for (auto &thread : this->dataPtr->threads)
+  {
+    // A job may release the last reference to its executor. Its thread
+    // keeps the private data alive and exits after the job returns.
+    if (thread.get_id() == std::this_thread::get_id())
+      thread.detach();
+    else if (thread.joinable())
+      thread.join();
+  }
+}
+
+//////////////////////////////////////////////////
+void Executor::Post(const std::function<void()> &_job)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stop)
+      return;
+    this->dataPtr->jobs.push_back(_job);
+  }
+  this->dataPtr->condition.notify_one();
+}
+
+//////////////////////////////////////////////////
+unsigned int Executor::ThreadCount() const
+{
+  return this->dataPtr->threads.size();
+}
+
+//////////////////////////////////////////////////
+unsigned int Executor::Pending() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->jobs.size();
+}
+
+//////////////////////////////////////////////////
+ExecutorPtr Executor::Pool()
+{
+  static ExecutorPtr pool(
+      new Executor(std::max(2u, std::thread::hardware_concurrency())));
+  return pool;
+}
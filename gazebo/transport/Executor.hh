@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_EXECUTOR_HH_
+#define GAZEBO_TRANSPORT_EXECUTOR_HH_
+
+#include <functional>
+#include <memory>
+
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    class ExecutorPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class Executor Executor.hh transport/transport.hh
+    /// \brief A set of worker threads that run subscriber callbacks.
+    ///
+    /// By default the callbacks of every node run on the connection manager
+    /// thread, one node after the other, which also flushes the outgoing
+    /// connections. A node that is given an executor with
+    /// Node::SetCallbackExecutor has its callbacks run on the executor
+    /// instead, so that a slow callback only delays the nodes that share
+    /// its executor. The callbacks of a node never run concurrently with
+    /// each other, and messages on a topic are delivered in order.
+    ///
+    /// An executor with a single thread dedicates it to the nodes that use
+    /// it. Executor::Pool returns an executor shared by the process.
+    class GZ_TRANSPORT_VISIBLE Executor
+    {
+      /// \brief Constructor.
+      /// \param[in] _threads Number of worker threads, at least one.
+      public: explicit Executor(const unsigned int _threads = 1);
+
+      /// \brief Destructor. Jobs that did not start are discarded. Waits
+      /// for the running jobs to complete, unless it is called from one of
+      /// them.
+      public: virtual ~Executor();
+
+      /// \brief Queue a job. Jobs start in the order they are posted.
+      /// \param[in] _job Function to run on a worker thread.
+      public: void Post(const std::function<void()> &_job);
+
+      /// \brief Get the number of worker threads.
+      /// \return Number of worker threads.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Get the number of jobs that did not start yet.
+      /// \return Number of queued jobs.
+      public: unsigned int Pending() const;
+
+      /// \brief Get the executor shared by the nodes of the process that
+      /// do not need a dedicated thread. It has one thread per hardware
+      /// thread, and at least two.
+      /// \return The shared executor.
+      public: static ExecutorPtr Pool();
+
+      /// \internal
+      /// \brief Private data pointer. It is shared with the worker threads,
+      /// which can outlive the executor when it is destroyed by one of its
+      /// own jobs.
+      private: std::shared_ptr<ExecutorPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "gazebo/transport/Executor.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ExecutorTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ExecutorTest, Order)
+{
+  transport::Executor executor;
+  EXPECT_EQ(executor.ThreadCount(), 1u);
+
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  for (int i = 0; i < 100; ++i)
+  {
+    executor.Post([&, i]()
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(i);
+        });
+  }
+  executor.Post([&]() { done.set_value(); });
+
+  ASSERT_EQ(std::future_status::ready,
+      done.get_future().wait_for(std::chrono::seconds(5)));
+  EXPECT_EQ(executor.Pending(), 0u);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(order.size(), 100u);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(order[i], i);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ExecutorTest, Concurrent)
+{
+  transport::Executor executor(2);
+  EXPECT_EQ(executor.ThreadCount(), 2u);
+
+  // The first job blocks until the second one runs, which requires the
+  // two jobs to run on different threads.
+  std::promise<void> second;
+  std::shared_future<void> secondRan = second.get_future().share();
+  std::promise<bool> first;
+  executor.Post([&]()
+      {
+        first.set_value(secondRan.wait_for(std::chrono::seconds(5)) ==
+            std::future_status::ready);
+      });
+  executor.Post([&]() { second.set_value(); });
+
+  EXPECT_TRUE(first.get_future().get());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ExecutorTest, Destroy)
+{
+  // Jobs that did not start are discarded
+  std::atomic<int> count(0);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> started;
+  std::thread releaser;
+  {
+    transport::Executor executor;
+    executor.Post([&]()
+        {
+          started.set_value();
+          released.wait();
+          ++count;
+        });
+    for (int i = 0; i < 10; ++i)
+      executor.Post([&]() { ++count; });
+
+    started.get_future().wait();
+    EXPECT_EQ(executor.Pending(), 10u);
+
+    // Let the running job complete while the executor is destroyed
+    releaser = std::thread([&]()
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          release.set_value();
+        });
+  }
+  releaser.join();
+  EXPECT_EQ(count, 1);
+
+  // An executor can be destroyed by one of its own jobs
+  transport::ExecutorPtr executor(new transport::Executor);
+  std::promise<void> posted;
+  std::shared_future<void> postedReady = posted.get_future().share();
+  std::promise<void> done;
+  executor->Post([&executor, &done, postedReady]()
+      {
+        postedReady.wait();
+        executor.reset();
+        done.set_value();
+      });
+  posted.set_value();
+  EXPECT_EQ(std::future_status::ready,
+      done.get_future().wait_for(std::chrono::seconds(5)));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ExecutorTest, Pool)
+{
+  transport::ExecutorPtr pool = transport::Executor::Pool();
+  ASSERT_NE(nullptr, pool);
+  EXPECT_GE(pool->ThreadCount(), 2u);
+  EXPECT_EQ(pool, transport::Executor::Pool());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
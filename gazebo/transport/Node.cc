@@ -14,8 +14,14 @@
  * limitations under the License.
  *
 */
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
+#include <set>
+#include <vector>
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Executor.hh"
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
 
@@ -26,6 +32,186 @@ unsigned int Node::idCounter = 0;
 
 extern void dummy_callback_fn(uint32_t);
 
+/////////////////////////////////////////////////
+/// \brief Add the poses of an older message to a newer one, except the
+/// poses of entities the newer message already has.
+/// \param[in] _older Older message.
+/// \param[in,out] _newer Newer message.
+static void MergePoses(const msgs::PosesStamped &_older,
+    msgs::PosesStamped &_newer)
+{
+  std::set<uint32_t> ids;
+  std::set<std::string> names;
+  for (int i = 0; i < _newer.pose_size(); ++i)
+  {
+    if (_newer.pose(i).has_id())
+      ids.insert(_newer.pose(i).id());
+    else
+      names.insert(_newer.pose(i).name());
+  }
+
+  for (int i = 0; i < _older.pose_size(); ++i)
+  {
+    const msgs::Pose &pose = _older.pose(i);
+    if (pose.has_id() ? ids.count(pose.id()) == 0 :
+        names.count(pose.name()) == 0)
+    {
+      _newer.add_pose()->CopyFrom(pose);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief A pose field of a serialized msgs::PosesStamped.
+struct SerializedPose
+{
+  /// \brief Offset of the field, tag included.
+  int offset = 0;
+
+  /// \brief Size of the field, tag included.
+  int size = 0;
+
+  /// \brief True if the pose has an id.
+  bool hasId = false;
+
+  /// \brief Id of the entity.
+  uint32_t id = 0;
+
+  /// \brief Name of the entity, used when it has no id.
+  std::string name;
+};
+
+/////////////////////////////////////////////////
+/// \brief Find the pose fields of a serialized msgs::PosesStamped and the
+/// entity of each pose, without parsing the message.
+/// \param[in] _data Serialized message.
+/// \param[out] _poses The pose fields.
+/// \return False if the message is malformed.
+static bool ScanPoses(const std::string &_data,
+    std::vector<SerializedPose> &_poses)
+{
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t *>(_data.data()),
+      static_cast<int>(_data.size()));
+  for (;;)
+  {
+    SerializedPose pose;
+    pose.offset = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0)
+      return pose.offset == static_cast<int>(_data.size());
+
+    if (tag != WireFormatLite::MakeTag(msgs::PosesStamped::kPoseFieldNumber,
+          WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+    {
+      if (!WireFormatLite::SkipField(&input, tag))
+        return false;
+      continue;
+    }
+
+    uint32_t length;
+    if (!input.ReadVarint32(&length))
+      return false;
+    auto limit = input.PushLimit(static_cast<int>(length));
+    for (uint32_t field = input.ReadTag(); field != 0;
+         field = input.ReadTag())
+    {
+      if (field == WireFormatLite::MakeTag(msgs::Pose::kIdFieldNumber,
+            WireFormatLite::WIRETYPE_VARINT))
+      {
+        if (!input.ReadVarint32(&pose.id))
+          return false;
+        pose.hasId = true;
+      }
+      else if (field == WireFormatLite::MakeTag(msgs::Pose::kNameFieldNumber,
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+      {
+        uint32_t size;
+        if (!input.ReadVarint32(&size) ||
+            !input.ReadString(&pose.name, static_cast<int>(size)))
+        {
+          return false;
+        }
+      }
+      else if (!WireFormatLite::SkipField(&input, field))
+      {
+        return false;
+      }
+    }
+    if (!input.ConsumedEntireMessage())
+      return false;
+    input.PopLimit(limit);
+
+    pose.size = input.CurrentPosition() - pose.offset;
+    _poses.push_back(std::move(pose));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Same as MergePoses, on serialized messages. The pose fields of
+/// the older message are copied as they are, neither message is parsed or
+/// serialized again.
+/// \param[in] _older Older serialized message.
+/// \param[in] _newer Newer serialized message.
+/// \param[out] _merged The newer message followed by the poses of the
+/// older message that are kept.
+/// \return False if a message is malformed.
+static bool MergeSerializedPoses(const std::string &_older,
+    const std::string &_newer, std::string &_merged)
+{
+  std::vector<SerializedPose> olderPoses;
+  std::vector<SerializedPose> newerPoses;
+  if (!ScanPoses(_older, olderPoses) || !ScanPoses(_newer, newerPoses))
+    return false;
+
+  std::set<uint32_t> ids;
+  std::set<std::string> names;
+  for (auto const &pose : newerPoses)
+  {
+    if (pose.hasId)
+      ids.insert(pose.id);
+    else
+      names.insert(pose.name);
+  }
+
+  _merged = _newer;
+  for (auto const &pose : olderPoses)
+  {
+    if (pose.hasId ? ids.count(pose.id) == 0 : names.count(pose.name) == 0)
+      _merged.append(_older, pose.offset, pose.size);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Make room in a bounded queue for a new message.
+/// \param[in,out] _queue Queue of messages.
+/// \param[in] _limit Queue depth and policy.
+/// \param[in,out] _dropped Number of dropped messages.
+/// \return False if the new message must be dropped.
+template<typename T>
+static bool MakeRoom(std::list<T> &_queue,
+    const std::pair<unsigned int, QueuePolicy> &_limit, uint64_t &_dropped)
+{
+  if (_queue.size() < _limit.first)
+    return true;
+
+  if (_limit.second == QueuePolicy::DROP_NEWEST)
+  {
+    ++_dropped;
+    return false;
+  }
+
+  while (!_queue.empty() && _queue.size() >= _limit.first)
+  {
+    _queue.pop_front();
+    ++_dropped;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 Node::Node()
 {
@@ -64,7 +250,7 @@ void Node::Fini()
   }
 
   {
-    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    boost::recursive_mutex::scoped_lock lock(this->processIncomingMutex);
     this->callbacks.clear();
   }
 }
@@ -150,7 +336,7 @@ std::string Node::GetTopicNamespace() const
 }
 
 /////////////////////////////////////////////////
-std::string Node::DecodeTopicName(const std::string &_topic)
+std::string Node::DecodeTopicName(const std::string &_topic) const
 {
   std::string result = _topic;
   boost::replace_first(result, "~", "/gazebo/" + this->topicNamespace);
@@ -194,8 +380,35 @@ void Node::ProcessPublishers()
 /////////////////////////////////////////////////
 bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 {
-  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    std::list<std::string> &queue = this->incomingMsgs[_topic];
+
+    auto limit = this->queueLimits.find(_topic);
+    if (limit == this->queueLimits.end())
+    {
+      queue.push_back(_msg);
+    }
+    else
+    {
+      uint64_t &dropped = this->droppedCounts[_topic];
+
+      // The queued message is merged on the wire format, it is only parsed
+      // once when it is delivered
+      std::string merged;
+      if (limit->second.second == QueuePolicy::LATEST_PER_ENTITY &&
+          !queue.empty() && MergeSerializedPoses(queue.back(), _msg, merged))
+      {
+        queue.back().swap(merged);
+        ++dropped;
+      }
+      else if (MakeRoom(queue, limit->second, dropped))
+      {
+        queue.push_back(_msg);
+      }
+    }
+  }
+
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
@@ -203,99 +416,230 @@ bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 /////////////////////////////////////////////////
 bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
 {
-  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgsLocal[_topic].push_back(_msg);
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    std::list<MessagePtr> &queue = this->incomingMsgsLocal[_topic];
+
+    auto limit = this->queueLimits.find(_topic);
+    if (limit == this->queueLimits.end())
+    {
+      queue.push_back(_msg);
+    }
+    else
+    {
+      uint64_t &dropped = this->droppedCounts[_topic];
+
+      const msgs::PosesStamped *older = queue.empty() ? nullptr :
+        dynamic_cast<const msgs::PosesStamped *>(queue.back().get());
+      const msgs::PosesStamped *newer =
+        dynamic_cast<const msgs::PosesStamped *>(_msg.get());
+
+      if (limit->second.second == QueuePolicy::LATEST_PER_ENTITY &&
+          older && newer)
+      {
+        // The messages are shared with other subscribers, merge into a copy
+        boost::shared_ptr<msgs::PosesStamped> merged(
+            new msgs::PosesStamped(*newer));
+        MergePoses(*older, *merged);
+        queue.back() = merged;
+        ++dropped;
+      }
+      else if (MakeRoom(queue, limit->second, dropped))
+      {
+        queue.push_back(_msg);
+      }
+    }
+  }
+
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
 
+/////////////////////////////////////////////////
+void Node::SetQueueLimit(const std::string &_topic,
+    const unsigned int _depth, const QueuePolicy _policy)
+{
+  std::string decodedTopic = this->DecodeTopicName(_topic);
+
+  std::pair<unsigned int, QueuePolicy> limit(_depth, _policy);
+  if (_policy == QueuePolicy::LATEST_PER_ENTITY)
+  {
+    if (this->GetMsgType(decodedTopic) == "gazebo.msgs.PosesStamped")
+    {
+      limit.first = 1;
+    }
+    else
+    {
+      gzwarn << "Topic[" << decodedTopic << "] is not subscribed with "
+             << "PosesStamped messages, using DROP_OLDEST instead of "
+             << "LATEST_PER_ENTITY.\n";
+      limit.second = QueuePolicy::DROP_OLDEST;
+    }
+  }
+
+  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+  if (limit.first == 0)
+  {
+    this->queueLimits.erase(decodedTopic);
+    return;
+  }
+
+  this->queueLimits[decodedTopic] = limit;
+  this->droppedCounts.insert(std::make_pair(decodedTopic, 0u));
+
+  // Apply the new limit to the messages already queued
+  uint64_t &dropped = this->droppedCounts[decodedTopic];
+  auto remote = this->incomingMsgs.find(decodedTopic);
+  if (remote != this->incomingMsgs.end())
+  {
+    while (remote->second.size() > limit.first)
+    {
+      remote->second.pop_front();
+      ++dropped;
+    }
+  }
+  auto local = this->incomingMsgsLocal.find(decodedTopic);
+  if (local != this->incomingMsgsLocal.end())
+  {
+    while (local->second.size() > limit.first)
+    {
+      local->second.pop_front();
+      ++dropped;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+uint64_t Node::DroppedCount(const std::string &_topic) const
+{
+  std::string decodedTopic = this->DecodeTopicName(_topic);
+
+  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+  auto iter = this->droppedCounts.find(decodedTopic);
+  return iter != this->droppedCounts.end() ? iter->second : 0u;
+}
+
+/////////////////////////////////////////////////
+std::map<std::string, uint64_t> Node::DroppedCounts() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+  return this->droppedCounts;
+}
+
 /////////////////////////////////////////////////
 void Node::ProcessIncoming()
 {
   boost::recursive_mutex::scoped_lock lock(this->processIncomingMutex);
 
-  if (!this->initialized ||
-      (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty()))
+  if (!this->initialized)
     return;
 
+  // Take the messages out of the buffers so that new messages can be
+  // received while the callbacks run.
+  std::map<std::string, std::list<std::string> > msgs;
+  std::map<std::string, std::list<MessagePtr> > msgsLocal;
+  {
+    boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
+    if (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty())
+      return;
+
+    msgs.swap(this->incomingMsgs);
+    msgsLocal.swap(this->incomingMsgsLocal);
+  }
+
   Callback_M::iterator cbIter;
   Callback_L::iterator liter;
 
   // For each topic
+  for (auto const &topicMsgs : msgs)
   {
-    std::list<std::string>::iterator msgIter;
-    std::map<std::string, std::list<std::string> >::iterator inIter;
-    std::map<std::string, std::list<std::string> >::iterator endIter;
-
-    boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
-    inIter = this->incomingMsgs.begin();
-    endIter = this->incomingMsgs.end();
+    // Find the callbacks for the topic
+    cbIter = this->callbacks.find(topicMsgs.first);
+    if (cbIter == this->callbacks.end())
+      continue;
 
-    for (; inIter != endIter; ++inIter)
+    // For each message in the buffer
+    for (auto const &msg : topicMsgs.second)
     {
-      // Find the callbacks for the topic
-      cbIter = this->callbacks.find(inIter->first);
-      if (cbIter != this->callbacks.end())
+      // Send the message to all callbacks
+      for (liter = cbIter->second.begin();
+          liter != cbIter->second.end(); ++liter)
       {
-        std::list<std::string>::iterator msgInIter;
-        std::list<std::string>::iterator msgEndIter;
+        (*liter)->HandleData(msg, boost::bind(&dummy_callback_fn, _1), 0);
+      }
+    }
+  }
 
-        msgInIter = inIter->second.begin();
-        msgEndIter = inIter->second.end();
+  for (auto const &topicMsgs : msgsLocal)
+  {
+    // Find the callbacks for the topic
+    cbIter = this->callbacks.find(topicMsgs.first);
+    if (cbIter == this->callbacks.end())
+      continue;
 
-        // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
-        {
-          // Send the message to all callbacks
-          for (liter = cbIter->second.begin();
-              liter != cbIter->second.end(); ++liter)
-          {
-            (*liter)->HandleData(*msgIter,
-                boost::bind(&dummy_callback_fn, _1), 0);
-          }
-        }
+    // For each message in the buffer
+    for (auto const &msg : topicMsgs.second)
+    {
+      // Send the message to all callbacks
+      for (liter = cbIter->second.begin();
+          liter != cbIter->second.end(); ++liter)
+      {
+        (*liter)->HandleMessage(msg);
       }
     }
+  }
+}
 
-    this->incomingMsgs.clear();
+/////////////////////////////////////////////////
+void Node::DispatchIncoming()
+{
+  ExecutorPtr exec = this->CallbackExecutor();
+  if (!exec)
+  {
+    this->ProcessIncoming();
+    return;
   }
 
   {
-    std::list<MessagePtr>::iterator msgIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator inIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator endIter;
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    if (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty())
+      return;
+  }
 
-    boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
-    inIter = this->incomingMsgsLocal.begin();
-    endIter = this->incomingMsgsLocal.end();
+  // A queued job processes every message received before it starts
+  if (this->dispatchQueued.exchange(true))
+    return;
 
-    for (; inIter != endIter; ++inIter)
-    {
-      // Find the callbacks for the topic
-      cbIter = this->callbacks.find(inIter->first);
-      if (cbIter != this->callbacks.end())
+  boost::weak_ptr<Node> weak(shared_from_this());
+  exec->Post([weak]()
       {
-        std::list<MessagePtr>::iterator msgInIter;
-        std::list<MessagePtr>::iterator msgEndIter;
-
-        msgInIter = inIter->second.begin();
-        msgEndIter = inIter->second.end();
-
-        // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        NodePtr node = weak.lock();
+        if (node)
         {
-          // Send the message to all callbacks
-          for (liter = cbIter->second.begin();
-              liter != cbIter->second.end(); ++liter)
-          {
-            (*liter)->HandleMessage(*msgIter);
-          }
+          node->dispatchQueued = false;
+          node->ProcessIncoming();
         }
-      }
-    }
+      });
+}
 
-    this->incomingMsgsLocal.clear();
+/////////////////////////////////////////////////
+void Node::SetCallbackExecutor(ExecutorPtr _executor)
+{
+  {
+    boost::mutex::scoped_lock lock(this->executorMutex);
+    this->executor = _executor;
   }
+  this->dispatchQueued = false;
+
+  // Messages received in the meantime are dispatched on the next update
+  ConnectionManager::Instance()->TriggerUpdate();
+}
+
+/////////////////////////////////////////////////
+ExecutorPtr Node::CallbackExecutor() const
+{
+  boost::mutex::scoped_lock lock(this->executorMutex);
+  return this->executor;
 }
 
 //////////////////////////////////////////////////
@@ -366,7 +710,7 @@ void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
   if (!this->initialized)
     return;
 
-  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+  boost::recursive_mutex::scoped_lock lock(this->processIncomingMutex);
 
   // Find the topic list in the map.
   Callback_M::iterator iter = this->callbacks.find(_topic);
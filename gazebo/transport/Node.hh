@@ -21,9 +21,11 @@
 #include <tbb/task.h>
 #include <boost/bind.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <atomic>
 #include <map>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -72,6 +74,26 @@ namespace gazebo
     /// \addtogroup gazebo_transport
     /// \{
 
+    /// \enum QueuePolicy
+    /// \brief What a node does with a message received on a topic whose
+    /// incoming queue is full.
+    /// \sa Node::SetQueueLimit
+    enum class QueuePolicy
+    {
+      /// \brief Discard the oldest queued message, so that the queue keeps
+      /// the latest messages.
+      DROP_OLDEST,
+
+      /// \brief Discard the received message.
+      DROP_NEWEST,
+
+      /// \brief Merge the received msgs::PosesStamped message into the
+      /// queued one, keeping the latest pose of each entity. The queue holds
+      /// at most one message. Other message types are treated as
+      /// DROP_OLDEST.
+      LATEST_PER_ENTITY
+    };
+
     /// \class Node Node.hh transport/transport.hh
     /// \brief A node can advertise and subscribe topics, publish on
     ///        advertised topics and listen to subscribed topics.
@@ -124,7 +146,7 @@ namespace gazebo
       /// \brief Decode a topic name
       /// \param[in] The encoded name
       /// \return The decoded name
-      public: std::string DecodeTopicName(const std::string &_topic);
+      public: std::string DecodeTopicName(const std::string &_topic) const;
 
       /// \brief Encode a topic name
       /// \param[in] The decoded name
@@ -142,6 +164,51 @@ namespace gazebo
       /// \brief Process incoming messages.
       public: void ProcessIncoming();
 
+      /// \brief Process incoming messages on the callback executor of the
+      /// node, or on the calling thread if the node has none. This is for
+      /// internal use only.
+      /// \sa SetCallbackExecutor
+      public: void DispatchIncoming();
+
+      /// \brief Set the executor that runs the subscriber callbacks of this
+      /// node. Nodes without an executor have their callbacks run on the
+      /// connection manager thread, one node after the other.
+      /// \param[in] _executor Executor to use, for example
+      /// Executor::Pool() or a dedicated Executor. Null to run the
+      /// callbacks on the connection manager thread.
+      public: void SetCallbackExecutor(ExecutorPtr _executor);
+
+      /// \brief Get the executor that runs the subscriber callbacks of this
+      /// node.
+      /// \return The executor, null if the callbacks run on the connection
+      /// manager thread.
+      public: ExecutorPtr CallbackExecutor() const;
+
+      /// \brief Bound the queue of messages received on a topic and not yet
+      /// delivered to the callbacks of this node. The limit is enforced when
+      /// a message is received, and applies to all the subscriptions of
+      /// this node on the topic. Queues are unbounded by default.
+      /// \param[in] _topic Name of the topic.
+      /// \param[in] _depth Maximum number of queued messages, 0 for no
+      /// limit.
+      /// \param[in] _policy What to do with a message received when the
+      /// queue is full.
+      /// \sa DroppedCount
+      public: void SetQueueLimit(const std::string &_topic,
+                  const unsigned int _depth,
+                  const QueuePolicy _policy = QueuePolicy::DROP_OLDEST);
+
+      /// \brief Get the number of messages received on a topic that were
+      /// discarded or merged because its queue was full.
+      /// \param[in] _topic Name of the topic.
+      /// \return Number of dropped messages.
+      public: uint64_t DroppedCount(const std::string &_topic) const;
+
+      /// \brief Get the number of dropped messages of every topic with a
+      /// queue limit.
+      /// \return Number of dropped messages by decoded topic name.
+      public: std::map<std::string, uint64_t> DroppedCounts() const;
+
       /// \brief Return true if a subscriber on a specific topic is latched.
       /// \param[in] _topic Name of the topic to check.
       /// \return True if a latched subscriber exists.
@@ -247,7 +314,8 @@ namespace gazebo
         ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
 
         {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+          boost::recursive_mutex::scoped_lock lock(
+              this->processIncomingMutex);
           this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
                 new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
         }
@@ -276,7 +344,8 @@ namespace gazebo
         ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
 
         {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+          boost::recursive_mutex::scoped_lock lock(
+              this->processIncomingMutex);
           this->callbacks[decodedTopic].push_back(
               CallbackHelperPtr(new CallbackHelperT<M>(_fp, _latching)));
         }
@@ -306,7 +375,8 @@ namespace gazebo
         ops.Init(decodedTopic, shared_from_this(), _latching);
 
         {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+          boost::recursive_mutex::scoped_lock lock(
+              this->processIncomingMutex);
           this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
                 new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
         }
@@ -334,7 +404,8 @@ namespace gazebo
         ops.Init(decodedTopic, shared_from_this(), _latching);
 
         {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+          boost::recursive_mutex::scoped_lock lock(
+              this->processIncomingMutex);
           this->callbacks[decodedTopic].push_back(
               CallbackHelperPtr(new RawCallbackHelper(_fp)));
         }
@@ -421,12 +492,35 @@ namespace gazebo
 
       private: boost::mutex publisherMutex;
       private: boost::mutex publisherDeleteMutex;
-      private: boost::recursive_mutex incomingMutex;
+
+      /// \brief Protects the incoming message buffers. It is only held
+      /// while messages are added or taken out of the buffers, never while
+      /// callbacks run.
+      private: mutable boost::recursive_mutex incomingMutex;
 
       /// \brief make sure we don't call ProcessingIncoming simultaneously
-      /// from separate threads.
+      /// from separate threads. Also protects the callbacks.
       private: boost::recursive_mutex processIncomingMutex;
 
+      /// \brief Queue depth and policy by decoded topic name. Protected by
+      /// incomingMutex.
+      private: std::map<std::string,
+               std::pair<unsigned int, QueuePolicy> > queueLimits;
+
+      /// \brief Number of dropped messages by decoded topic name. Protected
+      /// by incomingMutex.
+      private: std::map<std::string, uint64_t> droppedCounts;
+
+      /// \brief Executor that runs the callbacks, null to run them on the
+      /// connection manager thread.
+      private: ExecutorPtr executor;
+
+      /// \brief Protects the executor.
+      private: mutable boost::mutex executorMutex;
+
+      /// \brief True if ProcessIncoming is queued on the executor.
+      private: std::atomic<bool> dispatchQueued{false};
+
       private: bool initialized;
     };
     /// \}
@@ -70,6 +70,9 @@ void Publication::AddSubscription(const NodePtr &_node)
       _node->InsertLatchedMsg(this->topic, pubIter->second);
     }
   }
+  lock.unlock();
+
+  this->NotifyConnections();
 }
 
 //////////////////////////////////////////////////
@@ -98,6 +101,9 @@ void Publication::AddSubscription(const CallbackHelperPtr _callback)
       _callback->SetLatching(false);
     }
   }
+  lock.unlock();
+
+  this->NotifyConnections();
 }
 
 //////////////////////////////////////////////////
@@ -204,6 +210,9 @@ void Publication::RemoveSubscription(const NodePtr &_node)
   {
     this->transports.clear();
   }
+  lock.unlock();
+
+  this->NotifyConnections();
 }
 
 //////////////////////////////////////////////////
@@ -242,12 +251,16 @@ void Publication::RemoveSubscription(const std::string &_host,
   {
     this->transports.clear();
   }
+  lock.unlock();
+
+  this->NotifyConnections();
 }
 
 //////////////////////////////////////////////////
 void Publication::LocalPublish(const std::string &_data)
 {
   std::list<NodePtr>::iterator iter, endIter;
+  bool removed = false;
 
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
@@ -259,7 +272,10 @@ void Publication::LocalPublish(const std::string &_data)
       if ((*iter)->HandleData(this->topic, _data))
         ++iter;
       else
+      {
         this->nodes.erase(iter++);
+        removed = true;
+      }
     }
   }
 
@@ -280,12 +296,18 @@ void Publication::LocalPublish(const std::string &_data)
               boost::bind(&dummy_callback_fn, _1), 0))
           ++cbIter;
         else
+        {
           cbIter = this->callbacks.erase(cbIter);
+          removed = true;
+        }
       }
       else
         ++cbIter;
     }
   }
+
+  if (removed)
+    this->NotifyConnections();
 }
 
 //////////////////////////////////////////////////
@@ -294,6 +316,7 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
 {
   int result = 0;
   std::list<NodePtr>::iterator iter, endIter;
+  bool removed = false;
 
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
@@ -305,7 +328,10 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
       if ((*iter)->HandleMessage(this->topic, _msg))
         ++iter;
       else
+      {
         this->nodes.erase(iter++);
+        removed = true;
+      }
     }
   }
 
@@ -332,7 +358,10 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
           ++cbIter;
         }
         else
+        {
           this->callbacks.erase(cbIter++);
+          removed = true;
+        }
       }
 
       if (this->callbacks.empty() && !_cb.empty())
@@ -346,6 +375,9 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     }
   }
 
+  if (removed)
+    this->NotifyConnections();
+
   return result;
 }
 
@@ -448,6 +480,8 @@ bool Publication::RemovePublisher(const uint32_t _id)
 void Publication::RemoveNodes()
 {
   boost::mutex::scoped_lock removeLock(this->nodeRemoveMutex);
+  const bool removed =
+      !this->removeNodes.empty() || !this->removeCallbacks.empty();
 
   // Remove queued nodes.
   {
@@ -512,6 +546,30 @@ void Publication::RemoveNodes()
       this->transports.clear();
     }
   }
+
+  if (removed)
+    this->NotifyConnections();
+}
+
+//////////////////////////////////////////////////
+event::ConnectionPtr Publication::ConnectConnectionsChanged(
+    std::function<void (const bool)> _subscriber)
+{
+  boost::mutex::scoped_lock lock(this->connectedMutex);
+  return this->connectionsChanged.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Publication::NotifyConnections()
+{
+  boost::mutex::scoped_lock lock(this->connectedMutex);
+  const bool hasConnections =
+      this->GetCallbackCount() > 0 || this->GetNodeCount() > 0;
+  if (hasConnections != this->connected)
+  {
+    this->connected = hasConnections;
+    this->connectionsChanged(hasConnections);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -22,11 +22,13 @@
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
 #include <map>
 
+#include "gazebo/common/Event.hh"
 #include "gazebo/transport/CallbackHelper.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/PublicationTransport.hh"
@@ -164,9 +166,24 @@ namespace gazebo
       /// \param[in,out] _pub Pointer to publisher object to be added
       public: void AddPublisher(PublisherPtr _pub);
 
+      /// \brief Connect to the changes of whether the publication has
+      /// subscribers, which happen when the first subscriber connects and
+      /// when the last one disconnects.
+      /// \param[in] _subscriber Callback, called with true when the
+      /// publication gets subscribers and false when it loses them. It
+      /// must not change the subscriptions of the publication.
+      /// \return Connection to keep for as long as the callback is needed.
+      public: event::ConnectionPtr ConnectConnectionsChanged(
+                  std::function<void (const bool)> _subscriber);
+
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
+      /// \brief Signal connectionsChanged if the publication got its first
+      /// subscriber or lost its last one since the previous call. Must be
+      /// called without holding the node and callback mutexes.
+      private: void NotifyConnections();
+
       /// \brief Unique if of the publication.
       private: unsigned int id;
 
@@ -211,6 +228,18 @@ namespace gazebo
 
       /// \brief Publishers and their last messages.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
+
+      /// \brief True if the publication had subscribers at the last call
+      /// to NotifyConnections.
+      private: bool connected = false;
+
+      /// \brief Signaled when the publication gets its first subscriber
+      /// or loses its last one.
+      private: event::EventT<void (const bool)> connectionsChanged;
+
+      /// \brief Serializes NotifyConnections and the connections to
+      /// connectionsChanged.
+      private: boost::mutex connectedMutex;
     };
     /// \}
   }
@@ -60,6 +60,15 @@ bool Publisher::HasConnections() const
        this->publication->GetNodeCount() > 0));
 }
 
+//////////////////////////////////////////////////
+event::ConnectionPtr Publisher::ConnectConnectionsChanged(
+    std::function<void (const bool)> _subscriber)
+{
+  if (!this->publication)
+    return event::ConnectionPtr();
+  return this->publication->ConnectConnectionsChanged(_subscriber);
+}
+
 //////////////////////////////////////////////////
 void Publisher::WaitForConnection() const
 {
@@ -86,6 +95,31 @@ bool Publisher::WaitForConnection(const common::Time &_timeout) const
 //////////////////////////////////////////////////
 void Publisher::PublishImpl(const google::protobuf::Message &_message,
                             bool _block)
+{
+  if (!this->Accept(_message))
+    return;
+
+  // Save the latest message
+  MessagePtr msgPtr = this->RecycledMessage(_message);
+  msgPtr->CopyFrom(_message);
+
+  this->Enqueue(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+void Publisher::PublishSwap(google::protobuf::Message &_message, bool _block)
+{
+  if (!this->Accept(_message))
+    return;
+
+  MessagePtr msgPtr = this->RecycledMessage(_message);
+  msgPtr->GetReflection()->Swap(msgPtr.get(), &_message);
+
+  this->Enqueue(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+bool Publisher::Accept(const google::protobuf::Message &_message)
 {
   if (_message.GetTypeName() != this->msgType)
     gzthrow("Invalid message type\n");
@@ -95,7 +129,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     gzerr << "Publishing an uninitialized message on topic[" <<
       this->topic << "]. Required field [" <<
       _message.InitializationErrorString() << "] missing.\n";
-    return;
+    return false;
   }
 
   // Check if a throttling rate has been set
@@ -109,23 +143,48 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         (this->currentTime - this->prevPublishTime).Double() <
         this->updatePeriod)
     {
-      return;
+      return false;
     }
 
     // Set the previous time a message was published
     this->prevPublishTime = this->currentTime;
   }
 
-  // Save the latest message
+  return true;
+}
+
+//////////////////////////////////////////////////
+MessagePtr Publisher::RecycledMessage(
+    const google::protobuf::Message &_message)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  // A buffer only referenced here was replaced as latched message and has
+  // been sent. Nobody else can get a new reference to it.
+  for (auto const &buffer : this->buffers)
+  {
+    if (buffer.use_count() == 1)
+      return buffer;
+  }
+
   MessagePtr msgPtr(_message.New());
-  msgPtr->CopyFrom(_message);
 
-  this->publication->SetPrevMsg(this->id, msgPtr);
+  // Keep a few buffers, enough for a publisher that is not backlogged.
+  if (this->buffers.size() < 4)
+    this->buffers.push_back(msgPtr);
+
+  return msgPtr;
+}
+
+//////////////////////////////////////////////////
+void Publisher::Enqueue(MessagePtr _msgPtr, bool _block)
+{
+  this->publication->SetPrevMsg(this->id, _msgPtr);
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    this->messages.push_back(_msgPtr);
 
     if (this->messages.size() > this->queueLimit)
     {
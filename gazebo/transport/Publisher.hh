@@ -24,10 +24,13 @@
 #include <google/protobuf/message.h>
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
+#include <functional>
 #include <string>
 #include <list>
 #include <map>
+#include <vector>
 
+#include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
@@ -60,6 +63,15 @@ namespace gazebo
       /// \return true if there are any connections, false otherwise
       public: bool HasConnections() const;
 
+      /// \brief Connect to the changes of HasConnections, which happen when
+      /// the first subscriber connects and when the last one disconnects.
+      /// \param[in] _subscriber Callback, called with the new value of
+      /// HasConnections. It must not change the subscriptions of the topic.
+      /// \return Connection to keep for as long as the callback is needed,
+      /// or nullptr if the publisher has no publication.
+      public: event::ConnectionPtr ConnectConnectionsChanged(
+                  std::function<void (const bool)> _subscriber);
+
       /// \brief Block until a connection has been established with this
       ///        publisher
       public: void WaitForConnection() const;
@@ -101,6 +113,20 @@ namespace gazebo
               void Publish(M _message, bool _block = false)
               { this->PublishImpl(_message, _block); }
 
+      /// \brief Publish a protobuf message on the topic by swapping its
+      /// content into a buffer owned by the publisher, instead of copying it.
+      /// On return, _message holds the content of a previously published
+      /// message that is no longer in use, or is empty. Clearing a protobuf
+      /// message keeps the memory of its repeated and string fields, so a
+      /// message that is cleared and refilled before each call to this
+      /// function is published without any allocation once the buffers have
+      /// grown. Nothing is swapped if the message is dropped because of the
+      /// publication rate limit.
+      /// \param[in,out] _message Message to be published.
+      /// \param[in] _block Same as in Publish.
+      public: void PublishSwap(google::protobuf::Message &_message,
+                  bool _block = false);
+
       /// \brief Get the number of outgoing messages
       /// \return The number of outgoing messages
       public: unsigned int GetOutgoingCount() const;
@@ -147,6 +173,24 @@ namespace gazebo
       private: void PublishImpl(const google::protobuf::Message &_message,
                                 bool _block);
 
+      /// \brief Check whether a message can be published, and apply the
+      /// publication rate limit.
+      /// \param[in] _message Message to be published.
+      /// \return True if the message must be published.
+      private: bool Accept(const google::protobuf::Message &_message);
+
+      /// \brief Get a message buffer that is not referenced anywhere else,
+      /// to hold the next published message.
+      /// \param[in] _message Message of the type of the buffer.
+      /// \return A buffer, with unspecified content.
+      private: MessagePtr RecycledMessage(
+                   const google::protobuf::Message &_message);
+
+      /// \brief Latch a message and queue it for publication.
+      /// \param[in] _msgPtr Message to publish.
+      /// \param[in] _block Whether to send it out immediately.
+      private: void Enqueue(MessagePtr _msgPtr, bool _block);
+
       /// \brief Callback when a publish is completed
       /// \param[in] _id ID associated with the publication.
       private: void OnPublishComplete(uint32_t _id);
@@ -172,6 +216,10 @@ namespace gazebo
       /// \brief List of messages to publish.
       private: std::list<MessagePtr> messages;
 
+      /// \brief Buffers of published messages. A buffer is reused once the
+      /// latched message and the outgoing queue no longer reference it.
+      private: std::vector<MessagePtr> buffers;
+
       /// \brief For mutual exclusion.
       private: mutable boost::mutex mutex;
 
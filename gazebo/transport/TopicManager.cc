@@ -193,7 +193,7 @@ void TopicManager::ProcessNodes(bool _onlyOut)
 
       for (int i = 0; i < s; ++i)
       {
-        this->nodes[i]->ProcessIncoming();
+        this->nodes[i]->DispatchIncoming();
         if (this->pauseIncoming)
           break;
       }
@@ -201,6 +201,21 @@ void TopicManager::ProcessNodes(bool _onlyOut)
   }
 }
 
+//////////////////////////////////////////////////
+std::map<std::string, uint64_t> TopicManager::DroppedCounts()
+{
+  std::map<std::string, uint64_t> result;
+
+  boost::recursive_mutex::scoped_lock lock(this->nodeMutex);
+  for (auto const &node : this->nodes)
+  {
+    for (auto const &dropped : node->DroppedCounts())
+      result[dropped.first] += dropped.second;
+  }
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 void TopicManager::Publish(const std::string &_topic, MessagePtr _message,
     boost::function<void(uint32_t)> _cb, uint32_t _id)
@@ -81,6 +81,12 @@ namespace gazebo
       /// sent. False means nodes process both outbound and inbound messages
       public: void ProcessNodes(bool _onlyOut = false);
 
+      /// \brief Get the number of incoming messages dropped by the nodes
+      /// of this process because of their queue limits.
+      /// \return Sum over the nodes of the dropped messages, by topic.
+      /// \sa Node::SetQueueLimit
+      public: std::map<std::string, uint64_t> DroppedCounts();
+
       /// \brief Subscribe to a topic
       /// \param[in] _options The options to use for the subscription
       /// \return Pointer to the newly created subscriber
@@ -39,6 +39,7 @@ namespace gazebo
     class Subscriber;
     class SubscriptionTransport;
     class Node;
+    class Executor;
 
     /// \def MessagePtr
     /// \brief Shared_ptr to protobuf message
@@ -67,6 +68,10 @@ namespace gazebo
     /// \def SubscriptionTransportPtr
     /// \brief Shared_ptr to SubscriptionTransportPtr
     typedef boost::shared_ptr<SubscriptionTransport> SubscriptionTransportPtr;
+
+    /// \def ExecutorPtr
+    /// \brief Shared_ptr to Executor object
+    typedef boost::shared_ptr<Executor> ExecutorPtr;
   }
 }
 #endif
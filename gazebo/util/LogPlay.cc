@@ -23,6 +23,9 @@
 #endif
 
 #include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <thread>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
@@ -48,21 +51,76 @@
 using namespace gazebo;
 using namespace util;
 
+/////////////////////////////////////////////////
+/// \brief Decode the chunks queued in a read ahead pool, until it stops.
+/// \param[in] _pool The pool, kept alive by the worker.
+static void ReadAheadWorker(std::shared_ptr<LogReadAheadPool> _pool)
+{
+  std::unique_lock<std::mutex> lock(_pool->mutex);
+  while (true)
+  {
+    _pool->queued.wait(lock, [&]()
+        {
+          return _pool->stop || !_pool->queue.empty();
+        });
+    if (_pool->stop)
+    {
+      --_pool->workers;
+      _pool->decoded.notify_all();
+      return;
+    }
+
+    std::shared_ptr<LogReadAheadChunk> chunk = _pool->queue.front();
+    _pool->queue.pop_front();
+    if (chunk->cancelled)
+      continue;
+    chunk->started = true;
+    lock.unlock();
+
+    std::string data;
+    if (!LogPlay::DecodeChunk(chunk->encoding, chunk->text, data))
+      data.clear();
+
+    lock.lock();
+    chunk->data.swap(data);
+    chunk->text.clear();
+    chunk->done = true;
+    _pool->decoded.notify_all();
+  }
+}
+
 /////////////////////////////////////////////////
 LogPlay::LogPlay()
 : dataPtr(new LogPlayPrivate)
 {
   this->dataPtr->logStartXml = NULL;
+  this->dataPtr->readAheadChunks =
+    std::min(8u, std::max(2u, std::thread::hardware_concurrency()));
 }
 
 /////////////////////////////////////////////////
 LogPlay::~LogPlay()
 {
+  this->dataPtr->ClearReadAhead();
+
+  // Decoding uses static data, which must outlive the workers. This waits
+  // for at most the chunks being decoded, the queue is dropped.
+  auto pool = this->dataPtr->readAheadPool;
+  std::unique_lock<std::mutex> lock(pool->mutex);
+  pool->queue.clear();
+  pool->stop = true;
+  pool->queued.notify_all();
+  pool->decoded.wait(lock, [&]()
+      {
+        return pool->workers == 0;
+      });
 }
 
 /////////////////////////////////////////////////
 void LogPlay::Open(const std::string &_logFile)
 {
+  this->dataPtr->ClearReadAhead();
+  this->dataPtr->chunks.clear();
   this->dataPtr->currentChunk.clear();
 
   boost::filesystem::path path(_logFile);
@@ -141,6 +199,13 @@ void LogPlay::Open(const std::string &_logFile)
   if (!this->dataPtr->logStartXml)
     gzthrow("Log file is missing the <gazebo_log> element");
 
+  // Index the chunks, for random access
+  for (auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+       xml; xml = xml->NextSiblingElement("chunk"))
+  {
+    this->dataPtr->chunks.push_back(xml);
+  }
+
   // Store the filename for future use.
   this->dataPtr->filename = _logFile;
 
@@ -170,6 +235,8 @@ void LogPlay::Open(const std::string &_logFile)
 
   this->dataPtr->start = 0;
   this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
+
+  this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, true);
 }
 
 /////////////////////////////////////////////////
@@ -567,6 +634,8 @@ bool LogPlay::Rewind()
   this->dataPtr->start = 0;
   this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
 
+  this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, true);
+
   return true;
 }
 
@@ -594,12 +663,27 @@ bool LogPlay::Forward()
   this->dataPtr->start = this->dataPtr->currentChunk.size() - 1;
   this->dataPtr->end = this->dataPtr->currentChunk.size() - 1;
 
+  // Playback usually steps back from the end
+  this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, false);
+
   return true;
 }
 
 /////////////////////////////////////////////////
 bool LogPlay::Seek(const common::Time &_time)
 {
+  // Only the chunk the seek ends in is read ahead from
+  this->dataPtr->seeking = true;
+  this->dataPtr->ClearReadAhead();
+  struct SeekGuard
+  {
+    ~SeekGuard()
+    {
+      this->data->seeking = false;
+    }
+    LogPlayPrivate *data;
+  } seekGuard{this->dataPtr.get()};
+
   if (_time >= this->dataPtr->logEndTime)
   {
     this->Forward();
@@ -684,27 +768,24 @@ bool LogPlay::Seek(const common::Time &_time)
     }
   }
 
+  // Playback resumes forward from here
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->seeking = false;
+    this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, true);
+  }
+
   return true;
 }
 
 /////////////////////////////////////////////////
 bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
 {
-  unsigned int count = 0;
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  while (this->dataPtr->logCurrXml && count < _index)
-  {
-    count++;
-    this->dataPtr->logCurrXml =
-      this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  }
-
-  if (this->dataPtr->logCurrXml && count == _index)
-    return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
-  else
+  if (_index >= this->dataPtr->chunks.size())
     return false;
+
+  this->dataPtr->logCurrXml = this->dataPtr->chunks[_index];
+  return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
 }
 
 /////////////////////////////////////////////////
@@ -728,15 +809,261 @@ bool LogPlayPrivate::ChunkData(
     gzthrow("Encoding missing for a chunk in log file[" + this->filename + "]");
   }
 
-  if (this->encoding == "txt")
-    _data = _xml->GetText();
-  else if (this->encoding == "bz2")
+  // The chunk may have been decoded in the background already
+  auto iter = this->readAhead.find(_xml);
+  if (iter != this->readAhead.end())
+  {
+    std::shared_ptr<LogReadAheadChunk> chunk = iter->second;
+    this->readAhead.erase(iter);
+
+    // A chunk that no worker took yet is decoded right here
+    std::string data;
+    std::unique_lock<std::mutex> lock(this->readAheadPool->mutex);
+    if (chunk->started)
+    {
+      this->readAheadPool->decoded.wait(lock, [&]()
+          {
+            return chunk->done;
+          });
+      data.swap(chunk->data);
+    }
+    else
+    {
+      chunk->cancelled = true;
+    }
+    lock.unlock();
+
+    if (!data.empty())
+    {
+      _data.swap(data);
+      return true;
+    }
+  }
+
+  const char *text = _xml->GetText();
+  if (!LogPlay::DecodeChunk(this->encoding, text ? text : "", _data))
+  {
+    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
+      << this->filename << "]\n";
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LogPlayPrivate::ReadAhead(tinyxml2::XMLElement *_xml,
+    const bool _forward)
+{
+  std::vector<const tinyxml2::XMLElement *> window;
+  auto xml = _xml;
+  while (xml && window.size() < this->readAheadChunks)
+  {
+    xml = _forward ? xml->NextSiblingElement("chunk") :
+      xml->PreviousSiblingElement("chunk");
+    if (!xml)
+      break;
+
+    window.push_back(xml);
+    if (this->readAhead.find(xml) != this->readAhead.end())
+      continue;
+
+    // The chunks visited by a seek are not played next
+    if (this->seeking)
+      continue;
+
+    // Plain text chunks are as fast to copy as to decode
+    const char *attr = xml->Attribute("encoding");
+    std::string chunkEncoding = attr ? attr : "";
+    if (chunkEncoding.empty() || chunkEncoding == "txt")
+      continue;
+
+    // The text is copied here, the document must not be read from
+    // several threads.
+    auto chunk = std::make_shared<LogReadAheadChunk>();
+    chunk->encoding = chunkEncoding;
+    const char *text = xml->GetText();
+    chunk->text = text ? text : "";
+    this->readAhead[xml] = chunk;
+
+    std::lock_guard<std::mutex> lock(this->readAheadPool->mutex);
+    this->readAheadPool->queue.push_back(chunk);
+    if (this->readAheadPool->workers < std::min(this->readAheadChunks,
+          std::max(1u, std::thread::hardware_concurrency())))
+    {
+      std::thread(ReadAheadWorker, this->readAheadPool).detach();
+      ++this->readAheadPool->workers;
+    }
+    this->readAheadPool->queued.notify_one();
+  }
+
+  // Drop the chunks that are out of the window, e.g. after a seek or a
+  // change of direction
+  for (auto iter = this->readAhead.begin(); iter != this->readAhead.end();)
+  {
+    if (std::find(window.begin(), window.end(), iter->first) == window.end())
+    {
+      iter->second->cancelled = true;
+      iter = this->readAhead.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+/////////////////////////////////////////////////
+void LogPlayPrivate::ClearReadAhead()
+{
+  for (auto const &chunk : this->readAhead)
+    chunk.second->cancelled = true;
+  this->readAhead.clear();
+}
+
+/////////////////////////////////////////////////
+void LogPlay::SetReadAhead(const unsigned int _chunks)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->readAheadChunks = _chunks;
+  if (_chunks == 0)
+    this->dataPtr->ClearReadAhead();
+}
+
+/////////////////////////////////////////////////
+unsigned int LogPlay::ReadAhead() const
+{
+  return this->dataPtr->readAheadChunks;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::EncodedChunks(const std::function<bool(
+    const std::string &, const std::string &)> &_func) const
+{
+  if (!this->dataPtr->logStartXml)
+    return false;
+
+  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  while (xml)
+  {
+    const char *encoding = xml->Attribute("encoding");
+    const char *text = xml->GetText();
+    if (!_func(encoding ? encoding : "", text ? text : ""))
+      break;
+    xml = xml->NextSiblingElement("chunk");
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::EncodedChunks(const std::string &_logFile,
+    const std::function<bool(
+    const std::string &, const std::string &)> &_func)
+{
+  std::ifstream in(_logFile, std::ios::in | std::ios::binary);
+  if (!in || boost::filesystem::is_directory(_logFile))
+    return false;
+
+  // The file is read in blocks. Only the data from the start of the chunk
+  // being read is kept in the buffer.
+  const size_t blockSize = 1 << 20;
+  std::string buffer;
+  size_t pos = 0;
+  auto readBlock = [&]() -> bool
+  {
+    if (!in)
+      return false;
+    buffer.erase(0, pos);
+    pos = 0;
+    const size_t size = buffer.size();
+    buffer.resize(size + blockSize);
+    in.read(&buffer[size], blockSize);
+    buffer.resize(size + in.gcount());
+    return in.gcount() > 0;
+  };
+
+  const std::string openTag = "<chunk";
+  const std::string closeTag = "</chunk>";
+  const std::string cdataOpen = "<![CDATA[";
+  const std::string cdataClose = "]]>";
+  std::string encoding;
+  std::string text;
+  while (true)
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    size_t open = buffer.find(openTag, pos);
+    if (open == std::string::npos)
+    {
+      // Keep the end of the buffer, it may be the start of a tag
+      if (buffer.size() > pos + openTag.size())
+        pos = buffer.size() - openTag.size();
+      if (!readBlock())
+        break;
+      continue;
+    }
+
+    const size_t tagEnd = buffer.find('>', open);
+    const size_t close = tagEnd == std::string::npos ?
+      std::string::npos : buffer.find(closeTag, tagEnd);
+    if (close == std::string::npos)
+    {
+      pos = open;
+      if (!readBlock())
+        break;
+      continue;
+    }
+
+    // Encoding attribute of the chunk tag
+    encoding.clear();
+    const size_t attr = buffer.find("encoding", open);
+    if (attr < tagEnd)
+    {
+      const size_t quote = buffer.find_first_of("'\"", attr);
+      const size_t quoteEnd = quote < tagEnd ?
+        buffer.find(buffer[quote], quote + 1) : std::string::npos;
+      if (quoteEnd < tagEnd)
+        encoding = buffer.substr(quote + 1, quoteEnd - quote - 1);
+    }
 
+    // Text of the chunk, as TinyXML gives it for a chunk of the DOM
+    size_t textStart = buffer.find(cdataOpen, tagEnd);
+    size_t textEnd = close;
+    if (textStart < close)
+    {
+      textStart += cdataOpen.size();
+      textEnd = buffer.rfind(cdataClose, close);
+      if (textEnd == std::string::npos || textEnd < textStart)
+        textEnd = close;
+    }
+    else
+    {
+      textStart = buffer.find_first_not_of(" \t\r\n", tagEnd + 1);
+      if (textStart > close)
+        textStart = close;
+      while (textEnd > textStart && std::isspace(
+            static_cast<unsigned char>(buffer[textEnd - 1])))
+      {
+        --textEnd;
+      }
+    }
+    text.assign(buffer, textStart, textEnd - textStart);
+
+    pos = close + closeTag.size();
+    if (!_func(encoding, text))
+      break;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::DecodeChunk(const std::string &_encoding,
+    const std::string &_text, std::string &_data)
+{
+  if (_encoding == "txt")
+    _data = _text;
+  else if (_encoding == "bz2")
+  {
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(_text);
 
     // Decompress the bz2 data
     {
@@ -749,13 +1076,10 @@ bool LogPlayPrivate::ChunkData(
       _data += '\0';
     }
   }
-  else if (this->encoding == "zlib")
+  else if (_encoding == "zlib")
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
-
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(_text);
 
     // Decompress the zlib data
     {
@@ -769,11 +1093,7 @@ bool LogPlayPrivate::ChunkData(
     }
   }
   else
-  {
-    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
-      << this->filename << "]\n";
     return false;
-  }
 
   return true;
 }
@@ -787,16 +1107,7 @@ std::string LogPlay::Encoding() const
 /////////////////////////////////////////////////
 unsigned int LogPlay::ChunkCount() const
 {
-  unsigned int count = 0;
-  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  while (xml)
-  {
-    count++;
-    xml = xml->NextSiblingElement("chunk");
-  }
-
-  return count;
+  return this->dataPtr->chunks.size();
 }
 
 /////////////////////////////////////////////////
@@ -816,6 +1127,8 @@ bool LogPlay::NextChunk()
   this->dataPtr->start = 0;
   this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
 
+  this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, true);
+
   return true;
 }
 
@@ -836,5 +1149,7 @@ bool LogPlay::PrevChunk()
   this->dataPtr->start = this->dataPtr->currentChunk.size() - 1;
   this->dataPtr->end = this->dataPtr->currentChunk.size() - 1;
 
+  this->dataPtr->ReadAhead(this->dataPtr->logCurrXml, false);
+
   return true;
 }
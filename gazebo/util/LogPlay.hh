@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_UTIL_LOGPLAY_HH_
 #define _GAZEBO_UTIL_LOGPLAY_HH_
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -140,6 +141,51 @@ namespace gazebo
       /// \return True if the _index was valid.
       public: bool Chunk(const unsigned int _index, std::string &_data) const;
 
+      /// \brief Visit the encoded content of every chunk in order, without
+      /// decoding it. This walks the log once, while Chunk walks it from
+      /// the start on every call. The chunks can then be decoded with
+      /// DecodeChunk, on any thread.
+      /// \param[in] _func Function called with the encoding and the encoded
+      /// text of each chunk. Return false to stop the walk.
+      /// \return False if no log file is open.
+      public: bool EncodedChunks(const std::function<bool(
+                  const std::string &_encoding,
+                  const std::string &_text)> &_func) const;
+
+      /// \brief Visit the encoded content of every chunk of a log file in
+      /// order, without opening it. The file is read incrementally, so
+      /// only one chunk at a time is held in memory, whatever the size of
+      /// the log. Use this to walk a log that is too large to Open.
+      /// \param[in] _logFile Path of the log file.
+      /// \param[in] _func Function called with the encoding and the encoded
+      /// text of each chunk. Return false to stop the walk.
+      /// \return False if the file can't be read.
+      public: static bool EncodedChunks(const std::string &_logFile,
+                  const std::function<bool(const std::string &_encoding,
+                  const std::string &_text)> &_func);
+
+      /// \brief Decode the content of a chunk. This does not use the open
+      /// log file, and can be called from several threads at once.
+      /// \param[in] _encoding Encoding of the chunk (txt, bz2 or zlib).
+      /// \param[in] _text Encoded text of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return False if the encoding is not valid.
+      public: static bool DecodeChunk(const std::string &_encoding,
+                  const std::string &_text, std::string &_data);
+
+      /// \brief Set the number of chunks that are decoded in parallel, in
+      /// the background, ahead of Step and StepBack. Decoding a compressed
+      /// chunk takes long enough to stall playback at every chunk boundary
+      /// otherwise. The default depends on the number of cores.
+      /// \param[in] _chunks Number of chunks, 0 to decode every chunk when
+      /// it is reached.
+      public: void SetReadAhead(const unsigned int _chunks);
+
+      /// \brief Get the number of chunks decoded ahead of playback.
+      /// \return Number of chunks.
+      /// \sa SetReadAhead
+      public: unsigned int ReadAhead() const;
+
       /// \brief Get the type of encoding used for current chunck in the
       /// open log file.
       /// \return The type of encoding. An empty string will be returned if
@@ -25,8 +25,14 @@
 #include <tinyxml2.h>
 #endif
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/system.hh"
@@ -35,6 +41,55 @@ namespace gazebo
 {
   namespace util
   {
+    /// \internal
+    /// \brief A chunk decoded ahead of playback by a LogReadAheadPool.
+    class LogReadAheadChunk
+    {
+      /// \brief Encoding of the chunk.
+      public: std::string encoding;
+
+      /// \brief Encoded text of the chunk, released once decoded.
+      public: std::string text;
+
+      /// \brief Decoded chunk, empty if the chunk could not be decoded.
+      public: std::string data;
+
+      /// \brief True once a worker took the chunk. Protected by the mutex
+      /// of the pool.
+      public: bool started = false;
+
+      /// \brief True once data is set. Protected by the mutex of the pool.
+      public: bool done = false;
+
+      /// \brief Set when the chunk is dropped. A worker skips the chunk, or
+      /// throws its result away, nobody waits for it.
+      public: std::atomic<bool> cancelled{false};
+    };
+
+    /// \internal
+    /// \brief Detached threads that decode log chunks. The workers share
+    /// the pool, dropping a chunk never waits for them.
+    class LogReadAheadPool
+    {
+      /// \brief Protects the members below and the state of the chunks.
+      public: std::mutex mutex;
+
+      /// \brief Signaled when a chunk is queued or the pool stops.
+      public: std::condition_variable queued;
+
+      /// \brief Signaled when a chunk is decoded or a worker exits.
+      public: std::condition_variable decoded;
+
+      /// \brief Chunks waiting for a worker.
+      public: std::deque<std::shared_ptr<LogReadAheadChunk>> queue;
+
+      /// \brief Number of worker threads running.
+      public: unsigned int workers = 0;
+
+      /// \brief True to make the workers exit.
+      public: bool stop = false;
+    };
+
     /// \internal
     /// \brief Private data for log play
     class LogPlayPrivate
@@ -47,6 +102,18 @@ namespace gazebo
                   tinyxml2::XMLElement *_xml,
                   std::string &_data);
 
+      /// \brief Start decoding, in the background, the chunks that follow
+      /// or precede a chunk. Chunks that are out of the new window are
+      /// dropped.
+      /// \param[in] _xml The current chunk.
+      /// \param[in] _forward True to read the following chunks, false to
+      /// read the preceding ones.
+      public: void ReadAhead(tinyxml2::XMLElement *_xml, const bool _forward);
+
+      /// \brief Drop all the chunks being read ahead, without waiting for
+      /// the ones being decoded.
+      public: void ClearReadAhead();
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
@@ -71,6 +138,24 @@ namespace gazebo
       /// \brief Current position in the log file.
       public: tinyxml2::XMLElement *logCurrXml = nullptr;
 
+      /// \brief All the chunks of the log file, in order.
+      public: std::vector<tinyxml2::XMLElement *> chunks;
+
+      /// \brief Number of chunks decoded ahead of playback.
+      public: unsigned int readAheadChunks = 0;
+
+      /// \brief Chunks being decoded in the background, by chunk element.
+      public: std::map<const tinyxml2::XMLElement *,
+              std::shared_ptr<LogReadAheadChunk>> readAhead;
+
+      /// \brief Workers that decode the chunks read ahead.
+      public: std::shared_ptr<LogReadAheadPool> readAheadPool =
+              std::make_shared<LogReadAheadPool>();
+
+      /// \brief True while seeking, when the chunks visited are not the
+      /// ones played next and are not read ahead.
+      public: bool seeking = false;
+
       /// \brief Name of the log file.
       public: std::string filename;
 
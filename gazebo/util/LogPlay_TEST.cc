@@ -19,6 +19,7 @@
 #include <boost/filesystem.hpp>
 #include <string>
 #include <thread>
+#include <vector>
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/LogPlay.hh"
@@ -406,6 +407,51 @@ TEST_F(LogPlay_TEST, Seek)
   EXPECT_EQ(shasum, expectedShashum4);
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that reading chunks ahead does not change the frames.
+TEST_F(LogPlay_TEST, ReadAhead)
+{
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  boost::filesystem::path logFilePath(TEST_PATH);
+  logFilePath /= boost::filesystem::path("logs");
+  logFilePath /= boost::filesystem::path("state.log");
+
+  const unsigned int readAhead = player->ReadAhead();
+  EXPECT_GT(readAhead, 0u);
+
+  // Read all the frames forward, then some of them backward
+  auto readAll = [&](std::vector<std::string> &_frames)
+  {
+    EXPECT_NO_THROW(player->Open(logFilePath.string()));
+    std::string frame;
+    while (player->Step(frame))
+      _frames.push_back(gazebo::common::get_sha1<std::string>(frame));
+
+    EXPECT_TRUE(player->Forward());
+    for (int i = 0; i < 1500 && player->StepBack(frame); ++i)
+      _frames.push_back(gazebo::common::get_sha1<std::string>(frame));
+
+    EXPECT_TRUE(player->Seek(common::Time(30.0)));
+    EXPECT_TRUE(player->Step(frame));
+    _frames.push_back(gazebo::common::get_sha1<std::string>(frame));
+  };
+
+  std::vector<std::string> expected;
+  player->SetReadAhead(0);
+  EXPECT_EQ(0u, player->ReadAhead());
+  readAll(expected);
+  EXPECT_GT(expected.size(), 2000u);
+  EXPECT_EQ("a2af44bc561194dfeae9526c224d56bb332a4233", expected.back());
+
+  std::vector<std::string> frames;
+  player->SetReadAhead(4);
+  readAll(frames);
+  EXPECT_EQ(expected, frames);
+
+  player->SetReadAhead(readAhead);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test reading a log file that is missing the closing </gazebo_log>
 /// tag
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class MultiWorldTest : public ServerFixture {};
+
+/////////////////////////////////////////////////
+/// \brief Two identical worlds loaded in one process run independently
+/// and produce the same result.
+TEST_F(MultiWorldTest, IndependentDeterministic)
+{
+  this->Load("worlds/multi_world.world", true);
+
+  auto worlds = physics::get_worlds();
+  ASSERT_EQ(worlds.size(), 2u);
+
+  physics::WorldPtr worldA = physics::get_world("world_a");
+  physics::WorldPtr worldB = physics::get_world("world_b");
+  ASSERT_TRUE(worldA != nullptr);
+  ASSERT_TRUE(worldB != nullptr);
+  EXPECT_NE(worldA, worldB);
+  EXPECT_TRUE(worldA->Running());
+  EXPECT_TRUE(worldB->Running());
+
+  physics::ModelPtr boxA = worldA->ModelByName("box");
+  physics::ModelPtr boxB = worldB->ModelByName("box");
+  ASSERT_TRUE(boxA != nullptr);
+  ASSERT_TRUE(boxB != nullptr);
+
+  // Only step world A, world B must not move
+  auto startPose = boxB->WorldPose();
+  worldA->Step(500);
+  EXPECT_EQ(worldB->Iterations(), 0u);
+  EXPECT_EQ(boxB->WorldPose(), startPose);
+  EXPECT_NE(boxA->WorldPose(), startPose);
+
+  // Step world B by the same amount, the boxes must end up in the same
+  // place.
+  worldB->Step(500);
+  EXPECT_EQ(worldA->Iterations(), worldB->Iterations());
+  EXPECT_EQ(boxA->WorldPose(), boxB->WorldPose());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/test/helper_physics_generator.hh"
+
+#define TOL 1e-6
+using namespace gazebo;
+
+class StateBatchTest : public ServerFixture,
+                       public ::testing::WithParamInterface<const char*>
+{
+  /// \brief Compare the arrays of a state batch with the per joint and per
+  /// link API while a model is driven by joint efforts.
+  /// \param[in] _physicsEngine Physics engine to use.
+  public: void ReadWrite(const std::string &_physicsEngine);
+};
+
+//////////////////////////////////////////////////
+void StateBatchTest::ReadWrite(const std::string &_physicsEngine)
+{
+  Load("worlds/simple_arm_test.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+
+  physics::StateBatchPtr batch = model->CreateStateBatch();
+  ASSERT_TRUE(batch != nullptr);
+  ASSERT_EQ(model->GetJoints().size(), batch->Joints().size());
+  ASSERT_EQ(model->GetLinks().size(), batch->LinkCount());
+
+  unsigned int dof = 0;
+  for (auto const &joint : model->GetJoints())
+    dof += joint->DOF();
+  ASSERT_EQ(dof, batch->JointCoordinateCount());
+  ASSERT_GT(dof, 0u);
+
+  const unsigned int links = batch->LinkCount();
+  std::vector<double> efforts(dof);
+  for (unsigned int i = 0; i < dof; ++i)
+    efforts[i] = (i % 2 == 0) ? 1.0 : -1.0;
+
+  std::vector<double> positions(dof), velocities(dof), forces(dof);
+  std::vector<double> poses(links * physics::StateBatch::PoseSize);
+  std::vector<double> twists(links * physics::StateBatch::TwistSize);
+
+  for (unsigned int step = 0; step < 50; ++step)
+  {
+    batch->SetJointForces(efforts.data());
+    world->Step(1);
+  }
+  batch->SetJointForces(efforts.data());
+  batch->JointForces(forces.data());
+
+  batch->JointPositions(positions.data());
+  batch->JointVelocities(velocities.data());
+  batch->LinkPoses(poses.data());
+  batch->LinkTwists(twists.data());
+
+  // The arrays match the per entity API
+  bool moved = false;
+  for (unsigned int j = 0; j < batch->Joints().size(); ++j)
+  {
+    physics::JointPtr joint = batch->Joints()[j];
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+    {
+      const unsigned int k = batch->JointOffset(j) + i;
+      EXPECT_NEAR(positions[k], joint->Position(i), TOL);
+      EXPECT_NEAR(velocities[k], joint->GetVelocity(i), TOL);
+      EXPECT_NEAR(forces[k], joint->GetForce(i), TOL);
+      moved = moved || std::abs(positions[k]) > TOL;
+    }
+  }
+  EXPECT_TRUE(moved);
+
+  for (unsigned int l = 0; l < links; ++l)
+  {
+    physics::LinkPtr link = batch->Links()[l];
+    const double *pose = &poses[l * physics::StateBatch::PoseSize];
+    const double *twist = &twists[l * physics::StateBatch::TwistSize];
+    const ignition::math::Pose3d worldPose = link->WorldPose();
+    EXPECT_NEAR(pose[0], worldPose.Pos().X(), TOL);
+    EXPECT_NEAR(pose[1], worldPose.Pos().Y(), TOL);
+    EXPECT_NEAR(pose[2], worldPose.Pos().Z(), TOL);
+    EXPECT_NEAR(pose[3], worldPose.Rot().W(), TOL);
+    EXPECT_NEAR(pose[4], worldPose.Rot().X(), TOL);
+    EXPECT_NEAR(pose[5], worldPose.Rot().Y(), TOL);
+    EXPECT_NEAR(pose[6], worldPose.Rot().Z(), TOL);
+
+    const ignition::math::Vector3d lin = link->WorldCoGLinearVel();
+    const ignition::math::Vector3d ang = link->WorldAngularVel();
+    EXPECT_NEAR(twist[0], lin.X(), TOL);
+    EXPECT_NEAR(twist[1], lin.Y(), TOL);
+    EXPECT_NEAR(twist[2], lin.Z(), TOL);
+    EXPECT_NEAR(twist[3], ang.X(), TOL);
+    EXPECT_NEAR(twist[4], ang.Y(), TOL);
+    EXPECT_NEAR(twist[5], ang.Z(), TOL);
+  }
+
+  // A world batch holds each model in turn
+  physics::StateBatchPtr worldBatch =
+      world->CreateStateBatch({model, model});
+  ASSERT_EQ(2 * dof, worldBatch->JointCoordinateCount());
+  ASSERT_EQ(2 * links, worldBatch->LinkCount());
+  std::vector<double> twice(2 * dof);
+  worldBatch->JointPositions(twice.data());
+  batch->JointPositions(positions.data());
+  for (unsigned int i = 0; i < dof; ++i)
+  {
+    EXPECT_DOUBLE_EQ(twice[i], positions[i]);
+    EXPECT_DOUBLE_EQ(twice[dof + i], positions[i]);
+  }
+
+  // Stop the joints through the batch and read them back
+  std::fill(velocities.begin(), velocities.end(), 0.0);
+  batch->SetJointVelocities(velocities.data());
+  std::vector<double> readBack(dof, 1.0);
+  batch->JointVelocities(readBack.data());
+  for (unsigned int j = 0; j < batch->Joints().size(); ++j)
+  {
+    physics::JointPtr joint = batch->Joints()[j];
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+    {
+      const unsigned int k = batch->JointOffset(j) + i;
+      EXPECT_NEAR(readBack[k], 0.0, TOL);
+      EXPECT_NEAR(readBack[k], joint->GetVelocity(i), TOL);
+    }
+  }
+
+  if (_physicsEngine != "ode" && _physicsEngine != "bullet")
+  {
+    gzerr << "Link twists and joint positions of articulated models are "
+          << "only written with ODE and Bullet, see "
+          << "joint_set_position_test.\n";
+    return;
+  }
+
+  // Zero the twists of all links, the joints stay still
+  std::fill(twists.begin(), twists.end(), 0.0);
+  batch->SetLinkTwists(twists.data());
+  batch->LinkTwists(twists.data());
+  for (auto const &twist : twists)
+    EXPECT_NEAR(twist, 0.0, TOL);
+  batch->JointVelocities(velocities.data());
+  for (auto const &velocity : velocities)
+    EXPECT_NEAR(velocity, 0.0, TOL);
+
+  // Set positions through the batch and read them back
+  for (unsigned int i = 0; i < dof; ++i)
+    positions[i] = 0.1 * (i + 1);
+  batch->SetJointPositions(positions.data());
+  batch->JointPositions(readBack.data());
+  for (unsigned int i = 0; i < dof; ++i)
+    EXPECT_NEAR(readBack[i], positions[i], TOL);
+}
+
+//////////////////////////////////////////////////
+TEST_P(StateBatchTest, ReadWrite)
+{
+  ReadWrite(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(PhysicsEngines, StateBatchTest,
+  PHYSICS_ENGINE_VALUES,);  // NOLINT
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
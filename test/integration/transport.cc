@@ -788,6 +788,275 @@ TEST_F(TransportTest, TryInit)
   EXPECT_EQ(physics::get_world()->Name(), node->GetTopicNamespace());
 }
 
+int g_slowMsg = 0;
+int g_fastMsg = 0;
+
+void ReceiveSlowMsg(ConstGzStringPtr &/*_msg*/)
+{
+  common::Time::MSleep(2000);
+  g_slowMsg++;
+}
+
+void ReceiveFastMsg(ConstGzStringPtr &/*_msg*/)
+{
+  g_fastMsg++;
+}
+
+/////////////////////////////////////////////////
+// A slow callback on a node with its own executor must not delay the
+// callbacks of other nodes.
+TEST_F(TransportTest, CallbackExecutor)
+{
+  g_slowMsg = 0;
+  g_fastMsg = 0;
+
+  Load("worlds/empty.world");
+
+  transport::NodePtr slowNode(new transport::Node());
+  slowNode->Init();
+  EXPECT_EQ(nullptr, slowNode->CallbackExecutor());
+  transport::ExecutorPtr executor(new transport::Executor);
+  slowNode->SetCallbackExecutor(executor);
+  EXPECT_EQ(executor, slowNode->CallbackExecutor());
+  transport::SubscriberPtr slowSub =
+    slowNode->Subscribe("~/test_slow", &ReceiveSlowMsg);
+
+  transport::NodePtr fastNode(new transport::Node());
+  fastNode->Init();
+  fastNode->SetCallbackExecutor(transport::Executor::Pool());
+  transport::SubscriberPtr fastSub =
+    fastNode->Subscribe("~/test_fast", &ReceiveFastMsg);
+
+  transport::PublisherPtr slowPub =
+    fastNode->Advertise<msgs::GzString>("~/test_slow");
+  transport::PublisherPtr fastPub =
+    fastNode->Advertise<msgs::GzString>("~/test_fast");
+  slowPub->WaitForConnection();
+  fastPub->WaitForConnection();
+
+  msgs::GzString msg;
+  msg.set_data("test");
+  slowPub->Publish(msg);
+  common::Time::MSleep(100);
+
+  for (int i = 0; i < 10; ++i)
+    fastPub->Publish(msg);
+
+  for (int i = 0; i < 10 && g_fastMsg < 10; ++i)
+    common::Time::MSleep(100);
+
+  EXPECT_EQ(10, g_fastMsg);
+  EXPECT_EQ(0, g_slowMsg);
+
+  for (int i = 0; i < 50 && g_slowMsg < 1; ++i)
+    common::Time::MSleep(100);
+  EXPECT_EQ(1, g_slowMsg);
+
+  slowNode->Fini();
+  fastNode->Fini();
+}
+
+std::vector<std::string> g_queueMsgs;
+int g_posesMsgCount = 0;
+msgs::PosesStamped g_posesMsg;
+
+void ReceiveQueueMsg(ConstGzStringPtr &_msg)
+{
+  g_queueMsgs.push_back(_msg->data());
+}
+
+void ReceivePosesMsg(ConstPosesStampedPtr &_msg)
+{
+  g_posesMsg.CopyFrom(*_msg);
+  g_posesMsgCount++;
+}
+
+/////////////////////////////////////////////////
+// Deliver the queued messages of a node and wait for a number of them.
+void DeliverQueued(const std::vector<std::string>::size_type _count)
+{
+  transport::pause_incoming(false);
+  for (int i = 0; i < 50 && g_queueMsgs.size() < _count; ++i)
+    common::Time::MSleep(100);
+  common::Time::MSleep(100);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportTest, QueueLimit)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  transport::SubscriberPtr sub =
+    node->Subscribe("~/test_queue", &ReceiveQueueMsg);
+  const std::string topic = node->DecodeTopicName("~/test_queue");
+  EXPECT_EQ(0u, node->DroppedCount("~/test_queue"));
+
+  // Keep the latest messages
+  g_queueMsgs.clear();
+  node->SetQueueLimit("~/test_queue", 3);
+  transport::pause_incoming(true);
+  for (int i = 0; i < 10; ++i)
+  {
+    boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+    msg->set_data(std::to_string(i));
+    node->HandleMessage(topic, msg);
+  }
+  EXPECT_EQ(7u, node->DroppedCount("~/test_queue"));
+  DeliverQueued(3);
+  EXPECT_EQ(std::vector<std::string>({"7", "8", "9"}), g_queueMsgs);
+
+  // Keep the oldest messages
+  g_queueMsgs.clear();
+  node->SetQueueLimit("~/test_queue", 2, transport::QueuePolicy::DROP_NEWEST);
+  transport::pause_incoming(true);
+  for (int i = 0; i < 10; ++i)
+  {
+    boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+    msg->set_data(std::to_string(i));
+    node->HandleMessage(topic, msg);
+  }
+  EXPECT_EQ(15u, node->DroppedCount("~/test_queue"));
+  DeliverQueued(2);
+  EXPECT_EQ(std::vector<std::string>({"0", "1"}), g_queueMsgs);
+
+  // No limit
+  g_queueMsgs.clear();
+  node->SetQueueLimit("~/test_queue", 0);
+  transport::pause_incoming(true);
+  for (int i = 0; i < 10; ++i)
+  {
+    boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+    msg->set_data(std::to_string(i));
+    node->HandleMessage(topic, msg);
+  }
+  DeliverQueued(10);
+  EXPECT_EQ(10u, g_queueMsgs.size());
+  EXPECT_EQ(15u, node->DroppedCount("~/test_queue"));
+  EXPECT_EQ(15u, node->DroppedCounts()[topic]);
+
+  // Keep the latest pose of each entity
+  g_posesMsgCount = 0;
+  transport::SubscriberPtr posesSub =
+    node->Subscribe("~/test_poses", &ReceivePosesMsg);
+  node->SetQueueLimit("~/test_poses", 10,
+      transport::QueuePolicy::LATEST_PER_ENTITY);
+  const std::string posesTopic = node->DecodeTopicName("~/test_poses");
+
+  transport::pause_incoming(true);
+  boost::shared_ptr<msgs::PosesStamped> poses1(new msgs::PosesStamped);
+  msgs::Set(poses1->mutable_time(), common::Time(1, 0));
+  msgs::Pose *pose = poses1->add_pose();
+  msgs::Set(pose, ignition::math::Pose3d(1, 0, 0, 0, 0, 0));
+  pose->set_id(1);
+  pose = poses1->add_pose();
+  msgs::Set(pose, ignition::math::Pose3d(1, 0, 0, 0, 0, 0));
+  pose->set_id(2);
+  node->HandleMessage(posesTopic, poses1);
+
+  boost::shared_ptr<msgs::PosesStamped> poses2(new msgs::PosesStamped);
+  msgs::Set(poses2->mutable_time(), common::Time(2, 0));
+  pose = poses2->add_pose();
+  msgs::Set(pose, ignition::math::Pose3d(2, 0, 0, 0, 0, 0));
+  pose->set_id(1);
+  node->HandleMessage(posesTopic, poses2);
+  EXPECT_EQ(1u, node->DroppedCount("~/test_poses"));
+
+  // The queued messages are not modified
+  EXPECT_EQ(1, poses2->pose_size());
+
+  transport::pause_incoming(false);
+  for (int i = 0; i < 50 && g_posesMsgCount < 1; ++i)
+    common::Time::MSleep(100);
+  common::Time::MSleep(100);
+
+  EXPECT_EQ(1, g_posesMsgCount);
+  EXPECT_EQ(2, g_posesMsg.time().sec());
+  ASSERT_EQ(2, g_posesMsg.pose_size());
+  EXPECT_EQ(1u, g_posesMsg.pose(0).id());
+  EXPECT_DOUBLE_EQ(2.0, g_posesMsg.pose(0).position().x());
+  EXPECT_EQ(2u, g_posesMsg.pose(1).id());
+  EXPECT_DOUBLE_EQ(1.0, g_posesMsg.pose(1).position().x());
+
+  // Serialized messages are merged the same way. Poses without an id are
+  // kept by name.
+  g_posesMsgCount = 0;
+  transport::pause_incoming(true);
+  pose = poses1->add_pose();
+  msgs::Set(pose, ignition::math::Pose3d(1, 0, 0, 0, 0, 0));
+  pose->set_name("box");
+  node->HandleData(posesTopic, poses1->SerializeAsString());
+
+  msgs::Set(poses2->mutable_time(), common::Time(3, 0));
+  pose = poses2->add_pose();
+  msgs::Set(pose, ignition::math::Pose3d(3, 0, 0, 0, 0, 0));
+  pose->set_name("box");
+  node->HandleData(posesTopic, poses2->SerializeAsString());
+  EXPECT_EQ(2u, node->DroppedCount("~/test_poses"));
+
+  transport::pause_incoming(false);
+  for (int i = 0; i < 50 && g_posesMsgCount < 1; ++i)
+    common::Time::MSleep(100);
+  common::Time::MSleep(100);
+
+  EXPECT_EQ(1, g_posesMsgCount);
+  EXPECT_EQ(3, g_posesMsg.time().sec());
+  ASSERT_EQ(3, g_posesMsg.pose_size());
+  EXPECT_EQ(1u, g_posesMsg.pose(0).id());
+  EXPECT_DOUBLE_EQ(2.0, g_posesMsg.pose(0).position().x());
+  EXPECT_EQ("box", g_posesMsg.pose(1).name());
+  EXPECT_DOUBLE_EQ(3.0, g_posesMsg.pose(1).position().x());
+  EXPECT_EQ(2u, g_posesMsg.pose(2).id());
+  EXPECT_DOUBLE_EQ(1.0, g_posesMsg.pose(2).position().x());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportTest, PublishSwap)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  g_queueMsgs.clear();
+  transport::SubscriberPtr sub =
+    node->Subscribe("~/test_swap", &ReceiveQueueMsg);
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::GzString>("~/test_swap");
+
+  msgs::GzString msg;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 20; ++i)
+  {
+    msg.Clear();
+    msg.set_data("message " + std::to_string(i));
+    expected.push_back(msg.data());
+    pub->PublishSwap(msg, true);
+
+    // The content was moved to the publisher
+    EXPECT_NE(expected.back(), msg.data());
+  }
+  DeliverQueued(expected.size());
+  EXPECT_EQ(expected, g_queueMsgs);
+
+  // The latched message is the last one published
+  msgs::GzString latched;
+  ASSERT_TRUE(latched.ParseFromString(pub->GetPrevMsg()));
+  EXPECT_EQ(expected.back(), latched.data());
+
+  // Copying publications and swapping publications can be mixed
+  g_queueMsgs.clear();
+  msg.set_data("copied");
+  pub->Publish(msg, true);
+  EXPECT_EQ("copied", msg.data());
+  pub->PublishSwap(msg, true);
+  DeliverQueued(2);
+  EXPECT_EQ(std::vector<std::string>({"copied", "copied"}), g_queueMsgs);
+
+  msgs::Vector3d wrongType;
+  EXPECT_THROW(pub->PublishSwap(wrongType), common::Exception);
+}
+
 /////////////////////////////////////////////////
 // Main
 int main(int argc, char **argv)
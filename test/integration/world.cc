@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <set>
+#include <string>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/physics.hh"
@@ -554,6 +557,60 @@ TEST_F(WorldTest, RemoveModelUnPaused)
   EXPECT_FALSE(boxModel != NULL);
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the names of a list of models.
+std::set<std::string> ModelNames(const physics::Model_V &_models)
+{
+  std::set<std::string> names;
+  for (auto const &model : _models)
+    names.insert(model->GetScopedName());
+  return names;
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldTest, SpatialQueries)
+{
+  Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  // The sphere is at (0, 1.5, 0.5), between the box and the cylinder
+  auto names = ModelNames(world->ModelsInSphere(
+        ignition::math::Vector3d(0, 1.5, 0.5), 0.6));
+  EXPECT_EQ(1u, names.count("sphere"));
+  EXPECT_EQ(0u, names.count("box"));
+  EXPECT_EQ(0u, names.count("cylinder"));
+
+  names = ModelNames(world->ModelsOnRay(
+        ignition::math::Vector3d(0, -5, 0.5),
+        ignition::math::Vector3d(0, 5, 0.5)));
+  EXPECT_EQ(1u, names.count("sphere"));
+  EXPECT_EQ(1u, names.count("box"));
+  EXPECT_EQ(1u, names.count("cylinder"));
+
+  // Moving a model moves it in the tree
+  physics::ModelPtr sphereModel = world->ModelByName("sphere");
+  ASSERT_TRUE(sphereModel != NULL);
+  sphereModel->SetWorldPose(ignition::math::Pose3d(10, 10, 0.5, 0, 0, 0));
+  world->Step(1);
+
+  ignition::math::AxisAlignedBox box(ignition::math::Vector3d(9, 9, 0),
+      ignition::math::Vector3d(11, 11, 1));
+  names = ModelNames(world->ModelsInBox(box));
+  EXPECT_EQ(1u, names.count("sphere"));
+  names = ModelNames(world->ModelsInSphere(
+        ignition::math::Vector3d(0, 1.5, 0.5), 0.6));
+  EXPECT_EQ(0u, names.count("sphere"));
+
+  // Removed models are not returned
+  world->RemoveModel("box");
+  names = ModelNames(world->ModelsOnRay(
+        ignition::math::Vector3d(0, -5, 0.5),
+        ignition::math::Vector3d(0, 5, 0.5)));
+  EXPECT_EQ(0u, names.count("box"));
+  EXPECT_EQ(1u, names.count("cylinder"));
+}
+
 /////////////////////////////////////////////////
 /// \brief Check if WorldUpdateBegin, BeforePhysicsUpdate and WorldUpdateEnd
 /// events are called, and if the BeforePhysicsUpdate event is really called
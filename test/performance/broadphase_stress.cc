@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class BroadphaseStressTest : public ServerFixture {};
+
+/////////////////////////////////////////////////
+TEST_F(BroadphaseStressTest, Shelves)
+{
+  Load("worlds/broadphase_shelves.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  if (physics->GetType() != "ode")
+    return;
+
+  // 1000 static shelves and 200 balls falling on them. The balls are few,
+  // so most of the step is spent in the collision detection.
+  for (const std::string broadphase : {"hash", "sap", "tree"})
+  {
+    for (const bool staticSpace : {false, true})
+    {
+      world->Reset();
+      EXPECT_TRUE(physics->SetParam("broadphase", broadphase));
+      EXPECT_TRUE(physics->SetParam("static_space", staticSpace));
+
+      common::Time startTime = common::Time::GetWallTime();
+      world->Step(1000);
+      common::Time endTime = common::Time::GetWallTime();
+
+      const std::string name = broadphase +
+        (staticSpace ? "_static_space" : "");
+      gzdbg << "Time elapsed while stepping with " << name << " ["
+            << endTime - startTime << "]\n";
+      this->Record(name + "_time", (endTime - startTime).Double());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class PGSStressTest : public ServerFixture {};
+
+/////////////////////////////////////////////////
+TEST_F(PGSStressTest, BoxStacks)
+{
+  Load("worlds/pgs_benchmark.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  if (physics->GetType() != "ode")
+    return;
+
+  // Let the stacks settle, so both runs solve the same contacts
+  world->Step(100);
+
+  for (const bool simd : {false, true})
+  {
+    world->Reset();
+    EXPECT_TRUE(physics->SetParam("simd_rows", simd));
+
+    common::Time startTime = common::Time::GetWallTime();
+    world->Step(2000);
+    common::Time endTime = common::Time::GetWallTime();
+
+    const std::string name = simd ? "simd_rows" : "default_rows";
+    gzdbg << "Time elapsed while stepping with " << name << " ["
+          << endTime - startTime << "]\n";
+    this->Record(name + "_time", (endTime - startTime).Double());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(PGSStressTest, ColoredPile)
+{
+  Load("worlds/pgs_pile.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  if (physics->GetType() != "ode")
+    return;
+
+  // The pile is a single island, solved in order, then by colors with an
+  // increasing number of threads
+  for (const int threads : {0, 1, 2, 4})
+  {
+    world->Reset();
+    EXPECT_TRUE(physics->SetParam("colored_row_threads", threads));
+
+    common::Time startTime = common::Time::GetWallTime();
+    world->Step(1000);
+    common::Time endTime = common::Time::GetWallTime();
+
+    const std::string name = "colored_" + std::to_string(threads);
+    gzdbg << "Time elapsed while stepping with " << name << " ["
+          << endTime - startTime << "]\n";
+    this->Record(name + "_time", (endTime - startTime).Double());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(PGSStressTest, ContactWarmStart)
+{
+  Load("worlds/pgs_benchmark.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != NULL);
+  if (physics->GetType() != "ode")
+    return;
+
+  // How far the boxes drift from their initial height, for a decreasing
+  // number of iterations, without and with contact warm starting
+  std::vector<double> initialHeights;
+  for (auto const &model : world->Models())
+    initialHeights.push_back(model->WorldPose().Pos().Z());
+
+  for (const int iters : {50, 20, 10, 5})
+  {
+    for (const bool warmStart : {false, true})
+    {
+      world->Reset();
+      EXPECT_TRUE(physics->SetParam("iters", iters));
+      EXPECT_TRUE(physics->SetParam("contact_warm_start", warmStart));
+      world->Step(2000);
+
+      double drift = 0;
+      auto const models = world->Models();
+      for (size_t i = 0; i < models.size(); ++i)
+      {
+        drift = std::max(drift,
+            std::abs(models[i]->WorldPose().Pos().Z() - initialHeights[i]));
+      }
+
+      const std::string name = (warmStart ? "warm_" : "cold_") +
+        std::to_string(iters);
+      gzdbg << "Largest drift with " << name << " [" << drift << "]\n";
+      this->Record(name + "_drift", drift);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/StartupProfiler.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test_config.h"
+
+using namespace gazebo;
+
+/// \brief A reference world and the upper bound of its startup time.
+struct StartupBudget
+{
+  /// \brief World file.
+  const char *world;
+
+  /// \brief Number of models in the world, checked after the load.
+  unsigned int modelCount;
+
+  /// \brief Maximum time in seconds from the start of the load to the
+  /// end of the startup. This only catches hangs, regressions are caught
+  /// by the comparison with the baseline.
+  double seconds;
+};
+
+/// \brief Relative slowdown of a phase over its baseline that fails the
+/// test, unless GAZEBO_STARTUP_TOLERANCE is set.
+static const double DefaultTolerance = 0.25;
+
+/// \brief Slowdown in seconds that is always tolerated, so that phases
+/// that take a few milliseconds don't fail on noise.
+static const double MinSlack = 0.05;
+
+/// \brief Read the phase times of a baseline file.
+/// \param[in] _path Path of the file, with one "<phase> <seconds>" line
+/// per phase.
+/// \return Time of each phase, empty if the file doesn't exist.
+static std::map<std::string, double> ReadBaseline(const std::string &_path)
+{
+  std::map<std::string, double> baseline;
+  std::ifstream in(_path);
+  std::string phase;
+  double seconds;
+  while (in >> phase >> seconds)
+    baseline[phase] = seconds;
+  return baseline;
+}
+
+/// \brief Write the phase times of a baseline file.
+/// \param[in] _path Path of the file.
+/// \param[in] _times Time of each phase.
+static void WriteBaseline(const std::string &_path,
+    const std::map<std::string, double> &_times)
+{
+  std::ofstream out(_path);
+  for (auto const &time : _times)
+    out << time.first << " " << time.second << "\n";
+}
+
+/// \brief Path of the test binary, which runs each world in a process of
+/// its own.
+static std::string g_binary;
+
+/// \brief Environment variable that makes the test load its world and
+/// write the time of each phase to the file it names.
+static const char *ChildEnv = "GAZEBO_STARTUP_CHILD";
+
+/// \brief Cold start of the server on reference worlds. The startup is
+/// traced with common::StartupProfiler, the trace of each world is written
+/// to the build directory and the time of each phase is recorded in the
+/// test output.
+///
+/// Singletons such as common::MeshManager keep what they loaded for the
+/// life of the process, so only the first world a process loads is a cold
+/// start. Each world is therefore loaded by a child process that runs only
+/// its own test, and the parent compares the phase times it reports.
+///
+/// The time of each phase, and the total, are compared with a baseline
+/// recorded on the same machine: startup_<world>.baseline in
+/// GAZEBO_STARTUP_BASELINE_DIR, or in the build directory by default. A
+/// phase fails if it is slower than its baseline by more than
+/// GAZEBO_STARTUP_TOLERANCE, 0.25 by default, plus 50 ms. A missing
+/// baseline is recorded by the run, and GAZEBO_STARTUP_RECORD=1 records it
+/// again, for example on the main branch of a CI job. A CI job (CI set in
+/// the environment) must set GAZEBO_STARTUP_BASELINE_DIR to a directory
+/// kept between runs, otherwise every run records a fresh baseline and
+/// compares nothing, so the test fails instead.
+class StartupBenchmark : public ServerFixture,
+                         public ::testing::WithParamInterface<StartupBudget>
+{
+  /// \brief Load a world and wait for the end of its startup.
+  /// \param[in] _budget World to load.
+  /// \param[in] _tracePath Path of the startup trace.
+  /// \param[out] _times Time of each phase, and the total.
+  protected: void LoadWorld(const StartupBudget &_budget,
+                 const std::string &_tracePath,
+                 std::map<std::string, double> &_times);
+};
+
+/////////////////////////////////////////////////
+void StartupBenchmark::LoadWorld(const StartupBudget &_budget,
+    const std::string &_tracePath, std::map<std::string, double> &_times)
+{
+  common::StartupProfiler *profiler = common::StartupProfiler::Instance();
+  profiler->Enable(_tracePath);
+  this->Load(_budget.world, true);
+
+  // The trace is finished once the world has loaded its plugins
+  for (int i = 0; i < 300 && profiler->Enabled(); ++i)
+    common::Time::MSleep(100);
+  ASSERT_FALSE(profiler->Enabled());
+  EXPECT_TRUE(boost::filesystem::exists(_tracePath));
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  EXPECT_EQ(_budget.modelCount, world->ModelCount());
+
+  // From the first span to the end of the last one
+  std::vector<common::StartupSpan> spans = profiler->Spans();
+  ASSERT_FALSE(spans.empty());
+  double start = spans.front().start;
+  double end = 0;
+  for (auto const &span : spans)
+  {
+    start = std::min(start, span.start);
+    end = std::max(end, span.start + span.duration);
+  }
+
+  for (auto const &category :
+      {"sdf", "uri", "mesh", "physics", "plugin", "sensors"})
+  {
+    _times[category] = profiler->CategoryTime(category);
+  }
+  _times["total"] = end - start;
+
+  EXPECT_GT(_times["sdf"], 0.0);
+  EXPECT_GT(_times["physics"], 0.0);
+}
+
+/////////////////////////////////////////////////
+TEST_P(StartupBenchmark, ColdStart)
+{
+  const StartupBudget budget = GetParam();
+  const std::string worldName =
+      boost::filesystem::path(budget.world).stem().string();
+  const std::string outputDir = std::string(PROJECT_BINARY_PATH) +
+      "/test/performance";
+
+  // Child process: load the world and report its phase times
+  if (const char *child = std::getenv(ChildEnv))
+  {
+    std::map<std::string, double> times;
+    this->LoadWorld(budget, outputDir + "/startup_" + worldName + ".json",
+        times);
+    if (!this->HasFatalFailure())
+      WriteBaseline(child, times);
+    return;
+  }
+
+  const char *baselineEnv = std::getenv("GAZEBO_STARTUP_BASELINE_DIR");
+  const bool hasBaselineDir = baselineEnv && *baselineEnv;
+  const char *ci = std::getenv("CI");
+  if (ci && *ci && std::string(ci) != "false" && !hasBaselineDir)
+  {
+    FAIL() << "GAZEBO_STARTUP_BASELINE_DIR must name a directory kept "
+           << "between CI runs, a baseline recorded by the run itself "
+           << "compares nothing";
+  }
+
+  const std::string baselineDir = hasBaselineDir ? baselineEnv : outputDir;
+  const std::string baselinePath =
+      baselineDir + "/startup_" + worldName + ".baseline";
+
+  double tolerance = DefaultTolerance;
+  if (const char *env = std::getenv("GAZEBO_STARTUP_TOLERANCE"))
+    tolerance = std::atof(env);
+  ASSERT_GE(tolerance, 0.0);
+
+  const char *record = std::getenv("GAZEBO_STARTUP_RECORD");
+  std::map<std::string, double> baseline;
+  if (!record || std::string(record) != "1")
+    baseline = ReadBaseline(baselinePath);
+
+  // Run only this test in a fresh process, so that the world is a cold
+  // start whatever the worlds loaded before it
+  const ::testing::TestInfo *info =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string timesPath = outputDir + "/startup_" + worldName +
+      ".times";
+  boost::filesystem::remove(timesPath);
+  const std::string command = std::string(ChildEnv) + "='" + timesPath +
+      "' '" + g_binary + "' --gtest_filter='" + info->test_case_name() +
+      "." + info->name() + "'";
+  ASSERT_EQ(0, std::system(command.c_str()))
+      << "Startup of [" << budget.world << "] failed in its own process";
+
+  const std::map<std::string, double> times = ReadBaseline(timesPath);
+  ASSERT_FALSE(times.empty())
+      << "No phase times in [" << timesPath << "]";
+
+  for (auto const &time : times)
+  {
+    gzdbg << "Startup of [" << budget.world << "] " << time.first
+          << " [" << time.second << "]\n";
+    this->Record("startup_" + time.first, time.second);
+  }
+
+  ASSERT_TRUE(times.count("total") > 0);
+  EXPECT_LT(times.at("total"), budget.seconds);
+
+  if (baseline.empty())
+  {
+    gzmsg << "Recording the startup baseline of [" << budget.world
+          << "] in [" << baselinePath << "]\n";
+    WriteBaseline(baselinePath, times);
+    return;
+  }
+
+  for (auto const &time : times)
+  {
+    auto iter = baseline.find(time.first);
+    if (iter == baseline.end())
+      continue;
+    EXPECT_LE(time.second, iter->second * (1.0 + tolerance) + MinSlack)
+        << "Startup phase [" << time.first << "] of [" << budget.world
+        << "] regressed from its baseline in [" << baselinePath << "]";
+  }
+}
+
+// Generous upper bounds that only stop hangs, regressions are caught by the
+// baseline comparison in ColdStart
+INSTANTIATE_TEST_CASE_P(ReferenceWorlds, StartupBenchmark, ::testing::Values(
+      StartupBudget{"worlds/empty.world", 1u, 10.0},
+      StartupBudget{"worlds/shapes.world", 4u, 10.0},
+      StartupBudget{"worlds/load_benchmark.world", 401u, 30.0}));
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  g_binary = argv[0];
+
+  // A cold start doesn't find the meshes of earlier runs on disk
+  boost::filesystem::path meshCache =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gz_startup_mesh_cache-%%%%%%");
+  setenv("GAZEBO_MESH_CACHE_PATH", meshCache.string().c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+
+  boost::filesystem::remove_all(meshCache);
+  return result;
+}
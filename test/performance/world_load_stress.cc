@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <set>
+#include <string>
+
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Maximum time in seconds to load worlds/load_benchmark.world. This
+/// only catches hangs, regressions of the load time are caught by the
+/// baseline comparison of startup_benchmark.
+static const double MaxLoadTime = 30.0;
+
+class WorldLoadStressTest : public ServerFixture {};
+
+/////////////////////////////////////////////////
+TEST_F(WorldLoadStressTest, MeshGrid)
+{
+  common::Time startTime = common::Time::GetWallTime();
+  Load("worlds/load_benchmark.world", true);
+  common::Time endTime = common::Time::GetWallTime();
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  // 400 mesh models plus the ground plane
+  ASSERT_EQ(world->ModelCount(), 401u);
+
+  gzdbg << "Time elapsed while loading world ["
+        << endTime - startTime << "]\n";
+  this->Record("load_time", (endTime - startTime).Double());
+  EXPECT_LT((endTime - startTime).Double(), MaxLoadTime);
+
+  // The meshes are read in parallel, but the models are still constructed
+  // in SDF order and each one finds its collision mesh in the MeshManager
+  std::set<std::string> meshes;
+  physics::Model_V models = world->Models();
+  for (unsigned int i = 0; i < 400u; ++i)
+  {
+    physics::ModelPtr model = models[i + 1];
+    ASSERT_TRUE(model != nullptr);
+    EXPECT_EQ("model_" + std::to_string(i), model->GetName());
+
+    physics::LinkPtr link = model->GetLink("link");
+    ASSERT_TRUE(link != nullptr);
+    physics::CollisionPtr collision = link->GetCollision("collision");
+    ASSERT_TRUE(collision != nullptr);
+    physics::MeshShapePtr shape =
+        boost::dynamic_pointer_cast<physics::MeshShape>(
+        collision->GetShape());
+    ASSERT_TRUE(shape != nullptr);
+
+    std::string path = common::find_file(shape->GetMeshURI());
+    EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(path)) << path;
+    meshes.insert(path);
+  }
+  EXPECT_EQ(4u, meshes.size());
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -21,8 +21,19 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <vector>
 
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
 #include <ignition/math/Vector3.hh>
 
 #include <gazebo/util/util.hh>
@@ -622,7 +633,13 @@ LogCommand::LogCommand()
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, and output commands")
+    ("export,x", po::value<std::string>(),
+     "Export the poses, velocities and joint positions of all the models, "
+     "links and joints to one columnar binary file per entity in the given "
+     "directory. The log file is streamed rather than loaded, so logs "
+     "larger than memory can be exported. Valid in conjunction with the hz "
+     "command.");
 }
 
 /////////////////////////////////////////////////
@@ -681,8 +698,9 @@ bool LogCommand::RunImpl()
       return false;
     }
 
-    // Load log file from string
-    if (!this->LoadLogFromFile(filename))
+    // Load log file from string. The export streams the file instead,
+    // since it may not fit in memory.
+    if (!this->vm.count("export") && !this->LoadLogFromFile(filename))
     {
       return false;
     }
@@ -692,7 +710,9 @@ bool LogCommand::RunImpl()
   g_stateSdf.reset(new sdf::Element);
   sdf::initFile("state.sdf", g_stateSdf);
 
-  if (this->vm.count("output"))
+  if (this->vm.count("export"))
+    return this->Export(filename, this->vm["export"].as<std::string>(), hz);
+  else if (this->vm.count("output"))
   {
     std::string encoding = this->vm.count("encoding") ?
       this->vm["encoding"].as<std::string>() : "";
@@ -1045,6 +1065,465 @@ int LogCommand::GetChar()
 # endif
 }
 
+/////////////////////////////////////////////////
+namespace
+{
+  /// \brief Number of rows buffered per entity before they are written.
+  const size_t kExportRowGroup = 1024;
+
+  /// \brief Values of one entity in one state.
+  struct ExportSample
+  {
+    /// \brief Kind of entity: model, link or joint.
+    std::string kind;
+
+    /// \brief Scoped name of the entity.
+    std::string name;
+
+    /// \brief Values of the row, without the time.
+    std::vector<double> values;
+  };
+
+  /// \brief Samples of one state.
+  struct ExportState
+  {
+    /// \brief Simulation time in seconds.
+    double time = 0;
+
+    /// \brief Samples of all the entities.
+    std::vector<ExportSample> samples;
+  };
+
+  /// \brief Columns of one entity, and the rows that were not written yet.
+  struct ExportColumns
+  {
+    /// \brief Kind of entity.
+    std::string kind;
+
+    /// \brief Path of the output file.
+    std::string path;
+
+    /// \brief Names of the columns.
+    std::vector<std::string> names;
+
+    /// \brief Pending rows, one after the other.
+    std::vector<double> rows;
+
+    /// \brief Number of rows written or pending.
+    uint64_t count = 0;
+  };
+
+  /// \brief Read the numbers of an element text.
+  /// \param[in] _text Start of the text.
+  /// \param[in] _end End of the text.
+  /// \param[out] _values The numbers are appended to it.
+  void ExportNumbers(const char *_text, const char *_end,
+      std::vector<double> &_values)
+  {
+    while (_text < _end)
+    {
+      char *next = nullptr;
+      const double value = std::strtod(_text, &next);
+      if (next == _text || next > _end)
+        break;
+      _values.push_back(value);
+      _text = next;
+    }
+  }
+
+  /// \brief Get the value of an attribute in the attributes of a tag.
+  /// \param[in] _attrs Attributes of the tag.
+  /// \param[in] _name Name of the attribute.
+  /// \return The value, empty if the attribute is not there.
+  std::string ExportAttribute(const std::string &_attrs,
+      const std::string &_name)
+  {
+    size_t pos = 0;
+    while ((pos = _attrs.find(_name, pos)) != std::string::npos)
+    {
+      size_t eq = _attrs.find_first_not_of(" \t\r\n", pos + _name.size());
+      const bool word = pos == 0 ||
+        std::isspace(static_cast<unsigned char>(_attrs[pos - 1]));
+      pos += _name.size();
+      if (!word || eq == std::string::npos || _attrs[eq] != '=')
+        continue;
+      size_t quote = _attrs.find_first_of("'\"", eq);
+      if (quote == std::string::npos)
+        break;
+      size_t close = _attrs.find(_attrs[quote], quote + 1);
+      if (close == std::string::npos)
+        break;
+      return _attrs.substr(quote + 1, close - quote - 1);
+    }
+    return "";
+  }
+
+  /// \brief Parse the states of a chunk. This scans the tags of the state
+  /// XML written by LogRecord, instead of loading it in an SDF element,
+  /// and skips insertions and deletions.
+  /// \param[in] _data Decoded chunk.
+  /// \param[out] _states The states are appended to it.
+  void ExportParse(const std::string &_data, std::vector<ExportState> &_states)
+  {
+    // Open elements, with the scoped name of the entity of each of them
+    struct Open
+    {
+      std::string tag;
+      std::string scope;
+      size_t sample;
+      bool skip;
+    };
+    std::vector<Open> stack;
+
+    const char *data = _data.c_str();
+    const char *end = data + std::strlen(data);
+    const char *cur = data;
+    while ((cur = static_cast<const char *>(
+            std::memchr(cur, '<', end - cur))) != nullptr)
+    {
+      ++cur;
+      if (cur >= end)
+        break;
+
+      // Comments, CDATA, declarations and processing instructions
+      if (*cur == '!' || *cur == '?')
+      {
+        const char *close = std::strstr(cur,
+            std::strncmp(cur, "![CDATA[", 8) == 0 ? "]]>" :
+            (std::strncmp(cur, "!--", 3) == 0 ? "-->" : ">"));
+        if (!close)
+          break;
+        cur = close + 1;
+        continue;
+      }
+
+      const char *close = static_cast<const char *>(
+          std::memchr(cur, '>', end - cur));
+      if (!close)
+        break;
+
+      if (*cur == '/')
+      {
+        if (!stack.empty())
+          stack.pop_back();
+        cur = close + 1;
+        continue;
+      }
+
+      const bool empty = *(close - 1) == '/';
+      const char *nameEnd = cur;
+      while (nameEnd < close &&
+             !std::isspace(static_cast<unsigned char>(*nameEnd)) &&
+             *nameEnd != '/')
+      {
+        ++nameEnd;
+      }
+      const std::string tag(cur, nameEnd);
+      const std::string parent = stack.empty() ? "" : stack.back().tag;
+      std::string scope = stack.empty() ? "" : stack.back().scope;
+      // One plus the index of the sample of the enclosing entity, or zero
+      size_t sample = stack.empty() ? 0 : stack.back().sample;
+      // Insertions and deletions hold whole models, whose elements must
+      // not be read as states
+      const bool skip = (!stack.empty() && stack.back().skip) ||
+        tag == "insertions" || tag == "deletions";
+
+      // Text of the element, up to the next tag
+      const char *text = close + 1;
+      const char *textEnd = empty ? text : static_cast<const char *>(
+          std::memchr(text, '<', end - text));
+      if (!textEnd)
+        textEnd = end;
+
+      if (skip)
+      {
+        sample = 0;
+      }
+      else if (tag == "state" && parent == "sdf")
+      {
+        _states.push_back(ExportState());
+        scope.clear();
+        sample = 0;
+      }
+      else if (tag == "sim_time" && parent == "state" && !_states.empty())
+      {
+        std::vector<double> values;
+        ExportNumbers(text, textEnd, values);
+        if (values.size() == 2)
+          _states.back().time = values[0] + values[1] * 1e-9;
+      }
+      else if (!_states.empty() &&
+               ((tag == "model" && (parent == "state" || parent == "model")) ||
+                ((tag == "link" || tag == "joint") && parent == "model")))
+      {
+        const std::string name = ExportAttribute(
+            std::string(nameEnd, close), "name");
+        scope = scope.empty() ? name : scope + "::" + name;
+
+        auto &samples = _states.back().samples;
+        samples.push_back(ExportSample());
+        samples.back().kind = tag;
+        samples.back().name = scope;
+        samples.back().values.reserve(tag == "link" ? 13 : 7);
+        sample = samples.size();
+      }
+      else if (sample > 0)
+      {
+        ExportSample &current = _states.back().samples[sample - 1];
+        if (tag == "pose" && (parent == "model" || parent == "link") &&
+            current.values.empty())
+        {
+          std::vector<double> pose;
+          ExportNumbers(text, textEnd, pose);
+          pose.resize(6, 0.0);
+          ignition::math::Quaterniond rot(pose[3], pose[4], pose[5]);
+          current.values = {pose[0], pose[1], pose[2],
+            rot.W(), rot.X(), rot.Y(), rot.Z()};
+        }
+        else if (tag == "velocity" && parent == "link")
+        {
+          std::vector<double> velocity;
+          ExportNumbers(text, textEnd, velocity);
+          velocity.resize(6, 0.0);
+          current.values.resize(7, 0.0);
+          current.values.insert(current.values.end(), velocity.begin(),
+              velocity.end());
+        }
+        else if (tag == "angle" && parent == "joint")
+        {
+          std::vector<double> angle;
+          ExportNumbers(text, textEnd, angle);
+          const std::string axis = ExportAttribute(
+              std::string(nameEnd, close), "axis");
+          const size_t index = axis.empty() ? current.values.size() :
+            static_cast<size_t>(std::atoi(axis.c_str()));
+          if (index < 16)
+          {
+            if (current.values.size() <= index)
+              current.values.resize(index + 1, 0.0);
+            current.values[index] = angle.empty() ? 0.0 : angle[0];
+          }
+        }
+      }
+
+      if (!empty)
+        stack.push_back({tag, scope, sample, skip});
+      cur = close + 1;
+    }
+  }
+
+  /// \brief Write the pending rows of an entity.
+  /// \param[in] _columns The entity.
+  /// \return True on success.
+  bool ExportFlush(ExportColumns &_columns)
+  {
+    const size_t width = _columns.names.size();
+    const uint32_t rows = _columns.rows.size() / width;
+    if (rows == 0)
+      return true;
+
+    std::ofstream out(_columns.path,
+        std::ios::out | std::ios::app | std::ios::binary);
+    if (!out)
+      return false;
+
+    std::vector<double> column(rows);
+    out.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+    for (size_t c = 0; c < width; ++c)
+    {
+      for (size_t r = 0; r < rows; ++r)
+        column[r] = _columns.rows[r * width + c];
+      out.write(reinterpret_cast<const char *>(column.data()),
+          rows * sizeof(double));
+    }
+    _columns.rows.clear();
+
+    return out.good();
+  }
+}
+
+/////////////////////////////////////////////////
+bool LogCommand::Export(const std::string &_filename, const std::string &_dir,
+    const double _hz)
+{
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(_dir, ec);
+  if (!boost::filesystem::is_directory(_dir))
+  {
+    std::cerr << "Unable to create export directory[" << _dir << "]\n";
+    return false;
+  }
+
+  std::map<std::string, ExportColumns> entities;
+  bool result = true;
+  double prevTime = 0;
+  bool first = true;
+
+  // Merge the states of a batch in order
+  auto merge = [&](const std::vector<std::vector<ExportState>> &_batch)
+  {
+    for (auto const &states : _batch)
+    {
+      for (auto const &state : states)
+      {
+        if (_hz > 0.0 && !first && state.time - prevTime < 1.0 / _hz)
+          continue;
+        prevTime = state.time;
+        first = false;
+
+        for (auto const &sample : state.samples)
+        {
+          if (sample.values.empty())
+            continue;
+
+          const std::string key = sample.name + "." + sample.kind;
+          auto iter = entities.find(key);
+          if (iter == entities.end())
+          {
+            ExportColumns columns;
+            columns.kind = sample.kind;
+            columns.names = {"time"};
+            if (sample.kind == "joint")
+            {
+              for (size_t i = 0; i < sample.values.size(); ++i)
+                columns.names.push_back("axis" + std::to_string(i));
+            }
+            else
+            {
+              columns.names.insert(columns.names.end(),
+                  {"x", "y", "z", "qw", "qx", "qy", "qz"});
+              if (sample.kind == "link")
+              {
+                columns.names.insert(columns.names.end(),
+                    {"vx", "vy", "vz", "wx", "wy", "wz"});
+              }
+            }
+
+            std::string file = boost::replace_all_copy(key, "::", "__");
+            boost::replace_all(file, "/", "_");
+            columns.path = (boost::filesystem::path(_dir) /
+                (file + ".gzcol")).string();
+
+            // Header
+            std::ofstream out(columns.path,
+                std::ios::out | std::ios::trunc | std::ios::binary);
+            const uint32_t version = 1;
+            const uint32_t count = columns.names.size();
+            out.write("GZLOGCOL", 8);
+            out.write(reinterpret_cast<const char *>(&version),
+                sizeof(version));
+            out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            for (auto const &name : columns.names)
+            {
+              const uint32_t size = name.size();
+              out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+              out.write(name.c_str(), size);
+            }
+            if (!out)
+            {
+              std::cerr << "Unable to write[" << columns.path << "]\n";
+              result = false;
+            }
+            columns.rows.reserve(kExportRowGroup * columns.names.size());
+            iter = entities.insert(std::make_pair(key, columns)).first;
+          }
+
+          ExportColumns &columns = iter->second;
+          const size_t width = columns.names.size();
+          columns.rows.push_back(state.time);
+          for (size_t i = 1; i < width; ++i)
+          {
+            columns.rows.push_back(i <= sample.values.size() ?
+                sample.values[i - 1] : 0.0);
+          }
+          ++columns.count;
+
+          if (columns.rows.size() >= kExportRowGroup * width &&
+              !ExportFlush(columns))
+          {
+            result = false;
+          }
+        }
+      }
+    }
+  };
+
+  // Decode and parse a batch of chunks on several threads
+  const unsigned int threads =
+    std::max(1u, std::thread::hardware_concurrency());
+  const size_t batchSize = threads * 4;
+  std::vector<std::pair<std::string, std::string>> batch;
+  auto process = [&]()
+  {
+    std::vector<std::vector<ExportState>> states(batch.size());
+    std::atomic<size_t> next(0);
+    auto work = [&]()
+    {
+      std::string data;
+      for (size_t i = next++; i < batch.size(); i = next++)
+      {
+        if (gazebo::util::LogPlay::DecodeChunk(
+              batch[i].first, batch[i].second, data))
+        {
+          ExportParse(data, states[i]);
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < std::min<size_t>(threads, batch.size()); ++i)
+      workers.push_back(std::thread(work));
+    work();
+    for (auto &worker : workers)
+      worker.join();
+
+    merge(states);
+    batch.clear();
+  };
+
+  // The log is streamed, only the chunks of one batch are in memory. The
+  // first chunk holds the world description.
+  unsigned int chunk = 0;
+  if (!gazebo::util::LogPlay::EncodedChunks(_filename,
+      [&](const std::string &_encoding, const std::string &_text)
+      {
+        if (chunk++ == 0)
+          return true;
+
+        batch.push_back(std::make_pair(_encoding, _text));
+        if (batch.size() >= batchSize)
+          process();
+        return true;
+      }))
+  {
+    std::cerr << "Unable to open log file[" << _filename << "]\n";
+    return false;
+  }
+  process();
+
+  // Write the remaining rows and the index
+  std::ofstream index(
+      (boost::filesystem::path(_dir) / "index.txt").string());
+  for (auto &entity : entities)
+  {
+    if (!ExportFlush(entity.second))
+      result = false;
+
+    const size_t sep = entity.first.rfind('.');
+    index << entity.second.kind << " " << entity.second.count << " "
+      << boost::filesystem::path(entity.second.path).filename().string()
+      << " " << entity.first.substr(0, sep) << "\n";
+  }
+
+  if (!index || !result)
+  {
+    std::cerr << "Unable to write the export in[" << _dir << "]\n";
+    return false;
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 bool LogCommand::LoadLogFromFile(const std::string &_filename)
 {
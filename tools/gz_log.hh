@@ -240,6 +240,29 @@ namespace gazebo
     private: void Step(const std::string &_filter, bool _raw,
                  const std::string &_stamp, double _hz);
 
+    /// \brief Export the poses, velocities and joint positions of a log
+    /// file in a columnar binary format. The log is streamed once, without
+    /// being opened in LogPlay, and its chunks are decoded and parsed on
+    /// several threads. Only a batch of chunks is held in memory.
+    ///
+    /// One file is written per model, link and joint, named after its
+    /// scoped name and kind, for example pr2__base_link.link.gzcol, and
+    /// index.txt lists them. A file starts with the magic "GZLOGCOL", a
+    /// uint32 version and a uint32 column count, then each column name as
+    /// a uint32 length and its characters. Rows follow in groups: a uint32
+    /// row count, then the values of each column in turn, as doubles. All
+    /// numbers are in the byte order of the machine that wrote the file.
+    ///
+    /// Models and links have the columns time x y z qw qx qy qz, links
+    /// also have vx vy vz wx wy wz. Joints have time and one column per
+    /// axis. The time is the simulation time in seconds.
+    /// \param[in] _filename Path of the log file.
+    /// \param[in] _dir Output directory, created if needed.
+    /// \param[in] _hz Hertz rate, 0 to export every state.
+    /// \return True on success.
+    private: bool Export(const std::string &_filename,
+                 const std::string &_dir, const double _hz);
+
     /// \brief Start or stop logging
     /// \param[in] _start True to start logging
     private: void Record(bool _start);
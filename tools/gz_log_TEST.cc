@@ -14,7 +14,11 @@
  * limitations under the License.
  *
 */
+#include <fstream>
+#include <map>
+#include <sstream>
 #include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -474,6 +478,110 @@ TEST(gz_log, Output)
 #endif
 }
 
+/////////////////////////////////////////////////
+/// Check the columnar export of a log file
+TEST(gz_log, Export)
+{
+  std::ostringstream dir;
+  dir << "/tmp/__gz_log_export" << std::this_thread::get_id();
+  custom_exec("rm -rf " + dir.str());
+  custom_exec(std::string(GZ_LOG_PATH + " -x ") + dir.str() + " -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+
+  // One line per entity: kind, rows, file and scoped name
+  std::ifstream index(dir.str() + "/index.txt");
+  ASSERT_TRUE(index.good());
+  std::map<std::string, std::string> files;
+  std::string kind, file, name;
+  unsigned int rows;
+  while (index >> kind >> rows >> file >> name)
+  {
+    files[name] = file;
+    if (kind == "joint")
+      EXPECT_GE(2u, rows);
+    else
+      EXPECT_EQ(2u, rows) << name;
+  }
+  EXPECT_EQ("pr2.model.gzcol", files["pr2"]);
+  EXPECT_EQ("pr2__base_footprint.link.gzcol", files["pr2::base_footprint"]);
+  EXPECT_EQ("pr2__torso_lift_joint.joint.gzcol",
+      files["pr2::torso_lift_joint"]);
+
+  // Header and single row group of the model
+  std::ifstream in(dir.str() + "/pr2.model.gzcol", std::ios::binary);
+  char magic[8];
+  uint32_t version = 0, columns = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char *>(&version), sizeof(version));
+  in.read(reinterpret_cast<char *>(&columns), sizeof(columns));
+  EXPECT_EQ("GZLOGCOL", std::string(magic, sizeof(magic)));
+  EXPECT_EQ(1u, version);
+  ASSERT_EQ(8u, columns);
+
+  std::vector<std::string> names;
+  for (uint32_t i = 0; i < columns; ++i)
+  {
+    uint32_t size = 0;
+    in.read(reinterpret_cast<char *>(&size), sizeof(size));
+    std::string column(size, ' ');
+    in.read(&column[0], size);
+    names.push_back(column);
+  }
+  EXPECT_EQ(std::vector<std::string>(
+        {"time", "x", "y", "z", "qw", "qx", "qy", "qz"}), names);
+
+  uint32_t count = 0;
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  ASSERT_EQ(2u, count);
+  std::vector<double> values(count * columns);
+  in.read(reinterpret_cast<char *>(values.data()),
+      values.size() * sizeof(double));
+  ASSERT_TRUE(in.good());
+  EXPECT_DOUBLE_EQ(0.021343973, values[0]);
+  EXPECT_DOUBLE_EQ(0.028958235, values[1]);
+  EXPECT_DOUBLE_EQ(-0.000008, values[3 * count]);
+  EXPECT_DOUBLE_EQ(-0.000015, values[3 * count + 1]);
+  EXPECT_DOUBLE_EQ(1.0, values[4 * count]);
+
+  // Hz filter
+  custom_exec("rm -rf " + dir.str());
+  custom_exec(std::string(GZ_LOG_PATH + " -x ") + dir.str() + " -z 1 -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  std::ifstream filtered(dir.str() + "/index.txt");
+  ASSERT_TRUE(filtered >> kind >> rows);
+  EXPECT_EQ(1u, rows);
+
+  custom_exec("rm -rf " + dir.str());
+}
+
+/////////////////////////////////////////////////
+/// Check that the models of insertions are not exported as entities
+TEST(gz_log, ExportInsertion)
+{
+  std::ostringstream dir;
+  dir << "/tmp/__gz_log_export_insertion" << std::this_thread::get_id();
+  custom_exec("rm -rf " + dir.str());
+  custom_exec(std::string(GZ_LOG_PATH + " -x ") + dir.str() + " -f " +
+      PROJECT_SOURCE_PATH + "/test/logs/insertion_deletion.log");
+
+  std::ifstream index(dir.str() + "/index.txt");
+  ASSERT_TRUE(index.good());
+  std::map<std::string, unsigned int> entities;
+  std::string kind, file, name;
+  unsigned int rows;
+  while (index >> kind >> rows >> file >> name)
+    entities[kind + " " + name] = rows;
+
+  // The inserted box is exported from its states only, the link of its
+  // insertion is not a top level entity
+  EXPECT_EQ(2u, entities.size());
+  EXPECT_EQ(entities["model unit_box"], entities["link unit_box::link"]);
+  EXPECT_LT(0u, entities["model unit_box"]);
+  EXPECT_EQ(0u, entities.count("link link"));
+
+  custom_exec("rm -rf " + dir.str());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
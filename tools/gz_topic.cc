@@ -182,7 +182,10 @@ void TopicCommand::Info(const std::string &_topic)
   for (int i = 0; i < info.subscriber_size(); i++)
   {
     std::cout << "\t" << info.subscriber(i).host() << ":"
-              << info.subscriber(i).port() << "\n";
+              << info.subscriber(i).port();
+    if (info.subscriber(i).has_dropped())
+      std::cout << " (dropped " << info.subscriber(i).dropped() << ")";
+    std::cout << "\n";
   }
   std::cout << "\n";
 }